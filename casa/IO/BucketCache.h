@@ -314,6 +314,20 @@ public:
     // (Re)initialize the cache statistics.
     void initStatistics();
 
+    // Get the cache statistics: the number of bucket accesses and the
+    // number of buckets read, initialized and written since the last
+    // initialization of the statistics.
+    // <group>
+    uInt nAccess() const
+      { return naccess_p; }
+    uInt nRead() const
+      { return nread_p; }
+    uInt nInit() const
+      { return ninit_p; }
+    uInt nWrite() const
+      { return nwrite_p; }
+    // </group>
+
     // Show the statistics.
     void showStatistics (ostream& os) const;
 
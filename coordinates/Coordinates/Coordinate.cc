@@ -40,10 +40,13 @@
 #include <casacore/casa/Utilities/Assert.h>
 #include <casacore/casa/Utilities/Regex.h>
 
+#include <casacore/casa/OS/OMP.h>
 #include <casacore/casa/OS/Timer.h>
 
 #include <casacore/casa/iomanip.h>
 #include <casacore/casa/sstream.h>
+#include <algorithm>
+#include <vector>
 
 namespace casacore { //# NAMESPACE CASACORE - BEGIN
 
@@ -1044,6 +1047,25 @@ Bool Coordinate::toPixelWCS(Vector<Double> &pixel, const Vector<Double> &world,
 
 
 
+// Minimum number of coordinates per thread for which toWorldManyWCS
+// and toPixelManyWCS convert in parallel.
+static const uInt wcsManyPerThread = 4096;
+
+// Get the number of threads to use to convert the given number of
+// coordinates with wcs. wcsp2s and wcss2p only read the wcsprm once it has
+// been set by wcsset (as done by set_wcs), so threads can share it.
+// A flag of 0 means it still has to be set, which wcslib does itself,
+// so then a single thread is used.
+static Int wcsManyThreads (uInt nTransforms, const ::wcsprm& wcs)
+{
+    if (wcs.flag == 0) {
+       return 1;
+    }
+    return std::max (1u, std::min (nTransforms / wcsManyPerThread,
+                                   OMP::maxThreads()));
+}
+
+
 Bool Coordinate::toWorldManyWCS (Matrix<Double>& world, const Matrix<Double>& pixel,
                                  Vector<Bool>& failures, ::wcsprm& wcs) const
 {
@@ -1072,7 +1094,28 @@ Bool Coordinate::toWorldManyWCS (Matrix<Double>& world, const Matrix<Double>& pi
     Double* pTheta = theta.getStorage(deleteTheta);
     Int* pStat = stat.getStorage(deleteStat);
 //
-    int iret = wcsp2s (&wcs, nTransforms, nAxes, pPixel, pImgCrd, pPhi, pTheta, pWorld, pStat);
+    int iret = 0;
+    const Int nthr = wcsManyThreads (nTransforms, wcs);
+    if (nthr <= 1) {
+       iret = wcsp2s (&wcs, nTransforms, nAxes, pPixel, pImgCrd, pPhi, pTheta, pWorld, pStat);
+    } else {
+
+// Large batches are split over the threads; the first error is returned
+
+       std::vector<int> irets(nthr, 0);
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(nthr)
+#endif
+       for (Int t=0; t<nthr; t++) {
+          const size_t st = size_t(nTransforms) * t / nthr;
+          const int nC = size_t(nTransforms) * (t+1) / nthr - st;
+          irets[t] = wcsp2s (&wcs, nC, nAxes, pPixel + st*nAxes, pImgCrd + st*nAxes,
+                             pPhi + st, pTheta + st, pWorld + st*nAxes, pStat + st);
+       }
+       for (Int t=0; t<nthr && iret==0; t++) {
+          iret = irets[t];
+       }
+    }
     for (uInt i=0; i<nTransforms; i++) {
        failures[i] = pStat[i]!=0;
     }
@@ -1123,8 +1166,29 @@ Bool Coordinate::toPixelManyWCS (Matrix<Double>& pixel, const Matrix<Double>& wo
 
 // Convert from wcs units to pixel
 
-    const int nC = nTransforms;
-    int iret = wcss2p (&wcs, nC, nAxes, pWorld, pPhi, pTheta, pImgCrd, pPixel, pStat);
+    int iret = 0;
+    const Int nthr = wcsManyThreads (nTransforms, wcs);
+    if (nthr <= 1) {
+       const int nC = nTransforms;
+       iret = wcss2p (&wcs, nC, nAxes, pWorld, pPhi, pTheta, pImgCrd, pPixel, pStat);
+    } else {
+
+// Large batches are split over the threads; the first error is returned
+
+       std::vector<int> irets(nthr, 0);
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(nthr)
+#endif
+       for (Int t=0; t<nthr; t++) {
+          const size_t st = size_t(nTransforms) * t / nthr;
+          const int nC = size_t(nTransforms) * (t+1) / nthr - st;
+          irets[t] = wcss2p (&wcs, nC, nAxes, pWorld + st*nAxes, pPhi + st, pTheta + st,
+                             pImgCrd + st*nAxes, pPixel + st*nAxes, pStat + st);
+       }
+       for (Int t=0; t<nthr && iret==0; t++) {
+          iret = irets[t];
+       }
+    }
     for (uInt i=0; i<nTransforms; i++) {
        failures[i] = pStat[i]!=0;
     }
@@ -1148,7 +1212,22 @@ Bool Coordinate::toPixelManyWCS (Matrix<Double>& pixel, const Matrix<Double>& wo
 
 void Coordinate::toCurrentMany(Matrix<Double>& world, const Vector<Double>& toCurrentFactors) const
 {
-    for (uInt i=0; i<toCurrentFactors.nelements(); i++) {
+    const uInt nAxes = toCurrentFactors.nelements();
+    if (world.contiguousStorage()  &&  nAxes == world.nrow()) {
+
+// Scale all columns in one pass over the contiguous matrix
+
+       Double* pWorld = world.data();
+       const Double* pFactors = toCurrentFactors.data();
+       const size_t nTransforms = world.ncolumn();
+       for (size_t j=0; j<nTransforms; j++, pWorld+=nAxes) {
+          for (uInt i=0; i<nAxes; i++) {
+             pWorld[i] *= pFactors[i];
+          }
+       }
+       return;
+    }
+    for (uInt i=0; i<nAxes; i++) {
        Vector<Double> row(world.row(i));                // Reference
        row *= toCurrentFactors[i];
     }
@@ -1157,7 +1236,19 @@ void Coordinate::toCurrentMany(Matrix<Double>& world, const Vector<Double>& toCu
 
 void Coordinate::fromCurrentMany(Matrix<Double>& world, const Vector<Double>& toCurrentFactors) const
 {
-    for (uInt i=0; i<toCurrentFactors.nelements(); i++) {
+    const uInt nAxes = toCurrentFactors.nelements();
+    if (world.contiguousStorage()  &&  nAxes == world.nrow()) {
+       Double* pWorld = world.data();
+       const Double* pFactors = toCurrentFactors.data();
+       const size_t nTransforms = world.ncolumn();
+       for (size_t j=0; j<nTransforms; j++, pWorld+=nAxes) {
+          for (uInt i=0; i<nAxes; i++) {
+             pWorld[i] /= pFactors[i];
+          }
+       }
+       return;
+    }
+    for (uInt i=0; i<nAxes; i++) {
        Vector<Double> row(world.row(i));                // Reference
        row /= toCurrentFactors[i];
     }
@@ -149,6 +149,11 @@ public:
 // Align many spectra stored in an Array along the specified axis.  All spectra are aligned
 // to the same frequency abcissa (as described in previous function).  If any alignment
 // returns False, then the return value will be False, otherwise  True is returned.
+// The abcissa is computed once per epoch; it is reused if the function is called
+// again for the same epoch (e.g. for the next plane of a cube).  The spectra are
+// regridded in blocks, where each block is interpolated as a whole (all spectra
+// in a block share the abcissa search) and the blocks are distributed over
+// the OpenMP threads.  The result is the same as aligning the spectra one by one.
   Bool alignMany (Array<T>& yOut, Array<Bool>& maskOut,
                   const Array<T>& yIn, const Array<Bool>& maskIn,
                   uInt axis, const MEpoch& epoch, 
@@ -176,6 +181,11 @@ private:
   Vector<Double> itsFreqX;                        // Frequency abcissa
 
   Double itsDiffTol;                              // Tolerance which triggers a regrid
+//
+  Bool itsHasEpochX;                              // Is itsFreqX valid for itsEpochX?
+  Double itsEpochX;                               // Epoch (MJD) of itsFreqX
+  uInt itsEpochXType;                             // MEpoch type of itsEpochX
+  Double itsEpochMaxDiff;                         // Max diff of itsFreqX
 
 // Internal copy
    void copyOther (const FrequencyAligner<T>& other);
@@ -190,6 +200,10 @@ private:
 // Generate an abcissa with the machine
    Double makeAbcissa (Vector<Double>& f, Bool doMaxDiff);
 
+// Generate the abcissa at the given epoch in itsFreqX, unless it has already
+// been done for that epoch. It returns the max diff.
+   Double makeEpochAbcissa (const MEpoch& epoch);
+
 // Regrid one spectrum
    Bool regrid (Vector<T>& yOut, Vector<Bool>& maskOut,
                 const Vector<Double>& xOut,
@@ -29,6 +29,7 @@
 #include <casacore/coordinates/Coordinates/FrequencyAligner.h>
 
 #include <casacore/casa/Arrays/ArrayAccessor.h>
+#include <casacore/casa/Arrays/Matrix.h>
 #include <casacore/casa/Arrays/VectorIter.h>
 #include <casacore/casa/BasicMath/Math.h>
 #include <casacore/casa/Quanta/Unit.h>
@@ -36,6 +37,7 @@
 #include <casacore/casa/Exceptions/Error.h>
 #include <casacore/casa/Logging/LogIO.h>
 #include <casacore/casa/Logging/LogOrigin.h>
+#include <casacore/casa/OS/OMP.h>
 #include <casacore/casa/Quanta/Quantum.h>
 
 #include <casacore/coordinates/Coordinates/CoordinateUtil.h>
@@ -47,13 +49,21 @@
 
 #include <casacore/scimath/Mathematics/InterpolateArray1D.h>
 
+#include <algorithm>
+#include <exception>
+#include <vector>
+
 namespace casacore {
 
 template<class T>
 FrequencyAligner<T>::FrequencyAligner()
  : itsRefFreqX(0),
    itsFreqX(0),
-   itsDiffTol(0.0)
+   itsDiffTol(0.0),
+   itsHasEpochX(False),
+   itsEpochX(0.0),
+   itsEpochXType(0),
+   itsEpochMaxDiff(-1.0)
 {}
 
 
@@ -68,7 +78,11 @@ FrequencyAligner<T>::FrequencyAligner(const SpectralCoordinate& specCoord,
    itsFreqSystem(freqSystem),
    itsRefFreqX(0),
    itsFreqX(0),
-   itsDiffTol(0.0)
+   itsDiffTol(0.0),
+   itsHasEpochX(False),
+   itsEpochX(0.0),
+   itsEpochXType(0),
+   itsEpochMaxDiff(-1.0)
 {
 
 // Reset the conversion machinery so that there are no extra frame
@@ -97,7 +111,11 @@ template<class T>
 FrequencyAligner<T>::FrequencyAligner(const FrequencyAligner<T>& other)
  : itsRefFreqX(0),
    itsFreqX(0),
-   itsDiffTol(0.0)
+   itsDiffTol(0.0),
+   itsHasEpochX(False),
+   itsEpochX(0.0),
+   itsEpochXType(0),
+   itsEpochMaxDiff(-1.0)
 {
   copyOther(other);
 }
@@ -143,7 +161,8 @@ Bool FrequencyAligner<T>::align (Vector<T>& yOut, Vector<Bool>& maskOut,
    if (useCachedAbcissa) {
       maxDiff = abs(itsFreqX[0]-itsRefFreqX[0]);
    } else {   
-      maxDiff = makeAbcissa (itsFreqX, True);
+      itsHasEpochX = False;
+      maxDiff = makeEpochAbcissa (epoch);
    }
    maxDiff /= abs(itsRefFreqX[1]-itsRefFreqX[0]);      // Max diff as a fraction of a channel
 
@@ -184,6 +203,7 @@ Bool FrequencyAligner<T>::align (Vector<T>& yOut, Vector<Bool>& maskOut,
          itsFreqX[i] = itsMachine(xIn[i]).getValue().getValue();
          maxDiff = casacore::max(casacore::abs(itsFreqX[i]-itsRefFreqX[i]),maxDiff);
       }
+      itsHasEpochX = False;                            // Not the abcissa of the SC
    }
    maxDiff /= abs(itsRefFreqX[1]-itsRefFreqX[0]);      // Max diff as a fraction of a channel
 
@@ -216,44 +236,98 @@ Bool FrequencyAligner<T>::alignMany (Array<T>& yOut, Array<Bool>& maskOut,
    yOut.resize(yIn.shape());
    maskOut.resize(maskIn.shape());
 
-// Update epoch in FrequencyMachine
-
-   itsRefOut.getFrame().resetEpoch(epoch);
-   itsMachine.setOut(itsRefOut);
-
-// Generate abcissa at this epoch
+// Generate abcissa at this epoch (or reuse it if already done for this epoch)
 
-   Double maxDiff = makeAbcissa (itsFreqX, True);
+   Double maxDiff = makeEpochAbcissa (epoch);
    maxDiff /= abs(itsRefFreqX[1]-itsRefFreqX[0]);      // Max diff as a fraction of a channel
 
-// Make iterators
-
-   ReadOnlyVectorIterator<T> yItIn(yIn, axis);
-   ReadOnlyVectorIterator<Bool> mItIn(maskIn, axis);
-   VectorIterator<T> yItOut(yOut, axis);
-   VectorIterator<Bool> mItOut(maskOut, axis);
-
-// Iterate through Array and align each vector with the same grid
+// The array is seen as [inner,n,outer], where n is the spectral axis.
+// Spectrum s=j+o*inner starts at j+o*n*inner and has stride inner.
 
-   Bool ok = True;
-   while (!yItIn.pastEnd()) {
-
-// Align
-
-      Bool ok2 = regrid (yItOut.vector(), mItOut.vector(), itsRefFreqX, itsFreqX,
-                         yItIn.vector(), mItIn.vector(),
-                         method, extrapolate, maxDiff);
-      if (!ok2) ok = False;
-
-// Next vector
+   Int64 inner = 1;
+   for (uInt i=0; i<axis; i++) inner *= shp(i);
+   const Int64 nspec = shp.product() / n;
+   if (maxDiff <= itsDiffTol) {
+      yOut = yIn;
+      maskOut = maskIn;
+      return nspec == 0;
+   }
 
-       yItIn.next();
-       mItIn.next();
-       yItOut.next();
-       mItOut.next();
+// Regrid the spectra in blocks. A block is copied to a matrix [spectrum,n]
+// which is regridded in one go by InterpolateArray1D (along its last axis),
+// so the abcissa search is done once per block and the inner loops run
+// over contiguous spectra.
+
+   const Int64 blockSize = 256;
+   const Int64 nblock = (nspec + blockSize - 1) / blockSize;
+   Int nthr = std::max<Int64> (1, std::min<Int64> (nblock, OMP::maxThreads()));
+   Int methodInt = static_cast<Int>(method);
+   Bool deleteYIn, deleteMIn, deleteYOut, deleteMOut;
+   const T* yInPtr = yIn.getStorage (deleteYIn);
+   const Bool* mInPtr = maskIn.getStorage (deleteMIn);
+   T* yOutPtr = yOut.getStorage (deleteYOut);
+   Bool* mOutPtr = maskOut.getStorage (deleteMOut);
+   std::exception_ptr excp;
+#ifdef _OPENMP
+#pragma omp parallel num_threads(nthr)
+#endif
+   {
+      Matrix<T> yBuf, yBufOut;
+      Matrix<Bool> mBuf, mBufOut;
+      std::vector<Int64> offsets(blockSize);
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+      for (Int64 blk=0; blk<nblock; blk++) {
+         try {
+            const Int64 s0 = blk*blockSize;
+            const Int64 nb = std::min (blockSize, nspec-s0);
+            for (Int64 b=0; b<nb; b++) {
+               const Int64 s = s0+b;
+               offsets[b] = s%inner + (s/inner)*n*inner;
+            }
+            yBuf.resize (nb, n);
+            mBuf.resize (nb, n);
+            T* yb = yBuf.data();
+            Bool* mb = mBuf.data();
+            for (Int c=0; c<n; c++) {
+               const Int64 coff = c*inner;
+               for (Int64 b=0; b<nb; b++) {
+                  yb[b + c*nb] = yInPtr[offsets[b] + coff];
+                  mb[b + c*nb] = mInPtr[offsets[b] + coff];
+               }
+            }
+            InterpolateArray1D<Double,T>::interpolate (yBufOut, mBufOut,
+                                                       itsRefFreqX, itsFreqX,
+                                                       yBuf, mBuf, methodInt,
+                                                       True, extrapolate);
+            const T* ybo = yBufOut.data();
+            const Bool* mbo = mBufOut.data();
+            for (Int c=0; c<n; c++) {
+               const Int64 coff = c*inner;
+               for (Int64 b=0; b<nb; b++) {
+                  yOutPtr[offsets[b] + coff] = ybo[b + c*nb];
+                  mOutPtr[offsets[b] + coff] = mbo[b + c*nb];
+               }
+            }
+         } catch (...) {
+#ifdef _OPENMP
+#pragma omp critical(FrequencyAligner_alignMany)
+#endif
+            {
+               if (!excp) excp = std::current_exception();
+            }
+         }
+      }
    }
-//
-   return ok;
+   yIn.freeStorage (yInPtr, deleteYIn);
+   maskIn.freeStorage (mInPtr, deleteMIn);
+   yOut.putStorage (yOutPtr, deleteYOut);
+   maskOut.putStorage (mOutPtr, deleteMOut);
+   if (excp) {
+      std::rethrow_exception (excp);
+   }
+   return True;
 }
 
 
@@ -353,6 +427,32 @@ Double FrequencyAligner<T>::makeAbcissa (Vector<Double>& freq, Bool doDiff)
 }
 
 
+template<class T>
+Double FrequencyAligner<T>::makeEpochAbcissa (const MEpoch& epoch)
+{
+
+// The abcissa can only be reused if the epoch is exactly the same.
+
+   const Double mjd = epoch.getValue().get();
+   const uInt type = epoch.getRef().getType();
+   const Bool canCache = (epoch.getRef().offset() == 0);
+   if (itsHasEpochX && canCache && mjd == itsEpochX && type == itsEpochXType) {
+      return itsEpochMaxDiff;
+   }
+
+// Update epoch in FrequencyMachine and generate the abcissa.
+
+   itsRefOut.getFrame().resetEpoch(epoch);
+   itsMachine.setOut(itsRefOut);
+   Double maxDiff = makeAbcissa (itsFreqX, True);
+   itsHasEpochX = canCache;
+   itsEpochX = mjd;
+   itsEpochXType = type;
+   itsEpochMaxDiff = maxDiff;
+   return maxDiff;
+}
+
+
 template<class T>
 void FrequencyAligner<T>::copyOther(const FrequencyAligner<T>& other)
 {
@@ -367,6 +467,11 @@ void FrequencyAligner<T>::copyOther(const FrequencyAligner<T>& other)
    itsFreqX = other.itsFreqX;
 //
    itsDiffTol = other.itsDiffTol;
+//
+   itsHasEpochX = other.itsHasEpochX;
+   itsEpochX = other.itsEpochX;
+   itsEpochXType = other.itsEpochXType;
+   itsEpochMaxDiff = other.itsEpochMaxDiff;
 }
 
 
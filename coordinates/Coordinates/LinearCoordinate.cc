@@ -210,6 +210,21 @@ Bool LinearCoordinate::toPixel(Vector<Double> &pixel,
    return toPixelWCS (pixel, world, wcs_p);
 }
 
+Bool LinearCoordinate::toWorldMany(Matrix<Double> &world,
+                                   const Matrix<Double> &pixel,
+                                   Vector<Bool> &failures) const
+{
+   return toWorldManyWCS (world, pixel, failures, wcs_p);
+}
+
+Bool LinearCoordinate::toPixelMany(Matrix<Double> &pixel,
+                                   const Matrix<Double> &world,
+                                   Vector<Bool> &failures) const
+{
+   AlwaysAssert(world.nrow()==nWorldAxes(), AipsError);
+   return toPixelManyWCS (pixel, world, failures, wcs_p);
+}
+
 
 Vector<String> LinearCoordinate::worldAxisNames() const
 {
@@ -181,6 +181,22 @@ public:
 			 const Vector<Double> &world) const;
     // </group>
 
+    // Batch up a lot of transformations. The first (most rapidly varying) axis
+    // of the matrices contain the coordinates. All coordinates are converted
+    // by wcslib in one call (split over threads for large batches).
+    // Returns False if any conversion failed and <src>errorMessage()</src>
+    // will hold a message.
+    // The <src>failures</src> array is the length of the number of conversions
+    // (True for failure, False for success)
+    // <group>
+    virtual Bool toWorldMany(Matrix<Double> &world,
+                             const Matrix<Double> &pixel,
+                             Vector<Bool> &failures) const;
+    virtual Bool toPixelMany(Matrix<Double> &pixel,
+                             const Matrix<Double> &world,
+                             Vector<Bool> &failures) const;
+    // </group>
+
 
     // Return the requested attribute
     // <group>
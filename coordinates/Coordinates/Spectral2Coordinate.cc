@@ -111,15 +111,20 @@ Bool SpectralCoordinate::pixelToVelocity (Double& velocity, Double pixel) const
 
 Bool SpectralCoordinate::pixelToVelocity (Vector<Double>& velocity, const Vector<Double>& pixel) const
 {
-   velocity.resize(pixel.nelements());
-
-// Perhaps its faster to make a vector of world and do them 
-// all in one go in the machine ?  Haven't tested it.
-
-   Double world;
-   for (uInt i=0; i<pixel.nelements(); i++) {
-      if (!toWorld(world, pixel(i))) return False;
-      velocity(i) = pVelocityMachine_p->makeVelocity(world).getValue();
+   const uInt n = pixel.nelements();
+   velocity.resize(n);
+   if (n == 0) return True;
+
+// Convert all pixels to world in one go. The velocity machine is applied
+// per value, because its vector version uses another formula.
+
+   Matrix<Double> pixels(1, n);
+   pixels.row(0) = pixel;
+   Matrix<Double> world;
+   Vector<Bool> failures;
+   if (!toWorldMany(world, pixels, failures)) return False;
+   for (uInt i=0; i<n; i++) {
+      velocity(i) = pVelocityMachine_p->makeVelocity(world(0,i)).getValue();
    }
 //
    if(isNaN(velocity(0))){
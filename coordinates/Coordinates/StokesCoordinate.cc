@@ -162,6 +162,59 @@ Bool StokesCoordinate::toPixel(Vector<Double> &pixel,
     return False;
 }
 
+Bool StokesCoordinate::toWorldMany(Matrix<Double> &world,
+                                   const Matrix<Double> &pixel,
+                                   Vector<Bool> &failures) const
+{
+    AlwaysAssert(pixel.nrow()==1, AipsError);
+    const uInt nTransforms = pixel.ncolumn();
+    world.resize(1, nTransforms);
+    failures.resize(nTransforms);
+//
+    String errorMsg;
+    uInt nError = 0;
+    Double tmp;
+    for (uInt i=0; i<nTransforms; i++) {
+       failures[i] = !toWorld(tmp, pixel(0,i));
+       if (failures[i]) {
+          nError++;
+          if (nError == 1) errorMsg = errorMessage();    // Save the first error message
+       } else {
+          world(0,i) = tmp;
+       }
+    }
+//
+    if (nError != 0) set_error(errorMsg); // put back the first error
+    return (nError==0);
+}
+
+
+Bool StokesCoordinate::toPixelMany(Matrix<Double> &pixel,
+                                   const Matrix<Double> &world,
+                                   Vector<Bool> &failures) const
+{
+    AlwaysAssert(world.nrow()==1, AipsError);
+    const uInt nTransforms = world.ncolumn();
+    pixel.resize(1, nTransforms);
+    failures.resize(nTransforms);
+//
+    String errorMsg;
+    uInt nError = 0;
+    Double tmp;
+    for (uInt i=0; i<nTransforms; i++) {
+       failures[i] = !toPixel(tmp, world(0,i));
+       if (failures[i]) {
+          nError++;
+          if (nError == 1) errorMsg = errorMessage();    // Save the first error message
+       } else {
+          pixel(0,i) = tmp;
+       }
+    }
+//
+    if (nError != 0) set_error(errorMsg); // put back the first error
+    return (nError==0);
+}
+
 Double StokesCoordinate::toWorld (Stokes::StokesTypes stokes) 
 {
     return static_cast<Double>(stokes);
@@ -144,6 +144,22 @@ public:
                                 const Vector<Double> &world) const;
     // </group>
 
+    // Batch up a lot of transformations. The matrices have one row.
+    // The values are looked up directly without the overhead of the
+    // general implementation in Coordinate.
+    // Returns False if any conversion failed and <src>errorMessage()</src>
+    // will hold the message of the first failure.
+    // The <src>failures</src> array is the length of the number of conversions
+    // (True for failure, False for success)
+    // <group>
+    virtual Bool toWorldMany(Matrix<Double> &world,
+                             const Matrix<Double> &pixel,
+                             Vector<Bool> &failures) const;
+    virtual Bool toPixelMany(Matrix<Double> &pixel,
+                             const Matrix<Double> &world,
+                             Vector<Bool> &failures) const;
+    // </group>
+
     // Interconvert between pixel and world as a Stokes type.
     // It returns False if no conversion could be done.
     // <group>
@@ -0,0 +1,123 @@
+//# dFrequencyAligner.cc: time FrequencyAligner::alignMany on a synthetic cube
+//# Copyright (C) 2026
+//# Associated Universities, Inc. Washington DC, USA.
+//#
+//# This library is free software; you can redistribute it and/or modify it
+//# under the terms of the GNU Library General Public License as published by
+//# the Free Software Foundation; either version 2 of the License, or (at your
+//# option) any later version.
+//#
+//# This library is distributed in the hope that it will be useful, but WITHOUT
+//# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+//# License for more details.
+//#
+//# You should have received a copy of the GNU Library General Public License
+//# along with this library; if not, write to the Free Software Foundation,
+//# Inc., 675 Massachusetts Ave, Cambridge, MA 02139, USA.
+//#
+//# Correspondence concerning AIPS++ should be addressed as follows:
+//#        Internet email: aips2-request@nrao.edu.
+//#        Postal address: AIPS++ Project Office
+//#                        National Radio Astronomy Observatory
+//#                        520 Edgemont Road
+//#                        Charlottesville, VA 22903-2475 USA
+
+#include <casacore/casa/aips.h>
+#include <casacore/casa/Arrays/Array.h>
+#include <casacore/casa/Arrays/ArrayLogical.h>
+#include <casacore/casa/Arrays/VectorIter.h>
+#include <casacore/casa/Exceptions/Error.h>
+#include <casacore/casa/Inputs/Input.h>
+#include <casacore/casa/OS/Timer.h>
+#include <casacore/casa/Quanta/MVEpoch.h>
+#include <casacore/casa/Utilities/Assert.h>
+#include <casacore/coordinates/Coordinates/SpectralCoordinate.h>
+#include <casacore/coordinates/Coordinates/FrequencyAligner.h>
+#include <casacore/measures/Measures/MEpoch.h>
+#include <casacore/measures/Measures/MeasTable.h>
+#include <casacore/casa/iostream.h>
+
+#include <casacore/casa/namespace.h>
+
+// Align a synthetic TOPO cube [nx,ny,nchan] to LSRK with alignMany and
+// (optionally) spectrum by spectrum with align, and show the times.
+// The default cube is small; the full-size benchmark is
+//   dFrequencyAligner nx=1024 ny=1024 nchan=4096 serial=F
+// which needs about 40 GBytes of memory.
+
+int main (int argc, const char* argv[])
+{
+  try {
+    Input inp(1);
+    inp.version(" ");
+    inp.create("nx", "64", "Number of pixels along the x axis", "int");
+    inp.create("ny", "64", "Number of pixels along the y axis", "int");
+    inp.create("nchan", "512", "Number of channels", "int");
+    inp.create("serial", "T", "Also align spectrum by spectrum?", "bool");
+    inp.readArguments(argc, argv);
+    const IPosition shape(3, inp.getInt("nx"), inp.getInt("ny"),
+                          inp.getInt("nchan"));
+    const Bool serial = inp.getBool("serial");
+
+    SpectralCoordinate sc(MFrequency::TOPO, 1.4e9, 2e4, 0., 1.420405752e9);
+    MEpoch refEpoch(MVEpoch(Quantity(50237.29, "d")));
+    MEpoch epoch(MVEpoch(Quantity(50237.50, "d")));
+    MPosition pos;
+    MeasTable::Observatory(pos, "ATCA");
+    MDirection dir(Quantity(0., "rad"), Quantity(-35., "deg"),
+                   MDirection::J2000);
+    FrequencyAligner<Float> fa(sc, shape(2), refEpoch, dir, pos,
+                               MFrequency::LSRK);
+    InterpolateArray1D<Double,Float>::InterpolationMethod method =
+      InterpolateArray1D<Double,Float>::linear;
+
+    Array<Float> yIn(shape);
+    Array<Bool> maskIn(shape);
+    Float* yp = yIn.data();
+    Bool* mp = maskIn.data();
+    for (Int64 i=0; i<Int64(yIn.nelements()); ++i) {
+      yp[i] = Float(i%1000) / 1000.;
+      mp[i] = (i%101 != 0);
+    }
+    cout << "Aligning cube " << shape << " ("
+         << shape.product() * sizeof(Float) / (1024*1024) << " MBytes)" << endl;
+
+    Array<Float> yOut;
+    Array<Bool> maskOut;
+    {
+      Timer timer;
+      fa.alignMany (yOut, maskOut, yIn, maskIn, 2, epoch, method);
+      timer.show ("alignMany      ");
+    }
+    {
+      // The abcissa for this epoch is cached now.
+      Timer timer;
+      fa.alignMany (yOut, maskOut, yIn, maskIn, 2, epoch, method);
+      timer.show ("alignMany again");
+    }
+    if (serial) {
+      Array<Float> yOut2(shape);
+      Array<Bool> maskOut2(shape);
+      ReadOnlyVectorIterator<Float> yIt(yIn, 2);
+      ReadOnlyVectorIterator<Bool> mIt(maskIn, 2);
+      VectorIterator<Float> yOutIt(yOut2, 2);
+      VectorIterator<Bool> mOutIt(maskOut2, 2);
+      Timer timer;
+      Bool useCached = False;
+      while (!yIt.pastEnd()) {
+        fa.align (yOutIt.vector(), mOutIt.vector(), yIt.vector(),
+                  mIt.vector(), epoch, useCached, method);
+        useCached = True;
+        yIt.next(); mIt.next(); yOutIt.next(); mOutIt.next();
+      }
+      timer.show ("align serial   ");
+      AlwaysAssertExit (allEQ (yOut, yOut2));
+      AlwaysAssertExit (allEQ (maskOut, maskOut2));
+    }
+  } catch (std::exception& x) {
+    cout << "Unexpected exception: " << x.what() << endl;
+    return 1;
+  }
+  return 0;
+}
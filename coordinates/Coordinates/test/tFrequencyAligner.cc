@@ -223,6 +223,52 @@ int main()
       }
 
 
+// Align many in a cube along each axis and compare with aligning
+// the spectra one by one (with varying data and masks)
+
+      {
+         cerr << "Align many cube" << endl;
+         Quantum<Double> tt(50237.50, Unit(String("d")));  
+         MVEpoch t3(tt);
+         MEpoch epoch(t3);
+         for (uInt axis=0; axis<3; axis++) {
+            IPosition shp(3,3,300,5);
+            shp(axis) = nPix;
+            Array<Float> yInMany(shp);
+            Array<Bool> maskInMany(shp);
+            Array<Float> yOutMany, yOutMany2;
+            Array<Bool> maskOutMany, maskOutMany2;
+            Float* yp = yInMany.data();
+            Bool* mp = maskInMany.data();
+            for (uInt i=0; i<yInMany.nelements(); i++) {
+               yp[i] = (i*7)%23 - 11.0;
+               mp[i] = (i%13 != 0);
+            }
+            AlwaysAssert(fa.alignMany (yOutMany, maskOutMany, yInMany, maskInMany,
+                                       axis, epoch, method, extrapolate), AipsError);
+// Same epoch again (uses the cached abcissa)
+            AlwaysAssert(fa.alignMany (yOutMany2, maskOutMany2, yInMany, maskInMany,
+                                       axis, epoch, method, extrapolate), AipsError);
+            AlwaysAssert (allEQ(yOutMany2, yOutMany), AipsError);
+            AlwaysAssert (allEQ(maskOutMany2, maskOutMany), AipsError);
+//
+            ReadOnlyVectorIterator<Float> yIt(yInMany, axis);
+            ReadOnlyVectorIterator<Bool> mIt(maskInMany, axis);
+            ReadOnlyVectorIterator<Float> yOutIt(yOutMany, axis);
+            ReadOnlyVectorIterator<Bool> mOutIt(maskOutMany, axis);
+            Vector<Float> y1;
+            Vector<Bool> m1;
+            while (!yIt.pastEnd()) {
+               AlwaysAssert(fa.align (y1, m1, yIt.vector(), mIt.vector(), epoch,
+                                      False, method, extrapolate), AipsError);
+               AlwaysAssert (allEQ(yOutIt.vector(), y1), AipsError);
+               AlwaysAssert (allEQ(mOutIt.vector(), m1), AipsError);
+               yIt.next(); mIt.next(); yOutIt.next(); mOutIt.next();
+            }
+         }
+      }
+
+
 // Copy constructor and test results the same
 
       FrequencyAligner<Float> va2(fa);
@@ -463,6 +463,41 @@ int main()
          delete plc;
       }
 //
+// Test many conversions (large enough to be split over threads).
+// They must be the same as single conversions.
+//
+      {
+         LinearCoordinate lc = makeCoordinate(names, units, crpix, crval, cdelt, xform);
+         const uInt nCoord = 100000;
+         Matrix<Double> pixel(2, nCoord), pixel2, world;
+         Vector<Bool> failures, failures2;
+         for (uInt i=0; i<nCoord; i++) {
+            pixel(0,i) = i * 0.01 - 300;
+            pixel(1,i) = 700 - i * 0.02;
+         }
+         if (!lc.toWorldMany(world, pixel, failures)) {
+            throw(AipsError(String("toWorldMany conversion failed because ") + lc.errorMessage()));
+         }
+         if (!lc.toPixelMany(pixel2, world, failures2)) {
+            throw(AipsError(String("toPixelMany conversion failed because ") + lc.errorMessage()));
+         }
+         if (failures.nelements() != nCoord  ||  anyTrue(failures)  ||  anyTrue(failures2)) {
+            throw(AipsError("to{World,Pixel}Many gave wrong failures"));
+         }
+         if (!allNear(pixel, pixel2, 1e-10)) {
+            throw(AipsError("to{World,Pixel}Many reflection failed"));
+         }
+         Vector<Double> world2;
+         for (uInt i=0; i<nCoord; i+=997) {
+            if (!lc.toWorld(world2, pixel.column(i))) {
+               throw(AipsError(String("toWorld failed because ") + lc.errorMessage()));
+            }
+            if (!allEQ(world2, world.column(i))) {
+               throw(AipsError("World conversions gave wrong results in toWorldMany"));
+            }
+         }
+      }
+//
 // Test clone
 //
       {
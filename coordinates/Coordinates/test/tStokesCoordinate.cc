@@ -356,6 +356,42 @@ void doit3 (StokesCoordinate& lc,
       }
    }
 //
+// Many conversions, including a failing one
+//
+   {
+      const uInt n = whichStokes.nelements();
+      Matrix<Double> pixels(1, 2*n+1), pixels2, worlds;
+      Vector<Bool> failures;
+      for (uInt i=0; i<2*n; i++) {
+         pixels(0,i) = i%n;
+      }
+      pixels(0,2*n) = n;
+      if (lc.toWorldMany(worlds, pixels, failures)) {
+         throw(AipsError("toWorldMany succeeded unexpectedly"));
+      }
+      if (failures.nelements() != 2*n+1  ||  !failures(2*n)) {
+         throw(AipsError("toWorldMany gave wrong failures"));
+      }
+      for (uInt i=0; i<2*n; i++) {
+         if (failures(i)  ||  worlds(0,i) != Double(whichStokes(i%n))) {
+            throw(AipsError("toWorldMany gave wrong result"));
+         }
+      }
+      worlds.resize(1, 2*n, True);
+      if (!lc.toPixelMany(pixels2, worlds, failures)) {
+         throw(AipsError(String("toPixelMany conversion failed because ") + lc.errorMessage()));
+      }
+      for (uInt i=0; i<2*n; i++) {
+         if (failures(i)  ||  pixels2(0,i) != pixels(0,i)) {
+            throw(AipsError("toPixelMany gave wrong result"));
+         }
+      }
+      worlds(0,1) = -10000.0;
+      if (lc.toPixelMany(pixels2, worlds, failures)  ||  !failures(1)  ||  failures(0)) {
+         throw(AipsError("toPixelMany did not fail as expected"));
+      }
+   }
+//
 // Formatting
 //
    String unit;
@@ -25,15 +25,49 @@
 
 //# Includes
 #include <casacore/derivedmscal/DerivedMC/DerivedColumn.h>
+#include <casacore/tables/Tables/RefRows.h>
 
 namespace casacore {
 
+  void getDerivedValues (MSCalEngine* engine, MSCalEngine::ValueType type,
+                         Int antnr, const RefRows& rownrs, ArrayBase& arr)
+  {
+    Array<Double>& data = static_cast<Array<Double>&>(arr);
+    if (data.empty()) {
+      return;
+    }
+    Bool deleteIt;
+    Double* ptr = data.getStorage (deleteIt);
+    engine->getValues (type, antnr, rownrs, ptr);
+    data.putStorage (ptr, deleteIt);
+  }
+
+  void getDerivedValues (MSCalEngine* engine, MSCalEngine::ValueType type,
+                         Int antnr, ArrayBase& arr)
+  {
+    // The last axis is the row axis.
+    const IPosition& shape = arr.shape();
+    if (shape.size() > 0  &&  shape.last() > 0) {
+      getDerivedValues (engine, type, antnr,
+                        RefRows(0, shape.last()-1), arr);
+    }
+  }
+
   HourangleColumn::~HourangleColumn()
   {}
   void HourangleColumn::get (rownr_t rowNr, Double& data)
   {
     data = itsEngine->getHA (itsAntNr, rowNr);
   }
+  void HourangleColumn::getScalarColumnV (ArrayBase& data)
+  {
+    getDerivedValues (itsEngine, MSCalEngine::HA, itsAntNr, data);
+  }
+  void HourangleColumn::getScalarColumnCellsV (const RefRows& rownrs,
+                                               ArrayBase& data)
+  {
+    getDerivedValues (itsEngine, MSCalEngine::HA, itsAntNr, rownrs, data);
+  }
 
   ParAngleColumn::~ParAngleColumn()
   {}
@@ -41,6 +75,15 @@ namespace casacore {
   {
     data = itsEngine->getPA (itsAntNr, rowNr);
   }
+  void ParAngleColumn::getScalarColumnV (ArrayBase& data)
+  {
+    getDerivedValues (itsEngine, MSCalEngine::PA, itsAntNr, data);
+  }
+  void ParAngleColumn::getScalarColumnCellsV (const RefRows& rownrs,
+                                              ArrayBase& data)
+  {
+    getDerivedValues (itsEngine, MSCalEngine::PA, itsAntNr, rownrs, data);
+  }
 
   LASTColumn::~LASTColumn()
   {}
@@ -48,6 +91,15 @@ namespace casacore {
   {
     data = itsEngine->getLAST (itsAntNr, rowNr);
   }
+  void LASTColumn::getScalarColumnV (ArrayBase& data)
+  {
+    getDerivedValues (itsEngine, MSCalEngine::LAST, itsAntNr, data);
+  }
+  void LASTColumn::getScalarColumnCellsV (const RefRows& rownrs,
+                                          ArrayBase& data)
+  {
+    getDerivedValues (itsEngine, MSCalEngine::LAST, itsAntNr, rownrs, data);
+  }
 
   HaDecColumn::~HaDecColumn()
   {}
@@ -63,6 +115,15 @@ namespace casacore {
   {
     itsEngine->getHaDec (itsAntNr, rowNr, data);
   }
+  void HaDecColumn::getArrayColumn (Array<Double>& data)
+  {
+    getDerivedValues (itsEngine, MSCalEngine::HADEC, itsAntNr, data);
+  }
+  void HaDecColumn::getArrayColumnCells (const RefRows& rownrs,
+                                         Array<Double>& data)
+  {
+    getDerivedValues (itsEngine, MSCalEngine::HADEC, itsAntNr, rownrs, data);
+  }
 
   AzElColumn::~AzElColumn()
   {}
@@ -78,6 +139,15 @@ namespace casacore {
   {
     itsEngine->getAzEl (itsAntNr, rowNr, data);
   }
+  void AzElColumn::getArrayColumn (Array<Double>& data)
+  {
+    getDerivedValues (itsEngine, MSCalEngine::AZEL, itsAntNr, data);
+  }
+  void AzElColumn::getArrayColumnCells (const RefRows& rownrs,
+                                        Array<Double>& data)
+  {
+    getDerivedValues (itsEngine, MSCalEngine::AZEL, itsAntNr, rownrs, data);
+  }
 
   ItrfColumn::~ItrfColumn()
   {}
@@ -93,6 +163,15 @@ namespace casacore {
   {
     itsEngine->getItrf (itsAntNr, rowNr, data);
   }
+  void ItrfColumn::getArrayColumn (Array<Double>& data)
+  {
+    getDerivedValues (itsEngine, MSCalEngine::ITRF, itsAntNr, data);
+  }
+  void ItrfColumn::getArrayColumnCells (const RefRows& rownrs,
+                                        Array<Double>& data)
+  {
+    getDerivedValues (itsEngine, MSCalEngine::ITRF, itsAntNr, rownrs, data);
+  }
 
   UVWJ2000Column::~UVWJ2000Column()
   {}
@@ -108,5 +187,14 @@ namespace casacore {
   {
     itsEngine->getNewUVW (False, rowNr, data);
   }
+  void UVWJ2000Column::getArrayColumn (Array<Double>& data)
+  {
+    getDerivedValues (itsEngine, MSCalEngine::UVW_J2000, -1, data);
+  }
+  void UVWJ2000Column::getArrayColumnCells (const RefRows& rownrs,
+                                            Array<Double>& data)
+  {
+    getDerivedValues (itsEngine, MSCalEngine::UVW_J2000, -1, rownrs, data);
+  }
 
 } //# end namespace
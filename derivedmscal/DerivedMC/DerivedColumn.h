@@ -35,6 +35,17 @@
 
 namespace casacore {
 
+  // <summary>Get derived values of many rows using the engine.</summary>
+  // <use visibility=local>
+  // The values are calculated by MSCalEngine::getValues, which calculates
+  // a value only once for rows with equal time, field and antenna.
+  // <group>
+  void getDerivedValues (MSCalEngine* engine, MSCalEngine::ValueType type,
+                         Int antnr, const RefRows& rownrs, ArrayBase& data);
+  void getDerivedValues (MSCalEngine* engine, MSCalEngine::ValueType type,
+                         Int antnr, ArrayBase& data);
+  // </group>
+
 
   // <summary>Hourangle derived from TIME, etc.</summary>
   // <use visibility=local>
@@ -47,6 +58,9 @@ namespace casacore {
     {}
     virtual ~HourangleColumn();
     virtual void get (rownr_t rowNr, Double& data);
+    virtual void getScalarColumnV (ArrayBase& data);
+    virtual void getScalarColumnCellsV (const RefRows& rownrs,
+                                        ArrayBase& data);
   private:
     MSCalEngine* itsEngine;
     Int          itsAntNr;    //# -1=array 0=antenna1 1=antenna2
@@ -64,6 +78,9 @@ namespace casacore {
     {}
     virtual ~LASTColumn();
     virtual void get (rownr_t rowNr, Double& data);
+    virtual void getScalarColumnV (ArrayBase& data);
+    virtual void getScalarColumnCellsV (const RefRows& rownrs,
+                                        ArrayBase& data);
   private:
     MSCalEngine* itsEngine;
     Int          itsAntNr;    //# -1=array 0=antenna1 1=antenna2
@@ -81,6 +98,9 @@ namespace casacore {
     {}
     virtual ~ParAngleColumn();
     virtual void get (rownr_t rowNr, Double& data);
+    virtual void getScalarColumnV (ArrayBase& data);
+    virtual void getScalarColumnCellsV (const RefRows& rownrs,
+                                        ArrayBase& data);
   private:
     MSCalEngine* itsEngine;
     Int          itsAntNr;    //# 0=antenna1 1=antenna2
@@ -100,6 +120,9 @@ namespace casacore {
     virtual IPosition shape (rownr_t rownr);
     virtual Bool isShapeDefined (rownr_t rownr);
     virtual void getArray (rownr_t rowNr, Array<Double>& data);
+    virtual void getArrayColumn (Array<Double>& data);
+    virtual void getArrayColumnCells (const RefRows& rownrs,
+                                      Array<Double>& data);
   private:
     MSCalEngine* itsEngine;
     Int          itsAntNr;    //# 0=antenna1 1=antenna2
@@ -119,6 +142,9 @@ namespace casacore {
     virtual IPosition shape (rownr_t rownr);
     virtual Bool isShapeDefined (rownr_t rownr);
     virtual void getArray (rownr_t rowNr, Array<Double>& data);
+    virtual void getArrayColumn (Array<Double>& data);
+    virtual void getArrayColumnCells (const RefRows& rownrs,
+                                      Array<Double>& data);
   private:
     MSCalEngine* itsEngine;
     Int          itsAntNr;    //# 0=antenna1 1=antenna2
@@ -138,6 +164,9 @@ namespace casacore {
     virtual IPosition shape (rownr_t rownr);
     virtual Bool isShapeDefined (rownr_t rownr);
     virtual void getArray (rownr_t rowNr, Array<Double>& data);
+    virtual void getArrayColumn (Array<Double>& data);
+    virtual void getArrayColumnCells (const RefRows& rownrs,
+                                      Array<Double>& data);
   private:
     MSCalEngine* itsEngine;
     Int          itsAntNr;    //# 0=antenna1 1=antenna2
@@ -156,6 +185,9 @@ namespace casacore {
     virtual IPosition shape (rownr_t rownr);
     virtual Bool isShapeDefined (rownr_t rownr);
     virtual void getArray (rownr_t rowNr, Array<Double>& data);
+    virtual void getArrayColumn (Array<Double>& data);
+    virtual void getArrayColumnCells (const RefRows& rownrs,
+                                      Array<Double>& data);
   private:
     MSCalEngine* itsEngine;
   };
@@ -25,6 +25,7 @@
 
 #include <casacore/derivedmscal/DerivedMC/MSCalEngine.h>
 #include <casacore/tables/Tables/TableRecord.h>
+#include <casacore/tables/Tables/RefRows.h>
 #include <casacore/tables/DataMan/DataManError.h>
 #include <casacore/measures/Measures/MeasTable.h>
 #include <casacore/measures/Measures/MCDirection.h>
@@ -39,6 +40,9 @@
 #include <casacore/casa/OS/Path.h>
 #include <casacore/casa/BasicSL/Constants.h>
 #include <casacore/casa/Utilities/Assert.h>
+#include <algorithm>
+#include <map>
+#include <utility>
 
 
 namespace casacore {
@@ -170,6 +174,96 @@ double MSCalEngine::getDelay (Int antnr, rownr_t rownr)
   return (d1-d2) / C::c;
 }
 
+uInt MSCalEngine::nvalues (ValueType type)
+{
+  switch (type) {
+  case HADEC:
+  case AZEL:
+  case ITRF:
+    return 2;
+  case UVW_J2000:
+    return 3;
+  default:
+    return 1;
+  }
+}
+
+void MSCalEngine::getValues (ValueType type, Int antnr,
+                             const RefRows& rownrs, Double* data)
+{
+  if (itsLastCalInx < 0) {
+    init();
+  }
+  const uInt nv = nvalues(type);
+  Vector<rownr_t> rows = rownrs.convert();
+  Array<Double> value(IPosition(1,nv));
+  if (type == UVW_J2000) {
+    // UVW is calculated per antenna and time by getNewUVW itself.
+    for (rownr_t i=0; i<rows.size(); ++i) {
+      getNewUVW (False, rows[i], value);
+      std::copy (value.data(), value.data() + nv, data + i*nv);
+    }
+    return;
+  }
+  // Read the columns determining the value of a row.
+  Vector<Double> times = itsTimeCol.getColumnCells (rownrs);
+  Vector<Int> fields, ants, calIds;
+  if (itsReadFieldDir) {
+    fields = itsFieldCol.getColumnCells (rownrs);
+  }
+  if (antnr >= 0) {
+    ants = itsAntCol[antnr].getColumnCells (rownrs);
+  }
+  if (! itsCalCol.isNull()) {
+    calIds = itsCalCol.getColumnCells (rownrs);
+  }
+  // Calculate a value only once per (calId,field,antenna) in a time slot;
+  // the map gives the row in which it has been calculated.
+  typedef std::pair<Int, std::pair<Int,Int> > Key;
+  std::map<Key, rownr_t> done;
+  for (rownr_t i=0; i<rows.size(); ++i) {
+    if (i > 0  &&  times[i] != times[i-1]) {
+      done.clear();
+    }
+    Key key (calIds.empty() ? 0 : calIds[i],
+             std::make_pair (fields.empty() ? 0 : fields[i],
+                             ants.empty() ? -1 : ants[i]));
+    std::map<Key, rownr_t>::const_iterator iter = done.find (key);
+    if (iter != done.end()) {
+      const Double* from = data + iter->second * nv;
+      std::copy (from, from + nv, data + i*nv);
+      continue;
+    }
+    rownr_t rownr = rows[i];
+    switch (type) {
+    case HA:
+      data[i] = getHA (antnr, rownr);
+      break;
+    case PA:
+      data[i] = getPA (antnr, rownr);
+      break;
+    case LAST:
+      data[i] = getLAST (antnr, rownr);
+      break;
+    case HADEC:
+      getHaDec (antnr, rownr, value);
+      break;
+    case AZEL:
+      getAzEl (antnr, rownr, value);
+      break;
+    case ITRF:
+      getItrf (antnr, rownr, value);
+      break;
+    default:
+      break;
+    }
+    if (nv > 1) {
+      std::copy (value.data(), value.data() + nv, data + i*nv);
+    }
+    done[key] = i;
+  }
+}
+
 void MSCalEngine::setDirection (const MDirection& dir)
 {
   // Direction is explicitly given, so do not read from FIELD table.
@@ -41,6 +41,8 @@
 
 namespace casacore {
 
+class RefRows;
+
 // <summary>
 // Engine to calculate derived MS values
 // </summary>
@@ -102,6 +104,12 @@ namespace casacore {
 // The engine can also be used for old CASA Calibration Tables. It understands
 // how they reference the MeasurementSets. Because these calibration tables
 // contain no ANTENNA2 columns, columns XX2 are the same as XX1.
+//
+// The values can also be obtained for many rows at once using getValues.
+// Rows with the same time, field and antenna get the same value, so a
+// value is only calculated once for each such combination in a time slot.
+// Because usually many baselines share an antenna, it saves a lot of
+// measure conversions when getting, say, the parallactic angles of an MS.
 // </synopsis>
 
 // <motivation>
@@ -116,6 +124,9 @@ namespace casacore {
 class MSCalEngine
 {
 public:
+  // The types of values that can be obtained with getValues.
+  enum ValueType {HA, HADEC, PA, LAST, AZEL, ITRF, UVW_J2000};
+
   // Default constructor.
   MSCalEngine();
 
@@ -159,6 +170,16 @@ public:
   // Get the delay for the given row.
   double getDelay (Int antnr, rownr_t rownr);
 
+  // Get the values of the given type for the given rows.
+  // The number of values per row (1, 2 or 3) is given by nvalues.
+  // <src>data</src> must have room for all values of all rows.
+  // For UVW_J2000 antnr is ignored.
+  void getValues (ValueType type, Int antnr, const RefRows& rownrs,
+                  Double* data);
+
+  // Get the number of values per row for the given type.
+  static uInt nvalues (ValueType type);
+
 private:
   // Copy constructor cannot be used.
   MSCalEngine (const MSCalEngine& that);
@@ -35,7 +35,9 @@
 #include <casacore/tables/Tables/ArrColDesc.h>
 #include <casacore/tables/Tables/ScalarColumn.h>
 #include <casacore/tables/Tables/ArrayColumn.h>
+#include <casacore/tables/Tables/RefRows.h>
 #include <casacore/casa/Arrays/ArrayLogical.h>
+#include <casacore/casa/Arrays/ArrayMath.h>
 #include <casacore/casa/IO/ArrayIO.h>
 #include <casacore/casa/OS/Timer.h>
 #include <iostream>
@@ -111,6 +113,35 @@ void check (uInt rownr,
   AlwaysAssertExit (uvwJ2000.isDefined(rownr));
 }
 
+// Check that getting a column (or some cells) gives the same values
+// as getting the rows one by one.
+void checkBulk (ScalarColumn<double>& col)
+{
+  Vector<double> all = col.getColumn();
+  AlwaysAssertExit (all.size() == col.nrow());
+  for (rownr_t i=0; i<all.size(); ++i) {
+    AlwaysAssertExit (near(all[i], col(i), 1e-10));
+  }
+  if (col.nrow() > 10) {
+    RefRows rows(3, col.nrow()-1, 7);
+    Vector<double> cells = col.getColumnCells (rows);
+    Vector<rownr_t> rownrs = rows.convert();
+    for (rownr_t i=0; i<rownrs.size(); ++i) {
+      AlwaysAssertExit (near(cells[i], col(rownrs[i]), 1e-10));
+    }
+  }
+}
+
+void checkBulk (ArrayColumn<double>& col)
+{
+  Array<double> all = col.getColumn();
+  for (rownr_t i=0; i<col.nrow(); ++i) {
+    Array<double> row = col(i);
+    Array<double> bulk = all[i];
+    AlwaysAssertExit (allNear(bulk, row, 1e-10));
+  }
+}
+
 int main(int argc, char* argv[])
 {
   try {
@@ -218,6 +249,14 @@ int main(int argc, char* argv[])
         check (i, uvw, uvwJ2000);
       }
     }
+    // Getting the values of many rows at once must give the same results.
+    checkBulk (ha);
+    checkBulk (ha1);
+    checkBulk (pa2);
+    checkBulk (last1);
+    checkBulk (azel1);
+    checkBulk (itrf);
+    checkBulk (uvwJ2000);
     // Now time getting the hourangle using DataMan and MSDerivedValues.
     double totha = 0;
     Timer timer;
@@ -225,6 +264,9 @@ int main(int argc, char* argv[])
       totha += ha(i);
     }
     timer.show ("DataMan  ha");
+    timer.mark();
+    totha = sum (ha.getColumn());
+    timer.show ("DataMan bulk ha");
     totha = 0;
     timer.mark();
     for (uInt i=0; i<tab.nrow(); ++i) {
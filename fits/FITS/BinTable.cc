@@ -42,10 +42,15 @@
 #include <casacore/tables/Tables/RowCopier.h>
 #include <casacore/casa/Arrays/Vector.h>
 #include <casacore/casa/Arrays/ArrayMath.h>
+#include <casacore/casa/Arrays/Slicer.h>
+#include <casacore/casa/OS/OMP.h>
 #include <casacore/casa/Utilities/Assert.h>
 #include <casacore/casa/Utilities/Regex.h>
 #include <casacore/casa/sstream.h>
 #include <casacore/casa/stdio.h>
+#include <cstring>
+#include <exception>
+#include <memory>
 
 namespace casacore { //# NAMESPACE CASACORE - BEGIN
 
@@ -60,6 +65,54 @@ Bool isSDFitsColumn(FITS::ReservedName name) {
     else
 	return False;
 }
+
+// Gather the FITS values of a field from a block of raw FITS rows into
+// a contiguous buffer and convert them to local format in one go.
+template<typename T>
+void gatherField(T *to, const char *raw, uInt rowSize, uInt offset,
+		 uInt fieldSize, Int nelem, Int nrow)
+{
+    std::vector<char> buf(size_t(fieldSize) * nrow);
+    for (Int i=0; i<nrow; i++) {
+	memcpy(&buf[size_t(i)*fieldSize], raw + size_t(i)*rowSize + offset,
+	       fieldSize);
+    }
+    FITS::f2l(to, (void *)buf.data(), nelem*nrow);
+}
+
+// Make the array holding the values of a column in a block of rows.
+// A scalar column gets a vector.
+template<typename T>
+Array<T> *makeFieldArray(Int nelem, Int nrow)
+{
+    if (nelem > 1) {
+	return new Array<T>(IPosition(2, nelem, nrow));
+    }
+    return new Array<T>(IPosition(1, nrow));
+}
+
+// Put the values of a column in a block of rows into the table.
+template<typename T>
+void putFieldArray(Table &tab, const String &name, const ArrayBase &arr,
+		   Int nelem, rownr_t startRow)
+{
+    const Array<T> &values = static_cast<const Array<T>&>(arr);
+    Slicer rows(IPosition(1, startRow), IPosition(1, values.shape().last()));
+    if (nelem > 1) {
+	ArrayColumn<T>(tab, name).putColumnRange(rows, values);
+    } else {
+	ScalarColumn<T>(tab, name).putColumnRange(rows, Vector<T>(values));
+    }
+}
+
+// Put a constant value (of a virtual column) into a range of rows.
+template<typename T>
+void putVirtualColumn(Table &tab, const String &name, const T &value,
+		      rownr_t startRow, Int nrow)
+{
+    Slicer rows(IPosition(1, startRow), IPosition(1, nrow));
+    ScalarColumn<T>(tab, name).putColumnRange(rows, Vector<T>(nrow, value));
+}
 	
 	
 //   The constructor
@@ -67,7 +120,8 @@ Bool isSDFitsColumn(FITS::ReservedName name) {
 BinaryTable::BinaryTable(FitsInput& fitsin, FITSErrorHandler errhandler, 
 			 Bool useIncrSM, Bool sdfits) :
     BinaryTableExtension(fitsin, errhandler), currRowTab(0), nelem(0), 
-    colNames(0), vatypes_p(0), vaptr_p(0), va_p(0), theheap_p(0)
+    colNames(0), vatypes_p(0), vaptr_p(0), va_p(0), theheap_p(0),
+    bulkCopy_p(True), bulkBlockSize_p(8*1024*1024)
 {
 
     AlwaysAssert(err() == HeaderDataUnit::OK, AipsError);
@@ -982,18 +1036,7 @@ Table BinaryTable::fullTable(const String& tabname,
 
     //		and actually create the table
     Table full(newtab,nrows());
-    RowCopier rowcop(full, *currRowTab);
-    //			loop over all rows remaining
-    for (Int outrow = 0, infitsrow = currrow(); infitsrow < nrows(); 
-	 outrow++, infitsrow++) {
-	rowcop.copy(outrow, 0);
-	//		don't read past the end of the table
-	if ((infitsrow+1) < nrows()) {
-	    if (!theheap_p) read(1);
-	    else ++(*this);
-	    fillRow();
-	}
-    }		// end of loop over rows
+    fillTable(full);
     return full;
 }
 
@@ -1004,19 +1047,321 @@ Table BinaryTable::fullTable()
        newtab.bindAll(stman);
     //		and actually create the table
     Table full = Table(newtab,Table::Memory, nrows());
+    fillTable(full);
+    return full;
+}
+
+void BinaryTable::setBulkCopy(Bool bulkCopy, uInt blockSize)
+{
+    bulkCopy_p = bulkCopy;
+    bulkBlockSize_p = blockSize;
+}
+
+void BinaryTable::fillTable(Table& full)
+{
     RowCopier rowcop(full, *currRowTab);
-    //			loop over all rows remaining
-    for (Int outrow = 0, infitsrow = currrow(); infitsrow < nrows(); 
-	 outrow++, infitsrow++) {
+    Int outrow = 0;
+    Int infitsrow = currrow();
+    //		the current row has already been filled
+    if (infitsrow < nrows()) {
 	rowcop.copy(outrow, 0);
-	//		don't read past the end of the table
-	if ((infitsrow+1) < nrows()) {
-	    if (!theheap_p) read(1);
-	    else ++(*this);
-	    fillRow();
+	outrow++;
+	infitsrow++;
+    }
+    //		convert all but the last row in blocks if possible
+    //		the last one is done by fillRow below, so currRowTab
+    //		contains the last row as before
+    if (bulkCopy_p && infitsrow+1 < nrows() && canBulkCopy()) {
+	Int nbulk = nrows() - infitsrow - 1;
+	Int blockRows = max(1, Int(bulkBlockSize_p / max(1u, rowsize())));
+	std::vector<char> raw;
+	for (Int i=0; i<nbulk; i+=blockRows) {
+	    Int n = min(blockRows, nbulk-i);
+	    bulkCopy(full, outrow, n, raw);
+	    outrow += n;
+	    infitsrow += n;
 	}
+	//		skip the rows read in the row administration
+	end_row += nbulk;
+	curr_row = end_row;
+    }
+    //			loop over all rows remaining
+    for (; infitsrow < nrows(); outrow++, infitsrow++) {
+	if (!theheap_p) read(1);
+	else ++(*this);
+	fillRow();
+	rowcop.copy(outrow, 0);
     }		// end of loop over rows
-    return full;
+}
+
+Bool BinaryTable::canBulkCopy() const
+{
+    //		the rows must be read sequentially from the file
+    if (theheap_p || currrow() != end_row) {
+	return False;
+    }
+    for (Int j=0; j<tfields(); j++) {
+	switch (field(j).fieldtype()) {
+	case FITS::LOGICAL:
+	case FITS::BYTE:
+	case FITS::CHAR:
+	case FITS::STRING:
+	case FITS::SHORT:
+	case FITS::LONG:
+	case FITS::FLOAT:
+	case FITS::DOUBLE:
+	case FITS::COMPLEX:
+	case FITS::DCOMPLEX:
+	    break;
+	default:
+	    return False;
+	}
+    }
+    return True;
+}
+
+void BinaryTable::bulkCopy(Table& full, rownr_t outrow, Int nrow,
+			   std::vector<char>& raw)
+{
+    Int nbytes = nrow * rowsize();
+    raw.resize(nbytes);
+    if (read_data(raw.data(), nbytes) != nbytes) {
+	throw AipsError("BinaryTable: error while reading a block of rows");
+    }
+    //		convert the columns in parallel; the table columns are
+    //		filled sequentially afterwards
+    Int nfield = tfields();
+    std::vector<std::shared_ptr<ArrayBase> > values(nfield);
+    std::exception_ptr excp;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (Int j=0; j<nfield; j++) {
+	try {
+	    Int ne = nelem[j];
+	    uInt offset = fits_offset[j];
+	    uInt fsize = field(j).fitsfieldsize();
+	    const char *src = raw.data();
+	    switch (field(j).fieldtype()) {
+	    case FITS::LOGICAL:
+		if (ne > 0) {
+		    std::vector<FitsLogical> tmp(size_t(ne) * nrow);
+		    gatherField(tmp.data(), src, rowsize(), offset, fsize,
+				ne, nrow);
+		    Array<Bool> *arr = makeFieldArray<Bool>(ne, nrow);
+		    values[j].reset(arr);
+		    Bool *to = arr->data();
+		    for (size_t k=0; k<tmp.size(); k++) {
+			to[k] = tmp[k];
+		    }
+		}
+		break;
+	    case FITS::BYTE:
+		if (ne > 0) {
+		    Array<uChar> *arr = makeFieldArray<uChar>(ne, nrow);
+		    values[j].reset(arr);
+		    gatherField(arr->data(), src, rowsize(), offset, fsize,
+				ne, nrow);
+		}
+		break;
+	    case FITS::CHAR:
+	    case FITS::STRING:
+		{
+		    std::vector<char> tmp(size_t(fsize) * nrow);
+		    gatherField(tmp.data(), src, rowsize(), offset, fsize,
+				fsize, nrow);
+		    Array<String> *arr = new Array<String>(IPosition(1, nrow));
+		    values[j].reset(arr);
+		    String *to = arr->data();
+		    for (Int k=0; k<nrow; k++) {
+			// look for the true end of the string
+			const char *cptr = &tmp[size_t(k)*fsize];
+			uInt length = fsize;
+			while (length > 0 && 
+			       (cptr[length-1] == '\0' || cptr[length-1] == ' ')) {
+			    length--;
+			}
+			to[k] = String(cptr, length);
+		    }
+		}
+		break;
+	    case FITS::SHORT:
+		if (ne > 0) {
+		    Array<Short> *arr = makeFieldArray<Short>(ne, nrow);
+		    values[j].reset(arr);
+		    gatherField(arr->data(), src, rowsize(), offset, fsize,
+				ne, nrow);
+		}
+		break;
+	    case FITS::LONG:
+		if (ne > 0) {
+		    Array<Int> *arr = makeFieldArray<Int>(ne, nrow);
+		    values[j].reset(arr);
+		    gatherField(arr->data(), src, rowsize(), offset, fsize,
+				ne, nrow);
+		}
+		break;
+	    case FITS::FLOAT:
+		if (ne > 0) {
+		    Array<Float> *arr = makeFieldArray<Float>(ne, nrow);
+		    values[j].reset(arr);
+		    gatherField(arr->data(), src, rowsize(), offset, fsize,
+				ne, nrow);
+		    //		scale as done in fillRow
+		    Float *to = arr->data();
+		    size_t n = arr->nelements();
+		    if (tscal(j) != 1) {
+			for (size_t k=0; k<n; k++) {
+			    to[k] = Double(to[k]) * tscal(j) + tzero(j);
+			}
+		    } else if (tzero(j) != 0) {
+			Float zero = tzero(j);
+			for (size_t k=0; k<n; k++) {
+			    to[k] += zero;
+			}
+		    }
+		}
+		break;
+	    case FITS::DOUBLE:
+		if (ne > 0) {
+		    Array<Double> *arr = makeFieldArray<Double>(ne, nrow);
+		    values[j].reset(arr);
+		    gatherField(arr->data(), src, rowsize(), offset, fsize,
+				ne, nrow);
+		    if (tscal(j) != 1 || tzero(j) != 0) {
+			Double *to = arr->data();
+			size_t n = arr->nelements();
+			for (size_t k=0; k<n; k++) {
+			    to[k] = to[k] * tscal(j) + tzero(j);
+			}
+		    }
+		}
+		break;
+	    case FITS::COMPLEX:
+		if (ne > 0) {
+		    Array<Complex> *arr = makeFieldArray<Complex>(ne, nrow);
+		    values[j].reset(arr);
+		    gatherField(arr->data(), src, rowsize(), offset, fsize,
+				ne, nrow);
+		    if (tscal(j) != 1 || tzero(j) != 0) {
+			Complex scale(tscal(j), 0);
+			Complex zero(tzero(j), 0);
+			Complex *to = arr->data();
+			size_t n = arr->nelements();
+			for (size_t k=0; k<n; k++) {
+			    to[k] = to[k] * scale + zero;
+			}
+		    }
+		}
+		break;
+	    case FITS::DCOMPLEX:
+		if (ne > 0) {
+		    Array<DComplex> *arr = makeFieldArray<DComplex>(ne, nrow);
+		    values[j].reset(arr);
+		    gatherField(arr->data(), src, rowsize(), offset, fsize,
+				ne, nrow);
+		    if (tscal(j) != 1 || tzero(j) != 0) {
+			DComplex scale(tscal(j), 0);
+			DComplex zero(tzero(j), 0);
+			DComplex *to = arr->data();
+			size_t n = arr->nelements();
+			for (size_t k=0; k<n; k++) {
+			    to[k] = to[k] * scale + zero;
+			}
+		    }
+		}
+		break;
+	    default:
+		//	canBulkCopy has excluded all other types
+		break;
+	    }
+	} catch (...) {
+#ifdef _OPENMP
+#pragma omp critical(BinaryTable_bulkCopy)
+#endif
+	    excp = std::current_exception();
+	}
+    }
+    if (excp) {
+	std::rethrow_exception(excp);
+    }
+    //		put the converted columns into the table
+    for (Int j=0; j<nfield; j++) {
+	if (! values[j]) {
+	    continue;
+	}
+	const String &name = (*colNames)[j];
+	switch (field(j).fieldtype()) {
+	case FITS::LOGICAL:
+	    putFieldArray<Bool>(full, name, *values[j], nelem[j], outrow);
+	    break;
+	case FITS::BYTE:
+	    putFieldArray<uChar>(full, name, *values[j], nelem[j], outrow);
+	    break;
+	case FITS::CHAR:
+	case FITS::STRING:
+	    putFieldArray<String>(full, name, *values[j], 1, outrow);
+	    break;
+	case FITS::SHORT:
+	    putFieldArray<Short>(full, name, *values[j], nelem[j], outrow);
+	    break;
+	case FITS::LONG:
+	    putFieldArray<Int>(full, name, *values[j], nelem[j], outrow);
+	    break;
+	case FITS::FLOAT:
+	    putFieldArray<Float>(full, name, *values[j], nelem[j], outrow);
+	    break;
+	case FITS::DOUBLE:
+	    putFieldArray<Double>(full, name, *values[j], nelem[j], outrow);
+	    break;
+	case FITS::COMPLEX:
+	    putFieldArray<Complex>(full, name, *values[j], nelem[j], outrow);
+	    break;
+	case FITS::DCOMPLEX:
+	    putFieldArray<DComplex>(full, name, *values[j], nelem[j], outrow);
+	    break;
+	default:
+	    break;
+	}
+    }
+    //		the virtual columns have a constant value
+    for (uInt field=0;field<kwSet.nfields();field++) {
+	const String &name = kwSet.name(field);
+	switch (kwSet.type(field)) {
+	case TpBool:
+	    putVirtualColumn(full, name, kwSet.asBool(field), outrow, nrow);
+	    break;
+	case TpUChar:
+	    putVirtualColumn(full, name, kwSet.asuChar(field), outrow, nrow);
+	    break;
+	case TpShort:
+	    putVirtualColumn(full, name, kwSet.asShort(field), outrow, nrow);
+	    break;
+	case TpInt:
+	    putVirtualColumn(full, name, kwSet.asInt(field), outrow, nrow);
+	    break;
+	case TpUInt:
+	    putVirtualColumn(full, name, kwSet.asuInt(field), outrow, nrow);
+	    break;
+	case TpFloat:
+	    putVirtualColumn(full, name, kwSet.asfloat(field), outrow, nrow);
+	    break;
+	case TpDouble:
+	    putVirtualColumn(full, name, kwSet.asdouble(field), outrow, nrow);
+	    break;
+	//		a DComplex virtual column is stored as Complex
+	case TpComplex:
+	case TpDComplex:
+	    putVirtualColumn(full, name, kwSet.asComplex(field), outrow, nrow);
+	    break;
+	case TpString:
+	    putVirtualColumn(full, name, kwSet.asString(field), outrow, nrow);
+	    break;
+	default:
+	    throw(AipsError("Impossible virtual column type"));
+	    break;
+	}
+    }
 }
 
 
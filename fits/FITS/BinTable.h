@@ -34,6 +34,7 @@
 #include <casacore/tables/Tables/Table.h>
 #include <casacore/tables/Tables/TableRecord.h>
 #include <map>
+#include <vector>
 
 namespace casacore { //# NAMESPACE CASACORE - BEGIN
 
@@ -68,6 +69,14 @@ namespace casacore { //# NAMESPACE CASACORE - BEGIN
 // (which can be used to step through the FitsInput, copying each row
 // using the RowCopier class), and a Table containin the entire FITS binary 
 // table from the current row to the end of the table.
+// <p>
+// When the full table is made, the rows are read in blocks of (by default)
+// about 8 MBytes. The values of a column in such a block are converted
+// from FITS to local format at once and put into the table using
+// <src>putColumnRange</src>. Different columns are converted in parallel
+// if OpenMP is used. This is much faster than translating each row
+// separately. Tables with a heap or containing BIT or ICOMPLEX columns
+// are always converted row by row.
 // </synopsis> 
 //
 // <motivation>
@@ -154,6 +163,11 @@ public:
     // and returned in a Table object.
     const Table &nextRow();
 
+    // Tell if <src>fullTable</src> can convert the rows in blocks of about
+    // <src>blockSize</src> bytes (which is the default). If False, each row
+    // is converted separately using <src>nextRow</src>.
+    void setBulkCopy (Bool bulkCopy, uInt blockSize = 8*1024*1024);
+
 
 private:
 
@@ -173,8 +187,24 @@ private:
     VADescFitsField *va_p;
     char *theheap_p;
 
+    // Convert in blocks of rows and the size of a block in bytes
+    Bool bulkCopy_p;
+    uInt bulkBlockSize_p;
+
     // this is the function that fills each row in as needed
     void fillRow();
+
+    // Fill the table with all rows from the current row on.
+    void fillTable (Table& full);
+
+    // Can the rows be converted in blocks?
+    Bool canBulkCopy() const;
+
+    // Read the next nrow rows of the FITS table, convert the values of each
+    // column at once and put them into the table starting at outrow.
+    // The buffer is used to hold the raw FITS data.
+    void bulkCopy (Table& full, rownr_t outrow, Int nrow,
+                   std::vector<char>& raw);
 };
 
 
@@ -0,0 +1,194 @@
+//# tBinTableBulk.cc: test the conversion of a FITS binary table in blocks
+//# Copyright (C) 2026
+//# Associated Universities, Inc. Washington DC, USA.
+//#
+//# This program is free software; you can redistribute it and/or modify it
+//# under the terms of the GNU General Public License as published by the Free
+//# Software Foundation; either version 2 of the License, or (at your option)
+//# any later version.
+//#
+//# This program is distributed in the hope that it will be useful, but WITHOUT
+//# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+//# more details.
+//#
+//# You should have received a copy of the GNU General Public License along
+//# with this program; if not, write to the Free Software Foundation, Inc.,
+//# 675 Massachusetts Ave, Cambridge, MA 02139, USA.
+//#
+//# Correspondence concerning AIPS++ should be addressed as follows:
+//#        Internet email: aips2-request@nrao.edu.
+//#        Postal address: AIPS++ Project Office
+//#                        National Radio Astronomy Observatory
+//#                        520 Edgemont Road
+//#                        Charlottesville, VA 22903-2475 USA
+
+#include <casacore/fits/FITS/BinTable.h>
+#include <casacore/fits/FITS/fitsio.h>
+#include <casacore/tables/Tables/TableDesc.h>
+#include <casacore/tables/Tables/ScalarColumn.h>
+#include <casacore/tables/Tables/ArrayColumn.h>
+#include <casacore/tables/Tables/TableColumn.h>
+#include <casacore/casa/Arrays/ArrayLogical.h>
+#include <casacore/casa/Arrays/Vector.h>
+#include <casacore/casa/Utilities/Assert.h>
+#include <casacore/casa/Exceptions/Error.h>
+#include <casacore/casa/iostream.h>
+#include <vector>
+
+#include <fitsio.h>
+
+#include <casacore/casa/namespace.h>
+
+// <summary>
+// Test program for converting a FITS binary table to a Table in blocks of
+// rows. The result must be the same as converting it row by row.
+// The file is created with cfitsio.
+// </summary>
+
+const Int nrow = 1000;
+
+void writeFile (const String& name)
+{
+  fitsfile* fptr;
+  int status = 0;
+  String fname = "!" + name;
+  fits_create_file (&fptr, fname.chars(), &status);
+  const char* ttype[] = {"FLAG", "FLAGS", "BYTE", "SHORT", "INT", "SCALED",
+                         "DOUBLE", "CPLX", "DCPLX", "NAME"};
+  const char* tform[] = {"1L", "3L", "1B", "2I", "1J", "2E",
+                         "1D", "2C", "1M", "8A"};
+  fits_create_tbl (fptr, BINARY_TBL, nrow, 10, const_cast<char**>(ttype),
+                   const_cast<char**>(tform), 0, "TEST", &status);
+  std::vector<char> flag(3*nrow);
+  std::vector<unsigned char> bytes(nrow);
+  std::vector<short> shorts(2*nrow);
+  std::vector<int> ints(nrow);
+  std::vector<float> floats(2*nrow);
+  std::vector<double> doubles(nrow);
+  std::vector<float> cplx(4*nrow);
+  std::vector<double> dcplx(2*nrow);
+  std::vector<String> names(nrow);
+  std::vector<char*> namePtrs(nrow);
+  for (Int i=0; i<nrow; ++i) {
+    for (Int j=0; j<3; ++j) {
+      flag[3*i+j] = ((i+j)%3 == 0);
+    }
+    bytes[i] = i%256;
+    shorts[2*i] = i - 500;
+    shorts[2*i+1] = -i;
+    ints[i] = 1000*i;
+    floats[2*i] = i;
+    floats[2*i+1] = 0.5*i;
+    doubles[i] = i/3.;
+    for (Int j=0; j<4; ++j) {
+      cplx[4*i+j] = i + j;
+    }
+    dcplx[2*i] = i;
+    dcplx[2*i+1] = -i/7.;
+    names[i] = "src" + String::toString(i%17);
+    namePtrs[i] = const_cast<char*>(names[i].chars());
+  }
+  fits_write_col (fptr, TLOGICAL, 1, 1, 1, nrow, flag.data(), &status);
+  fits_write_col (fptr, TLOGICAL, 2, 1, 1, 3*nrow, flag.data(), &status);
+  fits_write_col (fptr, TBYTE, 3, 1, 1, nrow, bytes.data(), &status);
+  fits_write_col (fptr, TSHORT, 4, 1, 1, 2*nrow, shorts.data(), &status);
+  fits_write_col (fptr, TINT, 5, 1, 1, nrow, ints.data(), &status);
+  fits_write_col (fptr, TFLOAT, 6, 1, 1, 2*nrow, floats.data(), &status);
+  fits_write_col (fptr, TDOUBLE, 7, 1, 1, nrow, doubles.data(), &status);
+  fits_write_col (fptr, TCOMPLEX, 8, 1, 1, 2*nrow, cplx.data(), &status);
+  fits_write_col (fptr, TDBLCOMPLEX, 9, 1, 1, nrow, dcplx.data(), &status);
+  fits_write_col (fptr, TSTRING, 10, 1, 1, nrow, namePtrs.data(), &status);
+  // Add the scaling after writing, so the raw values are written.
+  fits_write_key_dbl (fptr, "TSCAL6", 2., -12, 0, &status);
+  fits_write_key_dbl (fptr, "TZERO6", 10., -12, 0, &status);
+  // Keywords that become virtual columns for SDFITS.
+  fits_write_key_str (fptr, "OBSMODE", "PSWITCH", 0, &status);
+  fits_write_key_dbl (fptr, "TSYS", 35.5, -12, 0, &status);
+  fits_close_file (fptr, &status);
+  AlwaysAssertExit (status == 0);
+}
+
+// Convert the table (in blocks of 1000 bytes if bulk is True).
+Table convert (const String& name, Bool bulk, Bool sdfits)
+{
+  FitsInput infits(name.chars(), FITS::Disk);
+  AlwaysAssertExit (infits.err() == FitsIO::OK);
+  infits.skip_hdu();
+  AlwaysAssertExit (infits.hdutype() == FITS::BinaryTableHDU);
+  BinaryTable bintab(infits, FITSError::defaultHandler, False, sdfits);
+  bintab.setBulkCopy (bulk, 1000);
+  Table tab = bintab.fullTable();
+  AlwaysAssertExit (tab.nrow() == uInt(nrow));
+  // The current row is the last row.
+  AlwaysAssertExit (ScalarColumn<Int>(bintab.thisRow(), "INT")(0) ==
+                    1000*(nrow-1));
+  return tab;
+}
+
+template<typename T>
+void compareColumn (const Table& tab1, const Table& tab2, const String& name)
+{
+  if (tab1.tableDesc()[name].isScalar()) {
+    AlwaysAssertExit (allEQ (ScalarColumn<T>(tab1, name).getColumn(),
+                             ScalarColumn<T>(tab2, name).getColumn()));
+  } else {
+    AlwaysAssertExit (allEQ (ArrayColumn<T>(tab1, name).getColumn(),
+                             ArrayColumn<T>(tab2, name).getColumn()));
+  }
+}
+
+void compareTables (const Table& tab1, const Table& tab2)
+{
+  compareColumn<Bool> (tab1, tab2, "FLAG");
+  compareColumn<Bool> (tab1, tab2, "FLAGS");
+  compareColumn<uChar> (tab1, tab2, "BYTE");
+  compareColumn<Short> (tab1, tab2, "SHORT");
+  compareColumn<Int> (tab1, tab2, "INT");
+  compareColumn<Float> (tab1, tab2, "SCALED");
+  compareColumn<Double> (tab1, tab2, "DOUBLE");
+  compareColumn<Complex> (tab1, tab2, "CPLX");
+  compareColumn<DComplex> (tab1, tab2, "DCPLX");
+  compareColumn<String> (tab1, tab2, "NAME");
+}
+
+int main()
+{
+  try {
+    const String name("tBinTableBulk_tmp.fits");
+    writeFile (name);
+    {
+      Table tab1 = convert (name, False, False);
+      Table tab2 = convert (name, True, False);
+      compareTables (tab1, tab2);
+      // Check some values.
+      ArrayColumn<Float> scaled(tab2, "SCALED");
+      Vector<Float> expScaled({30., 20.});
+      AlwaysAssertExit (allEQ (scaled(10), Array<Float>(expScaled)));
+      AlwaysAssertExit (ScalarColumn<String>(tab2, "NAME")(20) == "src3");
+      AlwaysAssertExit (ScalarColumn<uChar>(tab2, "BYTE")(300) == 44);
+      AlwaysAssertExit (ScalarColumn<Bool>(tab2, "FLAG")(3));
+      AlwaysAssertExit (! ScalarColumn<Bool>(tab2, "FLAG")(4));
+    }
+    {
+      // Also the virtual SDFITS columns have to be filled.
+      Table tab1 = convert (name, False, True);
+      Table tab2 = convert (name, True, True);
+      compareTables (tab1, tab2);
+      compareColumn<String> (tab1, tab2, "OBSMODE");
+      TableColumn tsys1(tab1, "TSYS");
+      TableColumn tsys2(tab2, "TSYS");
+      for (Int i=0; i<nrow; i+=99) {
+        AlwaysAssertExit (tsys1.asdouble(i) == tsys2.asdouble(i));
+      }
+      AlwaysAssertExit (tsys2.asdouble(nrow-2) == 35.5);
+      AlwaysAssertExit (ScalarColumn<String>(tab2, "OBSMODE")(nrow-2) ==
+                        "PSWITCH");
+    }
+  } catch (std::exception& x) {
+    cout << "Unexpected exception: " << x.what() << endl;
+    return 1;
+  }
+  cout << "ok" << endl;
+  return 0;
+}
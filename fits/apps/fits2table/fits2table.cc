@@ -27,9 +27,11 @@
 
 #include <casacore/fits/FITS/FITSTable.h>
 #include <casacore/fits/FITS/SDFITSTable.h>
+#include <casacore/fits/FITS/BinTable.h>
 #include <casacore/casa/Inputs/Input.h>
 #include <casacore/casa/Exceptions/Error.h>
 #include <casacore/casa/OS/File.h>
+#include <casacore/casa/OS/Timer.h>
 
 #include <casacore/tables/Tables.h>
 
@@ -37,6 +39,88 @@
 #include <casacore/casa/stdio.h>
 
 #include <casacore/casa/namespace.h>
+
+// Construct the FITS table of the appropriate type.
+FITSTable *openFITSTable(const String &fileName, Int whichHDU, Bool sdfits)
+{
+    FITSTable *infits = 0;
+    if (sdfits) {
+	infits = new SDFITSTable(fileName, whichHDU);
+    } else {
+	infits = new FITSTable(fileName, whichHDU);
+    }
+    AlwaysAssert(infits, AipsError);
+    return infits;
+}
+
+// Get the table description from the FITSTable.
+TableDesc fitsTableDesc(const FITSTable &infits, Bool sdfits)
+{
+    TableDesc td(FITSTabular::tableDesc(infits));
+    // if sdfits, remove any TDIM columns from td, FITSTable takes care of interpreting them
+    // and if sdfits is true, that most likely means we don't want to see them
+    if (sdfits) {
+	Vector<String> cols(td.columnNames());
+	for (uInt i=0;i<cols.nelements();i++) {
+	    if (cols(i).matches(Regex("^TDIM.*"))) {
+		td.removeColumn(cols(i));
+	    }
+	}
+    }
+    return td;
+}
+
+// Copy all rows of the FITSTable to the table one by one.
+void copyRows(FITSTable &infits, Table &tab)
+{
+    TableRow row(tab);
+    uInt rownr = 0;
+    while (rownr < tab.nrow()) {
+	row.putMatchingFields(rownr, TableRecord(infits.currentRow()));
+	infits.next();
+	rownr++;
+    }
+}
+
+// Position the FitsInput at the given HDU, which must be a binary table.
+Bool toBinaryTable(FitsInput &fin, Int whichHDU)
+{
+    for (Int i=0; i < whichHDU && !fin.err() && !fin.eof(); i++) {
+	fin.skip_hdu();
+    }
+    return (fin.err() == FitsIO::OK && !fin.eof() &&
+	    fin.hdutype() == FITS::BinaryTableHDU);
+}
+
+// Convert the HDU into memory tables using FITSTable and using
+// BinaryTable (row by row and in blocks of rows) and show the times.
+void benchmark(const String &fileName, Int whichHDU, Bool sdfits)
+{
+    Timer timer;
+    {
+	FITSTable *infits = openFITSTable(fileName, whichHDU, sdfits);
+	SetupNewTable newtab("", fitsTableDesc(*infits, sdfits),
+			     Table::Scratch);
+	Table tab(newtab, Table::Memory, infits->nrow());
+	copyRows(*infits, tab);
+	delete infits;
+	timer.show(cout, "FITSTable, row by row  ");
+    }
+    for (Int bulk=0; bulk<2; bulk++) {
+	timer.mark();
+	FitsInput fin(fileName.chars(), FITS::Disk);
+	if (!toBinaryTable(fin, whichHDU)) {
+	    cout << "HDU " << whichHDU << " is not a binary table" << endl;
+	    return;
+	}
+	BinaryTable bintab(fin, FITSError::defaultHandler, False, sdfits);
+	bintab.setBulkCopy(bulk);
+	Table tab = bintab.fullTable();
+	timer.show(cout, (bulk ? "BinaryTable, in blocks " :
+			  "BinaryTable, row by row"));
+    }
+}
+
 int main(int argc, const char* argv[])
 {
     try {
@@ -64,6 +148,17 @@ int main(int argc, const char* argv[])
 		      "True",
 		      "Interpret keywords as virtual columns as in the SD-FITS convention",
 		      "Bool");
+	inputs.create("method",
+		      "fitstable",
+		      "The conversion method - fitstable (row by row, using "
+		      "TDIM to shape arrays) or bintable (in blocks of rows, "
+		      "arrays are 1-dimensional)",
+		      "String");
+	inputs.create("benchmark",
+		      "False",
+		      "Show the time needed by the conversion methods "
+		      "(using memory tables) instead of converting",
+		      "Bool");
 
 	inputs.readArguments(argc, argv);
 
@@ -72,8 +167,11 @@ int main(int argc, const char* argv[])
 	String storageManagerType = inputs.getString("storage");
 	Int whichHDU = inputs.getInt("which_hdu");
 	Bool sdfits = inputs.getBool("sdfits");
+	String method = inputs.getString("method");
+	Bool doBenchmark = inputs.getBool("benchmark");
 
 	storageManagerType.downcase();
+	method.downcase();
 
 	Bool useIncrSM;
 	if (storageManagerType == "incremental") {
@@ -85,6 +183,10 @@ int main(int argc, const char* argv[])
 	        endl;
 	    return 1;
 	}
+	if (method != "fitstable" && method != "bintable") {
+	    cerr << method << " is not a valid conversion method" << endl;
+	    return 1;
+	}
 
 	if (whichHDU < 1) {
 	    cerr << "whichHDU is not valid, must be >= 1" << endl;
@@ -97,32 +199,34 @@ int main(int argc, const char* argv[])
 	    return 1;
 	}
 
-	// construct the FITS table of the appropriate type
-	FITSTable *infits = 0;
-	if (sdfits) {
-	    infits = new SDFITSTable(inputFilename, whichHDU);
-	} else {
-	    infits = new FITSTable(inputFilename, whichHDU);
+	if (doBenchmark) {
+	    benchmark(inputFilename, whichHDU, sdfits);
+	    return 0;
 	}
-	AlwaysAssert(infits, AipsError);
+
+	if (method == "bintable") {
+	    FitsInput fin(inputFilename.chars(), FITS::Disk);
+	    if (!toBinaryTable(fin, whichHDU)) {
+		cerr << "The indicated FITS file does not have a valid binary table at HDU=" 
+		     << whichHDU << endl;
+		return 1;
+	    }
+	    BinaryTable bintab(fin, FITSError::defaultHandler, useIncrSM, sdfits);
+	    Table tab = bintab.fullTable(outputFilename, Table::NewNoReplace,
+					 useIncrSM);
+	    cout << "done." << endl;
+	    return 0;
+	}
+
+	// construct the FITS table of the appropriate type
+	FITSTable *infits = openFITSTable(inputFilename, whichHDU, sdfits);
 	if (!infits->isValid()) {
 	    cerr << "The indicated FITS file does not have a valid binary table at HDU=" 
 		 << whichHDU << endl;
 	    return 1;
 	}
 
-	TableDesc td(FITSTabular::tableDesc(*infits));
-	// if sdfits, remove any TDIM columns from td, FITSTable takes care of interpreting them
-	// and if sdfits is true, that most likely means we don't want to see them
-	
-	if (sdfits) {
-	    Vector<String> cols(td.columnNames());
-	    for (uInt i=0;i<cols.nelements();i++) {
-		if (cols(i).matches(Regex("^TDIM.*"))) {
-		    td.removeColumn(cols(i));
-		}
-	    }
-	}
+	TableDesc td(fitsTableDesc(*infits, sdfits));
 	    
 	SetupNewTable newtab(outputFilename, td, Table::NewNoReplace);
 	if (useIncrSM) {
@@ -130,14 +234,8 @@ int main(int argc, const char* argv[])
 	    newtab.bindAll(stman);
 	}
 	Table tab(newtab, TableLock::PermanentLocking, infits->nrow());
-	TableRow row(tab);
-	uInt rownr = 0;
-
-	while (rownr < tab.nrow()) {
-	    row.putMatchingFields(rownr, TableRecord(infits->currentRow()));
-	    infits->next();
-	    rownr++;
-	}
+	copyRows(*infits, tab);
+	delete infits;
 
 	cout << "done." << endl;
     } catch (std::exception& x) {
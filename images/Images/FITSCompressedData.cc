@@ -0,0 +1,364 @@
+//# FITSCompressedData.cc: Access to the data of a tile-compressed FITS image
+//# Copyright (C) 2026
+//# Associated Universities, Inc. Washington DC, USA.
+//#
+//# This library is free software; you can redistribute it and/or modify it
+//# under the terms of the GNU Library General Public License as published by
+//# the Free Software Foundation; either version 2 of the License, or (at your
+//# option) any later version.
+//#
+//# This library is distributed in the hope that it will be useful, but WITHOUT
+//# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+//# License for more details.
+//#
+//# You should have received a copy of the GNU Library General Public License
+//# along with this library; if not, write to the Free Software Foundation,
+//# Inc., 675 Massachusetts Ave, Cambridge, MA 02139, USA.
+//#
+//# Correspondence concerning AIPS++ should be addressed as follows:
+//#        Internet email: aips2-request@nrao.edu.
+//#        Postal address: AIPS++ Project Office
+//#                        National Radio Astronomy Observatory
+//#                        520 Edgemont Road
+//#                        Charlottesville, VA 22903-2475 USA
+
+#include <casacore/images/Images/FITSCompressedData.h>
+#include <casacore/casa/Arrays/Slicer.h>
+#include <casacore/casa/BasicMath/Math.h>
+#include <casacore/casa/OS/OMP.h>
+#include <casacore/casa/Exceptions/Error.h>
+#include <algorithm>
+#include <exception>
+#include <stdlib.h>
+
+#include <fitsio.h>
+
+
+namespace casacore { //# NAMESPACE CASACORE - BEGIN
+
+// Get the cfitsio error message for a status.
+static String fitsCompressedError (int status)
+{
+  char msg[FLEN_ERRMSG];
+  fits_get_errstatus (status, msg);
+  return String(msg);
+}
+
+
+FITSCompressedData::FITSCompressedData (const String& fileName,
+                                        uInt whichHDU)
+: itsFileName  (fileName),
+  itsHDU       (whichHDU),
+  itsReentrant (False),
+  itsNCached   (0),
+  itsNHit      (0),
+  itsNRead     (0),
+  itsMaxCached (16*1024*1024)
+{
+  fitsfile* fptr = static_cast<fitsfile*>(openFile (fileName, whichHDU));
+  itsFiles.push_back (fptr);
+  int status = 0;
+  if (! fits_is_compressed_image (fptr, &status)) {
+    throw AipsError ("FITSCompressedData: HDU " + String::toString(whichHDU) +
+                     " in " + fileName + " is not a tile-compressed image");
+  }
+  // For a compressed image cfitsio returns the uncompressed image size.
+  int ndim = 0;
+  fits_get_img_dim (fptr, &ndim, &status);
+  std::vector<LONGLONG> naxes(std::max(ndim, 1));
+  fits_get_img_sizell (fptr, ndim, naxes.data(), &status);
+  if (status) {
+    throw AipsError ("FITSCompressedData: cannot get image shape in " +
+                     fileName + ": " + fitsCompressedError(status));
+  }
+  itsShape.resize (ndim);
+  itsTileShape.resize (ndim);
+  itsNTiles.resize (ndim);
+  for (int i=0; i<ndim; ++i) {
+    itsShape(i) = naxes[i];
+    // The default tile is a row of the image.
+    long tileLength = (i==0 ? itsShape(0) : 1);
+    String key = "ZTILE" + String::toString(i+1);
+    if (fits_read_key_lng (fptr, key.chars(), &tileLength, 0, &status)) {
+      if (status != KEY_NO_EXIST) {
+        throw AipsError ("FITSCompressedData: cannot read " + key + " in " +
+                         fileName + ": " + fitsCompressedError(status));
+      }
+      status = 0;
+    }
+    itsTileShape(i) = std::max (Int64(1),
+                                std::min (Int64(tileLength), Int64(itsShape(i))));
+    itsNTiles(i) = (itsShape(i) + itsTileShape(i) - 1) / itsTileShape(i);
+  }
+  // Make the chunk shape a multiple of the tile shape of about 1M pixels,
+  // so iterating does not go row by row for the default tiling.
+  itsChunkShape = itsTileShape;
+  for (int i=0; i<ndim; ++i) {
+    Int64 nfit = std::max (Int64(1), (1024*1024) / itsChunkShape.product());
+    itsChunkShape(i) = std::min (Int64(itsShape(i)),
+                                 itsTileShape(i) * std::min(nfit, Int64(itsNTiles(i))));
+  }
+  // Tiles can only be decompressed in parallel using multiple file handles
+  // if cfitsio has been built reentrant.
+#if defined(CFITSIO_VERSION_MAJOR) && CFITSIO_VERSION_MAJOR >= 3
+  itsReentrant = fits_is_reentrant();
+#endif
+}
+
+FITSCompressedData::~FITSCompressedData()
+{
+  for (size_t i=0; i<itsFiles.size(); ++i) {
+    closeFile (itsFiles[i]);
+  }
+}
+
+void* FITSCompressedData::openFile (const String& fileName, uInt whichHDU)
+{
+  fitsfile* fptr = 0;
+  int status = 0;
+  if (fits_open_file (&fptr, fileName.chars(), READONLY, &status)) {
+    throw AipsError ("FITSCompressedData: cannot open " + fileName +
+                     ": " + fitsCompressedError(status));
+  }
+  int hduType;
+  if (fits_movabs_hdu (fptr, whichHDU+1, &hduType, &status)) {
+    closeFile (fptr);
+    throw AipsError ("FITSCompressedData: cannot move to HDU " +
+                     String::toString(whichHDU) + " in " + fileName +
+                     ": " + fitsCompressedError(status));
+  }
+  return fptr;
+}
+
+void FITSCompressedData::closeFile (void* file)
+{
+  if (file) {
+    int status = 0;
+    fits_close_file (static_cast<fitsfile*>(file), &status);
+  }
+}
+
+Bool FITSCompressedData::isCompressed (const String& fileName, uInt whichHDU)
+{
+  void* file = 0;
+  try {
+    file = openFile (fileName, whichHDU);
+  } catch (const AipsError&) {
+    return False;
+  }
+  int status = 0;
+  Bool compressed = fits_is_compressed_image (static_cast<fitsfile*>(file),
+                                              &status);
+  closeFile (file);
+  return compressed  &&  status == 0;
+}
+
+Vector<String> FITSCompressedData::imageHeader (const String& fileName,
+                                                uInt whichHDU)
+{
+  fitsfile* fptr = static_cast<fitsfile*>(openFile (fileName, whichHDU));
+  char* header = 0;
+  int nkeys = 0;
+  int status = 0;
+  // Convert the compressed header to the uncompressed image header.
+  fits_convert_hdr2str (fptr, 0, 0, 0, &header, &nkeys, &status);
+  closeFile (fptr);
+  if (status) {
+    throw AipsError ("FITSCompressedData: cannot read header of HDU " +
+                     String::toString(whichHDU) + " in " + fileName +
+                     ": " + fitsCompressedError(status));
+  }
+  std::vector<String> cards;
+  cards.reserve (nkeys+1);
+  const char* card = header;
+  for (int i=0; i<nkeys  &&  card[0] != 0; ++i, card+=80) {
+    cards.push_back (String(card, 80));
+  }
+  free (header);
+  if (cards.empty()  ||  !cards.back().startsWith("END ")) {
+    cards.push_back ("END");
+  }
+  return Vector<String>(cards);
+}
+
+void FITSCompressedData::readTile (void* file, const IPosition& tileStart,
+                                   Array<Float>& tile) const
+{
+  const uInt ndim = itsShape.size();
+  tile.resize (min(itsTileShape, itsShape - tileStart));
+  std::vector<long> blc(ndim), trc(ndim), inc(ndim, 1);
+  for (uInt i=0; i<ndim; ++i) {
+    blc[i] = tileStart(i) + 1;
+    trc[i] = tileStart(i) + tile.shape()(i);
+  }
+  Float nullValue;
+  setNaN (nullValue);
+  int anyNull = 0;
+  int status = 0;
+  Bool deleteIt;
+  Float* data = tile.getStorage (deleteIt);
+  fits_read_subset (static_cast<fitsfile*>(file), TFLOAT, blc.data(),
+                    trc.data(), inc.data(), &nullValue, data,
+                    &anyNull, &status);
+  tile.putStorage (data, deleteIt);
+  if (status) {
+    throw AipsError ("FITSCompressedData: cannot decompress tile at " +
+                     String(tileStart.toString()) + " in " + itsFileName + ": " +
+                     fitsCompressedError(status));
+  }
+}
+
+void FITSCompressedData::get (Array<Float>& buffer,
+                              const Slicer& section) const
+{
+  const uInt ndim = itsShape.size();
+  IPosition blc, trc, inc;
+  IPosition shp = section.inferShapeFromSource (itsShape, blc, trc, inc);
+  buffer.resize (shp);
+  if (shp.product() == 0) {
+    return;
+  }
+  // Determine per axis the tiles containing a pixel of the section.
+  // A strided section can skip tiles.
+  std::vector<std::vector<Int64>> axisTiles(ndim);
+  for (uInt i=0; i<ndim; ++i) {
+    for (Int64 t=blc(i)/itsTileShape(i); t<=trc(i)/itsTileShape(i); ++t) {
+      Int64 st = std::max (Int64(t*itsTileShape(i)), Int64(blc(i)));
+      Int64 first = blc(i) + (st - blc(i) + inc(i) - 1) / inc(i) * inc(i);
+      if (first <= std::min (Int64((t+1)*itsTileShape(i) - 1), Int64(trc(i)))) {
+        axisTiles[i].push_back (t);
+      }
+    }
+  }
+  // Collect the tiles, and find out which ones are in the cache.
+  std::vector<IPosition> tileStarts;
+  std::vector<Int64> tileNrs;
+  std::vector<const Array<Float>*> tiles;
+  std::vector<size_t> missing;
+  IPosition pos(ndim, 0);
+  while (True) {
+    IPosition tileStart(ndim);
+    Int64 tileNr = 0;
+    for (Int i=ndim-1; i>=0; --i) {
+      Int64 t = axisTiles[i][pos(i)];
+      tileStart(i) = t * itsTileShape(i);
+      tileNr = tileNr * itsNTiles(i) + t;
+    }
+    std::map<Int64,Array<Float>>::const_iterator iter = itsTiles.find(tileNr);
+    if (iter == itsTiles.end()) {
+      missing.push_back (tiles.size());
+      tiles.push_back (0);
+    } else {
+      tiles.push_back (&(iter->second));
+    }
+    tileStarts.push_back (tileStart);
+    tileNrs.push_back (tileNr);
+    uInt ax = 0;
+    for (; ax<ndim; ++ax) {
+      if (++pos(ax) < Int64(axisTiles[ax].size())) break;
+      pos(ax) = 0;
+    }
+    if (ax == ndim) break;
+  }
+  itsNHit += tiles.size() - missing.size();
+  itsNRead += missing.size();
+  // Decompress the missing tiles, each thread using its own file handle.
+  const Int64 nmissing = missing.size();
+  std::vector<Array<Float>> newTiles(nmissing);
+  if (nmissing > 0) {
+    Int nthr = 1;
+    if (itsReentrant) {
+      nthr = std::min (Int64(OMP::maxThreads()), nmissing);
+    }
+    while (Int(itsFiles.size()) < nthr) {
+      itsFiles.push_back (openFile (itsFileName, itsHDU));
+    }
+    std::exception_ptr excp;
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(nthr) schedule(dynamic)
+#endif
+    for (Int64 i=0; i<nmissing; ++i) {
+      try {
+        readTile (itsFiles[OMP::threadNum()], tileStarts[missing[i]],
+                  newTiles[i]);
+      } catch (...) {
+#ifdef _OPENMP
+#pragma omp critical(FITSCompressedData_get)
+#endif
+        excp = std::current_exception();
+      }
+    }
+    if (excp) {
+      std::rethrow_exception (excp);
+    }
+    for (Int64 i=0; i<nmissing; ++i) {
+      tiles[missing[i]] = &(newTiles[i]);
+    }
+  }
+  // Copy the selected pixels of each tile into the buffer.
+  IPosition bufBlc(ndim), bufTrc(ndim), tileBlc(ndim), tileTrc(ndim);
+  for (size_t j=0; j<tiles.size(); ++j) {
+    const IPosition& ts = tileStarts[j];
+    const IPosition tileShape = tiles[j]->shape();
+    for (uInt i=0; i<ndim; ++i) {
+      Int64 st = std::max (ts(i), blc(i));
+      Int64 end = std::min (ts(i) + tileShape(i) - 1, trc(i));
+      bufBlc(i) = (st - blc(i) + inc(i) - 1) / inc(i);
+      bufTrc(i) = (end - blc(i)) / inc(i);
+      tileBlc(i) = blc(i) + bufBlc(i)*inc(i) - ts(i);
+      tileTrc(i) = blc(i) + bufTrc(i)*inc(i) - ts(i);
+    }
+    Array<Float> part (buffer(bufBlc, bufTrc));
+    part.assign_conforming ((*tiles[j])(tileBlc, tileTrc, inc));
+  }
+  // Keep the new tiles in the cache.
+  for (Int64 i=0; i<nmissing; ++i) {
+    Int64 npixels = newTiles[i].nelements();
+    if (npixels <= itsMaxCached) {
+      makeRoom (npixels);
+      itsTiles[tileNrs[missing[i]]].reference (newTiles[i]);
+      itsTileOrder.push_back (tileNrs[missing[i]]);
+      itsNCached += npixels;
+    }
+  }
+}
+
+void FITSCompressedData::makeRoom (Int64 npixels) const
+{
+  while (!itsTileOrder.empty()  &&  itsNCached + npixels > itsMaxCached) {
+    std::map<Int64,Array<Float>>::iterator iter =
+      itsTiles.find (itsTileOrder.front());
+    itsNCached -= iter->second.nelements();
+    itsTiles.erase (iter);
+    itsTileOrder.pop_front();
+  }
+}
+
+uInt FITSCompressedData::maximumCacheSize() const
+{
+  return itsMaxCached;
+}
+
+void FITSCompressedData::setMaximumCacheSize (uInt howManyPixels)
+{
+  itsMaxCached = howManyPixels;
+  makeRoom (0);
+}
+
+void FITSCompressedData::clearCache()
+{
+  itsTiles.clear();
+  itsTileOrder.clear();
+  itsNCached = 0;
+}
+
+void FITSCompressedData::showCacheStatistics (ostream& os) const
+{
+  os << "tile-compressed, tile shape " << itsTileShape
+     << ", " << itsNHit << " tiles found in cache, "
+     << itsNRead << " tiles decompressed" << endl;
+}
+
+
+} //# NAMESPACE CASACORE - END
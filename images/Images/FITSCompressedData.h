@@ -0,0 +1,172 @@
+//# FITSCompressedData.h: Access to the data of a tile-compressed FITS image
+//# Copyright (C) 2026
+//# Associated Universities, Inc. Washington DC, USA.
+//#
+//# This library is free software; you can redistribute it and/or modify it
+//# under the terms of the GNU Library General Public License as published by
+//# the Free Software Foundation; either version 2 of the License, or (at your
+//# option) any later version.
+//#
+//# This library is distributed in the hope that it will be useful, but WITHOUT
+//# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+//# License for more details.
+//#
+//# You should have received a copy of the GNU Library General Public License
+//# along with this library; if not, write to the Free Software Foundation,
+//# Inc., 675 Massachusetts Ave, Cambridge, MA 02139, USA.
+//#
+//# Correspondence concerning AIPS++ should be addressed as follows:
+//#        Internet email: aips2-request@nrao.edu.
+//#        Postal address: AIPS++ Project Office
+//#                        National Radio Astronomy Observatory
+//#                        520 Edgemont Road
+//#                        Charlottesville, VA 22903-2475 USA
+
+#ifndef IMAGES_FITSCOMPRESSEDDATA_H
+#define IMAGES_FITSCOMPRESSEDDATA_H
+
+//# Includes
+#include <casacore/casa/aips.h>
+#include <casacore/casa/Arrays/Vector.h>
+#include <casacore/casa/BasicSL/String.h>
+#include <casacore/casa/Utilities/DataType.h>
+#include <casacore/images/Images/FITSDataAccess.h>
+#include <deque>
+#include <map>
+#include <vector>
+
+namespace casacore { //# NAMESPACE CASACORE - BEGIN
+
+
+// <summary>
+// Access to the data of a tile-compressed FITS image.
+// </summary>
+
+// <use visibility=local>
+
+// <reviewed reviewer="" date="" tests="tFITSImage.cc">
+// </reviewed>
+
+// <prerequisite>
+//   <li> <linkto class=FITSImage>FITSImage</linkto>
+//   <li> <linkto class=FITSDataAccess>FITSDataAccess</linkto>
+// </prerequisite>
+
+// <synopsis>
+// The FITS tiled image compression convention (as used by fpack) stores an
+// image in a binary table extension with the keyword <src>ZIMAGE=T</src>.
+// Each row of the table contains a tile of the image compressed with
+// Rice, GZIP, HCOMPRESS or PLIO. The keywords describing the image are
+// given as <src>ZNAXISn</src>, <src>ZBITPIX</src>, etc.
+// <p>
+// This class uses cfitsio to decompress the tiles intersecting a requested
+// section. Decompressed tiles are kept in a cache of (by default) 64 MBytes;
+// the oldest tile is removed first. Tiles that have to be decompressed for
+// a section are distributed over the OpenMP threads, each using its own
+// cfitsio file handle. That is only done if cfitsio has been built
+// reentrant; otherwise the tiles are decompressed sequentially.
+// <p>
+// The values are returned as Float; scaling (also of quantized floating
+// point data) is done by cfitsio and blanked pixels are set to a NaN.
+// <p>
+// Function <src>imageHeader</src> returns the header of the HDU converted to
+// the header of the equivalent uncompressed image, so it can be interpreted
+// in the same way as an image extension header.
+// </synopsis>
+
+// <motivation>
+// Archives store images as tile-compressed FITS files. Reading them
+// should not require to decompress the entire file first.
+// </motivation>
+
+class FITSCompressedData : public FITSDataAccess
+{
+public:
+  // Open the given HDU (0-relative) of the FITS file.
+  // An exception is thrown if it is not a tile-compressed image.
+  FITSCompressedData (const String& fileName, uInt whichHDU);
+
+  // Close the file handles.
+  virtual ~FITSCompressedData();
+
+  // Forbid copy constructor and assignment.
+  // <group>
+  FITSCompressedData (const FITSCompressedData&) = delete;
+  FITSCompressedData& operator= (const FITSCompressedData&) = delete;
+  // </group>
+
+  // Test if the given HDU (0-relative) of a FITS file is a tile-compressed
+  // image. False is returned if the file cannot be opened by cfitsio.
+  static Bool isCompressed (const String& fileName, uInt whichHDU);
+
+  // Get the header of the given HDU (0-relative) as the header of the
+  // equivalent uncompressed image. Each element is a card; the last one is
+  // the END card.
+  static Vector<String> imageHeader (const String& fileName, uInt whichHDU);
+
+  // Get the shape of the image.
+  virtual const IPosition& shape() const
+    { return itsShape; }
+
+  // Get the shape of a compression tile.
+  const IPosition& tileShape() const
+    { return itsTileShape; }
+
+  // Get the chunk shape, which is a multiple of the tile shape
+  // containing about 1M pixels.
+  virtual const IPosition& chunkShape() const
+    { return itsChunkShape; }
+
+  // Get a section of the image. Only the tiles intersecting the
+  // section are decompressed (if not in the cache).
+  virtual void get (Array<Float>& buffer, const Slicer& section) const;
+
+  // Get or set the maximum size of the tile cache (in pixels).
+  // <group>
+  virtual uInt maximumCacheSize() const;
+  virtual void setMaximumCacheSize (uInt howManyPixels);
+  // </group>
+
+  // Remove all tiles from the cache.
+  virtual void clearCache();
+
+  // Show the number of tiles found in and decompressed into the cache.
+  virtual void showCacheStatistics (ostream& os) const;
+
+private:
+  // Open the file and move to the HDU. The returned pointer is a fitsfile*.
+  static void* openFile (const String& fileName, uInt whichHDU);
+
+  // Close a file opened by openFile (if not null).
+  static void closeFile (void* file);
+
+  // Decompress the tile with the given start position.
+  void readTile (void* file, const IPosition& tileStart,
+                 Array<Float>& tile) const;
+
+  // Remove the oldest tiles until the cache can hold the given number
+  // of extra pixels.
+  void makeRoom (Int64 npixels) const;
+
+  String    itsFileName;
+  uInt      itsHDU;
+  IPosition itsShape;
+  IPosition itsTileShape;
+  IPosition itsNTiles;
+  IPosition itsChunkShape;
+  Bool      itsReentrant;
+  //# The cfitsio file handles (fitsfile*); one per thread.
+  mutable std::vector<void*>              itsFiles;
+  mutable std::map<Int64,Array<Float>>    itsTiles;
+  mutable std::deque<Int64>               itsTileOrder;
+  mutable Int64                           itsNCached;
+  mutable Int64                           itsNHit;
+  mutable Int64                           itsNRead;
+  Int64                                   itsMaxCached;
+};
+
+
+} //# NAMESPACE CASACORE - END
+
+#endif
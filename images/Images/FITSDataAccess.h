@@ -0,0 +1,106 @@
+//# FITSDataAccess.h: Abstract base class for direct access to FITS image data
+//# Copyright (C) 2026
+//# Associated Universities, Inc. Washington DC, USA.
+//#
+//# This library is free software; you can redistribute it and/or modify it
+//# under the terms of the GNU Library General Public License as published by
+//# the Free Software Foundation; either version 2 of the License, or (at your
+//# option) any later version.
+//#
+//# This library is distributed in the hope that it will be useful, but WITHOUT
+//# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+//# License for more details.
+//#
+//# You should have received a copy of the GNU Library General Public License
+//# along with this library; if not, write to the Free Software Foundation,
+//# Inc., 675 Massachusetts Ave, Cambridge, MA 02139, USA.
+//#
+//# Correspondence concerning AIPS++ should be addressed as follows:
+//#        Internet email: aips2-request@nrao.edu.
+//#        Postal address: AIPS++ Project Office
+//#                        National Radio Astronomy Observatory
+//#                        520 Edgemont Road
+//#                        Charlottesville, VA 22903-2475 USA
+
+#ifndef IMAGES_FITSDATAACCESS_H
+#define IMAGES_FITSDATAACCESS_H
+
+//# Includes
+#include <casacore/casa/aips.h>
+#include <casacore/casa/Arrays/Array.h>
+#include <casacore/casa/Arrays/IPosition.h>
+#include <casacore/casa/iostream.h>
+
+namespace casacore { //# NAMESPACE CASACORE - BEGIN
+
+//# Forward Declarations
+class Slicer;
+
+
+// <summary>
+// Abstract base class for direct access to the data of a FITS image.
+// </summary>
+
+// <use visibility=local>
+
+// <reviewed reviewer="" date="" tests="tFITSImage.cc">
+// </reviewed>
+
+// <prerequisite>
+//   <li> <linkto class=FITSImage>FITSImage</linkto>
+// </prerequisite>
+
+// <synopsis>
+// FITSImage can read the data of an image in several ways. A plain image
+// is memory-mapped (<linkto class=FITSMappedData>FITSMappedData</linkto>),
+// while a tile-compressed image is decompressed on the fly
+// (<linkto class=FITSCompressedData>FITSCompressedData</linkto>).
+// This class defines the interface used by FITSImage and
+// <linkto class=FITSMappedMask>FITSMappedMask</linkto> to get the data
+// as Float values, where blanked pixels are set to a NaN.
+// </synopsis>
+
+class FITSDataAccess
+{
+public:
+  FITSDataAccess()
+    {}
+
+  virtual ~FITSDataAccess()
+    {}
+
+  // Get the shape of the data array.
+  virtual const IPosition& shape() const = 0;
+
+  // Get the shape of the chunks used for the mask cache.
+  // It is also a good cursor shape for iterating through the image.
+  virtual const IPosition& chunkShape() const = 0;
+
+  // Get a pointer to the data if they can be used without conversion.
+  // The default implementation returns a null pointer.
+  virtual const Float* directData() const
+    { return 0; }
+
+  // Get a section of the data converted to Float.
+  // The buffer is resized if needed.
+  virtual void get (Array<Float>& buffer, const Slicer& section) const = 0;
+
+  // Functions to handle a cache of decompressed or converted data.
+  // The default implementations do nothing, because no cache is used.
+  // <group>
+  virtual uInt maximumCacheSize() const
+    { return 0; }
+  virtual void setMaximumCacheSize (uInt howManyPixels)
+    { (void)howManyPixels; }
+  virtual void clearCache()
+    {}
+  virtual void showCacheStatistics (ostream& os) const
+    { os << "no cache" << endl; }
+  // </group>
+};
+
+
+} //# NAMESPACE CASACORE - END
+
+#endif
@@ -26,6 +26,8 @@
 #include <casacore/images/Images/FITSImage.h>
 
 #include <casacore/images/Images/FITSImgParser.h>
+#include <casacore/images/Images/FITSMappedData.h>
+#include <casacore/images/Images/FITSCompressedData.h>
 #include <casacore/fits/FITS/hdu.h>
 #include <casacore/fits/FITS/fitsio.h>
 #include <casacore/fits/FITS/FITSKeywordUtil.h>
@@ -59,7 +61,8 @@
 
 namespace casacore { //# NAMESPACE CASACORE - BEGIN
 
-FITSImage::FITSImage (const String& name, uInt whichRep, uInt whichHDU)
+FITSImage::FITSImage (const String& name, uInt whichRep, uInt whichHDU,
+                      Bool useMemoryMap)
 : ImageInterface<Float>(),
   name_p      (name),
   fullname_p  (name),
@@ -71,8 +74,10 @@ FITSImage::FITSImage (const String& name, uInt whichRep, uInt whichHDU)
   hasBlanks_p (False),
   dataType_p  (TpOther),
   fileOffset_p(0),
+  isCompressed_p(False),
   isClosed_p  (True),
   filterZeroMask_p(False),
+  useMemoryMap_p(useMemoryMap),
   whichRep_p(whichRep),
   whichHDU_p(whichHDU),
   _hasBeamsTable(False)
@@ -80,7 +85,8 @@ FITSImage::FITSImage (const String& name, uInt whichRep, uInt whichHDU)
    setup();
 }
 
-FITSImage::FITSImage (const String& name, const MaskSpecifier& maskSpec, uInt whichRep, uInt whichHDU)
+FITSImage::FITSImage (const String& name, const MaskSpecifier& maskSpec, uInt whichRep, uInt whichHDU,
+                      Bool useMemoryMap)
 : ImageInterface<Float>(),
   name_p      (name),
   fullname_p  (name),
@@ -93,8 +99,10 @@ FITSImage::FITSImage (const String& name, const MaskSpecifier& maskSpec, uInt wh
   hasBlanks_p (False),
   dataType_p  (TpOther),
   fileOffset_p(0),
+  isCompressed_p(False),
   isClosed_p  (True),
   filterZeroMask_p(False),
+  useMemoryMap_p(useMemoryMap),
   whichRep_p(whichRep),
   whichHDU_p(whichHDU),
   _hasBeamsTable(False)
@@ -108,6 +116,7 @@ FITSImage::FITSImage (const FITSImage& other)
   fullname_p  (other.fullname_p),
   maskSpec_p  (other.maskSpec_p),
   pTiledFile_p(other.pTiledFile_p),
+  pDataAccess_p(other.pDataAccess_p),
   shape_p     (other.shape_p),
   scale_p     (other.scale_p),
   offset_p    (other.offset_p),
@@ -117,8 +126,10 @@ FITSImage::FITSImage (const FITSImage& other)
   hasBlanks_p (other.hasBlanks_p),
   dataType_p  (other.dataType_p),
   fileOffset_p(other.fileOffset_p),
+  isCompressed_p(other.isCompressed_p),
   isClosed_p  (other.isClosed_p),
   filterZeroMask_p(other.filterZeroMask_p),
+  useMemoryMap_p(other.useMemoryMap_p),
   whichRep_p(other.whichRep_p),
   whichHDU_p(other.whichHDU_p),
   _hasBeamsTable(other._hasBeamsTable)
@@ -138,6 +149,7 @@ FITSImage& FITSImage::operator=(const FITSImage& other)
       ImageInterface<Float>::operator= (other);
 //
       pTiledFile_p = other.pTiledFile_p;             // shared pointer
+      pDataAccess_p = other.pDataAccess_p;           // shared pointer
 //
       pPixelMask_p.reset();
       if (other.pPixelMask_p) {
@@ -156,8 +168,10 @@ FITSImage& FITSImage::operator=(const FITSImage& other)
       hasBlanks_p = other.hasBlanks_p;
       dataType_p  = other.dataType_p;
       fileOffset_p= other.fileOffset_p;
+      isCompressed_p = other.isCompressed_p;
       isClosed_p  = other.isClosed_p;
       filterZeroMask_p = other.filterZeroMask_p;
+      useMemoryMap_p = other.useMemoryMap_p;
       whichRep_p = other.whichRep_p;
       whichHDU_p = other.whichHDU_p;
       _hasBeamsTable = other._hasBeamsTable;
@@ -352,11 +366,19 @@ IPosition FITSImage::shape() const
 
 uInt FITSImage::advisedMaxPixels() const
 {
+   reopenIfNeeded();
+   if (pDataAccess_p) {
+      return pDataAccess_p->chunkShape().product();
+   }
    return shape_p.tileShape().product();
 }
 
 IPosition FITSImage::doNiceCursorShape (uInt) const  
 {
+   reopenIfNeeded();
+   if (pDataAccess_p) {
+      return pDataAccess_p->chunkShape();
+   }
    return shape_p.tileShape();
 }
 
@@ -369,7 +391,9 @@ Bool FITSImage::doGetSlice(Array<Float>& buffer,
                            const Slicer& section)
 {
    reopenIfNeeded();
-   if (pTiledFile_p->dataType() == TpFloat) {
+   if (pDataAccess_p) {
+      pDataAccess_p->get (buffer, section);
+   } else if (pTiledFile_p->dataType() == TpFloat) {
       pTiledFile_p->get (buffer, section);
    } else if (pTiledFile_p->dataType() == TpDouble) {
       Array<Double> tmp;
@@ -478,6 +502,7 @@ void FITSImage::tempClose()
    if (! isClosed_p) {
       pPixelMask_p.reset();
       pTiledFile_p.reset();
+      pDataAccess_p.reset();
       isClosed_p = True;
    }
 }
@@ -489,15 +514,30 @@ void FITSImage::reopen()
    }
 }
 
+const Float* FITSImage::directData() const
+{
+   reopenIfNeeded();
+   return (pDataAccess_p ? pDataAccess_p->directData() : 0);
+}
+
 uInt FITSImage::maximumCacheSize() const
 {
    reopenIfNeeded();
+   if (!pTiledFile_p) {
+      return (pDataAccess_p ? pDataAccess_p->maximumCacheSize() : 0);
+   }
    return pTiledFile_p->maximumCacheSize() / ValType::getTypeSize(dataType_p);
 }
 
 void FITSImage::setMaximumCacheSize (uInt howManyPixels)
 {
    reopenIfNeeded();
+   if (!pTiledFile_p) {
+      if (pDataAccess_p) {
+         pDataAccess_p->setMaximumCacheSize (howManyPixels);
+      }
+      return;
+   }
    const uInt sizeInBytes = howManyPixels * ValType::getTypeSize(dataType_p);
    pTiledFile_p->setMaximumCacheSize (sizeInBytes);
 }
@@ -508,6 +548,9 @@ void FITSImage::setCacheSizeFromPath (const IPosition& sliceShape,
 				      const IPosition& axisPath)
 {
    reopenIfNeeded();
+   if (!pTiledFile_p) {
+      return;
+   }
    pTiledFile_p->setCacheSize (sliceShape, windowStart,
 			       windowLength, axisPath);
 }
@@ -515,6 +558,9 @@ void FITSImage::setCacheSizeFromPath (const IPosition& sliceShape,
 void FITSImage::setCacheSizeInTiles (uInt howManyTiles)  
 {  
    reopenIfNeeded();
+   if (!pTiledFile_p) {
+      return;
+   }
    pTiledFile_p->setCacheSize (howManyTiles);
 }
 
@@ -522,7 +568,11 @@ void FITSImage::setCacheSizeInTiles (uInt howManyTiles)
 void FITSImage::clearCache()
 {
    if (! isClosed_p) {
-      pTiledFile_p->clearCache();
+      if (pTiledFile_p) {
+         pTiledFile_p->clearCache();
+      } else if (pDataAccess_p) {
+         pDataAccess_p->clearCache();
+      }
    }
 }
 
@@ -530,7 +580,11 @@ void FITSImage::showCacheStatistics (ostream& os) const
 {
    reopenIfNeeded();
    os << "FITSImage statistics : ";
-   pTiledFile_p->showCacheStatistics (os);
+   if (pTiledFile_p) {
+      pTiledFile_p->showCacheStatistics (os);
+   } else if (pDataAccess_p) {
+      pDataAccess_p->showCacheStatistics (os);
+   }
 }
 
 
@@ -660,6 +714,37 @@ void FITSImage::open()
    Bool writable = False;
    Bool canonical = True;    
 
+// A tile-compressed image is decompressed on the fly.
+// On 64-bit systems memory-map the data (unless not wanted). The mapping
+// can fail (e.g. a truncated file); then fall back to TiledFileAccess.
+
+   if (isCompressed_p) {
+      pDataAccess_p = std::make_shared<FITSCompressedData>(name_p, whichHDU_p);
+   } else if (useMemoryMap_p  &&  sizeof(void*) >= 8) {
+      Int blank = longMagic_p;
+      if (dataType_p == TpShort) {
+         blank = shortMagic_p;
+      } else if (dataType_p == TpUChar) {
+         blank = uCharMagic_p;
+      }
+      try {
+         pDataAccess_p = std::make_shared<FITSMappedData>
+           (name_p, fileOffset_p, shape_p.shape(), dataType_p,
+            scale_p, offset_p, blank, hasBlanks_p);
+      } catch (const AipsError&) {
+         pDataAccess_p.reset();
+      }
+   }
+   if (pDataAccess_p) {
+      if (hasBlanks_p) {
+         FITSMappedMask* mappedMask = new FITSMappedMask(pDataAccess_p);
+         pPixelMask_p.reset (mappedMask);
+         mappedMask->setFilterZero(filterZeroMask_p);
+      }
+      isClosed_p = False;
+      return;
+   }
+
 // The tile shape must not be a subchunk in all dimensions
 
    pTiledFile_p = std::make_shared<TiledFileAccess>(name_p, fileOffset_p,
@@ -718,6 +803,21 @@ void FITSImage::getImageAttributes (CoordinateSystem& cSys,
    if (type != ImageOpener::FITS) {
        throw (AipsError(name + " is not a FITS image"));
    }
+//
+// A tile-compressed image is stored in a binary table extension.
+// Its header is read by cfitsio; the data do not have a file offset.
+//
+    isCompressed_p = whichHDU > 0  &&
+                     FITSCompressedData::isCompressed (name, whichHDU);
+    if (isCompressed_p) {
+        crackCompressedHeader (cSys, shape, imageInfo, brightnessUnit,
+                               miscInfo, dataType, scale, offset,
+                               uCharMagic, shortMagic, longMagic,
+                               hasBlanks, os, name, whichRep, whichHDU);
+        recordsize = 0;
+        recordnumber = 0;
+        return;
+    }
 //
     FitsInput infile(fitsfile.path().expandedName().chars(), FITS::Disk);
     if (infile.err()) {
@@ -823,12 +923,153 @@ void FITSImage::getImageAttributes (CoordinateSystem& cSys,
     recordnumber = infile.recno();
 }
 
+void FITSImage::crackCompressedHeader (CoordinateSystem& cSys,
+                                       IPosition& shape, ImageInfo& imageInfo,
+                                       Unit& brightnessUnit,
+                                       RecordInterface& miscInfo,
+                                       FITS::ValueType& dataType,
+                                       Float& scale, Float& offset,
+                                       uChar& magicUChar, Short& magicShort,
+                                       Int& magicInt, Bool& hasBlanks,
+                                       LogIO& os, const String& name,
+                                       uInt whichRep, uInt whichHDU)
+{
+// Get the header as a Vector of strings and as a keyword list.
+
+    Vector<String> header = FITSCompressedData::imageHeader (name, whichHDU);
+    FitsKeywordList kwl;
+    for (uInt i=0; i<header.nelements(); i++) {
+       String card (header(i));
+       if (card.length() < 80) {
+          card += String(80 - card.length(), ' ');
+       }
+       kwl.parse (card.chars(), 80);
+    }
+
+// Shape
+
+    Int ndim = (kwl(FITS::NAXIS) ? kwl(FITS::NAXIS)->asInt() : 0);
+    shape.resize(ndim);
+    for (Int i=0; i<ndim; i++) {
+       const FitsKeyword* kw = kwl(FITS::NAXIS, i+1);
+       if (kw == 0) {
+          throw (AipsError("NAXIS" + String::toString(i+1) +
+                           " missing in compressed image header of " + name));
+       }
+       shape(i) = kw->asInt();
+    }
+
+// Get Coordinate System.  Return un-used FITS cards in a Record for further use.
+
+    Record headerRec;
+    Bool dropStokes = True;
+    Int stokesFITSValue = 1;
+    cSys = ImageFITSConverter::getCoordinateSystem(stokesFITSValue, headerRec, header,
+                                                   os, whichRep, shape, dropStokes);
+    _hasBeamsTable = headerRec.isDefined(ImageFITSConverter::CASAMBM)
+      && headerRec.asRecord(ImageFITSConverter::CASAMBM).asBool("value");
+
+// BITPIX gives the data type of the uncompressed image.
+
+    Int bitpix;
+    Record subRec = headerRec.asRecord("bitpix");
+    subRec.get("value", bitpix);
+    headerRec.removeField("bitpix");
+    if (bitpix == -32) {
+       dataType = FITS::FLOAT;
+    } else if (bitpix == -64) {
+       dataType = FITS::DOUBLE;
+    } else if (bitpix == 32) {
+       dataType = FITS::LONG;
+    } else if (bitpix == 16) {
+       dataType = FITS::SHORT;
+    } else if (bitpix == 8) {
+       dataType = FITS::BYTE;
+    } else {
+       throw (AipsError("FITS file " + name +
+                        " should contain float, double, short or long data"));
+    }
+
+// Scale and blank. They are applied by cfitsio when decompressing,
+// but are kept for completeness.
+
+    Double s = 1.0;
+    Double o = 0.0;
+    if (headerRec.isDefined("bscale")) {
+       subRec = headerRec.asRecord("bscale");
+       subRec.get("value", s);
+       headerRec.removeField("bscale");
+    }
+    if (headerRec.isDefined("bzero")) {
+       subRec = headerRec.asRecord("bzero");
+       subRec.get("value", o);
+       headerRec.removeField("bzero");
+    }
+    scale = s;
+    offset = o;
+    hasBlanks = False;
+    if (headerRec.isDefined("blank")) {
+       subRec = headerRec.asRecord("blank");
+       Int m;
+       subRec.get("value", m);
+       headerRec.removeField("blank");
+       magicUChar = m;
+       magicShort = m;
+       magicInt = m;
+       hasBlanks = True;
+    }
+
+// Brightness Unit and ImageInfo
+
+    brightnessUnit = ImageFITSConverter::getBrightnessUnit(headerRec, os);
+    imageInfo = ImageFITSConverter::getImageInfo(headerRec);
+    if (stokesFITSValue != -1) {
+       ImageInfo::ImageTypes type = ImageInfo::imageTypeFromFITS(stokesFITSValue);
+       if (type!= ImageInfo::Undefined) {
+          imageInfo.setImageType(type);
+       }
+    }
+
+// Get rid of anything else we don't want to end up in MiscInfo
+
+    Vector<String> ignore(12);
+    ignore(0) = "^datamax$";
+    ignore(1) = "^datamin$";
+    ignore(2) = "^origin$";
+    ignore(3) = "^extend$";
+    ignore(4) = "^blocked$";
+    ignore(5) = "^blank$";
+    ignore(6) = "^simple$";
+    ignore(7) = "bscale";
+    ignore(8) = "bzero";
+    ignore(9) = "xtension";
+    ignore(10) = "pcount";
+    ignore(11) = "gcount";
+    FITSKeywordUtil::removeKeywords(headerRec, ignore);
+    ImageFITSConverter::extractMiscInfo(miscInfo, headerRec);
+
+// Restore the history and find the restoring beam in it if needed.
+
+    LoggerHolder& log = logger();
+    ConstFitsKeywordList kw(kwl);
+    ImageFITSConverter::restoreHistory(log, kw);
+    if (! imageInfo.hasSingleBeam()) {
+       imageInfo.getRestoringBeam(log);
+    }
+}
+
 void FITSImage::setMaskZero(Bool filterZero)
 {
   // set the zero masking on the
   // current mask
   if (pPixelMask_p) {
-    dynamic_cast<FITSMask *>(pPixelMask_p.get())->setFilterZero(True);
+    FITSMappedMask* mappedMask =
+      dynamic_cast<FITSMappedMask*>(pPixelMask_p.get());
+    if (mappedMask) {
+      mappedMask->setFilterZero(filterZero);
+    } else {
+      dynamic_cast<FITSMask *>(pPixelMask_p.get())->setFilterZero(True);
+    }
   }
   // set the flag, such that an later
   // mask created in 'open()' will be OK
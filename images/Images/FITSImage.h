@@ -52,6 +52,7 @@ class IPosition;
 class Slicer;
 class CoordinateSystem;
 class FITSMask;
+class FITSDataAccess;
 class FitsInput;
 
 
@@ -76,14 +77,22 @@ class FitsInput;
 // </etymology>
 
 // <synopsis> 
-//  A FITSImage provides native access to FITS images by accessing them
-//  with the TiledFileAccess class.  The FITSImage is read only.
+//  A FITSImage provides native access to FITS images.  On 64-bit systems
+//  the file is memory-mapped and accessed with the FITSMappedData class,
+//  which converts the data in parallel.  Otherwise (or if mapping fails)
+//  the TiledFileAccess class is used.
+//  An image compressed according to the FITS tiled image compression
+//  convention (e.g. by fpack) is recognized automatically. It is read with
+//  the FITSCompressedData class, which only decompresses the tiles
+//  needed (possibly in parallel) and keeps them in a cache.
+//  The FITSImage is read only.
 //  We could implement a writable FITSImage but putting the mask
 //  would lose data values (uses magic blanking) and FITS is really
 //  meant as an interchange medium, not an internal format.
 //
 //  Because FITS uses magic value blanking, the mask is generated
-//  on the fly as needed.
+//  on the fly as needed.  For a memory-mapped image the mask is cached
+//  per chunk (see FITSMappedMask).
 // </synopsis> 
 
 // <example>
@@ -107,10 +116,14 @@ class FITSImage: public ImageInterface<Float>
 {
 public: 
   // Construct a FITSImage from the disk FITS file name  and extension and apply mask.
-  explicit FITSImage(const String& name, uInt whichRep=0, uInt whichHDU=0);
+  // If <src>useMemoryMap=False</src>, the data are always accessed with
+  // TiledFileAccess instead of a memory map.
+  explicit FITSImage(const String& name, uInt whichRep=0, uInt whichHDU=0,
+                     Bool useMemoryMap=True);
 
   // Construct a FITSImage from the disk FITS file name and extension and apply mask or not.
-  FITSImage(const String& name, const MaskSpecifier& mask, uInt whichRep=0, uInt whichHDU=0);
+  FITSImage(const String& name, const MaskSpecifier& mask, uInt whichRep=0, uInt whichHDU=0,
+            Bool useMemoryMap=True);
 
   // Copy constructor (reference semantics)
   FITSImage(const FITSImage& other);
@@ -228,11 +241,20 @@ public:
   DataType internalDataType() const
     { return dataType_p; }
 
+  // Get a pointer to the pixels in the memory-mapped file if they can be
+  // used without conversion, i.e., unscaled 32-bit floats on a big-endian
+  // host. Otherwise a null pointer is returned.
+  // The pointer is valid until the image is (temporarily) closed.
+  const Float* directData() const;
+
   // Return the HDU number
   uInt whichHDU () const
     { return whichHDU_p; }
 
-  // Maximum size - not necessarily all used. In pixels.
+  // The cache functions only apply if the image is accessed with
+  // TiledFileAccess. A memory-mapped image has no cache, so 0 is returned
+  // for its maximum cache size.
+  // <br>Maximum size - not necessarily all used. In pixels.
   virtual uInt maximumCacheSize() const;
 
   // Set the maximum (allowed) cache size as indicated.
@@ -267,6 +289,7 @@ private:
   String         fullname_p;
   MaskSpecifier  maskSpec_p;
   std::shared_ptr<TiledFileAccess> pTiledFile_p;
+  std::shared_ptr<FITSDataAccess>  pDataAccess_p;
   std::unique_ptr<Lattice<Bool>>   pPixelMask_p;
   TiledShape     shape_p;
   Float          scale_p;
@@ -277,8 +300,10 @@ private:
   Bool           hasBlanks_p;
   DataType       dataType_p;
   Int64          fileOffset_p;
+  Bool           isCompressed_p;
   Bool           isClosed_p;
   Bool           filterZeroMask_p;
+  Bool           useMemoryMap_p;
   uInt           whichRep_p;
   uInt           whichHDU_p;
   Bool           _hasBeamsTable;
@@ -320,6 +345,17 @@ private:
 			Short& magicShort,
                         Int& magicLong, Bool& hasBlanks, LogIO& os, FitsInput& infile,
                         uInt whichRep);
+
+// Crack the header of a tile-compressed image extension.
+// cfitsio converts it to the header of the equivalent uncompressed image.
+   void crackCompressedHeader (CoordinateSystem& cSys, IPosition& shape,
+                               ImageInfo& imageInfo, Unit& brightnessUnit,
+                               RecordInterface& miscInfo,
+                               FITS::ValueType& dataType,
+                               Float& scale, Float& offset, uChar& uCharMagic,
+                               Short& magicShort, Int& magicLong,
+                               Bool& hasBlanks, LogIO& os, const String& name,
+                               uInt whichRep, uInt whichHDU);
 		     
 };
 
@@ -389,6 +389,7 @@ void FITSImgParser::setup(void)
 	extensions_p = new FITSExtInfo[num_hdu];
 
 	HeaderDataUnit *hdu;
+	BinaryTableExtension *bt;
 	PrimaryArray<unsigned char> *paB;
 	PrimaryArray<short> *paS;
 	PrimaryArray<FitsLong> *paL;
@@ -470,7 +471,15 @@ void FITSImgParser::setup(void)
 				isfitsimg = False;
 				break;
 			case FITS::BinaryTableHDU:
-				isfitsimg = False;
+				// a tile-compressed image is stored in a binary table
+				// with ZIMAGE=T; any other table ends the image HDUs
+				bt = new BinaryTableExtension(fin);
+				if (bt->kw("ZIMAGE") && bt->kw("ZIMAGE")->asBool()) {
+					process_extension(bt, extindex);
+				} else {
+					isfitsimg = False;
+				}
+				delete bt;
 				break;
 			case FITS::UnknownExtensionHDU:
 				hdu = new ExtensionHeaderDataUnit(fin);
@@ -0,0 +1,472 @@
+//# FITSMappedData.cc: Memory-mapped access to the data unit of a FITS image
+//# Copyright (C) 2026
+//# Associated Universities, Inc. Washington DC, USA.
+//#
+//# This library is free software; you can redistribute it and/or modify it
+//# under the terms of the GNU Library General Public License as published by
+//# the Free Software Foundation; either version 2 of the License, or (at your
+//# option) any later version.
+//#
+//# This library is distributed in the hope that it will be useful, but WITHOUT
+//# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+//# License for more details.
+//#
+//# You should have received a copy of the GNU Library General Public License
+//# along with this library; if not, write to the Free Software Foundation,
+//# Inc., 675 Massachusetts Ave, Cambridge, MA 02139, USA.
+//#
+//# Correspondence concerning AIPS++ should be addressed as follows:
+//#        Internet email: aips2-request@nrao.edu.
+//#        Postal address: AIPS++ Project Office
+//#                        National Radio Astronomy Observatory
+//#                        520 Edgemont Road
+//#                        Charlottesville, VA 22903-2475 USA
+
+#include <casacore/images/Images/FITSMappedData.h>
+#include <casacore/tables/DataMan/TiledFileAccess.h>
+#include <casacore/casa/Arrays/Slicer.h>
+#include <casacore/casa/BasicMath/Math.h>
+#include <casacore/casa/IO/MMapfdIO.h>
+#include <casacore/casa/OS/CanonicalConversion.h>
+#include <casacore/casa/OS/HostInfo.h>
+#include <casacore/casa/Utilities/ValType.h>
+#include <casacore/casa/Exceptions/Error.h>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+
+namespace casacore { //# NAMESPACE CASACORE - BEGIN
+
+// The maximum number of pixels converted as a single block.
+static const Int64 FITSMappedBlockSize = 65536;
+
+// Read n values of type T (in canonical format) from every step-th
+// position into the buffer.
+template<typename T>
+inline void fitsMappedGather (T* to, const char* from, Int64 n, Int64 step)
+{
+  if (step == 1) {
+    CanonicalConversion::toLocal (to, from, n);
+  } else {
+    const Int64 incr = step * sizeof(T);
+    for (Int64 i=0; i<n; ++i) {
+      CanonicalConversion::toLocal (to[i], from + i*incr);
+    }
+  }
+}
+
+// Scale integer values and set blanked values to NaN.
+template<typename T>
+inline void fitsMappedScale (Float* to, const T* from, Int64 n,
+                             Float scale, Float offset, T blank,
+                             Bool hasBlanks)
+{
+  if (hasBlanks) {
+    Float nan;
+    setNaN (nan);
+    for (Int64 i=0; i<n; ++i) {
+      to[i] = (from[i] == blank  ?  nan : from[i] * scale + offset);
+    }
+  } else {
+    for (Int64 i=0; i<n; ++i) {
+      to[i] = from[i] * scale + offset;
+    }
+  }
+}
+
+
+FITSMappedData::FITSMappedData (const String& fileName, Int64 fileOffset,
+                                const IPosition& shape, DataType dataType,
+                                Float scale, Float offset,
+                                Int blank, Bool hasBlanks)
+: itsFD        (-1),
+  itsData      (0),
+  itsShape     (shape),
+  itsDataType  (dataType),
+  itsPixelSize (ValType::getTypeSize (dataType)),
+  itsScale     (scale),
+  itsOffset    (offset),
+  itsBlank     (blank),
+  itsHasBlanks (hasBlanks)
+{
+  if (dataType != TpFloat  &&  dataType != TpDouble  &&  dataType != TpInt
+  &&  dataType != TpShort  &&  dataType != TpUChar) {
+    throw AipsError ("FITSMappedData: unsupported data type for " + fileName);
+  }
+  itsFD = FiledesIO::open (fileName.chars(), False);
+  try {
+    itsFile.reset (new MMapfdIO (itsFD, fileName));
+    if (itsFile->getFileSize() < fileOffset + shape.product()*itsPixelSize) {
+      throw AipsError ("FITSMappedData: file " + fileName +
+                       " is too short for the data array");
+    }
+  } catch (...) {
+    itsFile.reset();
+    FiledesIO::close (itsFD);
+    throw;
+  }
+  itsData = static_cast<const char*>(itsFile->getReadPointer (fileOffset));
+  // Chunks of about 1M pixels, which are whole planes for most images.
+  itsChunkShape = TiledFileAccess::makeTileShape (shape, 1024*1024);
+}
+
+FITSMappedData::~FITSMappedData()
+{
+  itsFile.reset();
+  FiledesIO::close (itsFD);
+}
+
+const Float* FITSMappedData::directData() const
+{
+  if (itsDataType == TpFloat  &&  HostInfo::bigEndian()) {
+    return reinterpret_cast<const Float*>(itsData);
+  }
+  return 0;
+}
+
+void FITSMappedData::get (Array<Float>& buffer, const Slicer& section) const
+{
+  IPosition start, end, stride;
+  IPosition shp = section.inferShapeFromSource (itsShape, start, end, stride);
+  buffer.resize (shp);
+  if (shp.product() == 0) {
+    return;
+  }
+  const uInt ndim = shp.size();
+  // Determine the increments of the axes in the file (in pixels).
+  IPosition fileIncr(ndim);
+  Int64 incr = 1;
+  for (uInt i=0; i<ndim; ++i) {
+    fileIncr[i] = incr;
+    incr *= itsShape[i];
+  }
+  // Leading axes that are read entirely are contiguous in the file, so
+  // they are merged with the next axis into a single line.
+  uInt nlineAxes = 1;
+  Int64 lineLength = shp[0];
+  if (stride[0] == 1) {
+    while (nlineAxes < ndim  &&  shp[nlineAxes-1] == itsShape[nlineAxes-1]
+           &&  stride[nlineAxes] == 1) {
+      lineLength *= shp[nlineAxes];
+      ++nlineAxes;
+    }
+  }
+  Int64 lineOffset = 0;
+  for (uInt i=0; i<nlineAxes; ++i) {
+    lineOffset += start[i] * fileIncr[i];
+  }
+  const Int64 nlines = shp.product() / lineLength;
+  // Long lines are split into blocks.
+  const Int64 nblocks = (lineLength + FITSMappedBlockSize - 1) /
+                        FITSMappedBlockSize;
+  const Int64 nitems = nlines * nblocks;
+  const Int64 step = stride[0];
+  Bool deleteIt;
+  Float* data = buffer.getStorage (deleteIt);
+#ifdef _OPENMP
+#pragma omp parallel if (nitems > 1  &&  shp.product() >= FITSMappedBlockSize)
+#endif
+  {
+    std::vector<Double> work (std::min(lineLength, FITSMappedBlockSize));
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+    for (Int64 item=0; item<nitems; ++item) {
+      Int64 line  = item / nblocks;
+      Int64 block = item % nblocks;
+      // Get the file offset of the line from its position in the section.
+      Int64 offset = lineOffset;
+      Int64 rest = line;
+      for (uInt i=nlineAxes; i<ndim; ++i) {
+        Int64 pos = rest % shp[i];
+        rest /= shp[i];
+        offset += (start[i] + pos*stride[i]) * fileIncr[i];
+      }
+      Int64 first = block * FITSMappedBlockSize;
+      Int64 n = std::min (FITSMappedBlockSize, lineLength - first);
+      convertBlock (data + line*lineLength + first,
+                    itsData + (offset + first*step) * itsPixelSize,
+                    n, step, work.data());
+    }
+  }
+  buffer.putStorage (data, deleteIt);
+}
+
+void FITSMappedData::convertBlock (Float* to, const char* from, Int64 n,
+                                   Int64 step, void* work) const
+{
+  switch (itsDataType) {
+  case TpFloat:
+    fitsMappedGather (to, from, n, step);
+    break;
+  case TpDouble:
+    {
+      Double* tmp = static_cast<Double*>(work);
+      fitsMappedGather (tmp, from, n, step);
+      for (Int64 i=0; i<n; ++i) {
+        to[i] = tmp[i];
+      }
+    }
+    break;
+  case TpInt:
+    {
+      Int* tmp = static_cast<Int*>(work);
+      fitsMappedGather (tmp, from, n, step);
+      fitsMappedScale (to, tmp, n, itsScale, itsOffset, itsBlank,
+                       itsHasBlanks);
+    }
+    break;
+  case TpShort:
+    {
+      Short* tmp = static_cast<Short*>(work);
+      fitsMappedGather (tmp, from, n, step);
+      fitsMappedScale (to, tmp, n, itsScale, itsOffset, Short(itsBlank),
+                       itsHasBlanks);
+    }
+    break;
+  case TpUChar:
+    {
+      uChar* tmp = static_cast<uChar*>(work);
+      fitsMappedGather (tmp, from, n, step);
+      fitsMappedScale (to, tmp, n, itsScale, itsOffset, uChar(itsBlank),
+                       itsHasBlanks);
+    }
+    break;
+  default:
+    break;
+  }
+}
+
+void FITSMappedData::showCacheStatistics (ostream& os) const
+{
+  os << "memory-mapped, no cache" << endl;
+}
+
+
+
+FITSMappedMask::FITSMappedMask (const std::shared_ptr<FITSDataAccess>& data)
+: itsData       (data),
+  itsNCached    (0),
+  itsMaxCached  (64*1024*1024),
+  itsFilterZero (False)
+{
+  const IPosition& shp = itsData->shape();
+  const IPosition& chunkShape = itsData->chunkShape();
+  itsNChunks.resize (shp.size());
+  for (uInt i=0; i<shp.size(); ++i) {
+    itsNChunks[i] = (shp[i] + chunkShape[i] - 1) / chunkShape[i];
+  }
+  itsChunkStatus.resize (itsNChunks.product(), 0);
+}
+
+FITSMappedMask::FITSMappedMask (const FITSMappedMask& other)
+: Lattice<Bool>  (other),
+  itsData        (other.itsData),
+  itsNChunks     (other.itsNChunks),
+  itsChunkStatus (other.itsChunkStatus),
+  itsChunkMasks  (other.itsChunkMasks),
+  itsChunkOrder  (other.itsChunkOrder),
+  itsNCached     (other.itsNCached),
+  itsMaxCached   (other.itsMaxCached),
+  itsFilterZero  (other.itsFilterZero)
+{}
+
+FITSMappedMask::~FITSMappedMask()
+{}
+
+FITSMappedMask& FITSMappedMask::operator= (const FITSMappedMask& other)
+{
+  if (this != &other) {
+    itsData        = other.itsData;
+    itsNChunks.resize (other.itsNChunks.size());
+    itsNChunks     = other.itsNChunks;
+    itsChunkStatus = other.itsChunkStatus;
+    itsChunkMasks  = other.itsChunkMasks;
+    itsChunkOrder  = other.itsChunkOrder;
+    itsNCached     = other.itsNCached;
+    itsMaxCached   = other.itsMaxCached;
+    itsFilterZero  = other.itsFilterZero;
+  }
+  return *this;
+}
+
+Lattice<Bool>* FITSMappedMask::clone() const
+{
+  return new FITSMappedMask (*this);
+}
+
+Bool FITSMappedMask::isWritable() const
+{
+  return False;
+}
+
+IPosition FITSMappedMask::shape() const
+{
+  return itsData->shape();
+}
+
+IPosition FITSMappedMask::doNiceCursorShape (uInt) const
+{
+  return itsData->chunkShape();
+}
+
+void FITSMappedMask::setFilterZero (Bool filterZero)
+{
+  if (filterZero != itsFilterZero) {
+    itsFilterZero = filterZero;
+    clearCache();
+  }
+}
+
+void FITSMappedMask::clearCache()
+{
+  std::fill (itsChunkStatus.begin(), itsChunkStatus.end(), 0);
+  itsChunkMasks.clear();
+  itsChunkOrder.clear();
+  itsNCached = 0;
+}
+
+Int64 FITSMappedMask::makeMask (Bool* mask, const Float* data, Int64 n) const
+{
+  Int64 nmasked = 0;
+  const Bool filterZero = itsFilterZero;
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+:nmasked) if (n >= 65536)
+#endif
+  for (Int64 i=0; i<n; ++i) {
+    Bool valid = !(std::isnan(data[i])  ||  (filterZero && data[i] == 0));
+    mask[i] = valid;
+    nmasked += (valid ? 0 : 1);
+  }
+  return nmasked;
+}
+
+const Array<Bool>* FITSMappedMask::chunkMask (Int64 chunkNr,
+                                              const IPosition& chunkStart)
+{
+  if (itsChunkStatus[chunkNr] == 1) {
+    return 0;
+  }
+  if (itsChunkStatus[chunkNr] == 2) {
+    std::map<Int64,Array<Bool>>::const_iterator iter =
+      itsChunkMasks.find (chunkNr);
+    if (iter != itsChunkMasks.end()) {
+      return &(iter->second);
+    }
+  }
+  // Make the mask of the chunk (which can be smaller at the edges).
+  IPosition shp = min (itsData->chunkShape(), itsData->shape() - chunkStart);
+  Array<Float> data;
+  itsData->get (data, Slicer(chunkStart, shp));
+  Array<Bool> mask(shp);
+  Bool deleteData, deleteMask;
+  const Float* dataPtr = data.getStorage (deleteData);
+  Bool* maskPtr = mask.getStorage (deleteMask);
+  Int64 nmasked = makeMask (maskPtr, dataPtr, mask.nelements());
+  data.freeStorage (dataPtr, deleteData);
+  mask.putStorage (maskPtr, deleteMask);
+  if (nmasked == 0) {
+    itsChunkStatus[chunkNr] = 1;
+    return 0;
+  }
+  itsChunkStatus[chunkNr] = 2;
+  // Remove the oldest chunks if the cache gets too large.
+  while (!itsChunkOrder.empty()  &&
+         itsNCached + Int64(mask.nelements()) > itsMaxCached) {
+    std::map<Int64,Array<Bool>>::iterator iter =
+      itsChunkMasks.find (itsChunkOrder.front());
+    itsNCached -= iter->second.nelements();
+    itsChunkMasks.erase (iter);
+    itsChunkOrder.pop_front();
+  }
+  itsNCached += mask.nelements();
+  itsChunkOrder.push_back (chunkNr);
+  return &(itsChunkMasks[chunkNr] = mask);
+}
+
+Bool FITSMappedMask::doGetSlice (Array<Bool>& buffer, const Slicer& section)
+{
+  const IPosition& latShape = itsData->shape();
+  const IPosition& chunkShape = itsData->chunkShape();
+  IPosition start, end, stride;
+  IPosition shp = section.inferShapeFromSource (latShape, start, end, stride);
+  buffer.resize (shp);
+  if (shp.product() == 0) {
+    return False;
+  }
+  const uInt ndim = shp.size();
+  const IPosition firstChunk = start / chunkShape;
+  const IPosition lastChunk  = end / chunkShape;
+  // Step through the chunks touched by the section. The function is
+  // called with the chunk number and start; it stops if it returns False.
+  auto forEachChunk = [&] (const std::function<Bool(Int64, const IPosition&)>& func)
+  {
+    IPosition chunk(firstChunk);
+    while (True) {
+      Int64 chunkNr = 0;
+      Int64 incr = 1;
+      for (uInt i=0; i<ndim; ++i) {
+        chunkNr += chunk[i] * incr;
+        incr *= itsNChunks[i];
+      }
+      if (!func (chunkNr, chunk*chunkShape)) {
+        return False;
+      }
+      uInt ax = 0;
+      for (; ax<ndim; ++ax) {
+        if (++chunk[ax] <= lastChunk[ax]) break;
+        chunk[ax] = firstChunk[ax];
+      }
+      if (ax == ndim) {
+        return True;
+      }
+    }
+  };
+  // If all chunks are known to have no masked pixels, no data need to be read.
+  if (forEachChunk ([&] (Int64 chunkNr, const IPosition&)
+                    { return itsChunkStatus[chunkNr] == 1; })) {
+    buffer = True;
+    return False;
+  }
+  // Use the chunk cache for larger sections without strides.
+  if (stride.allOne()  &&  4*shp.product() >= chunkShape.product()) {
+    forEachChunk ([&] (Int64 chunkNr, const IPosition& chunkStart)
+    {
+      const Array<Bool>* mask = chunkMask (chunkNr, chunkStart);
+      IPosition blc = max (start, chunkStart);
+      IPosition trc = min (end, chunkStart + chunkShape - 1);
+      Array<Bool> part (buffer(Slicer(blc - start, trc - start,
+                                      Slicer::endIsLast)));
+      if (mask) {
+        part.assign_conforming ((*mask)(Slicer(blc - chunkStart,
+                                               trc - chunkStart,
+                                               Slicer::endIsLast)));
+      } else {
+        part = True;
+      }
+      return True;
+    });
+    return False;
+  }
+  Array<Float> data;
+  itsData->get (data, section);
+  Bool deleteData, deleteMask;
+  const Float* dataPtr = data.getStorage (deleteData);
+  Bool* maskPtr = buffer.getStorage (deleteMask);
+  makeMask (maskPtr, dataPtr, buffer.nelements());
+  data.freeStorage (dataPtr, deleteData);
+  buffer.putStorage (maskPtr, deleteMask);
+  return False;
+}
+
+void FITSMappedMask::doPutSlice (const Array<Bool>&,
+                                 const IPosition&,
+                                 const IPosition&)
+{
+  throw AipsError ("FITSMappedMask object is not writable");
+}
+
+
+} //# NAMESPACE CASACORE - END
@@ -0,0 +1,248 @@
+//# FITSMappedData.h: Memory-mapped access to the data unit of a FITS image
+//# Copyright (C) 2026
+//# Associated Universities, Inc. Washington DC, USA.
+//#
+//# This library is free software; you can redistribute it and/or modify it
+//# under the terms of the GNU Library General Public License as published by
+//# the Free Software Foundation; either version 2 of the License, or (at your
+//# option) any later version.
+//#
+//# This library is distributed in the hope that it will be useful, but WITHOUT
+//# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+//# License for more details.
+//#
+//# You should have received a copy of the GNU Library General Public License
+//# along with this library; if not, write to the Free Software Foundation,
+//# Inc., 675 Massachusetts Ave, Cambridge, MA 02139, USA.
+//#
+//# Correspondence concerning AIPS++ should be addressed as follows:
+//#        Internet email: aips2-request@nrao.edu.
+//#        Postal address: AIPS++ Project Office
+//#                        National Radio Astronomy Observatory
+//#                        520 Edgemont Road
+//#                        Charlottesville, VA 22903-2475 USA
+
+#ifndef IMAGES_FITSMAPPEDDATA_H
+#define IMAGES_FITSMAPPEDDATA_H
+
+//# Includes
+#include <casacore/casa/aips.h>
+#include <casacore/casa/Arrays/Array.h>
+#include <casacore/casa/Arrays/IPosition.h>
+#include <casacore/casa/BasicSL/String.h>
+#include <casacore/casa/Utilities/DataType.h>
+#include <casacore/images/Images/FITSDataAccess.h>
+#include <casacore/lattices/Lattices/Lattice.h>
+#include <deque>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace casacore { //# NAMESPACE CASACORE - BEGIN
+
+//# Forward Declarations
+class MMapfdIO;
+class Slicer;
+
+
+// <summary>
+// Memory-mapped access to the data unit of a FITS image.
+// </summary>
+
+// <use visibility=local>
+
+// <reviewed reviewer="" date="" tests="tFITSImage.cc">
+// </reviewed>
+
+// <prerequisite>
+//   <li> <linkto class=FITSImage>FITSImage</linkto>
+//   <li> <linkto class=MMapfdIO>MMapfdIO</linkto>
+// </prerequisite>
+
+// <synopsis>
+// FITSMappedData maps the entire FITS file into memory and gives access
+// to the (big-endian) data array of an image HDU as Float values.
+// The data array in a FITS file is stored contiguously in the same
+// (Fortran) order as a casacore Array, so a section can be located
+// directly without going through a tiled storage manager and its cache.
+// <p>
+// Getting a section converts the data in blocks of at most 64K pixels,
+// which are distributed over the OpenMP threads. Leading axes read entirely
+// are merged, so reading a plane results in a few large blocks.
+// The conversion loops (byte swap, BSCALE/BZERO and replacing BLANK values
+// by a NaN) are simple, so the compiler can vectorize them.
+// The result is bit-identical to that of
+// <linkto class=TiledFileAccess>TiledFileAccess</linkto>.
+// <p>
+// If the data are 32-bit floats on a big-endian host, they can be used
+// as is; function <src>directData</src> gives a pointer to them.
+// </synopsis>
+
+// <motivation>
+// Reading large FITS cubes plane by plane through TiledFileAccess is slow.
+// </motivation>
+
+class FITSMappedData : public FITSDataAccess
+{
+public:
+  // Map the file and check it is large enough to hold the data array
+  // starting at the given offset.
+  // For integer data types the values are scaled as
+  // <src>value*scale + offset</src>. If <src>hasBlanks</src> is set,
+  // pixels with the value <src>blank</src> are set to a NaN.
+  // An exception is thrown if the file cannot be mapped.
+  FITSMappedData (const String& fileName, Int64 fileOffset,
+                  const IPosition& shape, DataType dataType,
+                  Float scale=1, Float offset=0,
+                  Int blank=0, Bool hasBlanks=False);
+
+  // Unmap and close the file.
+  virtual ~FITSMappedData();
+
+  // Forbid copy constructor and assignment.
+  // <group>
+  FITSMappedData (const FITSMappedData&) = delete;
+  FITSMappedData& operator= (const FITSMappedData&) = delete;
+  // </group>
+
+  // Get the shape of the data array.
+  virtual const IPosition& shape() const
+    { return itsShape; }
+
+  // Get the data type in the file.
+  DataType dataType() const
+    { return itsDataType; }
+
+  // Get the shape of the chunks used for the mask cache.
+  // It is also a good cursor shape for iterating through the image.
+  virtual const IPosition& chunkShape() const
+    { return itsChunkShape; }
+
+  // Get a pointer to the data if they can be used without conversion
+  // (Float data on a big-endian host). Otherwise a null pointer is returned.
+  // The pointer is only valid as long as this object exists.
+  virtual const Float* directData() const;
+
+  // Get a section of the data converted to Float.
+  // The buffer is resized if needed.
+  virtual void get (Array<Float>& buffer, const Slicer& section) const;
+
+  // The data are not cached.
+  virtual void showCacheStatistics (ostream& os) const;
+
+private:
+  // Convert a block of <src>n</src> pixels taking every <src>step</src>-th
+  // pixel starting at the given file data pointer.
+  // The work buffer must be able to hold <src>n</src> Doubles.
+  void convertBlock (Float* to, const char* from, Int64 n, Int64 step,
+                     void* work) const;
+
+  std::unique_ptr<MMapfdIO> itsFile;
+  int        itsFD;
+  const char* itsData;
+  IPosition  itsShape;
+  IPosition  itsChunkShape;
+  DataType   itsDataType;
+  uInt       itsPixelSize;
+  Float      itsScale;
+  Float      itsOffset;
+  Int        itsBlank;
+  Bool       itsHasBlanks;
+};
+
+
+// <summary>
+// The pixel mask of a FITS image accessed through FITSDataAccess.
+// </summary>
+
+// <use visibility=local>
+
+// <reviewed reviewer="" date="" tests="tFITSImage.cc">
+// </reviewed>
+
+// <prerequisite>
+//   <li> <linkto class=FITSDataAccess>FITSDataAccess</linkto>
+//   <li> <linkto class=FITSMask>FITSMask</linkto>
+// </prerequisite>
+
+// <synopsis>
+// This class does the same as <linkto class=FITSMask>FITSMask</linkto>,
+// but for an image accessed through a FITSDataAccess object (a memory-mapped
+// or a tile-compressed image). A pixel is masked
+// if its value is a NaN (thus also an integer BLANK value) and optionally
+// if it is 0.
+// <p>
+// The mask is cached in chunks of <src>FITSDataAccess::chunkShape()</src>.
+// For each chunk it is remembered if it has masked pixels. A chunk without
+// masked pixels takes no memory, so sections containing only such chunks
+// are filled without reading any data. The masks of chunks with masked
+// pixels are kept up to a maximum of 64 MBytes; the oldest chunk is removed
+// first. Small or strided sections bypass the cache.
+// </synopsis>
+
+class FITSMappedMask : public Lattice<Bool>
+{
+public:
+  // Create the mask for the given data.
+  explicit FITSMappedMask (const std::shared_ptr<FITSDataAccess>& data);
+
+  // Copy constructor (reference semantics for the data; the cache is copied).
+  FITSMappedMask (const FITSMappedMask& other);
+
+  virtual ~FITSMappedMask();
+
+  // Assignment (reference semantics for the data; the cache is copied).
+  FITSMappedMask& operator= (const FITSMappedMask& other);
+
+  // Make a copy of the object (reference semantics).
+  virtual Lattice<Bool>* clone() const;
+
+  // The mask is not writable.
+  virtual Bool isWritable() const;
+
+  // Return the shape of the mask.
+  virtual IPosition shape() const;
+
+  // Get a section of the mask.
+  virtual Bool doGetSlice (Array<Bool>& buffer, const Slicer& section);
+
+  // Throws an exception, because the mask is not writable.
+  virtual void doPutSlice (const Array<Bool>& sourceBuffer,
+                           const IPosition& where,
+                           const IPosition& stride);
+
+  // The chunk shape is a nice cursor shape.
+  virtual IPosition doNiceCursorShape (uInt maxPixels) const;
+
+  // Set the switch for also masking values 0.0 (besides NaNs).
+  // It clears the cache if the switch changes.
+  void setFilterZero (Bool filterZero);
+
+private:
+  // Make the mask for the given data values. It returns the number of
+  // masked pixels.
+  Int64 makeMask (Bool* mask, const Float* data, Int64 n) const;
+
+  // Get the mask of the given chunk. A null pointer is returned if the
+  // chunk has no masked pixels.
+  const Array<Bool>* chunkMask (Int64 chunkNr, const IPosition& chunkStart);
+
+  // Clear the cache.
+  void clearCache();
+
+  std::shared_ptr<FITSDataAccess> itsData;
+  IPosition                       itsNChunks;
+  //# Per chunk: 0 = unknown, 1 = no masked pixels, 2 = has masked pixels.
+  std::vector<uChar>              itsChunkStatus;
+  std::map<Int64,Array<Bool>>     itsChunkMasks;
+  std::deque<Int64>               itsChunkOrder;
+  Int64                           itsNCached;
+  Int64                           itsMaxCached;
+  Bool                            itsFilterZero;
+};
+
+
+} //# NAMESPACE CASACORE - END
+
+#endif
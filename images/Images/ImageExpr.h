@@ -181,6 +181,10 @@ public:
 			   const IPosition& where,
 			   const IPosition& stride);
 
+  // Copy the data to the given lattice using the (parallel) evaluation
+  // of the lattice expression.
+  virtual void copyDataTo (Lattice<T>& to) const;
+
   // If the object is persistent, the file name is given.
   // Otherwise it returns the expression string given in the constructor.
   virtual String name (Bool stripPath=False) const;
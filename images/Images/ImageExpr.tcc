@@ -288,6 +288,13 @@ Bool ImageExpr<T>::doGetMaskSlice (Array<Bool>& buffer, const Slicer& section)
 }
 
 
+template <class T>
+void ImageExpr<T>::copyDataTo (Lattice<T>& to) const
+{
+  latticeExpr_p.copyDataTo (to);
+}
+
+
 template <class T>
 Bool ImageExpr<T>::lock (FileLocker::LockType type, uInt nattempts)
 {
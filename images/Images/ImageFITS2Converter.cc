@@ -68,11 +68,138 @@
 #include <casacore/casa/sstream.h>
 #include <casacore/casa/iomanip.h>
 
+#include <deque>
+#include <vector>
+#ifdef USE_THREADS
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
 
 namespace casacore { //# NAMESPACE CASACORE - BEGIN
 
   const String ImageFITSConverter::CASAMBM = "casambm";
 
+  // Writes the data chunks of an HDU (already in FITS format) in order.
+  // If threads are used, the chunks are written by a separate thread, so
+  // the next chunk can be read and converted in the meantime.
+  // At most two chunks are queued; their buffers are reused.
+  class ImageFITSChunkWriter
+  {
+  public:
+    ImageFITSChunkWriter (HeaderDataUnit& hdu, FitsOutput& out)
+      : itsHDU  (hdu),
+        itsOut  (out),
+        itsOK   (True)
+#ifdef USE_THREADS
+        , itsDone (False)
+#endif
+    {
+#ifdef USE_THREADS
+      itsThread = std::thread (&ImageFITSChunkWriter::run, this);
+#endif
+    }
+
+    ~ImageFITSChunkWriter()
+      { finish(); }
+
+    // Get a buffer of the given size to convert the next chunk into.
+    std::vector<char> getBuffer (size_t nbytes)
+    {
+      std::vector<char> buf;
+#ifdef USE_THREADS
+      std::lock_guard<std::mutex> lock(itsMutex);
+      if (!itsFree.empty()) {
+        buf = std::move (itsFree.back());
+        itsFree.pop_back();
+      }
+#endif
+      buf.resize (nbytes);
+      return buf;
+    }
+
+    // Write a chunk (or queue it for writing).
+    // It returns False if writing has failed.
+    Bool put (std::vector<char>& buf)
+    {
+#ifdef USE_THREADS
+      std::unique_lock<std::mutex> lock(itsMutex);
+      itsCond.wait (lock, [this] { return itsQueue.size() < 2; });
+      itsQueue.push_back (std::move(buf));
+      itsCond.notify_all();
+      return itsOK;
+#else
+      return itsOK = (itsOK && writeChunk(buf));
+#endif
+    }
+
+    // Wait until all chunks are written.
+    // It returns False if writing has failed.
+    Bool finish()
+    {
+#ifdef USE_THREADS
+      if (itsThread.joinable()) {
+        {
+          std::lock_guard<std::mutex> lock(itsMutex);
+          itsDone = True;
+        }
+        itsCond.notify_all();
+        itsThread.join();
+      }
+#endif
+      return itsOK;
+    }
+
+  private:
+    Bool writeChunk (std::vector<char>& buf)
+    {
+      return (itsHDU.write_data (itsOut, buf.data(), buf.size()) == 0  &&
+              !itsOut.err());
+    }
+
+#ifdef USE_THREADS
+    void run()
+    {
+      std::unique_lock<std::mutex> lock(itsMutex);
+      while (True) {
+        itsCond.wait (lock, [this] { return !itsQueue.empty() || itsDone; });
+        if (itsQueue.empty()) {
+          break;
+        }
+        std::vector<char> buf (std::move (itsQueue.front()));
+        itsQueue.pop_front();
+        itsCond.notify_all();
+        // After a failure the remaining chunks are discarded.
+        if (itsOK) {
+          lock.unlock();
+          Bool ok;
+          try {
+            ok = writeChunk (buf);
+          } catch (...) {
+            ok = False;
+          }
+          lock.lock();
+          itsOK = itsOK && ok;
+        }
+        itsFree.push_back (std::move(buf));
+      }
+    }
+#endif
+
+    HeaderDataUnit& itsHDU;
+    FitsOutput&     itsOut;
+    Bool            itsOK;
+#ifdef USE_THREADS
+    Bool                          itsDone;
+    std::deque<std::vector<char>> itsQueue;
+    std::vector<std::vector<char>> itsFree;
+    std::mutex                    itsMutex;
+    std::condition_variable       itsCond;
+    std::thread                   itsThread;
+#endif
+  };
+
   Bool ImageFITSConverter::FITSToImage
   (ImageInterface<Float> *&newImage, String &error,
    const String &imageName, const String &fitsName,
@@ -1349,140 +1476,107 @@ namespace casacore { //# NAMESPACE CASACORE - BEGIN
         AlwaysAssert(0, AipsError); // NOTREACHED
       }
 
-      Short *buffer16 = 0; // Use this to write the scaled shorts into
-      if (fits16) {
-        buffer16 = new Short[bufferSize];
-        AlwaysAssert(buffer16, AipsError);
-      }
       //
-      // Iterate through the image.
+      // Iterate through the image. Each chunk is converted to FITS format
+      // (in parallel) and handed to the writer, which writes it while the
+      // next chunk is read and converted.
       //
-      for (iter.reset(); !iter.atEnd(); iter++) {
-        const Array<Float>& cursor = iter.cursor();
-        Bool deletePtr;
-        const Float* ptr = cursor.getStorage(deletePtr);
-        //
-        const Bool* maskPtr = 0;
-        Bool deleteMaskPtr;
-        if (fhi.applyMask) {
-          if (!fhi.pMask->shape().isEqual(cursor.shape())) {
-            fhi.pMask->resize(cursor.shape());
-          }
-          (*fhi.pMask) = iter.getMask(False);
-          maskPtr = fhi.pMask->getStorage(deleteMaskPtr);
-        }
-        //
-        //       pMeter->update((count*1.0 - 0.5)*curpixels);
-        //
-        const uInt nPts = cursor.nelements();
-        error= "";
-        Int n = 0;
-        if (fits32) {
+      HeaderDataUnit* hdu = fits32;
+      if (fits16) hdu = fits16;
+      const uInt fitsPixelSize = (fits32 ? sizeof(Float) : sizeof(Short));
+      const Int blockSize = 65536;
+      const Int nBlocks = (bufferSize + blockSize - 1) / blockSize;
+      Bool writeOK = True;
+      {
+        ImageFITSChunkWriter writer(*hdu, *outfile);
+        for (iter.reset(); !iter.atEnd(); iter++) {
+          const Array<Float>& cursor = iter.cursor();
+          Bool deletePtr;
+          const Float* ptr = cursor.getStorage(deletePtr);
+          //
+          const Bool* maskPtr = 0;
+          Bool deleteMaskPtr;
           if (fhi.applyMask) {
-            Float* ptr2 = new float[nPts];
-            for (uInt j=0; j<nPts; j++) {
-              if (maskPtr[j]) {
-                ptr2[j] = ptr[j];
-              }
-              else {
-                ptr2[j] = ptr[j];
-                setNaN(ptr2[j]);
-              }
-            }
-            fits32->store(ptr2, bufferSize);
-            delete [] ptr2;
-          }
-          else {
-            fits32->store(ptr, bufferSize);
-          }
-          Int hduErr = 0;
-          if (!(hduErr = fits32->err())){
-            n = fits32->write(*outfile);
-            if (n != bufferSize) {
-              delete outfile;
-              error = "Write failed (full disk or tape?)";
-              return False;
+            if (!fhi.pMask->shape().isEqual(cursor.shape())) {
+              fhi.pMask->resize(cursor.shape());
             }
-          } else {
-            error = "ImageFITS2Converter: Storing FITS primary Float array failed with HDU error code "
-              + String::toString(hduErr);
-            return False;
+            (*fhi.pMask) = iter.getMask(False);
+            maskPtr = fhi.pMask->getStorage(deleteMaskPtr);
           }
-        }
-        else if (fits16) {
-          short blankOffset = fhi.hasBlanks ? 1 : 0;
           //
-          if (fhi.applyMask) {
-            for (Int j=0; j<bufferSize; j++) {
-              //                    if (ptr[j] != ptr[j] || maskPtr[j]) {
-              if (isNaN(ptr[j]) || !maskPtr[j]) {
-                buffer16[j] = fhi.minshort;
-              } else {
-                if (ptr[j] > fhi.maxPix) {
-                  buffer16[j] = fhi.maxshort;
-                } else if (ptr[j] < fhi.minPix) {
-                  buffer16[j] = fhi.minshort + blankOffset;
-                } else {
-                  buffer16[j] = Short((ptr[j] - fhi.bzero)/fhi.bscale);
+          std::vector<char> fitsBuffer =
+            writer.getBuffer (size_t(bufferSize) * fitsPixelSize);
+          if (fits32) {
+            Float* buffer32 = reinterpret_cast<Float*>(fitsBuffer.data());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) if (nBlocks > 1)
+#endif
+            for (Int blk=0; blk<nBlocks; blk++) {
+              const Int first = blk * blockSize;
+              const Int last  = min(first + blockSize, bufferSize);
+              for (Int j=first; j<last; j++) {
+                buffer32[j] = ptr[j];
+                if (maskPtr  &&  !maskPtr[j]) {
+                  setNaN(buffer32[j]);
                 }
               }
+              FITS::l2f(buffer32 + first, buffer32 + first, last - first);
             }
           }
-          else {
-            for (Int j=0; j<bufferSize; j++) {
-              //                    if (ptr[j] != ptr[j]) {
-              if (isNaN(ptr[j])) {
-                buffer16[j] = fhi.minshort;
-              } else {
-                if (ptr[j] > fhi.maxPix) {
-                  buffer16[j] = fhi.maxshort;
-                } else if (ptr[j] < fhi.minPix) {
-                  buffer16[j] = fhi.minshort + blankOffset;
+          else if (fits16) {
+            Short* buffer16 = reinterpret_cast<Short*>(fitsBuffer.data());
+            const short blankOffset = fhi.hasBlanks ? 1 : 0;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) if (nBlocks > 1)
+#endif
+            for (Int blk=0; blk<nBlocks; blk++) {
+              const Int first = blk * blockSize;
+              const Int last  = min(first + blockSize, bufferSize);
+              for (Int j=first; j<last; j++) {
+                if (isNaN(ptr[j]) || (maskPtr && !maskPtr[j])) {
+                  buffer16[j] = fhi.minshort;
                 } else {
-                  buffer16[j] = Short((ptr[j] - fhi.bzero)/fhi.bscale);
+                  if (ptr[j] > fhi.maxPix) {
+                    buffer16[j] = fhi.maxshort;
+                  } else if (ptr[j] < fhi.minPix) {
+                    buffer16[j] = fhi.minshort + blankOffset;
+                  } else {
+                    buffer16[j] = Short((ptr[j] - fhi.bzero)/fhi.bscale);
+                  }
                 }
               }
-            }
-          }
-          fits16->store(buffer16, bufferSize);
-          Int hduErr = 0;
-          if (!(hduErr = fits16->err())) {
-            n = fits16->write(*outfile);
-            if (n != bufferSize) {
-              delete outfile;
-              error = "Write failed (full disk or tape?";
-              return False;
+              FITS::l2f(buffer16 + first, buffer16 + first, last - first);
             }
           }
           else {
-            error = "ImageFITS2Converter: Storing FITS primary Short array failed with HDU error code "
-              + String::toString(hduErr);
-            return False;
+            AlwaysAssert(0, AipsError); // NOTREACHED
           }
+          //
+          cursor.freeStorage(ptr, deletePtr);
+          if (fhi.applyMask) fhi.pMask->freeStorage(maskPtr, deleteMaskPtr);
+          //
+          if (!writer.put(fitsBuffer)) {
+            writeOK = False;
+            break;
+          }
+          count++;
+          if (verbose) pMeter->update(count*curpixels);
         }
-        else {
-          AlwaysAssert(0, AipsError); // NOTREACHED
-        }
-        //
-        cursor.freeStorage(ptr, deletePtr);
-        if (fhi.applyMask) fhi.pMask->freeStorage(maskPtr, deleteMaskPtr);
-        //
-        if ((fits32 && fits32->err()) ||
-            (fits16 && fits16->err()) ||
-            outfile->err()) {
-          error = String("Error writing into file!");
-          delete outfile;
-          return False;
-        }
-        count++;
-        if (verbose) pMeter->update(count*curpixels);
+        writeOK = writer.finish() && writeOK;
+      }
+      if (!writeOK) {
+        error = String("Error writing into file (full disk or tape?)");
+        delete fits32;
+        delete fits16;
+        delete pMeter;
+        delete outfile;
+        return False;
       }
       if (fits32) {
         delete fits32; fits32 = 0;
       }
       else if (fits16) {
         delete fits16; fits16 = 0;
-        delete buffer16; buffer16 = 0;
       }
       else {
         AlwaysAssert(0, AipsError); // NOTREACHED
@@ -204,6 +204,10 @@ namespace casacore { //# NAMESPACE CASACORE - BEGIN
                             Bool zeroBlanks=False);
 
     // Convert a Casacore image to a FITS file.
+    // The image is read in chunks, which are converted to FITS format in
+    // parallel (if OpenMP is used). If casacore is built with thread
+    // support, a separate thread writes the converted chunks, so reading
+    // and writing overlap.
     // <ul>
     //   <li> <src>return</src> True if the conversion succeeds, False 
     //        otherwise.
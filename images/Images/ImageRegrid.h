@@ -185,6 +185,14 @@ public:
   // Enable/disable Measures Reference conversions
   void disableReferenceConversions(Bool disable=True) {itsDisableConversions = disable;};
 
+  // Set the tolerance (in input pixels) of the 2-D coordinate grid.
+  // If positive and no decimation is given to <src>regrid</src>, the
+  // coordinate grid is computed on a coarse grid which is refined until
+  // the bilinearly interpolated coordinates differ less than the tolerance
+  // from those of the next finer grid. The edge pixels are always
+  // converted exactly. The default 0 means exact conversion of all pixels.
+  void setCoordinateGridTolerance(Double tolerance=0) {itsCoordinateGridTolerance = tolerance;};
+
   // Helper function.  We are regridding from cSysFrom to cSysTo for the
   // specified pixel axes of cSyFrom. This function returns a CoordinateSystem which,
   // for the pixel axes being regridded, copies the coordinates from cSysTo
@@ -222,7 +230,11 @@ public:
   Cube<Double> itsUser2DCoordinateGrid;
   Matrix<Bool> itsUser2DCoordinateGridMask;
   Bool itsNotify;
+  Double itsCoordinateGridTolerance;
 //  
+  // Get the increment of the sparse grid for the given decimation factor.
+  static uInt decimationIncrement (uInt n, uInt decimate);
+//
   // Check shape and axes.  Exception if no good.  If pixelAxes
   // of length 0, set to all axes according to shape
   void _checkAxes(IPosition& outPixelAxes,
@@ -340,8 +352,8 @@ public:
                  Bool useMachine, Bool showProgress);
 
 //
-   void regrid2DMatrix(Lattice<T>& outCursor,
-                       LatticeIterator<Bool>*& outMaskIterPtr,
+   void regrid2DMatrix(Array<T>& outCursor,
+                       Array<Bool>* outMaskCursorPtr,
                        const Interpolate2D& interp,  
                                     ProgressMeter*& pProgress,
                                     Double& iPix,
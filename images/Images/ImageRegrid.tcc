@@ -42,8 +42,14 @@
 #include <casacore/scimath/Mathematics/InterpolateArray1D.h>
 #include <casacore/casa/System/ProgressMeter.h>
 
+#include <casacore/casa/OS/HostInfo.h>
+#include <casacore/casa/OS/OMP.h>
+
 #include <casacore/casa/sstream.h>
 #include <casacore/casa/fstream.h>
+#include <algorithm>
+#include <exception>
+#include <vector>
 
 namespace casacore { //# NAMESPACE CASACORE - BEGIN
 
@@ -51,14 +57,16 @@ template<class T>
 ImageRegrid<T>::ImageRegrid()
 : itsShowLevel(0),
   itsDisableConversions(False),
-  itsNotify(False)
+  itsNotify(False),
+  itsCoordinateGridTolerance(0)
 {;}
 
 template<class T>
 ImageRegrid<T>::ImageRegrid(const ImageRegrid& other)  
 : itsShowLevel(other.itsShowLevel),
   itsDisableConversions(other.itsDisableConversions),
-  itsNotify(other.itsNotify)
+  itsNotify(other.itsNotify),
+  itsCoordinateGridTolerance(other.itsCoordinateGridTolerance)
 {;}
 
 
@@ -73,10 +81,22 @@ ImageRegrid<T>& ImageRegrid<T>::operator=(const ImageRegrid& other)
     itsShowLevel = other.itsShowLevel;
     itsDisableConversions = other.itsDisableConversions;
     itsNotify = other.itsNotify;
+    itsCoordinateGridTolerance = other.itsCoordinateGridTolerance;
   }
   return *this;
 }
 
+template<class T>
+uInt ImageRegrid<T>::decimationIncrement (uInt n, uInt decimate)
+{
+  // Same increment as used in make2DCoordinateGrid.
+  Int nOut = n / decimate;
+  if (nOut <= 1) {
+    return 1;
+  }
+  return std::max(1u, n / (nOut - 1));
+}
+
 template<class T>
 void ImageRegrid<T>::regrid(
 	ImageInterface<T>& outImage,
@@ -809,6 +829,25 @@ void ImageRegrid<T>::regridTwoAxisCoordinate (
 	niceShape=1;
 	niceShape(xOutAxis)=outLattice.shape()(xOutAxis);
 	niceShape(yOutAxis)=outLattice.shape()(yOutAxis);
+	// Hold as many planes as there are threads (if memory allows),
+	// so regrid2DMatrix can interpolate them in parallel.
+	{
+		const Double planeSize = Double(niceShape.product()) *
+				(2*sizeof(T) + (outIsMasked ? 1 : 0) + (inIsMasked ? 1 : 0));
+		const Double maxPlanes = Double(HostInfo::memoryFree()) * 1024 / 4 /
+				planeSize;
+		Int64 nPlanes = std::max(Int64(1), std::min(Int64(OMP::maxThreads()),
+				Int64(maxPlanes)));
+		for (uInt k=0; k<outShape.nelements() && nPlanes>1; k++) {
+			if (k != xOutAxis  &&  k != yOutAxis) {
+				niceShape(k) = std::min<Int64>(nPlanes, outShape(k));
+				if (niceShape(k) < outShape(k)) {
+					break;
+				}
+				nPlanes /= niceShape(k);
+			}
+		}
+	}
 
 	LatticeStepper outStepper(outShape, niceShape, LatticeStepper::RESIZE);
 
@@ -924,14 +963,90 @@ void ImageRegrid<T>::regridTwoAxisCoordinate (
 			its2DCoordinateGridMask.set(True);
 		}
 		else {
-			make2DCoordinateGrid (os, allFailed, missedIt, minInX, minInY, maxInX,
-					maxInY,
-					its2DCoordinateGrid, its2DCoordinateGridMask,
-					inCoords, outCoords, inCoordinate, outCoordinate,
-					xInAxis, yInAxis, xOutAxis,
-					yOutAxis,
-					inPixelAxes, outPixelAxes, inShape, outPosFull,
-					outShape, decimate);
+			auto makeGrid = [&] (Cube<Double>& grid, Matrix<Bool>& gridMask,
+					Bool& failed, Bool& missed,
+					const IPosition& pos, const IPosition& shape,
+					uInt dec) {
+				Double x0, y0, x1, y1;
+				make2DCoordinateGrid (os, failed, missed, x0, y0, x1, y1,
+						grid, gridMask,
+						inCoords, outCoords, inCoordinate, outCoordinate,
+						xInAxis, yInAxis, xOutAxis,
+						yOutAxis,
+						inPixelAxes, outPixelAxes, inShape, pos,
+						shape, dec);
+			};
+			const uInt ni = outShape(xOutAxis);
+			const uInt nj = outShape(yOutAxis);
+			uInt dec = 0;
+			if (decimate == 0  &&  itsCoordinateGridTolerance > 0) {
+				dec = std::min(32u, std::min(ni, nj) / 8);
+			}
+			if (dec < 2) {
+				makeGrid (its2DCoordinateGrid, its2DCoordinateGridMask,
+						allFailed, missedIt, outPosFull, outShape, decimate);
+			} else {
+				// Start with a coarse grid and refine it until the
+				// (bilinearly interpolated) coordinates differ less than
+				// the tolerance from those of the next finer grid.
+				makeGrid (its2DCoordinateGrid, its2DCoordinateGridMask,
+						allFailed, missedIt, outPosFull, outShape, dec);
+				while (dec > 1) {
+					uInt finer = (dec >= 4  ?  dec/2 : 0);
+					Cube<Double> grid(shapeGrid);
+					Matrix<Bool> gridMask(ni, nj);
+					makeGrid (grid, gridMask, allFailed, missedIt,
+							outPosFull, outShape, finer);
+					Double maxDiff = 0;
+					for (uInt j=0; j<nj; ++j) {
+						for (uInt i=0; i<ni; ++i) {
+							if (gridMask(i,j)  &&  its2DCoordinateGridMask(i,j)) {
+								maxDiff = std::max(maxDiff, std::max(
+										abs(grid(i,j,0) - its2DCoordinateGrid(i,j,0)),
+										abs(grid(i,j,1) - its2DCoordinateGrid(i,j,1))));
+							}
+						}
+					}
+					its2DCoordinateGrid.reference (grid);
+					its2DCoordinateGridMask.reference (gridMask);
+					dec = finer;
+					if (maxDiff <= itsCoordinateGridTolerance) {
+						break;
+					}
+				}
+				if (dec > 1) {
+					// A decimated grid does not reach the right and top edge;
+					// convert the remaining edge pixels exactly.
+					const uInt lastI = ni - 1 - (ni-1) % decimationIncrement(ni, dec);
+					const uInt lastJ = nj - 1 - (nj-1) % decimationIncrement(nj, dec);
+					for (uInt edge=0; edge<2; ++edge) {
+						IPosition edgePos(outPosFull);
+						IPosition edgeShape(outShape);
+						if (edge == 0) {
+							edgePos(xOutAxis) = lastI + 1;
+							edgeShape(xOutAxis) = ni - lastI - 1;
+						} else {
+							edgePos(yOutAxis) = lastJ + 1;
+							edgeShape(yOutAxis) = nj - lastJ - 1;
+						}
+						const uInt ne = edgeShape(xOutAxis);
+						const uInt me = edgeShape(yOutAxis);
+						if (ne == 0  ||  me == 0) continue;
+						Cube<Double> grid(ne, me, 2);
+						Matrix<Bool> gridMask(ne, me);
+						Bool edgeFailed, edgeMissed;
+						makeGrid (grid, gridMask, edgeFailed, edgeMissed,
+								edgePos, edgeShape, 0);
+						allFailed = allFailed && edgeFailed;
+						missedIt = missedIt && edgeMissed;
+						const IPosition blc(2, edgePos(xOutAxis), edgePos(yOutAxis));
+						const IPosition trc(2, blc(0)+ne-1, blc(1)+me-1);
+						its2DCoordinateGridMask(blc, trc) = gridMask;
+						its2DCoordinateGrid(IPosition(3, blc(0), blc(1), 0),
+								IPosition(3, trc(0), trc(1), 1)) = grid;
+					}
+				}
+			}
 		}
 	}
 	s1 += t1.all();
@@ -1049,7 +1164,7 @@ void ImageRegrid<T>::regridTwoAxisCoordinate (
 			// This gets us just a few percent speed up over
 			// iterating through pixel by pixel.
 
-			ArrayLattice<T> outCursor(outIter.rwCursor());    // reference copy
+			Array<T>& outCursor = outIter.rwCursor();
 			t4.mark();
 			ThrowIf(
 				inChunkShape(xInAxis)==1 && inChunkShape(yInAxis)==1,
@@ -1060,7 +1175,9 @@ void ImageRegrid<T>::regridTwoAxisCoordinate (
 				"Cannot yet handle DirectionCoordinate plane with one "
 				"degenerate axis"
 			);
-			regrid2DMatrix(outCursor, outMaskIterPtr, interp, pProgressMeter,
+			regrid2DMatrix(outCursor,
+					outIsMasked ? &(outMaskIterPtr->rwCursor()) : 0,
+					interp, pProgressMeter,
 					iPix, nDim,
 					xInAxis, yInAxis, xOutAxis, yOutAxis, scale,
 					inIsMasked, outIsMasked,
@@ -1575,8 +1692,8 @@ void ImageRegrid<T>::findXYExtent (Bool& missedIt, Bool& allFailed,
 }
 
 template<class T>
-void ImageRegrid<T>::regrid2DMatrix(Lattice<T>& outCursor, 
-                                    LatticeIterator<Bool>*& outMaskIterPtr,
+void ImageRegrid<T>::regrid2DMatrix(Array<T>& outCursor, 
+                                    Array<Bool>* outMaskCursorPtr,
                                     const Interpolate2D& interp,
                                     ProgressMeter*& pProgressMeter,
                                     Double& iPix,
@@ -1598,7 +1715,8 @@ void ImageRegrid<T>::regrid2DMatrix(Lattice<T>& outCursor,
   // Iterate through a stack of DirectionCoordinate planes and interpolate them
   //
   // Setup Navigator and tell it which axes are the Direction ones in case
-  // of other degenerate axes
+  // of other degenerate axes. It is only used to find the planes, which
+  // are independent, so they are interpolated in parallel.
   
   IPosition axisPath;
   IPosition outCursorAxes(2, xOutAxis, yOutAxis);
@@ -1606,130 +1724,137 @@ void ImageRegrid<T>::regrid2DMatrix(Lattice<T>& outCursor,
 			       outCursorShape(yOutAxis));
   LatticeStepper outCursorIterStepper(outCursor.shape(), outCursorIterShape,
 				      outCursorAxes, axisPath);
-  LatticeIterator<T> outCursorIter(outCursor, outCursorIterStepper);
-  //
-  LatticeIterator<Bool>* outMaskCursorIterPtr = 0;
-  Lattice<Bool>* outMaskCursorPtr = 0;
-  if (outIsMasked) {
-    outMaskCursorPtr = new ArrayLattice<Bool>(outMaskIterPtr->rwCursor());
-    outMaskCursorIterPtr = new LatticeIterator<Bool>(*outMaskCursorPtr,
-						     outCursorIterStepper);
+  std::vector<IPosition> planeBlc;
+  for (outCursorIterStepper.reset(); !outCursorIterStepper.atEnd();
+       outCursorIterStepper++) {
+    planeBlc.push_back (outCursorIterStepper.position());
   }
-  //
-  IPosition inChunkBlc2D(nDim, 0);
-  IPosition inChunkTrc2D(nDim);
-  inChunkTrc2D = inChunkShape - 1;
+  const uInt nRow = outCursorShape(xOutAxis);
+  const uInt nCol = outCursorShape(yOutAxis);
+  IPosition planeShape(nDim, 1);
+  planeShape[xOutAxis] = nRow;
+  planeShape[yOutAxis] = nCol;
+  const IPosition matrixShape(2, nRow, nCol);
   //
   IPosition inChunk2DShape(2);
-  inChunk2DShape[0] = inChunkTrc2D[xInAxis] - inChunkBlc2D[xInAxis] + 1;
-  inChunk2DShape[1] = inChunkTrc2D[yInAxis] - inChunkBlc2D[yInAxis] + 1;
+  inChunk2DShape[0] = inChunkShape[xInAxis];
+  inChunk2DShape[1] = inChunkShape[yInAxis];
+  const uInt dpix2DPos = &pix2DPos(0,0,1) - &pix2DPos(0,0,0);
   //
-  Vector<Double> pix2DPos2(2);
-  IPosition outPos3;
-  Bool interpOK;
-  T result(0);
-  //
-  for (outCursorIter.reset(); !outCursorIter.atEnd(); outCursorIter++) {
-    
-    // outCursorIter.position is the location of the BLC of the current matrix
-    // within the current
-    // cursor (tile) of data. outPos3 is the location of the BLC of the
-    // current matrix within
-    // the full lattice
-    outPos3 = outPos + outCursorIter.position();
+  const Int64 nPlanes = planeBlc.size();
+  std::exception_ptr exc;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) if (nPlanes > 1)
+#endif
+  for (Int64 plane=0; plane<nPlanes; ++plane) {
+    try {
+      // Each thread has its own interpolator and work vector.
+      Interpolate2D planeInterp(interp);
+      Vector<Double> pix2DPos2(2);
+      T result(0);
+      Bool interpOK;
+
+      // outPos3 is the location of the BLC of the current matrix within
+      // the full lattice
+      const IPosition& blc = planeBlc[plane];
+      IPosition outPos3 = outPos + blc;
     
-    // Fish out the 2D piece of the inChunk relevant to this plane of the cursor
-    for (uInt k=0; k<nDim; k++) {
-      if (k!=xInAxis&& k!=yInAxis) {
-	inChunkBlc2D[k] = outPos3[pixelAxisMap2[k]] - inChunkBlc[k];
-	inChunkTrc2D[k] = inChunkBlc2D[k];
-      }; 
-    };
-    //
-    const Matrix<T>& inDataChunk2D =
-      inDataChunk(inChunkBlc2D, inChunkTrc2D).reform(inChunk2DShape);
-    Matrix<Bool>* inMaskChunk2DPtr = 0;
-    if (inIsMasked) {
-      inMaskChunk2DPtr = 
-	new Matrix<Bool>((*inMaskChunkPtr)
-			 (inChunkBlc2D, inChunkTrc2D).
-			 reform(inChunk2DShape));
-    };
+      // Fish out the 2D piece of the inChunk relevant to this plane of the cursor
+      IPosition inChunkBlc2D(nDim, 0);
+      IPosition inChunkTrc2D(inChunkShape - 1);
+      for (uInt k=0; k<nDim; k++) {
+        if (k!=xInAxis&& k!=yInAxis) {
+          inChunkBlc2D[k] = outPos3[pixelAxisMap2[k]] - inChunkBlc[k];
+          inChunkTrc2D[k] = inChunkBlc2D[k];
+        }
+      }
+      //
+      const Matrix<T> inDataChunk2D
+        (inDataChunk(inChunkBlc2D, inChunkTrc2D).reform(inChunk2DShape));
+      Matrix<Bool> inMaskChunk2D;
+      if (inIsMasked) {
+        inMaskChunk2D.reference ((*inMaskChunkPtr)
+                                 (inChunkBlc2D, inChunkTrc2D).
+                                 reform(inChunk2DShape));
+      }
 
-    // Now work through each output pixel in the data Matrix and do the
-    // interpolation
-    uInt nCol = outCursorIter.matrixCursor().ncolumn();
-    uInt nRow = outCursorIter.matrixCursor().nrow();
-    Matrix<T> &outMCursor = outCursorIter.rwMatrixCursor();
-    Matrix<Bool> *outMaskMCursor = 0;
-    if (outIsMasked) {
-      outMaskMCursor = &(outMaskCursorIterPtr->rwMatrixCursor());
-    };
+      // Now work through each output pixel in the data Matrix and do the
+      // interpolation
+      Matrix<T> outMCursor
+        (outCursor(blc, blc+planeShape-1).reform(matrixShape));
+      Matrix<Bool> outMaskMCursor;
+      if (outIsMasked) {
+        outMaskMCursor.reference ((*outMaskCursorPtr)
+                                  (blc, blc+planeShape-1).reform(matrixShape));
+      }
     
-    ArrayAccessor<Bool, Axis<0> > sucp0;
-    ArrayAccessor<Bool, Axis<1> > sucp1(succeed);
-    ArrayAccessor<T, Axis<0> > outMp0;
-    ArrayAccessor<T, Axis<1> > outMp1(outMCursor);
-    ArrayAccessor<Bool, Axis<0> > outMaskMp0;
-    ArrayAccessor<Bool, Axis<1> > outMaskMp1;
-    if (outIsMasked) outMaskMp1.init(*outMaskMCursor);
-    uInt dpix2DPos = &pix2DPos(0,0,1) - &pix2DPos(0,0,0);
-
-    for (uInt j=0; j<nCol; j++) {
-      if (outIsMasked) outMaskMp0 = outMaskMp1;
-      sucp0 = sucp1;
-      outMp0 = outMp1;
-      for (uInt i=0; i<nRow; i++) {
-	if (! *sucp0) {
-	  *outMp0 = 0.0;
-	  if (outIsMasked) *outMaskMp0 = False;
-	} else {
+      ArrayAccessor<Bool, Axis<0> > sucp0;
+      ArrayAccessor<Bool, Axis<1> > sucp1(succeed);
+      ArrayAccessor<T, Axis<0> > outMp0;
+      ArrayAccessor<T, Axis<1> > outMp1(outMCursor);
+      ArrayAccessor<Bool, Axis<0> > outMaskMp0;
+      ArrayAccessor<Bool, Axis<1> > outMaskMp1;
+      if (outIsMasked) outMaskMp1.init(outMaskMCursor);
+
+      for (uInt j=0; j<nCol; j++) {
+        if (outIsMasked) outMaskMp0 = outMaskMp1;
+        sucp0 = sucp1;
+        outMp0 = outMp1;
+        for (uInt i=0; i<nRow; i++) {
+          if (! *sucp0) {
+            *outMp0 = 0.0;
+            if (outIsMasked) *outMaskMp0 = False;
+          } else {
 	  
-	  // Now do the interpolation. pix2DPos(i,j,) is the absolute input
-	  // pixel coordinate in the input lattice for the
-	  // current output pixel.
-	  uInt ii = outPos3[xOutAxis] + i;
-	  uInt jj = outPos3[yOutAxis] + j;
-	  const Double *pix2Dp = &pix2DPos(ii,jj,0);
-	  pix2DPos2[0] = *pix2Dp - inChunkBlc[xInAxis];
-	  pix2DPos2[1] = *(pix2Dp + dpix2DPos) - inChunkBlc[yInAxis];
-	  if (inIsMasked) {                     
-	    interpOK = interp.interp(result, pix2DPos2, inDataChunk2D,
-				     *inMaskChunk2DPtr);
-	  } else {
-	    interpOK = interp.interp(result, pix2DPos2, inDataChunk2D);
-	  };
-	  if (interpOK) {
-	    *outMp0 = scale * result;
-	    if (outIsMasked) *outMaskMp0 = True; 
-	  } else {
-	    *outMp0 = 0.0;
-	    if (outIsMasked) *outMaskMp0 = False; 
-	  };
-	};
-	sucp0++;
-	outMp0++;
-	outMaskMp0++;
-      };
-      sucp1++;
-      outMp1++;
-      outMaskMp1++;
-    };
-    //
-    if (pProgressMeter) {
-      pProgressMeter->update(iPix); 
-      iPix += nCol*nRow;
-    };
-    //
-    if (outIsMasked) (*outMaskCursorIterPtr)++;
-    if (inIsMasked) delete inMaskChunk2DPtr;
-  };
+            // Now do the interpolation. pix2DPos(i,j,) is the absolute input
+            // pixel coordinate in the input lattice for the
+            // current output pixel.
+            uInt ii = outPos3[xOutAxis] + i;
+            uInt jj = outPos3[yOutAxis] + j;
+            const Double *pix2Dp = &pix2DPos(ii,jj,0);
+            pix2DPos2[0] = *pix2Dp - inChunkBlc[xInAxis];
+            pix2DPos2[1] = *(pix2Dp + dpix2DPos) - inChunkBlc[yInAxis];
+            if (inIsMasked) {                     
+              interpOK = planeInterp.interp(result, pix2DPos2, inDataChunk2D,
+                                            inMaskChunk2D);
+            } else {
+              interpOK = planeInterp.interp(result, pix2DPos2, inDataChunk2D);
+            }
+            if (interpOK) {
+              *outMp0 = scale * result;
+              if (outIsMasked) *outMaskMp0 = True; 
+            } else {
+              *outMp0 = 0.0;
+              if (outIsMasked) *outMaskMp0 = False; 
+            }
+          }
+          sucp0++;
+          outMp0++;
+          if (outIsMasked) outMaskMp0++;
+        }
+        sucp1++;
+        outMp1++;
+        if (outIsMasked) outMaskMp1++;
+      }
+    } catch (...) {
+#ifdef _OPENMP
+#pragma omp critical(ImageRegrid_regrid2DMatrix)
+#endif
+      {
+        if (!exc) exc = std::current_exception();
+      }
+    }
+  }
+  if (exc) {
+    std::rethrow_exception (exc);
+  }
+  //
+  if (pProgressMeter) {
+    pProgressMeter->update(iPix); 
+    iPix += Double(nPlanes) * nCol * nRow;
+  }
   //
   if (inIsMasked) delete inMaskChunkPtr;
-  if (outIsMasked) {
-    delete outMaskCursorIterPtr;
-    delete outMaskCursorPtr;
-  };
 }
 
 template<class T>
@@ -219,6 +219,9 @@ public:
   virtual Lattice<Bool>& pixelMask();
   // </group>
 
+  // Get the name of the mask used (empty if no pixelmask is used).
+  virtual Bool pixelMaskName (String& name) const;
+
   // Get a pointer the default pixelmask object used with this image.
   // It returns 0 if no default pixelmask is used.
   virtual const LatticeRegion* getRegionPtr() const;
@@ -429,6 +432,7 @@ private:
 
   PagedArray<T>  map_p;
   LatticeRegion* regionPtr_p;
+  String         maskName_p;
   ImageAttrHandlerCasa itsAttrHandler;
 
   //# Make members of parent class known.
@@ -38,6 +38,7 @@
 #include <casacore/lattices/LEL/LatticeExprNode.h>
 #include <casacore/lattices/LEL/LatticeExpr.h>
 #include <casacore/lattices/LRegions/LatticeRegion.h>
+#include <casacore/lattices/LatticeMath/LatticeStatsBase.h>
 #include <casacore/casa/Logging/LogIO.h>
 #include <casacore/casa/Logging/LogMessage.h>
 
@@ -198,7 +199,8 @@ template <class T>
 PagedImage<T>::PagedImage (const PagedImage<T>& other)
 : ImageInterface<T>(other),
   map_p            (other.map_p),
-  regionPtr_p      (0)
+  regionPtr_p      (0),
+  maskName_p       (other.maskName_p)
 {
   if (other.regionPtr_p != 0) {
     regionPtr_p = new LatticeRegion (*other.regionPtr_p);
@@ -224,6 +226,7 @@ PagedImage<T>& PagedImage<T>::operator=(const PagedImage<T>& other)
     if (other.regionPtr_p != 0) {
       regionPtr_p = new LatticeRegion (*other.regionPtr_p);
     }
+    maskName_p = other.maskName_p;
   } 
   return *this;
 }
@@ -305,9 +308,18 @@ Lattice<Bool>& PagedImage<T>::pixelMask()
   if (regionPtr_p == 0) {
     throw (AipsError ("PagedImage::pixelMask - no pixelmask used"));
   }
+  // The mask might be changed, so the statistics cache is not valid anymore.
+  LatticeStatsBase::invalidateStatsCache (name());
   return *regionPtr_p;
 }
 
+template<class T>
+Bool PagedImage<T>::pixelMaskName (String& name) const
+{
+  name = (hasPixelMask()  ?  maskName_p : String());
+  return True;
+}
+
 template<class T>
 const LatticeRegion* PagedImage<T>::getRegionPtr() const
 {
@@ -321,6 +333,7 @@ void PagedImage<T>::setDefaultMask (const String& regionName)
   reopenRW();
   // Use the new region as the image's mask.
   applyMask (regionName);
+  LatticeStatsBase::invalidateStatsCache (name());
   // Store the new default name.
   ImageInterface<T>::setDefaultMask (regionName);
 }
@@ -353,6 +366,7 @@ void PagedImage<T>::applyMask (const String& maskName)
   if (maskName.empty()) {
     delete regionPtr_p;
     regionPtr_p = 0;
+    maskName_p  = String();
     return;
   }
   // Reconstruct the ImageRegion object.
@@ -370,6 +384,7 @@ void PagedImage<T>::applyMask (const String& maskName)
   // Replace current by new mask.
   delete regionPtr_p;
   regionPtr_p = latReg;
+  maskName_p  = maskName;
 }
 
 
@@ -784,6 +799,7 @@ void PagedImage<T>::flush()
   if (regionPtr_p != 0) {
     regionPtr_p->flush();
   }
+  LatticeStatsBase::flushedStatsCache (name());
 }
 
 template<class T>
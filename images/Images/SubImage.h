@@ -158,6 +158,9 @@ public:
   virtual Lattice<Bool>& pixelMask();
   // </group>
 
+  // Get the name of the pixelmask in use (thus of the parent).
+  virtual Bool pixelMaskName (String& name) const;
+
   // A SubImage is persistent if no region is applied to the parent image.
   // That is true if the region has the same shape as the parent image
   // and the region has no mask.
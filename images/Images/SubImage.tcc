@@ -300,6 +300,12 @@ Lattice<Bool>& SubImage<T>::pixelMask()
   return itsSubLatPtr->pixelMask();
 }
 
+template<class T>
+Bool SubImage<T>::pixelMaskName (String& name) const
+{
+  return itsSubLatPtr->pixelMaskName (name);
+}
+
 template<class T>
 const LatticeRegion* SubImage<T>::getRegionPtr() const
 {
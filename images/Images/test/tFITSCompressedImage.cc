@@ -0,0 +1,178 @@
+//# tFITSCompressedImage.cc: test FITSImage on a tile-compressed FITS file
+//# Copyright (C) 2026
+//# Associated Universities, Inc. Washington DC, USA.
+//#
+//# This program is free software; you can redistribute it and/or modify it
+//# under the terms of the GNU General Public License as published by the Free
+//# Software Foundation; either version 2 of the License, or (at your option)
+//# any later version.
+//#
+//# This program is distributed in the hope that it will be useful, but WITHOUT
+//# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+//# more details.
+//#
+//# You should have received a copy of the GNU General Public License along
+//# with this program; if not, write to the Free Software Foundation, Inc.,
+//# 675 Massachusetts Ave, Cambridge, MA 02139, USA.
+//#
+//# Correspondence concerning AIPS++ should be addressed as follows:
+//#        Internet email: aips2-request@nrao.edu.
+//#        Postal address: AIPS++ Project Office
+//#                        National Radio Astronomy Observatory
+//#                        520 Edgemont Road
+//#                        Charlottesville, VA 22903-2475 USA
+
+#include <casacore/images/Images/FITSImage.h>
+#include <casacore/images/Images/FITSCompressedData.h>
+#include <casacore/casa/Arrays/ArrayLogical.h>
+#include <casacore/casa/Arrays/Slicer.h>
+#include <casacore/casa/Utilities/Assert.h>
+#include <casacore/casa/Exceptions/Error.h>
+#include <casacore/casa/iostream.h>
+
+#include <fitsio.h>
+
+#include <casacore/casa/namespace.h>
+
+// <summary>
+// Test program for reading a tile-compressed FITS image with FITSImage.
+// The file is created with cfitsio (Rice compressed 16-bit integers, so
+// it is lossless) and contains blanked pixels and partial tiles.
+// </summary>
+
+const Short blank = -32768;
+
+// Make the data; every 7th pixel is blanked.
+Array<Short> makeData (const IPosition& shape)
+{
+  Array<Short> data(shape);
+  Short* ptr = data.data();
+  for (Int64 i=0; i<Int64(data.nelements()); ++i) {
+    ptr[i] = (i%7 == 3  ?  blank : Short(i%1000 - 500));
+  }
+  return data;
+}
+
+void writeFile (const String& name, const Array<Short>& data)
+{
+  fitsfile* fptr;
+  int status = 0;
+  String fname = "!" + name;
+  fits_create_file (&fptr, fname.chars(), &status);
+  fits_set_compression_type (fptr, RICE_1, &status);
+  long tile[3] = {16, 16, 1};
+  fits_set_tile_dim (fptr, 3, tile, &status);
+  long naxes[3] = {long(data.shape()[0]), long(data.shape()[1]),
+                   long(data.shape()[2])};
+  fits_create_img (fptr, SHORT_IMG, 3, naxes, &status);
+  long blankValue = blank;
+  fits_write_key (fptr, TLONG, "BLANK", &blankValue, 0, &status);
+  fits_write_key_str (fptr, "BUNIT", "Jy/beam", 0, &status);
+  fits_write_key_str (fptr, "CTYPE1", "RA---SIN", 0, &status);
+  fits_write_key_str (fptr, "CTYPE2", "DEC--SIN", 0, &status);
+  fits_write_key_str (fptr, "CTYPE3", "FREQ", 0, &status);
+  double crval[3] = {180., 45., 1.4e9};
+  double cdelt[3] = {-0.001, 0.001, 1e6};
+  double crpix[3] = {25., 20., 1.};
+  const char* crvalKey[3] = {"CRVAL1", "CRVAL2", "CRVAL3"};
+  const char* cdeltKey[3] = {"CDELT1", "CDELT2", "CDELT3"};
+  const char* crpixKey[3] = {"CRPIX1", "CRPIX2", "CRPIX3"};
+  for (int i=0; i<3; ++i) {
+    fits_write_key_dbl (fptr, crvalKey[i], crval[i], -12, 0, &status);
+    fits_write_key_dbl (fptr, cdeltKey[i], cdelt[i], -12, 0, &status);
+    fits_write_key_dbl (fptr, crpixKey[i], crpix[i], -12, 0, &status);
+  }
+  fits_write_img (fptr, TSHORT, 1, data.nelements(),
+                  const_cast<Short*>(data.data()), &status);
+  fits_close_file (fptr, &status);
+  AlwaysAssertExit (status == 0);
+}
+
+// Check a section of the image and its mask against the expected data.
+void checkSection (FITSImage& image, const Array<Short>& data,
+                   const Slicer& section)
+{
+  Array<Short> expData = data(section.start(), section.end(),
+                              section.stride());
+  Array<Float> values = image.getSlice (section);
+  Array<Bool> mask = image.getMaskSlice (section);
+  AlwaysAssertExit (values.shape().isEqual (expData.shape()));
+  Array<Short>::const_iterator iter = expData.begin();
+  Array<Float>::const_iterator viter = values.begin();
+  Array<Bool>::const_iterator miter = mask.begin();
+  for (; iter!=expData.end(); ++iter, ++viter, ++miter) {
+    if (*iter == blank) {
+      AlwaysAssertExit (!*miter);
+    } else {
+      AlwaysAssertExit (*miter  &&  *viter == *iter);
+    }
+  }
+}
+
+int main()
+{
+  try {
+    const String name("tFITSCompressedImage_tmp.fits");
+    IPosition shape(3, 50, 40, 6);
+    Array<Short> data = makeData (shape);
+    writeFile (name, data);
+    AlwaysAssertExit (!FITSCompressedData::isCompressed (name, 0));
+    AlwaysAssertExit (FITSCompressedData::isCompressed (name, 1));
+    // The image is found in the first extension.
+    FITSImage image(name);
+    AlwaysAssertExit (image.shape().isEqual (shape));
+    AlwaysAssertExit (image.hasPixelMask());
+    AlwaysAssertExit (image.units().getName() == "Jy/beam");
+    AlwaysAssertExit (image.coordinates().nCoordinates() == 2);
+    // Read the entire image, a strided section, a section skipping tiles
+    // and an iteration with the nice cursor shape.
+    checkSection (image, data, Slicer(IPosition(3,0), shape));
+    checkSection (image, data, Slicer(IPosition(3,1,2,0), IPosition(3,47,37,5),
+                                      IPosition(3,3,2,2), Slicer::endIsLast));
+    checkSection (image, data, Slicer(IPosition(3,2,0,1), IPosition(3,45,39,1),
+                                      IPosition(3,20,1,1), Slicer::endIsLast));
+    IPosition cursor = image.niceCursorShape();
+    for (Int z=0; z<shape[2]; z+=cursor[2]) {
+      for (Int y=0; y<shape[1]; y+=cursor[1]) {
+        for (Int x=0; x<shape[0]; x+=cursor[0]) {
+          IPosition st(3, x, y, z);
+          checkSection (image, data, Slicer(st, min(cursor, shape-st)));
+        }
+      }
+    }
+    // Use a cache smaller than the image, so tiles get removed.
+    image.setMaximumCacheSize (3*16*16);
+    AlwaysAssertExit (image.maximumCacheSize() == 3*16*16);
+    checkSection (image, data, Slicer(IPosition(3,0), shape));
+    checkSection (image, data, Slicer(IPosition(3,10,10,2), IPosition(3,20,20,2)));
+    image.showCacheStatistics (cout);
+    image.clearCache();
+    // A section defined by its length or mimicing the source shape
+    // has to be resolved against the shape of the data.
+    {
+      FITSCompressedData cdata(name, 1);
+      Array<Float> buffer;
+      cdata.get (buffer, Slicer(IPosition(3,4,5,1), IPosition(3,10,6,2),
+                                Slicer::endIsLength));
+      AlwaysAssertExit (buffer.shape().isEqual (IPosition(3,10,6,2)));
+      AlwaysAssertExit (buffer(IPosition(3,1,3,1)) == data(IPosition(3,5,8,2)));
+      cdata.get (buffer, Slicer(IPosition(3,3,0,0),
+                                IPosition(3,Slicer::MimicSource,
+                                          Slicer::MimicSource, 0),
+                                IPosition(3,7,4,1), Slicer::endIsLast));
+      AlwaysAssertExit (buffer.shape().isEqual (IPosition(3,7,10,1)));
+      AlwaysAssertExit (buffer(IPosition(3,6,9,0)) ==
+                        data(IPosition(3,45,36,0)));
+    }
+    // A copy and a reopened image give the same result.
+    FITSImage image2(image);
+    image2.tempClose();
+    checkSection (image2, data, Slicer(IPosition(3,0), shape));
+  } catch (std::exception& x) {
+    cout << "Unexpected exception: " << x.what() << endl;
+    return 1;
+  }
+  cout << "ok" << endl;
+  return 0;
+}
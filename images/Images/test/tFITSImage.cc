@@ -41,11 +41,15 @@
 #include <casacore/coordinates/Coordinates/CoordinateSystem.h>
 
 #include <casacore/casa/iostream.h>
+#include <casacore/casa/fstream.h>
+#include <casacore/casa/sstream.h>
+#include <casacore/casa/OS/RegularFile.h>
 
 #include <casacore/casa/namespace.h>
 Bool allNear (const Array<Float>& data, const Array<Bool>& dataMask,
               const Array<Float>& fits, const Array<Bool>& fitsMask,
               Float tol=1.0e-5, Float abstol=-1.);
+void testIntegerBlanks();
 
 int main (int argc, const char* argv[])
 {
@@ -53,6 +57,10 @@ try {
 
    LogIO os(LogOrigin("tFITSImage", "main()", WHERE));
 
+// Test the blanking of integer FITS images.
+
+   testIntegerBlanks();
+
 // Get inputs
 
    Input inputs(1);
@@ -132,6 +140,51 @@ try {
    AlwaysAssert(allNear(dataArray, dataMask, fitsArray, fitsMask), AipsError);
    AlwaysAssert(fitsCS.near(dataCS), AipsError);
 
+// Compare sections (also strided ones) with the entire array.
+
+   {
+      IPosition shp = fitsImage.shape();
+      IPosition blc(shp.size(), 0);
+      IPosition trc(shp - 1);
+      IPosition inc(shp.size(), 1);
+      for (uInt i=0; i<shp.size(); i++) {
+         if (shp(i) > 2) {
+            blc(i) = 1;
+            inc(i) = 2;
+         }
+      }
+      Slicer sl1(blc, trc, inc, Slicer::endIsLast);
+      AlwaysAssert(allNear(fitsArray(sl1), fitsMask(sl1),
+                           fitsImage.getSlice(sl1),
+                           fitsImage.getMaskSlice(sl1), 0.0), AipsError);
+      // A single column crossing the first axis.
+      IPosition len(shp.size(), 1);
+      len(1) = shp(1);
+      Slicer sl2(IPosition(shp.size(), 0), len);
+      AlwaysAssert(allNear(fitsArray(sl2), fitsMask(sl2),
+                           fitsImage.getSlice(sl2),
+                           fitsImage.getMaskSlice(sl2), 0.0), AipsError);
+      // Iterate with the nice cursor shape; the second time the mask
+      // comes from the chunk cache.
+      for (uInt j=0; j<2; j++) {
+         IPosition cursor = fitsImage.niceCursorShape();
+         IPosition pos(shp.size(), 0);
+         while (True) {
+            Slicer sl(pos, min(cursor, shp-pos));
+            AlwaysAssert(allNear(fitsArray(sl), fitsMask(sl),
+                                 fitsImage.getSlice(sl),
+                                 fitsImage.getMaskSlice(sl), 0.0), AipsError);
+            uInt ax = 0;
+            for (; ax<shp.size(); ax++) {
+               pos(ax) += cursor(ax);
+               if (pos(ax) < shp(ax)) break;
+               pos(ax) = 0;
+            }
+            if (ax == shp.size()) break;
+         }
+      }
+   }
+
 // Test Clone
 
    ImageInterface<Float>* pFitsImage = fitsImage.cloneII();
@@ -198,3 +251,140 @@ Bool allNear (const Array<Float>& data, const Array<Bool>& dataMask,
 }
 
 
+
+// Make an 80 character FITS header card.
+String fitsCard (const String& key, const String& value)
+{
+   String card(key);
+   card.resize (8, ' ');
+   if (! value.empty()) {
+      card += "= ";
+      if (value[0] == '\'') {
+         card += value;
+      } else {
+         card += String(20 - min(20, Int(value.size())), ' ') + value;
+      }
+   }
+   card.resize (80, ' ');
+   return card;
+}
+
+String toFITSString (Int64 value)
+{
+   return String::toString (value);
+}
+
+// A real value always gets a decimal point.
+String toFITSString (Double value)
+{
+   ostringstream ostr;
+   ostr.precision (10);
+   ostr << std::showpoint << value;
+   return ostr.str();
+}
+
+// Write a FITS file with the given integer values (big-endian).
+// The pixels equal to the blank value are blanked.
+void writeIntFITS (const String& name, Int bitpix, const IPosition& shape,
+                   const Vector<Int>& values, Int blank,
+                   Double bscale, Double bzero)
+{
+   String header;
+   header += fitsCard ("SIMPLE", "T");
+   header += fitsCard ("BITPIX", toFITSString(Int64(bitpix)));
+   header += fitsCard ("NAXIS", toFITSString(Int64(shape.size())));
+   for (uInt i=0; i<shape.size(); i++) {
+      header += fitsCard ("NAXIS" + String::toString(i+1),
+                          toFITSString(Int64(shape(i))));
+   }
+   header += fitsCard ("BSCALE", toFITSString(bscale));
+   header += fitsCard ("BZERO", toFITSString(bzero));
+   header += fitsCard ("BLANK", toFITSString(Int64(blank)));
+   header += fitsCard ("BUNIT", "'JY/BEAM '");
+   const char* ctype[] = {"'RA---SIN'", "'DEC--SIN'", "'FREQ    '"};
+   const Double crval[] = {180., 45., 1.4e9};
+   const Double cdelt[] = {-1e-3, 1e-3, 1e6};
+   for (uInt i=0; i<shape.size(); i++) {
+      String ax = String::toString(i+1);
+      header += fitsCard ("CTYPE" + ax, ctype[i]);
+      header += fitsCard ("CRPIX" + ax, "1.0");
+      header += fitsCard ("CRVAL" + ax, toFITSString(crval[i]));
+      header += fitsCard ("CDELT" + ax, toFITSString(cdelt[i]));
+   }
+   header += fitsCard ("EQUINOX", "2000.0");
+   header += fitsCard ("END", "");
+   header.resize ((header.size() + 2879) / 2880 * 2880, ' ');
+   const Int nbytes = bitpix / 8;
+   std::string data;
+   for (uInt i=0; i<values.size(); i++) {
+      for (Int j=nbytes-1; j>=0; j--) {
+         data += char((uInt(values(i)) >> (8*j)) & 0xff);
+      }
+   }
+   data.resize ((data.size() + 2879) / 2880 * 2880, '\0');
+   std::ofstream ofs(name.c_str(), std::ios::binary);
+   ofs.write (header.data(), header.size());
+   ofs.write (data.data(), data.size());
+   AlwaysAssertExit (ofs.good());
+}
+
+// Check the pixels and mask of an integer FITS image with BLANK pixels
+// read through a memory map against the expected scaled values and against
+// the image read with TiledFileAccess.
+void testIntegerBlanks()
+{
+   const String name("tFITSImage_tmp.fits");
+   const IPosition shape(3, 7, 5, 3);
+   const Int npix = shape.product();
+   const Int bitpixs[] = {8, 16, 32};
+   const Int blanks[] = {255, -32768, -2147483647-1};
+   const Double bscales[] = {2.0, 0.5, 0.25};
+   const Double bzeros[] = {-100.0, -10.0, 1000.0};
+   for (uInt k=0; k<3; k++) {
+      Vector<Int> values(npix);
+      Array<Float> expData(shape);
+      Array<Bool> expMask(shape);
+      Float* expPtr = expData.data();
+      Bool* maskPtr = expMask.data();
+      for (Int i=0; i<npix; i++) {
+         if (bitpixs[k] == 8) {
+            values(i) = (i * 7) % 200;
+         } else if (bitpixs[k] == 16) {
+            values(i) = i * 37 - 500;
+         } else {
+            values(i) = i * 100003 - 1000000;
+         }
+         // The second plane has no blanks.
+         maskPtr[i] = (i % 5 != 2  ||  i / (7*5) == 1);
+         if (! maskPtr[i]) {
+            values(i) = blanks[k];
+         }
+         expPtr[i] = Float(values(i)) * Float(bscales[k]) + Float(bzeros[k]);
+      }
+      writeIntFITS (name, bitpixs[k], shape, values, blanks[k],
+                    bscales[k], bzeros[k]);
+      FITSImage mapped(name);
+      FITSImage tiled(name, 0, 0, False);
+      AlwaysAssertExit (mapped.shape() == shape);
+      AlwaysAssertExit (mapped.hasPixelMask()  &&  tiled.hasPixelMask());
+      // A memory-mapped image has no cache.
+      if (sizeof(void*) >= 8) {
+         AlwaysAssertExit (mapped.maximumCacheSize() == 0);
+      }
+      Array<Float> data = mapped.get();
+      Array<Bool> mask = mapped.getMask();
+      AlwaysAssertExit (allEQ (mask, expMask));
+      AlwaysAssertExit (allNear (expData, expMask, data, mask, 1e-6));
+      AlwaysAssertExit (allEQ (mask, tiled.getMask()));
+      AlwaysAssertExit (allNear (tiled.get(), tiled.getMask(), data, mask,
+                                 0.0));
+      // A section crossing the planes.
+      Slicer sl(IPosition(3, 1, 1, 0), IPosition(3, 4, 3, 3));
+      AlwaysAssertExit (allEQ (mapped.getMaskSlice(sl), expMask(sl)));
+      AlwaysAssertExit (allEQ (mapped.getMaskSlice(sl),
+                               tiled.getMaskSlice(sl)));
+      AlwaysAssertExit (allNear (mapped.getSlice(sl), expMask(sl),
+                                 tiled.getSlice(sl), expMask(sl), 0.0));
+   }
+   RegularFile(name).remove();
+}
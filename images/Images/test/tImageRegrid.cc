@@ -196,6 +196,70 @@ try {
       delete pImOut;
     }
 
+    {
+      // Regrid a linear function to a finer grid with another reference
+      // direction lying within the input, once exactly and once with a
+      // coordinate grid tolerance.
+      cout << "*** Test coordinate grid tolerance" << endl;
+      const IPosition shapeIn2(2, 64, 64);
+      const IPosition shapeOut2(2, 48, 48);
+      CoordinateSystem cSysIn2 = CoordinateUtil::makeCoordinateSystem(shapeIn2, False);
+      TempImage<Float> inIm(TiledShape(shapeIn2), cSysIn2);
+      Matrix<Float> vals(shapeIn2);
+      for (Int j=0; j<shapeIn2(1); j++) {
+         for (Int i=0; i<shapeIn2(0); i++) {
+            vals(i,j) = 0.01 * (i + 2*j);
+         }
+      }
+      inIm.put(vals);
+      CoordinateSystem cSysOut2(cSysIn2);
+      Vector<Double> incr = cSysOut2.increment().copy();
+      Vector<Double> refp = cSysOut2.referencePixel().copy();
+      Vector<Double> refv = cSysOut2.referenceValue().copy();
+      refv(0) += 3 * incr(0);
+      refv(1) += 2 * incr(1);
+      incr *= 0.9;
+      refp = shapeOut2(0) / 2.0;
+      cSysOut2.setReferencePixel(refp);
+      cSysOut2.setReferenceValue(refv);
+      cSysOut2.setIncrement(incr);
+      const IPosition axes2(2, 0, 1);
+      const Double tol = 0.05;
+      ImageRegrid<Float> exactRegridder;
+      TempImage<Float> outExact(TiledShape(shapeOut2), cSysOut2);
+      exactRegridder.regrid(outExact, Interpolate2D::LINEAR, axes2, inIm);
+      ImageRegrid<Float> tolRegridder;
+      tolRegridder.setCoordinateGridTolerance(tol);
+      TempImage<Float> outTol(TiledShape(shapeOut2), cSysOut2);
+      tolRegridder.regrid(outTol, Interpolate2D::LINEAR, axes2, inIm);
+      // The grid is refined until it differs less than the tolerance from
+      // the next finer one, so allow twice the tolerance from the exact
+      // input pixel positions. The edges are converted exactly.
+      Cube<Double> exactGrid, tolGrid;
+      Matrix<Bool> exactMask, tolMask;
+      exactRegridder.get2DCoordinateGrid(exactGrid, exactMask);
+      tolRegridder.get2DCoordinateGrid(tolGrid, tolMask);
+      AlwaysAssert(allEQ(exactMask, True) && allEQ(tolMask, True), AipsError);
+      AlwaysAssert(allNearAbs(tolGrid, exactGrid, 2*tol), AipsError);
+      AlwaysAssert(anyNE(tolGrid, exactGrid), AipsError);
+      const uInt nx = shapeOut2(0) - 1;
+      const uInt ny = shapeOut2(1) - 1;
+      AlwaysAssert(allNearAbs(tolGrid(IPosition(3,nx,0,0), IPosition(3,nx,ny,1)),
+                              exactGrid(IPosition(3,nx,0,0), IPosition(3,nx,ny,1)),
+                              1e-6),
+                   AipsError);
+      AlwaysAssert(allNearAbs(tolGrid(IPosition(3,0,ny,0), IPosition(3,nx,ny,1)),
+                              exactGrid(IPosition(3,0,ny,0), IPosition(3,nx,ny,1)),
+                              1e-6),
+                   AipsError);
+      // Linear interpolation of the linear function is exact, so a position
+      // error (dx,dy) gives a value error 0.01*(|dx|+2|dy|) <= 0.03*2*tol.
+      Array<Float> exactVals = outExact.get();
+      AlwaysAssert(max(exactVals) > min(exactVals), AipsError);
+      AlwaysAssert(allNearAbs(outTol.get(), exactVals, 0.06*tol + 1e-5),
+                   AipsError);
+    }
+
       {
     	  cout << "*** Test makeCoordinateSystem" << endl;
     	  CoordinateSystem cIn = CoordinateUtil::defaultCoords2D();
@@ -25,10 +25,12 @@
 
 #include <casacore/images/Images/PagedImage.h>
 #include <casacore/images/Images/ImageInfo.h>
+#include <casacore/images/Images/SubImage.h>
 #include <casacore/coordinates/Coordinates/CoordinateSystem.h>
 #include <casacore/coordinates/Coordinates/CoordinateUtil.h>
 #include <casacore/lattices/Lattices/ArrayLattice.h>
 #include <casacore/lattices/Lattices/LatticeIterator.h>
+#include <casacore/lattices/LatticeMath/LatticeStatistics.h>
 
 #include <casacore/casa/Arrays/Array.h>
 #include <casacore/casa/IO/ArrayIO.h>
@@ -49,6 +51,10 @@
 #include <casacore/casa/Utilities/DataType.h>
 #include <casacore/casa/BasicSL/String.h>
 #include <casacore/casa/Utilities/Regex.h>
+#include <casacore/casa/OS/Directory.h>
+#include <casacore/casa/OS/DirectoryIterator.h>
+#include <casacore/casa/OS/File.h>
+#include <ctime>
 
 #include <casacore/casa/stdlib.h>
 #include <casacore/casa/iostream.h>
@@ -138,6 +144,78 @@ void testTempCloseDelete()
   AlwaysAssertExit (File("tPagedImage_tmp.imgtc").exists());
 }
 
+// Make the files in the image older, because the statistics cache is not
+// written for a lattice changed in the last seconds.
+void makeOlder (const Directory& dir)
+{
+  for (DirectoryIterator iter(dir); !iter.pastEnd(); iter++) {
+    File file(iter.file());
+    if (file.isDirectory (False)) {
+      makeOlder (Directory(file));
+    }
+    file.touch (uInt(time(0)) - 10);
+  }
+}
+
+// Get the number of unmasked points per plane using the statistics cache.
+Array<Double> cachedNpts (const ImageInterface<Float>& img)
+{
+  LatticeStatistics<Float> stats(img, False);
+  stats.setUseStatsCache (True);
+  Vector<Int> axes(2);
+  axes[0] = 0;
+  axes[1] = 1;
+  AlwaysAssertExit (stats.setAxes (axes));
+  Array<Double> npts;
+  AlwaysAssertExit (stats.getStatistic (npts, LatticeStatsBase::NPTS));
+  return npts;
+}
+
+void testStatsCacheMask()
+{
+  const String name("tPagedImage_tmp.imgsc");
+  const IPosition shape(3,10,8,4);
+  {
+    PagedImage<Float> img (TiledShape(shape),
+                           CoordinateUtil::defaultCoords3D(), name);
+    Array<Float> arr(shape);
+    indgen (arr);
+    img.put (arr);
+    // mask1 (the default) masks half of the pixels; mask2 none.
+    img.makeMask ("mask2", True, False, True, True);
+    img.makeMask ("mask1", True, True, True, True);
+    Array<Bool> mask(shape, True);
+    mask(IPosition(3,0), shape-1, IPosition(3,2,1,1)) = False;
+    img.pixelMask().put (mask);
+  }
+  makeOlder (Directory(name));
+  const String cacheName(name + "/statscache");
+  {
+    // The cache is made using the default mask.
+    PagedImage<Float> img (name);
+    String maskName;
+    AlwaysAssertExit (img.pixelMaskName (maskName)  &&  maskName == "mask1");
+    SubImage<Float> sub(img);
+    AlwaysAssertExit (sub.pixelMaskName (maskName)  &&  maskName == "mask1");
+    AlwaysAssertExit (allEQ (cachedNpts(sub), 40.));
+    AlwaysAssertExit (File(cacheName).exists());
+    AlwaysAssertExit (allEQ (cachedNpts(sub), 40.));
+  }
+  {
+    // Another mask or no mask must not use it.
+    PagedImage<Float> img (name, MaskSpecifier("mask2"));
+    String maskName;
+    AlwaysAssertExit (img.pixelMaskName (maskName)  &&  maskName == "mask2");
+    AlwaysAssertExit (allEQ (cachedNpts(SubImage<Float>(img)), 80.));
+    PagedImage<Float> img2 (name, MaskSpecifier(False));
+    AlwaysAssertExit (img2.pixelMaskName (maskName)  &&  maskName.empty());
+    AlwaysAssertExit (allEQ (cachedNpts(img2), 80.));
+    PagedImage<Float> img1 (name);
+    AlwaysAssertExit (allEQ (cachedNpts(SubImage<Float>(img1)), 40.));
+  }
+  TableUtil::deleteTable (name);
+}
+
 int main()
 {
   try {
@@ -565,6 +643,9 @@ int main()
    // Test the temporary close if marked for delete.
    testTempCloseDelete();
 
+   // Test the use of the mask by the statistics cache.
+   testStatsCacheMask();
+
    cout<< "ok"<< endl;
   } catch (std::exception& x) {
     cerr << "Exception caught: " << x.what() << endl;
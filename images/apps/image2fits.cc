@@ -33,6 +33,7 @@
 #include <casacore/images/Images/FITSImage.h>
 #include <casacore/images/Images/MIRIADImage.h>
 #include <casacore/casa/Exceptions/Error.h>
+#include <casacore/casa/OS/Timer.h>
 #include <casacore/casa/iostream.h>
 
 #include <casacore/casa/namespace.h>
@@ -54,6 +55,9 @@ int main (int argc, const char* argv[])
     inputs.create ("out", "",
 		   "Name of output FITS file",
 		   "string");
+    inputs.create ("memory", "64",
+		   "Memory (in MB) to use for the buffers",
+		   "int");
     // Fill the input structure from the command line.
     inputs.readArguments (argc, argv);
 
@@ -91,11 +95,22 @@ int main (int argc, const char* argv[])
       img = new ImageExpr<Float> (lat, imgin);
     }
     // Now write the fits file.
-    res = ImageFITSConverter::ImageToFITS (error, *img, ffout);
+    Int memory = inputs.getInt("memory");
+    Double nbytes = img->shape().product() * Double(sizeof(Float));
+    Timer timer;
+    res = ImageFITSConverter::ImageToFITS (error, *img, ffout,
+                                           max(1, memory));
+    Double elapsed = timer.real();
     delete img;
     if (!res) {
       throw AipsError(error);
     }
+    cout << "Wrote " << nbytes / (1024*1024) << " MB in " << elapsed
+         << " sec";
+    if (elapsed > 0) {
+      cout << " (" << nbytes / (1024*1024) / elapsed << " MB/sec)";
+    }
+    cout << endl;
   } catch (std::exception& x) {
     cout << x.what() << endl;
     return 1;
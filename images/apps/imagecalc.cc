@@ -24,6 +24,7 @@
 //#                        Charlottesville, VA 22903-2475 USA
 
 #include <casacore/casa/Inputs/Input.h>
+#include <casacore/casa/OS/OMP.h>
 #include <casacore/images/Images/PagedImage.h>
 #include <casacore/images/Images/HDF5Image.h>
 #include <casacore/images/Images/FITSImage.h>
@@ -47,6 +48,9 @@ int main(int argc, const char* argv[])
     inputs.create("in", "", "Input image or image expression", "string");
     inputs.create("out", "", "Output image name (optional)", "string");
     inputs.create("hdf5", "F", "output image in HDF5 format?", "bool");
+    inputs.create("nthreads", "0",
+                  "Number of threads to evaluate the expression"
+                  " (0 = OMP_NUM_THREADS or all cores)", "int");
     inputs.readArguments(argc, argv);
 
     // Get and check the input specification.
@@ -60,6 +64,10 @@ int main(int argc, const char* argv[])
       outName = "/tmp/image.out";
     }
     Bool hdf5 = inputs.getBool("hdf5");
+    Int nthreads = inputs.getInt("nthreads");
+    if (nthreads > 0) {
+      OMP::setNumThreads (nthreads);
+    }
     if (hdf5  &&  !HDF5Object::hasHDF5Support()) {
       cerr << "Support for HDF5 has not been compiled in; revert to PagedImage"
            << endl;
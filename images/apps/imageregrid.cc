@@ -30,6 +30,7 @@
 #include <casacore/casa/Arrays/ArrayMath.h>
 #include <casacore/casa/Inputs/Input.h>
 #include <casacore/casa/Arrays/IPosition.h>
+#include <casacore/casa/OS/OMP.h>
 
 #include <casacore/images/Images/PagedImage.h>
 #include <casacore/images/Images/ImageInterface.h>
@@ -66,6 +67,12 @@ int main(int argc, const char* argv[]) {
     inputs.create("refval", "", "New center of the image in degrees (reference value)", 
 		  "Block<Double>");
     inputs.create("interpolation", "linear", "Interpolation method (linear, nearest, cubic,lanczos)");
+    inputs.create("tolerance", "0",
+                  "Max pixel error of the coordinate grid if decimate=0"
+                  " (0 = exact conversion of all pixels)");
+    inputs.create("nthreads", "0",
+                  "Number of threads to regrid the planes"
+                  " (0 = OMP_NUM_THREADS or all cores)", "int");
     inputs.readArguments(argc, argv);
 
     const String in = inputs.getString("in");
@@ -90,6 +97,11 @@ int main(int argc, const char* argv[]) {
     }
     const String proj = inputs.getString("projection");
     const String interpolation = inputs.getString("interpolation");
+    const Double tolerance = inputs.getDouble("tolerance");
+    Int nthreads = inputs.getInt("nthreads");
+    if (nthreads > 0) {
+      OMP::setNumThreads (nthreads);
+    }
 
     FITSImage::registerOpenFunction();
     MIRIADImage::registerOpenFunction();
@@ -107,6 +119,7 @@ int main(int argc, const char* argv[]) {
     Interpolate2D::Method itsMethod = Interpolate2D::stringToMethod(interpolation);
     itsIr.disableReferenceConversions(False);
     itsIr.showDebugInfo(0);
+    itsIr.setCoordinateGridTolerance(tolerance);
     Int itsDecimate = decimate;
     String itsProj = proj;
     String itsMDir = dirref;
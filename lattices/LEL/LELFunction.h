@@ -33,6 +33,7 @@
 #include <casacore/lattices/LEL/LatticeExprNode.h>
 #include <casacore/lattices/LEL/LELFunctionEnums.h>
 #include <casacore/casa/Containers/Block.h>
+#include <casacore/scimath/Mathematics/NumericTraits.h>
 
 namespace casacore { //# NAMESPACE CASACORE - BEGIN
 
@@ -135,6 +136,13 @@ public:
   // </group>
 
 private:
+   // Reduce the array expression for the MIN1D, MAX1D, MEAN1D and SUM
+   // functions. The chunks of the expression are evaluated and reduced in
+   // parallel. It returns the number of valid elements. <src>extVal</src>
+   // is set to the minimum or maximum, <src>sumVal</src> to the sum.
+   size_t reduceArray (T& extVal,
+                       typename NumericTraits<T>::PrecisionType& sumVal) const;
+
    LELFunctionEnums::Function   function_p;
    std::shared_ptr<LELInterface<T>> pExpr_p;
 };
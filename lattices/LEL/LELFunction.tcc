@@ -40,6 +40,7 @@
 #include <casacore/casa/Arrays/ArrayMath.h>
 #include <casacore/scimath/Mathematics/NumericTraits.h> 
 #include <casacore/casa/Exceptions/Error.h> 
+#include <vector>
 
 
 namespace casacore { //# NAMESPACE CASACORE - BEGIN
@@ -190,152 +191,26 @@ LELScalar<T> LELFunction1D<T>::getScalar() const
    case LELFunctionEnums::VALUE :
       return pExpr_p->getScalar();
    case LELFunctionEnums::MIN1D :
-   {
-      if (pExpr_p->isScalar()) {
-         return pExpr_p->getScalar();
-      }
-      Bool firstTime = True;
-      T minVal = T();
-      LatticeExpr<T> latExpr(pExpr_p);
-      if (! latExpr.isMasked()) {
-	 RO_LatticeIterator<T> iter(latExpr);
-	 while (! iter.atEnd()) {
-	    T minv = min(iter.cursor());
-	    if (firstTime  ||  minv < minVal) {
-	       firstTime = False;
-	       minVal = minv;
-	    }
-	    iter++;
-	 }
-      } else {
-	 RO_MaskedLatticeIterator<T> iter(latExpr);
-	 Bool delMask, delData;
-	 Array<Bool> mask;
-	 while (! iter.atEnd()) {
-	    const Array<T>& array = iter.cursor();
-	    iter.getMask (mask);
-	    const Bool* maskPtr = mask.getStorage (delMask);
-	    const T* dataPtr = array.getStorage (delData);
-	    size_t n = array.nelements();
-	    T lminVal = minVal;
-	    for (size_t i=0; i<n; i++) {
-	       if (maskPtr[i]) {
-		  if (firstTime  ||  dataPtr[i] < lminVal) {
-		     firstTime = False;
-		     lminVal = dataPtr[i];
-		  }
-	       }
-	    }
-	    minVal = lminVal;
-	    mask.freeStorage (maskPtr, delMask);
-	    array.freeStorage (dataPtr, delData);
-	    iter++;
-	 }
-      }
-      if (firstTime) {
-	  return LELScalar<T>();           // no element found
-      }
-      return minVal;
-   }
    case LELFunctionEnums::MAX1D :
    {
       if (pExpr_p->isScalar()) {
          return pExpr_p->getScalar();
       }
-      Bool firstTime = True;
-      T maxVal = T();
-      LatticeExpr<T> latExpr(pExpr_p);
-      if (! latExpr.isMasked()) {
-	 RO_LatticeIterator<T> iter(latExpr);
-	 while (! iter.atEnd()) {
-	    T maxv = max(iter.cursor());
-	    if (firstTime  ||  maxv > maxVal) {
-	       firstTime = False;
-	       maxVal = maxv;
-	    }
-	    iter++;
-	 }
-      } else {
-	 RO_MaskedLatticeIterator<T> iter(latExpr);
-	 Bool delMask, delData;
-	 Array<Bool> mask;
-	 while (! iter.atEnd()) {
-	    const Array<T>& array = iter.cursor();
-	    iter.getMask (mask);
-	    const Bool* maskPtr = mask.getStorage (delMask);
-	    const T* dataPtr = array.getStorage (delData);
-	    size_t n = array.nelements();
-	    T lmaxVal = maxVal;
-	    for (size_t i=0; i<n; i++) {
-	       if (maskPtr[i]) {
-		  if (firstTime  ||  dataPtr[i] > lmaxVal) {
-		     firstTime = False;
-		     lmaxVal = dataPtr[i];
-		  }
-	       }
-	    }
-	    maxVal = lmaxVal;
-	    mask.freeStorage (maskPtr, delMask);
-	    array.freeStorage (dataPtr, delData);
-	    iter++;
-	 }
-      }
-      if (firstTime) {
+      T extVal = T();
+      typename NumericTraits<T>::PrecisionType sumVal = 0;
+      if (reduceArray (extVal, sumVal) == 0) {
 	  return LELScalar<T>();           // no element found
       }
-      return maxVal;
+      return extVal;
    }
    case LELFunctionEnums::MEAN1D :
    {
       if (pExpr_p->isScalar()) {
          return pExpr_p->getScalar();
       }
+      T extVal = T();
       typename NumericTraits<T>::PrecisionType sumVal = 0;
-      size_t nrVal = 0;
-      LatticeExpr<T> latExpr(pExpr_p);
-      Bool delData, delMask;
-
-// Do the sum ourselves to avoid round off
-
-      if (! latExpr.isMasked()) {
-	 RO_LatticeIterator<T> iter(latExpr);
-	 while (! iter.atEnd()) {
-	    const Array<T>& array = iter.cursor();
-	    const T* dataPtr = array.getStorage(delData);
-	    size_t n = array.nelements();
-	    typename NumericTraits<T>::PrecisionType lsumVal = 0;
-	    for (size_t i=0; i<n; i++) {
-		lsumVal += dataPtr[i];
-	    }
-	    sumVal += lsumVal;
-	    array.freeStorage(dataPtr, delData);
-	    nrVal += n;
-	    iter++;
-	 }
-      } else {
-	 RO_MaskedLatticeIterator<T> iter(latExpr);
-	 Array<Bool> mask;
-	 while (! iter.atEnd()) {
-	    const Array<T>& array = iter.cursor();
-	    iter.getMask (mask);
-	    const Bool* maskPtr = mask.getStorage (delMask);
-	    const T* dataPtr = array.getStorage (delData);
-	    size_t n = array.nelements();
-	    typename NumericTraits<T>::PrecisionType lsumVal = 0;
-	    size_t lnrVal = 0;
-	    for (size_t i=0; i<n; i++) {
-	       if (maskPtr[i]) {
-		  lsumVal += dataPtr[i];
-		  lnrVal++;
-	       }
-	    }
-	    sumVal += lsumVal;
-	    nrVal += lnrVal;
-	    mask.freeStorage (maskPtr, delMask);
-	    array.freeStorage (dataPtr, delData);
-	    iter++;
-	 }
-      }
+      size_t nrVal = reduceArray (extVal, sumVal);
       if (nrVal == 0) {
 	  return LELScalar<T>();           // no element found
       }
@@ -346,47 +221,9 @@ LELScalar<T> LELFunction1D<T>::getScalar() const
       if (pExpr_p->isScalar()) {
          return pExpr_p->getScalar();
       }
+      T extVal = T();
       typename NumericTraits<T>::PrecisionType sumVal = 0;
-      LatticeExpr<T> latExpr(pExpr_p);
-      Bool delData, delMask;
-
-// Do the sum ourselves to avoid round off
-
-      if (! latExpr.isMasked()) {
-	 RO_LatticeIterator<T> iter(latExpr);
-	 while (! iter.atEnd()) {
-	    const Array<T>& array = iter.cursor();
-	    const T* dataPtr = array.getStorage(delData);
-	    size_t n = array.nelements();
-	    typename NumericTraits<T>::PrecisionType lsumVal = 0;
-	    for (size_t i=0; i<n; i++) {
-		lsumVal += dataPtr[i];
-	    }
-	    sumVal += lsumVal;
-	    array.freeStorage(dataPtr, delData);
-	    iter++;
-	 }
-      } else {
-	 RO_MaskedLatticeIterator<T> iter(latExpr);
-	 Array<Bool> mask;
-	 while (! iter.atEnd()) {
-	    const Array<T>& array = iter.cursor();
-	    iter.getMask (mask);
-	    const Bool* maskPtr = mask.getStorage (delMask);
-	    const T* dataPtr = array.getStorage (delData);
-	    size_t n = array.nelements();
-	    typename NumericTraits<T>::PrecisionType lsumVal = 0;
-	    for (size_t i=0; i<n; i++) {
-	       if (maskPtr[i]) {
-		  lsumVal += dataPtr[i];
-	       }
-	    }
-	    sumVal += lsumVal;
-	    mask.freeStorage (maskPtr, delMask);
-	    array.freeStorage (dataPtr, delData);
-	    iter++;
-	 }
-      }
+      reduceArray (extVal, sumVal);
       return T(sumVal);
    }
    default:
@@ -395,6 +232,89 @@ LELScalar<T> LELFunction1D<T>::getScalar() const
    return pExpr_p->getScalar();         // to make compiler happy
 }
 
+template <class T>
+size_t LELFunction1D<T>::reduceArray
+                   (T& extVal,
+                    typename NumericTraits<T>::PrecisionType& sumVal) const
+{
+   typedef typename NumericTraits<T>::PrecisionType SumType;
+   const Bool doMin = (function_p == LELFunctionEnums::MIN1D);
+   const Bool doMax = (function_p == LELFunctionEnums::MAX1D);
+// Accumulate per slot (thus per thread) and combine the partial results
+// in slot order thereafter.
+   LatticeExpr<T> latExpr(pExpr_p);
+   const uInt nslot = LatticeExpr<T>::nSlots();
+   std::vector<size_t>  nrVals (nslot, 0);
+   std::vector<T>       extVals(nslot, T());
+   std::vector<SumType> sumVals(nslot, SumType(0));
+   auto reduceChunk = [&] (const LELArray<T>& chunk, const Slicer&, uInt slot)
+   {
+      Bool delData, delMask;
+      const Array<T>& array = chunk.value();
+      const T* dataPtr = array.getStorage (delData);
+      const Bool* maskPtr = 0;
+      if (chunk.isMasked()) {
+         maskPtr = chunk.mask().getStorage (delMask);
+      }
+      const size_t n = array.nelements();
+      size_t lnrVal = nrVals[slot];
+      T lextVal = extVals[slot];
+// Do the sum ourselves to avoid round off
+      SumType lsumVal = 0;
+      if (doMin) {
+         for (size_t i=0; i<n; i++) {
+            if (maskPtr == 0  ||  maskPtr[i]) {
+               if (lnrVal == 0  ||  dataPtr[i] < lextVal) {
+                  lextVal = dataPtr[i];
+               }
+               lnrVal++;
+            }
+         }
+      } else if (doMax) {
+         for (size_t i=0; i<n; i++) {
+            if (maskPtr == 0  ||  maskPtr[i]) {
+               if (lnrVal == 0  ||  dataPtr[i] > lextVal) {
+                  lextVal = dataPtr[i];
+               }
+               lnrVal++;
+            }
+         }
+      } else if (maskPtr == 0) {
+         for (size_t i=0; i<n; i++) {
+            lsumVal += dataPtr[i];
+         }
+         lnrVal += n;
+      } else {
+         for (size_t i=0; i<n; i++) {
+            if (maskPtr[i]) {
+               lsumVal += dataPtr[i];
+               lnrVal++;
+            }
+         }
+      }
+      nrVals[slot]  = lnrVal;
+      extVals[slot] = lextVal;
+      sumVals[slot] += lsumVal;
+      if (maskPtr) {
+         chunk.mask().freeStorage (maskPtr, delMask);
+      }
+      array.freeStorage (dataPtr, delData);
+   };
+   latExpr.evalChunks (latExpr.niceCursorShape(), reduceChunk, True);
+   size_t nrVal = 0;
+   for (uInt i=0; i<nslot; ++i) {
+      if (nrVals[i] > 0) {
+         if (nrVal == 0  ||  (doMin && extVals[i] < extVal)
+         ||  (doMax && extVals[i] > extVal)) {
+            extVal = extVals[i];
+         }
+         nrVal += nrVals[i];
+         sumVal += sumVals[i];
+      }
+   }
+   return nrVal;
+}
+
 template <class T>
 Bool LELFunction1D<T>::prepareScalarExpr()
 {
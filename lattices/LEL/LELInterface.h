@@ -34,6 +34,7 @@
 #include <casacore/casa/Utilities/DataType.h>
 #include <casacore/casa/IO/FileLocker.h>
 #include <memory>
+#include <mutex>
 
 namespace casacore { //# NAMESPACE CASACORE - BEGIN
 
@@ -43,6 +44,13 @@ template <class T> class LELArray;
 template <class T> class LELArrayRef;
 class Slicer;
 
+// Get the mutex serializing the access to the lattices and regions
+// used in lattice expressions, which makes it possible to evaluate an
+// expression concurrently for different sections.
+// It is a recursive mutex, because a lattice in an expression can
+// be an expression itself.
+std::recursive_mutex& lelAccessMutex();
+
 
 // <summary> This base class provides the interface for Lattice expressions </summary>
 
@@ -133,6 +141,13 @@ class Slicer;
 //  pixels from the Lattice.  The rest only care about the shape of the
 //  buffer in the <src>eval</src> call.
 //
+//  The <src>eval</src> functions can be called concurrently for different
+//  sections (see <src>LatticeExpr::evalChunks</src>). Therefore the
+//  letter classes must not change their state in <src>eval</src>.
+//  The classes accessing a lattice or region (LELLattice and
+//  LELRegionAsBool) serialize that access using the mutex returned by
+//  function <src>lelAccessMutex</src>.
+//
 // </synopsis> 
 //
 // <motivation>
@@ -89,6 +89,7 @@ void LELLattice<T>::eval(LELArray<T>& result,
 	<< pLattice_p.nrefs() << endl;
 #endif
 
+   std::lock_guard<std::recursive_mutex> lock(lelAccessMutex());
    Array<T> tmp = pLattice_p->getSlice (section);
    result.value().reference(tmp);
    if (getAttribute().isMasked()) {
@@ -108,6 +109,7 @@ void LELLattice<T>::evalRef(LELArrayRef<T>& result,
 	<< pLattice_p.nrefs() << endl;
 #endif
 
+   std::lock_guard<std::recursive_mutex> lock(lelAccessMutex());
    Array<T> tmp;
    pLattice_p->getSlice (tmp, section);
    // Cast to its base class LELArray to use the non-const value function.
@@ -34,6 +34,8 @@
 #include <casacore/lattices/LRegions/LatticeRegion.h>
 #include <casacore/casa/Arrays/Slicer.h>
 #include <casacore/casa/Arrays/ArrayFwd.h>
+#include <casacore/casa/OS/OMP.h>
+#include <algorithm>
 
 namespace casacore { //# NAMESPACE CASACORE - BEGIN
 
@@ -220,8 +222,32 @@ public:
 			    const IPosition& stride);
 
   // Copy the data from this lattice to the given lattice.
+  // The expression is evaluated in chunks of the nice cursor shape of the
+  // output lattice using <src>evalChunks</src>, thus in parallel if
+  // OpenMP is used. The chunks are written serially in order.
    virtual void copyDataTo (Lattice<T>& to) const;
 
+  // Evaluate the expression in chunks of the given cursor shape and call
+  // <src>func(const LELArray<T>& chunk, const Slicer& section, uInt slot)</src>
+  // for each chunk.
+  // <br>If OpenMP is used, batches of <src>nSlots()</src> chunks are
+  // evaluated concurrently (the number of threads can be set using
+  // <src>OMP::setNumThreads</src>). Only the computations are done in
+  // parallel; the access to the lattices and regions in the expression is
+  // serialized (see <src>LELInterface</src>).
+  // If <src>parallelFunc</src> is True, <src>func</src> is also called
+  // concurrently by the thread evaluating the chunk. Chunks processed at the
+  // same time have a different <src>slot</src> number, so <src>func</src>
+  // can accumulate partial results per slot without locking.
+  // Otherwise <src>func</src> is called serially in chunk order.
+  // <group>
+  template<typename Func>
+  void evalChunks (const IPosition& cursorShape, Func& func,
+                   Bool parallelFunc) const;
+  static uInt nSlots()
+    { return std::max (1u, OMP::maxThreads()); }
+  // </group>
+
   // Handle the Math operators (+=, -=, *=, /=).
   // They work similarly to copyData(To).
   // However, they are not defined for Bool types, thus specialized below.
@@ -29,11 +29,15 @@
 #include <casacore/lattices/LEL/LatticeExpr.h>
 #include <casacore/lattices/LEL/LELArray.h>
 #include <casacore/lattices/Lattices/LatticeIterator.h>
+#include <casacore/lattices/Lattices/LatticeStepper.h>
 #include <casacore/casa/Arrays/Array.h>
 #include <casacore/casa/Arrays/Slicer.h>
 #include <casacore/casa/Arrays/ArrayMath.h>
 #include <casacore/casa/Utilities/Assert.h>
 #include <casacore/casa/Exceptions/Error.h> 
+#include <exception>
+#include <memory>
+#include <vector>
 
 
 namespace casacore { //# NAMESPACE CASACORE - BEGIN
@@ -255,7 +259,80 @@ void LatticeExpr<T>::copyDataTo (Lattice<T>& to) const
     expr_p.eval (value);
     to.set (value);
   } else {
-    Lattice<T>::copyDataTo (to);
+    // Check the shape conformance.
+    AlwaysAssert (to.isWritable(), AipsError);
+    AlwaysAssert (shape_p.isEqual (to.shape()), AipsError);
+    IPosition cursorShape = to.niceCursorShape();
+    // Create an iterator for the output to setup the cache.
+    // It is not used, because using putSlice directly is faster and as easy.
+    LatticeStepper stepper (shape_p, cursorShape, LatticeStepper::RESIZE);
+    LatticeIterator<T> dummyIter(to, stepper);
+    auto putChunk = [&to] (const LELArray<T>& chunk, const Slicer& section,
+                           uInt)
+      { to.putSlice (chunk.value(), section.start()); };
+    evalChunks (cursorShape, putChunk, False);
+  }
+}
+
+template<class T>
+template<typename Func>
+void LatticeExpr<T>::evalChunks (const IPosition& cursorShape, Func& func,
+                                 Bool parallelFunc) const
+{
+  LatticeStepper stepper (shape_p, cursorShape, LatticeStepper::RESIZE);
+  // Evaluate the chunks in batches; each thread evaluates a single chunk
+  // of a batch, so the memory needed is bounded by the batch size.
+  const uInt nthreads = nSlots();
+  std::vector<Slicer> sections;
+  std::vector<std::unique_ptr<LELArray<T>>> chunks(nthreads);
+  sections.reserve (nthreads);
+  stepper.reset();
+  while (!stepper.atEnd()) {
+    sections.clear();
+    while (sections.size() < nthreads  &&  !stepper.atEnd()) {
+      sections.push_back (Slicer(stepper.position(), stepper.endPosition(),
+                                 Slicer::endIsLast));
+      stepper++;
+    }
+    Int nchunk = sections.size();
+    if (nchunk == 1) {
+      chunks[0].reset (new LELArray<T> (sections[0].length()));
+      expr_p.eval (*chunks[0], sections[0]);
+      func (*chunks[0], sections[0], 0);
+      continue;
+    }
+    // Exceptions cannot be thrown out of a parallel loop, so keep the
+    // first one and rethrow it thereafter.
+    std::exception_ptr excp;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(nchunk)
+#endif
+    for (Int i=0; i<nchunk; ++i) {
+      try {
+        chunks[i].reset (new LELArray<T> (sections[i].length()));
+        expr_p.eval (*chunks[i], sections[i]);
+        if (parallelFunc) {
+          func (*chunks[i], sections[i], i);
+        }
+      } catch (...) {
+#ifdef _OPENMP
+#pragma omp critical(LatticeExpr_evalChunks)
+#endif
+        {
+          if (!excp) {
+            excp = std::current_exception();
+          }
+        }
+      }
+    }
+    if (excp) {
+      std::rethrow_exception (excp);
+    }
+    if (!parallelFunc) {
+      for (Int i=0; i<nchunk; ++i) {
+        func (*chunks[i], sections[i], i);
+      }
+    }
   }
 }
 
@@ -0,0 +1,98 @@
+//# tLatticeExprThread.cc: Test parallel evaluation of lattice expressions
+//# Copyright (C) 2026
+//# Associated Universities, Inc. Washington DC, USA.
+//#
+//# This library is free software; you can redistribute it and/or modify it
+//# under the terms of the GNU Library General Public License as published by
+//# the Free Software Foundation; either version 2 of the License, or (at your
+//# option) any later version.
+//#
+//# This library is distributed in the hope that it will be useful, but WITHOUT
+//# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+//# License for more details.
+//#
+//# You should have received a copy of the GNU Library General Public License
+//# along with this library; if not, write to the Free Software Foundation,
+//# Inc., 675 Massachusetts Ave, Cambridge, MA 02139, USA.
+//#
+//# Correspondence concerning AIPS++ should be addressed as follows:
+//#        Internet email: aips2-request@nrao.edu.
+//#        Postal address: AIPS++ Project Office
+//#                        National Radio Astronomy Observatory
+//#                        520 Edgemont Road
+//#                        Charlottesville, VA 22903-2475 USA
+
+#include <casacore/lattices/LEL/LatticeExpr.h>
+#include <casacore/lattices/LEL/LatticeExprNode.h>
+#include <casacore/lattices/Lattices/ArrayLattice.h>
+#include <casacore/lattices/Lattices/TempLattice.h>
+#include <casacore/casa/Arrays/ArrayMath.h>
+#include <casacore/casa/Arrays/ArrayLogical.h>
+#include <casacore/casa/OS/OMP.h>
+#include <casacore/casa/Utilities/Assert.h>
+#include <casacore/casa/Exceptions/Error.h>
+#include <casacore/casa/iostream.h>
+
+
+#include <casacore/casa/namespace.h>
+
+// Evaluate some expressions and check if the results match the
+// results of the plain array math.
+void doTest (uInt nthreads)
+{
+  cout << "Test using " << nthreads << " threads" << endl;
+  OMP::setNumThreads (nthreads);
+  // Use a small tile shape to get many chunks.
+  IPosition shape(3, 32, 24, 10);
+  TempLattice<Float> lat1 (TiledShape(shape, IPosition(3,8,8,2)), 0);
+  TempLattice<Float> lat2 (TiledShape(shape, IPosition(3,8,8,2)), 0);
+  Array<Float> arr1(shape), arr2(shape);
+  indgen (arr1, Float(1), Float(0.5));
+  indgen (arr2, Float(2), Float(0.25));
+  lat1.put (arr1);
+  lat2.put (arr2);
+  LatticeExprNode n1(lat1);
+  LatticeExprNode n2(lat2);
+  // Copy an expression to a lattice.
+  {
+    TempLattice<Float> out (TiledShape(shape, IPosition(3,8,8,2)), 0);
+    out.copyData (LatticeExpr<Float> ((n1 - n2) / sqrt(n2)));
+    Array<Float> expected = (arr1 - arr2) / sqrt(arr2);
+    AlwaysAssertExit (allNear (out.get(), expected, 1e-5));
+  }
+  // The same for an expression using the same lattice twice.
+  {
+    ArrayLattice<Float> out (shape);
+    out.copyData (LatticeExpr<Float> (n1*n1 + 2*n1));
+    Array<Float> expected = arr1*arr1 + Float(2)*arr1;
+    AlwaysAssertExit (allNear (out.get(), expected, 1e-5));
+  }
+  // Reductions of unmasked and masked expressions.
+  {
+    AlwaysAssertExit (near (sum(n1).getFloat(), sum(arr1), 1e-5));
+    AlwaysAssertExit (near (min(n2-n1).getFloat(), min(arr2-arr1), 1e-5));
+    AlwaysAssertExit (near (max(n2-n1).getFloat(), max(arr2-arr1), 1e-5));
+    AlwaysAssertExit (near (mean(n1).getFloat(), mean(arr1), 1e-5));
+    LatticeExprNode masked = n1[n1 > Float(1000)];
+    Array<Float> sel = arr1(arr1 > Float(1000)).getCompressedArray();
+    AlwaysAssertExit (near (sum(masked).getFloat(), sum(sel), 1e-5));
+    AlwaysAssertExit (near (min(masked).getFloat(), min(sel), 1e-5));
+    AlwaysAssertExit (near (max(masked).getFloat(), max(sel), 1e-5));
+    AlwaysAssertExit (near (nelements(masked).getDouble(),
+                            Double(sel.size()), 1e-10));
+  }
+}
+
+int main()
+{
+  try {
+    doTest (1);
+    doTest (4);
+  } catch (const std::exception& x) {
+    cout << "Unexpected exception: " << x.what() << endl;
+    return 1;
+  }
+  cout << "OK" << endl;
+  return 0;
+}
@@ -229,6 +229,11 @@ public:
   // Helper function to optimize adding
   static void addTo(Lattice<T>& to, const Lattice<T>& add);
 
+  // Add <src>factor*add</src> to <src>to</src> without the overhead of
+  // a LatticeExpr. In-memory lattices are processed as a whole in
+  // parallel, others in chunks of the nice cursor shape.
+  static void addScaled(Lattice<T>& to, const Lattice<T>& add, T factor);
+
 protected:
   // Make sure that the peak of the Psf is within the image
   Bool validatePsf(const Lattice<T> & psf);
@@ -247,6 +252,22 @@ protected:
   Bool findMaxAbsMaskLattice(const Lattice<T>& lattice, const Lattice<T>& mask,
                              T& maxAbs, IPosition& posMax);
 
+  // Get the cursor shape to use when processing a lattice in chunks.
+  // An in-memory lattice is processed as a whole.
+  static IPosition chunkShape(const Lattice<T>& lattice);
+
+  // Find the peak in a chunk consisting of <src>nlines</src> lines.
+  // <src>lineFunc(line, value)</src> gives the candidate value of a line
+  // and returns its position in the line. The candidate with the largest
+  // (absolute) value exceeding <src>peak</src> is returned in
+  // <src>peak, line, pixel</src>; in case of equal values the first line
+  // is taken. The lines are processed in parallel if large enough.
+  // It returns False if no candidate exceeded <src>peak</src>.
+  template<typename LineFunc>
+  static Bool findPeakInLines(size_t nlines, size_t lineLength,
+                              LineFunc lineFunc, Bool useAbs,
+                              T& peak, size_t& line, size_t& pixel);
+
   // Helper function to reduce the box sizes until the have the same   
   // size keeping the centers intact  
   static void makeBoxesSameSize(IPosition& blc1, IPosition& trc1,                               
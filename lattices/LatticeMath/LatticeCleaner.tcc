@@ -48,6 +48,7 @@
 #include <casacore/lattices/LEL/LatticeExprNode.h>
 
 #include <casacore/casa/OS/HostInfo.h>
+#include <casacore/casa/OS/OMP.h>
 #include <casacore/casa/System/PGPlotter.h>
 #include <casacore/casa/Arrays/ArrayError.h>
 #include <casacore/casa/Arrays/ArrayIter.h>
@@ -66,6 +67,9 @@
 #include <casacore/casa/Arrays/ArrayMath.h>
 #include <casacore/casa/Arrays/Matrix.h>
 
+#include <algorithm>
+#include <vector>
+
 
 
 namespace casacore { //# NAMESPACE CASACORE - BEGIN
@@ -619,8 +623,7 @@ Int LatticeCleaner<T>::clean(Lattice<T>& model,
     SubLattice<T> scaleSub(*itsScales[optimumScale], subRegionPsf, True);
     
     // Now do the addition of this scale to the model image....
-    LatticeExpr<T> add(scaleFactor*scaleSub);
-    addTo(modelSub, add);
+    addScaled(modelSub, scaleSub, scaleFactor);
 
     // and then subtract the effects of this scale from all the precomputed
     // dirty convolutions.
@@ -629,8 +632,7 @@ Int LatticeCleaner<T>::clean(Lattice<T>& model,
       AlwaysAssert(itsPsfConvScales[index(scale,optimumScale)], AipsError);
       SubLattice<T> psfSub(*itsPsfConvScales[index(scale,optimumScale)],
 			   subRegionPsf, True);
-      LatticeExpr<T> sub((-scaleFactor)*psfSub);
-      addTo(dirtySub, sub);
+      addScaled(dirtySub, psfSub, -scaleFactor);
     }
   }
   // End of iteration
@@ -664,6 +666,55 @@ Int LatticeCleaner<T>::clean(Lattice<T>& model,
 }
 
 
+template<class T>
+IPosition LatticeCleaner<T>::chunkShape(const Lattice<T>& lattice)
+{
+  if (lattice.isPaged()) {
+    return lattice.niceCursorShape();
+  }
+  return lattice.shape();
+}
+
+template<class T>
+template<typename LineFunc>
+Bool LatticeCleaner<T>::findPeakInLines(size_t nlines, size_t lineLength,
+                                        LineFunc lineFunc, Bool useAbs,
+                                        T& peak, size_t& line, size_t& pixel)
+{
+  // Each thread handles a contiguous block of lines (static schedule).
+  // Merging the results in thread order keeps the first of equal peaks,
+  // so the result does not depend on the number of threads.
+  const uInt nthreads = (nlines*lineLength < 16384  ?  1 :
+                         std::max (1u, OMP::maxThreads()));
+  std::vector<T> thrPeak(nthreads, peak);
+  std::vector<Int64> thrLine(nthreads, -1);
+  std::vector<size_t> thrPixel(nthreads, 0);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+#endif
+  for (Int64 i=0; i<Int64(nlines); ++i) {
+    const uInt thr = OMP::threadNum();
+    T value;
+    size_t pos = lineFunc (size_t(i), value);
+    if (useAbs ? abs(value) > abs(thrPeak[thr]) : value > thrPeak[thr]) {
+      thrPeak[thr]  = value;
+      thrLine[thr]  = i;
+      thrPixel[thr] = pos;
+    }
+  }
+  Bool found = False;
+  for (uInt i=0; i<nthreads; ++i) {
+    if (thrLine[i] >= 0  &&
+        (useAbs ? abs(thrPeak[i]) > abs(peak) : thrPeak[i] > peak)) {
+      peak  = thrPeak[i];
+      line  = thrLine[i];
+      pixel = thrPixel[i];
+      found = True;
+    }
+  }
+  return found;
+}
+
 template<class T>
 Bool LatticeCleaner<T>::findMaxAbsLattice(const Lattice<T>& lattice,
 					  T& maxAbs,
@@ -672,27 +723,40 @@ Bool LatticeCleaner<T>::findMaxAbsLattice(const Lattice<T>& lattice,
 
   posMaxAbs = IPosition(lattice.shape().nelements(), 0);
   maxAbs=0.0;
-  const IPosition tileShape = lattice.niceCursorShape();
-  TiledLineStepper ls(lattice.shape(), tileShape, 0);
-  {
-    RO_LatticeIterator<T> li(lattice, ls);
-    for(li.reset();!li.atEnd();li++) {
-      IPosition posMax=li.position();
-      IPosition posMin=li.position();
-      T maxVal=0.0;
-      T minVal=0.0;
-      minMax(minVal, maxVal, posMin, posMax, li.cursor());
-      if(abs(minVal)>abs(maxAbs)) {
-        maxAbs=minVal;
-	posMaxAbs=li.position();
-	posMaxAbs(0)=posMin(0);
-      }
-      if(abs(maxVal)>abs(maxAbs)) {
-        maxAbs=maxVal;
-	posMaxAbs=li.position();
-	posMaxAbs(0)=posMax(0);
-      }
+  LatticeStepper ls(lattice.shape(), chunkShape(lattice),
+                    LatticeStepper::RESIZE);
+  RO_LatticeIterator<T> li(lattice, ls);
+  for(li.reset();!li.atEnd();li++) {
+    const Array<T>& chunk = li.cursor();
+    const IPosition& shape = chunk.shape();
+    const size_t nx = shape[0];
+    Bool deleteIt;
+    const T* data = chunk.getStorage (deleteIt);
+    // As in minMax, take the first minimum and maximum in each line and
+    // prefer the minimum if both have the same absolute value.
+    size_t line, pixel;
+    if (findPeakInLines (chunk.nelements() / nx, nx,
+                         [data, nx] (size_t l, T& value) -> size_t
+                         {
+                           const T* d = data + l*nx;
+                           size_t minp = 0;
+                           size_t maxp = 0;
+                           for (size_t i=1; i<nx; ++i) {
+                             if (d[i] < d[minp]) {
+                               minp = i;
+                             } else if (d[i] > d[maxp]) {
+                               maxp = i;
+                             }
+                           }
+                           const size_t pos = (abs(d[maxp]) > abs(d[minp])
+                                               ?  maxp : minp);
+                           value = d[pos];
+                           return pos;
+                         },
+                         True, maxAbs, line, pixel)) {
+      posMaxAbs = li.position() + toIPositionInArray (line*nx + pixel, shape);
     }
+    chunk.freeStorage (data, deleteIt);
   }
 
   return True;
@@ -710,46 +774,64 @@ Bool LatticeCleaner<T>::findMaxAbsMaskLattice(const Lattice<T>& lattice,
 
   posMaxAbs = IPosition(lattice.shape().nelements(), 0);
   maxAbs=0.0;
-  const IPosition tileShape = lattice.niceCursorShape();
-  TiledLineStepper ls(lattice.shape(), tileShape, 0);
-  {
-    RO_LatticeIterator<T> li(lattice, ls);
-    RO_LatticeIterator<T> mi(mask, ls);
-    for(li.reset(),mi.reset();!li.atEnd();li++, mi++) {
-      IPosition posMax=li.position();
-      IPosition posMin=li.position();
-      IPosition posMaxMask=li.position();
-      IPosition posMinMask=li.position();
-      T maxVal=0.0;
-      T minVal=0.0;
-      
-      minMaxMasked(minVal, maxVal, posMin, posMax, li.cursor(), mi.cursor());
-      if (itsMaskThreshold<0) {
-          // Mask threhsolding is not used, i.e. mask values are interpreted as weights.
-          // This means that minVal and maxVal are optima of the mask * lattice product, 
-          // we need just values of lattice and have to redetermine them.
-          minVal = li.cursor()(posMin);
-          maxVal = li.cursor()(posMax);
-      }
-
-      if(abs(minVal)>abs(maxAbs)) {
-         maxAbs=minVal;
-         posMaxAbs=li.position();
-         posMaxAbs(0)=posMin(0);
-      }
-      if(abs(maxVal)>abs(maxAbs)) {
-         maxAbs=maxVal;
-         posMaxAbs=li.position();
-         posMaxAbs(0)=posMax(0);
-      }
+  LatticeStepper ls(lattice.shape(), chunkShape(lattice),
+                    LatticeStepper::RESIZE);
+  RO_LatticeIterator<T> li(lattice, ls);
+  RO_LatticeIterator<T> mi(mask, ls);
+  // If mask thresholding is not used, mask values are interpreted as
+  // weights. The optima are found in the mask * lattice product, but
+  // the lattice values are returned.
+  const Bool useWeights = (itsMaskThreshold < 0);
+  for(li.reset(),mi.reset();!li.atEnd();li++, mi++) {
+    const Array<T>& chunk = li.cursor();
+    const Array<T>& mchunk = mi.cursor();
+    const IPosition& shape = chunk.shape();
+    const size_t nx = shape[0];
+    Bool deleteIt, deleteMask;
+    const T* data = chunk.getStorage (deleteIt);
+    const T* mdata = mchunk.getStorage (deleteMask);
+    size_t line, pixel;
+    if (findPeakInLines (chunk.nelements() / nx, nx,
+                         [data, mdata, nx, useWeights] (size_t l, T& value)
+                         -> size_t
+                         {
+                           const T* d = data + l*nx;
+                           const T* m = mdata + l*nx;
+                           size_t minp = 0;
+                           size_t maxp = 0;
+                           T minv = d[0] * m[0];
+                           T maxv = minv;
+                           for (size_t i=1; i<nx; ++i) {
+                             const T tmp = d[i] * m[i];
+                             if (tmp < minv) {
+                               minv = tmp;
+                               minp = i;
+                             } else if (tmp > maxv) {
+                               maxv = tmp;
+                               maxp = i;
+                             }
+                           }
+                           if (useWeights) {
+                             minv = d[minp];
+                             maxv = d[maxp];
+                           }
+                           if (abs(maxv) > abs(minv)) {
+                             value = maxv;
+                             return maxp;
+                           }
+                           value = minv;
+                           return minp;
+                         },
+                         True, maxAbs, line, pixel)) {
+      posMaxAbs = li.position() + toIPositionInArray (line*nx + pixel, shape);
     }
+    chunk.freeStorage (data, deleteIt);
+    mchunk.freeStorage (mdata, deleteMask);
   }
 
   return True;
 }
 
-
-
 template<class T>
 Bool LatticeCleaner<T>::setscales(const Int nscales, const Float scaleInc)
 {
@@ -1188,6 +1270,35 @@ void LatticeCleaner<T>::addTo(Lattice<T>& to, const Lattice<T>& add)
   }
 }
 
+template<class T>
+void LatticeCleaner<T>::addScaled(Lattice<T>& to, const Lattice<T>& add,
+                                  T factor)
+{
+  AlwaysAssert (to.isWritable(), AipsError);
+  const IPosition shapeOut = to.shape();
+  AlwaysAssert (add.shape().isEqual (shapeOut), AipsError);
+  LatticeStepper stepper (shapeOut, chunkShape(to), LatticeStepper::RESIZE);
+  LatticeIterator<T> toIter(to, stepper);
+  RO_LatticeIterator<T> addIter(add, stepper);
+  for (addIter.reset(), toIter.reset(); !addIter.atEnd();
+       addIter++, toIter++) {
+    Array<T>& toArr = toIter.rwCursor();
+    const Array<T>& addArr = addIter.cursor();
+    Bool deleteTo, deleteAdd;
+    T* toData = toArr.getStorage (deleteTo);
+    const T* addData = addArr.getStorage (deleteAdd);
+    const Int64 n = toArr.nelements();
+#ifdef _OPENMP
+#pragma omp parallel for if (n >= 65536)
+#endif
+    for (Int64 i=0; i<n; ++i) {
+      toData[i] += factor * addData[i];
+    }
+    toArr.putStorage (toData, deleteTo);
+    addArr.freeStorage (addData, deleteAdd);
+  }
+}
+
 template <class T>
 void LatticeCleaner<T>::makeBoxesSameSize(IPosition& blc1, IPosition& trc1, 
                   IPosition &blc2, IPosition& trc2)
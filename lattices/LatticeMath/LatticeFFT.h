@@ -48,6 +48,11 @@ template <class T> class Lattice;
 // </etymology>
 
 // <synopsis> 
+// The complex->complex transforms along an axis are done on slabs of the
+// lattice holding whole tiles and the entire axis. The lines in a slab are
+// transformed in parallel (if OpenMP is used) where each thread has its
+// own FFTServer object (thus its own FFT plans). The number of threads
+// can be set using <src>OMP::setNumThreads</src>.
 // </synopsis> 
 
 // <example>
@@ -144,6 +149,15 @@ public:
         const Bool doShift=True, Bool doFast=False
     );
   // </group>
+
+private:
+  // Apply <src>func(FFTServer&, Vector<ComplexType>& line)</src> to all
+  // lines along the given axis of the lattice (in place).
+  // The lattice is read in slabs of whole tiles containing the entire
+  // axis; the lines in a slab are processed in parallel.
+    template <class ComplexType, typename Func> static void doLines(
+        Lattice<ComplexType>& cLattice, uInt axis, Func func
+    );
 };
 
 // implement template specializations to throw exceptions in the relevant cases.
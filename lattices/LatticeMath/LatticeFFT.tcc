@@ -42,7 +42,12 @@
 #include <casacore/lattices/Lattices/TempLattice.h>
 #include <casacore/lattices/Lattices/TiledLineStepper.h>
 #include <casacore/casa/OS/HostInfo.h>
+#include <casacore/casa/OS/OMP.h>
 #include <casacore/casa/iostream.h>
+#include <algorithm>
+#include <exception>
+#include <memory>
+#include <vector>
 
 namespace casacore { //# NAMESPACE CASACORE - BEGIN
 
@@ -83,17 +88,13 @@ template <class ComplexType> void LatticeFFT::cfft(Lattice<ComplexType>& cLattic
   const uInt ndim = cLattice.ndim();
   DebugAssert(ndim > 0, AipsError);
   DebugAssert(ndim == whichAxes.nelements(), AipsError);
-  FFTServer<typename NumericTraits<ComplexType>::ConjugateType,ComplexType> ffts;
-  const IPosition latticeShape = cLattice.shape();
-  const IPosition tileShape = cLattice.niceCursorShape();
-
+  typedef FFTServer<typename NumericTraits<ComplexType>::ConjugateType,
+                    ComplexType> Server;
   for (uInt dim = 0; dim < ndim; dim++) {
     if (whichAxes(dim) == True) {
-      TiledLineStepper ts(latticeShape, tileShape, dim);
-      LatticeIterator<ComplexType> li(cLattice, ts);
-      for (li.reset(); !li.atEnd(); li++) {
-	ffts.fft(li.rwVectorCursor(), toFrequency);
-      }
+      doLines (cLattice, dim,
+               [toFrequency] (Server& ffts, Vector<ComplexType>& line)
+               { ffts.fft(line, toFrequency); });
     }
   }
 }
@@ -103,17 +104,13 @@ template <class ComplexType> void LatticeFFT::cfft0(Lattice<ComplexType>& cLatti
   const uInt ndim = cLattice.ndim();
   DebugAssert(ndim > 0, AipsError);
   DebugAssert(ndim == whichAxes.nelements(), AipsError);
-  FFTServer<typename NumericTraits<ComplexType>::ConjugateType,ComplexType> ffts;
-  const IPosition latticeShape = cLattice.shape();
-  const IPosition tileShape = cLattice.niceCursorShape();
-
+  typedef FFTServer<typename NumericTraits<ComplexType>::ConjugateType,
+                    ComplexType> Server;
   for (uInt dim = 0; dim < ndim; dim++) {
     if (whichAxes(dim) == True) {
-      TiledLineStepper ts(latticeShape, tileShape, dim);
-      LatticeIterator<ComplexType> li(cLattice, ts);
-      for (li.reset(); !li.atEnd(); li++) {
-	ffts.fft0(li.rwVectorCursor(), toFrequency);
-      }
+      doLines (cLattice, dim,
+               [toFrequency] (Server& ffts, Vector<ComplexType>& line)
+               { ffts.fft0(line, toFrequency); });
     }
   }
 }
@@ -185,21 +182,17 @@ template <class ComplexType> void LatticeFFT::rcfft(
 	  }
 	  else { // Do complex->complex transforms
 	    if (inShape(dim) != 1) { 
-	      LatticeIterator<ComplexType> iter(out,
-					    TiledLineStepper(outShape,
-							     tileShape, dim));
-	      for (iter.reset(); !iter.atEnd(); iter++) {
-		if (doShift) {
-		  if(doFast){
-		    ffts.fft0(iter.rwVectorCursor(),True);
-		  }
-		  else{
-		    ffts.fft(iter.rwVectorCursor(),True);
-		  }
-		} else {
-		  ffts.fft0(iter.rwVectorCursor(), True);
-		}
-	      }
+	      const Bool fold = doShift && !doFast;
+	      doLines (out, dim,
+		       [fold] (FFTServer<typename NumericTraits<ComplexType>::ConjugateType,ComplexType>& lffts,
+			       Vector<ComplexType>& line)
+		       {
+			 if (fold) {
+			   lffts.fft(line, True);
+			 } else {
+			   lffts.fft0(line, True);
+			 }
+		       });
 	    }
 	  }
 	}
@@ -259,17 +252,15 @@ template <class ComplexType> void LatticeFFT::myrcfft(
 	  }
 	  else { // Do complex->complex transforms
 	    if (inShape(dim) != 1) { 
-	      LatticeIterator<ComplexType> iter(out,
-					    TiledLineStepper(outShape, tileShape, dim));
-	      for (iter.reset(); !iter.atEnd(); iter++) {
-		if (doShift) {
-		  //		  ffts.fft(iter.rwVectorCursor(), 1, True);
-		  ffts.flip(iter.rwVectorCursor(),True,False);
-		  ffts.fft0(iter.rwVectorCursor(),True);
-		} else {
-		  ffts.fft0(iter.rwVectorCursor(), True);
-		}
-	      }
+	      doLines (out, dim,
+		       [doShift] (FFTServer<typename NumericTraits<ComplexType>::ConjugateType,ComplexType>& lffts,
+				  Vector<ComplexType>& line)
+		       {
+			 if (doShift) {
+			   lffts.flip(line, True, False);
+			 }
+			 lffts.fft0(line, True);
+		       });
 	    }
 	  }
 	}
@@ -329,22 +320,19 @@ template <class ComplexType> void LatticeFFT::crfft(
     if (whichAxes(dim) == True) {
       if (dim != firstAxis) { // Do complex->complex Transforms
 	if (inShape(dim) != 1) { // no need to do anything unless len > 1
-	  LatticeIterator<ComplexType> iter(in, TiledLineStepper(inShape,
-							     tileShape, dim));
-	  for (iter.reset(); !iter.atEnd(); iter++) {
-	    if (doShift) {
-	      if(doFast){
-		ffts.fft0(iter.rwVectorCursor(), False);
-		ffts.flip(iter.rwVectorCursor(), False, False);
-	      }
-	      else{
-	      //	      ffts.fft(iter.rwVectorCursor(), 2, False);
-	      ffts.fft(iter.rwVectorCursor(),False);
-	      }
-	    } else {
-	      ffts.fft0(iter.rwVectorCursor(), False);
-	    }
-	  }
+	  doLines (in, dim,
+		   [doShift, doFast] (FFTServer<typename NumericTraits<ComplexType>::ConjugateType,ComplexType>& lffts,
+				      Vector<ComplexType>& line)
+		   {
+		     if (doShift  &&  !doFast) {
+		       lffts.fft(line, False);
+		     } else {
+		       lffts.fft0(line, False);
+		       if (doShift) {
+			 lffts.flip(line, False, False);
+		       }
+		     }
+		   });
 	}
       } else { // the first axis is treated specially
 	if (inShape(dim) != 1) { // Do complex->real transforms
@@ -391,6 +379,77 @@ template <class ComplexType> void LatticeFFT::crfft(
  inCopy.copyData(in);
  LatticeFFT::crfft(out, inCopy, doShift, doFast);
 }
+template <class ComplexType, typename Func> void LatticeFFT::doLines(
+    Lattice<ComplexType>& cLattice, uInt axis, Func func
+) {
+  typedef FFTServer<typename NumericTraits<ComplexType>::ConjugateType,
+                    ComplexType> Server;
+  const IPosition latticeShape = cLattice.shape();
+  // Iterate through the lattice in slabs of whole tiles containing the
+  // entire axis, so each tile is read and written only once.
+  IPosition slabShape = cLattice.niceCursorShape();
+  slabShape(axis) = latticeShape(axis);
+  LatticeStepper stepper(latticeShape, slabShape, LatticeStepper::RESIZE);
+  LatticeIterator<ComplexType> iter(cLattice, stepper);
+  // Each thread uses its own FFTServer, thus its own plans and buffers.
+  const uInt nthreads = std::max (1u, OMP::maxThreads());
+  std::vector<std::unique_ptr<Server>> servers(nthreads);
+  for (uInt i=0; i<nthreads; ++i) {
+    servers[i].reset (new Server());
+  }
+  for (iter.reset(); !iter.atEnd(); iter++) {
+    Array<ComplexType>& slab = iter.rwCursor();
+    const IPosition& shape = slab.shape();
+    // Element i of a line is at offset i*stride.
+    Int64 stride = 1;
+    for (uInt i=0; i<axis; ++i) {
+      stride *= shape(i);
+    }
+    const Int64 length = shape(axis);
+    const Int64 nlines = shape.product() / length;
+    Bool deleteIt;
+    ComplexType* data = slab.getStorage (deleteIt);
+    std::exception_ptr excp;
+#ifdef _OPENMP
+#pragma omp parallel num_threads(nthreads) if(nlines > 1)
+#endif
+    {
+      Server& ffts = *servers[OMP::threadNum()];
+      Vector<ComplexType> line(length);
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+      for (Int64 l=0; l<nlines; ++l) {
+        ComplexType* ptr = data + (l/stride)*stride*length + l%stride;
+        try {
+          // Resize as the function might have changed the size.
+          line.resize (length);
+          for (Int64 i=0; i<length; ++i) {
+            line(i) = ptr[i*stride];
+          }
+          func (ffts, line);
+          for (Int64 i=0; i<length; ++i) {
+            ptr[i*stride] = line(i);
+          }
+        } catch (...) {
+#ifdef _OPENMP
+#pragma omp critical(LatticeFFT_doLines)
+#endif
+          {
+            if (!excp) {
+              excp = std::current_exception();
+            }
+          }
+        }
+      }
+    }
+    slab.putStorage (data, deleteIt);
+    if (excp) {
+      std::rethrow_exception (excp);
+    }
+  }
+}
+
 // Local Variables: 
 // compile-command: "gmake OPTLIB=1 LatticeFFT"
 // End: 
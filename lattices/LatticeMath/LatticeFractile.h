@@ -72,6 +72,7 @@ template<class T> class Block;
 // elements of the bins containing the fractiles. This continues
 // until the number of elements left is less than <src>smallSize</src>.
 // Typically only 2 passes are needed for a big image.
+// The histograms are made in parallel if OpenMP is used.
 // <br>
 // The algorithm is robust and takes possible rounding errors into account.
 // It also takes into account that the lattice can contain many equal values.
@@ -132,6 +133,24 @@ public:
 				    uInt smallSize = 4096*4096);
   // </group>
 
+  // Determine the values at the given fractions in a single series
+  // of passes over the lattice, thus the same number of passes as needed
+  // for a single fractile.
+  // <br>If the lattice is masked, only masked-on elements are taken
+  // into account. If it has no masked-on elements, an empty vector is
+  // returned.
+  // <br><src>smallSize</src> is the memory budget; it gives the maximum
+  // total number of values held in memory. Successive histograms are
+  // made until the number of values left for all fractiles together does
+  // not exceed it.
+  // <br>The histogram of each chunk of the lattice is made in parallel
+  // using <src>OMP::maxThreads()</src> threads, each filling its own
+  // histogram. The histograms are merged at the end of each pass.
+  // The lattice itself is read sequentially.
+  static Vector<T> maskedFractiles (const MaskedLattice<T>& lattice,
+                                    const Vector<Float>& fractions,
+                                    uInt smallSize = 4096*4096);
+
 private:
   // Determine the fractile for a small masked lattice.
   static Vector<T> smallMaskedFractile (const MaskedLattice<T>& lattice,
@@ -141,19 +160,25 @@ private:
   static Vector<T> smallMaskedFractiles (const MaskedLattice<T>& lattice,
 					 Float left, Float right);
 
-  // Calculate the first histogram (with 10000 bins).
-  // Also calculate the minimum and maximum. It returns the number
-  // of masked-on values. Masked-off values are ignored.
-  // <group>
-  static uInt maskedHistogram (T& stv, T& endv, T& minv, T& maxv,
-			       Block<uInt>& hist,
-			       Block<T>& boundaries,
-			       const MaskedLattice<T>& lattice);
-  static void unmaskedHistogram (T& stv, T& endv, T& minv, T& maxv,
-				 Block<uInt>& hist,
-				 Block<T>& boundaries,
-				 const Lattice<T>& lattice);
-  // </group>
+  // Determine the fractiles of a large lattice in multiple passes.
+  // If <src>mlattice</src> is not null, it is the masked version of
+  // <src>lattice</src> and only its masked-on elements are used.
+  // An empty vector is returned if no masked-on elements are found.
+  static Vector<T> multiPassFractiles (const Lattice<T>& lattice,
+                                       const MaskedLattice<T>* mlattice,
+                                       const Vector<Float>& fractions,
+                                       uInt smallSize);
+
+  // Iterate through the lattice and call <src>func(data, mask, n)</src>
+  // for each chunk. The mask pointer is null if <src>mlattice</src> is null.
+  template<typename Func>
+  static void iterateChunks (const Lattice<T>& lattice,
+                             const MaskedLattice<T>* mlattice,
+                             Func& func);
+
+  // Histogram (and number of values, min and max) of the values in an
+  // interval accumulated by a single thread.
+  struct Histogram;
 
   // Helper function which determines which bin in the histogram 
   // contains the passed index. 
@@ -166,11 +191,11 @@ private:
   // to minv and the last bin to maxv.
   // If the bins are getting too small (i.e. if stv is nearly endv), 0 is
   // returned. In that case endv contains the fractile.
-  static uInt findBin (uInt& fractileInx,
-		       T& stv, T& endv,
-		       T minv, T maxv,
-		       const Block<uInt>& hist,
-		       const Block<T>& boundaries);
+  static uInt64 findBin (uInt64& fractileInx,
+                         T& stv, T& endv,
+                         T minv, T maxv,
+                         const Block<uInt64>& hist,
+                         const Block<T>& boundaries);
 };
 
 
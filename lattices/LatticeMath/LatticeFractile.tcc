@@ -36,16 +36,32 @@
 #include <casacore/casa/Utilities/COWPtr.h>
 #include <casacore/casa/Utilities/Assert.h>
 #include <casacore/casa/Exceptions/Error.h>
+#include <casacore/casa/OS/OMP.h>
+#include <algorithm>
+#include <vector>
 
 
 namespace casacore { //# NAMESPACE CASACORE - BEGIN
 
 template <class T>
-uInt LatticeFractile<T>::findBin (uInt& fractileInx,
-				  T& stv, T& endv,
-				  T minv, T maxv,
-				  const Block<uInt>& hist,
-				  const Block<T>& boundaries)
+struct LatticeFractile<T>::Histogram
+{
+  explicit Histogram (uInt nbins)
+    : hist (nbins+1, 0), nval (0), minv (0), maxv (0)
+  {}
+  std::vector<uInt64> hist;
+  uInt64 nval;
+  T minv;
+  T maxv;
+};
+
+
+template <class T>
+uInt64 LatticeFractile<T>::findBin (uInt64& fractileInx,
+                                    T& stv, T& endv,
+                                    T minv, T maxv,
+                                    const Block<uInt64>& hist,
+                                    const Block<T>& boundaries)
 {
   // Return 0 if minimum and maximum value are about equal.
   if (near (minv, maxv)) {
@@ -53,7 +69,7 @@ uInt LatticeFractile<T>::findBin (uInt& fractileInx,
     return 0;
   }
   uInt foundBin = 0;
-  uInt ndone = 0;
+  uInt64 ndone = 0;
   const uInt nbins = hist.nelements()-1;
   // First determine the index of the bin containing the specified index.
   // If not found (rounding problems are possible) 0 is returned.
@@ -69,7 +85,7 @@ uInt LatticeFractile<T>::findBin (uInt& fractileInx,
   // The nr of values in there have to be examined again.
   // Determine the offset of the fractile in the bin.
   // The start/end values are reset to the boundaries of this bin.
-  uInt ntodo = hist[foundBin];
+  uInt64 ntodo = hist[foundBin];
   ndone -= ntodo;
   fractileInx -= ndone;
   stv  = boundaries[foundBin];
@@ -90,134 +106,339 @@ uInt LatticeFractile<T>::findBin (uInt& fractileInx,
 
 
 template <class T>
-void LatticeFractile<T>::unmaskedHistogram (T& stv, T& endv, T& minv, T& maxv,
-					    Block<uInt>& hist,
-					    Block<T>& boundaries,
-					    const Lattice<T>& lattice)
+template <typename Func>
+void LatticeFractile<T>::iterateChunks (const Lattice<T>& lattice,
+                                        const MaskedLattice<T>* mlattice,
+                                        Func& func)
 {
-  AlwaysAssert (hist.nelements() == boundaries.nelements(), AipsError);
-  // Find number of bins (last one is for extraneous values).
-  // Scale between -50 and +50 (which is usually okay for
-  // radio-astronomical images, both for the image itself and for
-  // difference of image with median or so).
-  // It is only a first guess, so nothing goes wrong if grossly incorrect.
-  // It may only result in one more iteration.
-  const uInt nbins = hist.nelements() - 1;
-  T step = 2*50./nbins;
-  minv = 0;
-  maxv = 0;
-  for (uInt i=0; i<=nbins; ++i) {
-    boundaries[i] = i*step - 50.;
-  }
-  stv  = boundaries[0];
-  endv = boundaries[nbins];
-  Bool firstTime = True;
-  // Iterate through the lattice.
-  RO_LatticeIterator<T> iter(lattice);
-  while (! iter.atEnd()) {
-    Bool delData;
-    const Array<T>& array = iter.cursor();
-    const T* dataPtr = array.getStorage (delData);
-    uInt n = array.nelements();
-    if (firstTime) {
-      firstTime = False;
-      minv = dataPtr[0];
-      maxv = dataPtr[0];
+  if (mlattice == 0) {
+    RO_LatticeIterator<T> iter(lattice);
+    while (! iter.atEnd()) {
+      Bool delData;
+      const Array<T>& array = iter.cursor();
+      const T* dataPtr = array.getStorage (delData);
+      func (dataPtr, static_cast<const Bool*>(0), array.nelements());
+      array.freeStorage (dataPtr, delData);
+      iter++;
     }
-    for (uInt i=0; i<n; i++) {
-      if (dataPtr[i] < minv) {
-	minv = dataPtr[i];
-      } else if (dataPtr[i] > maxv) {
-	maxv = dataPtr[i];
-      }
-      Int bin = Int((dataPtr[i] - stv)/step);
-      if (bin < 0) {
-	hist[0]++;
-      } else if (bin >= Int(nbins)) {
-	hist[nbins-1]++;
-      } else {
-	if (dataPtr[i] < boundaries[bin] &&  bin > 0) {
-	  bin--;
-	} else if (dataPtr[i] >= boundaries[bin+1]) {
-	  bin++;
-	}
-	hist[bin]++;
-      }
+  } else {
+    COWPtr<Array<Bool>> mask;
+    RO_MaskedLatticeIterator<T> iter(*mlattice);
+    while (! iter.atEnd()) {
+      Bool delData, delMask;
+      const Array<T>& array = iter.cursor();
+      iter.getMask (mask);
+      const Bool* maskPtr = mask->getStorage (delMask);
+      const T* dataPtr = array.getStorage (delData);
+      func (dataPtr, maskPtr, array.nelements());
+      array.freeStorage (dataPtr, delData);
+      mask->freeStorage (maskPtr, delMask);
+      iter++;
     }
-    array.freeStorage (dataPtr, delData);
-    iter++;
   }
 }
 
 
 template <class T>
-uInt LatticeFractile<T>::maskedHistogram (T& stv, T& endv, T& minv, T& maxv,
-					  Block<uInt>& hist,
-					  Block<T>& boundaries,
-					  const MaskedLattice<T>& lattice)
+Vector<T> LatticeFractile<T>::multiPassFractiles
+                                       (const Lattice<T>& lattice,
+                                        const MaskedLattice<T>* mlattice,
+                                        const Vector<Float>& fractions,
+                                        uInt smallSize)
 {
-  AlwaysAssert (hist.nelements() == boundaries.nelements(), AipsError);
-  uInt ntodo = 0;
+  const uInt nfrac = fractions.size();
+  const uInt nbins = 10000;
+  const uInt nthreads = std::max (1u, OMP::maxThreads());
+  // Minimum number of values in a chunk to histogram it in parallel.
+  const size_t minParallel = 16384;
+  // Each thread fills its own histogram(s) which are merged thereafter.
+  std::vector<std::vector<Histogram>> thrHist (nthreads);
+  // Do a first binning while determining min/max at the same time.
   // Find number of bins (last one is for extraneous values).
   // Scale between -50 and +50 (which is usually okay for
   // radio-astronomical images, both for the image itself and for
   // difference of image with median or so).
   // It is only a first guess, so nothing goes wrong if grossly incorrect.
   // It may only result in one more iteration.
-  const uInt nbins = hist.nelements() - 1;
-  T step = 2*50./nbins;
-  minv = 0;
-  maxv = 0;
-  for (uInt i=0; i<=nbins; ++i) {
-    boundaries[i] = i*step - 50.;
-  }
-  stv  = boundaries[0];
-  endv = boundaries[nbins];
-  Bool firstTime = True;
-  // Iterate through the lattice.
-  COWPtr<Array<Bool>> mask;
-  RO_MaskedLatticeIterator<T> iter(lattice);
-  while (! iter.atEnd()) {
-    Bool delData, delMask;
-    const Array<T>& array = iter.cursor();
-    iter.getMask (mask);
-    const Bool* maskPtr = mask->getStorage (delMask);
-    const T* dataPtr = array.getStorage (delData);
-    uInt n = array.nelements();
-    for (uInt i=0; i<n; i++) {
-      if (maskPtr[i]) {
-	ntodo++;
-	if (firstTime) {
-	  firstTime = False;
-	  minv = dataPtr[i];
-	  maxv = dataPtr[i];
-	} else {
-	  if (dataPtr[i] < minv) {
-	    minv = dataPtr[i];
-	  } else if (dataPtr[i] > maxv) {
-	    maxv = dataPtr[i];
-	  }
-	}
-	Int bin = Int((dataPtr[i] - stv)/step);
-	if (bin < 0) {
-	  hist[0]++;
-	} else if (bin >= Int(nbins)) {
-	  hist[nbins-1]++;
-	} else {
-	  if (dataPtr[i] < boundaries[bin] &&  bin > 0 ) {
-	    bin--;
-	  } else if (dataPtr[i] >= boundaries[bin+1] &&  bin < Int(nbins)-1) {
-	    bin++;
-	  }
-	  hist[bin]++;
-	}
+  // Make the block 1 element larger, because possible roundoff errors
+  // could result in a binnr just beyond the end.
+  Block<uInt64> hist(nbins+1, uInt64(0));
+  Block<T> boundaries(nbins+1);
+  {
+    T step = 2*50./nbins;
+    for (uInt i=0; i<=nbins; ++i) {
+      boundaries[i] = i*step - 50.;
+    }
+    T stv = boundaries[0];
+    const T* bnd = boundaries.storage();
+    for (uInt t=0; t<nthreads; ++t) {
+      thrHist[t].assign (1, Histogram(nbins));
+    }
+    auto firstPass = [&] (const T* dataPtr, const Bool* maskPtr, size_t n)
+    {
+#ifdef _OPENMP
+#pragma omp parallel num_threads(nthreads) if(n >= minParallel)
+#endif
+      {
+        Histogram& h = thrHist[OMP::threadNum()][0];
+        uInt64* hp = &(h.hist[0]);
+        uInt64 nval = h.nval;
+        T minv = h.minv;
+        T maxv = h.maxv;
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+        for (Int64 i=0; i<Int64(n); ++i) {
+          if (maskPtr == 0  ||  maskPtr[i]) {
+            T v = dataPtr[i];
+            if (nval++ == 0) {
+              minv = v;
+              maxv = v;
+            } else if (v < minv) {
+              minv = v;
+            } else if (v > maxv) {
+              maxv = v;
+            }
+            // Compare as floating point to avoid integer overflow.
+            T fbin = (v - stv)/step;
+            if (fbin < 0) {
+              hp[0]++;
+            } else if (fbin >= nbins) {
+              hp[nbins-1]++;
+            } else {
+              Int bin = Int(fbin);
+              if (v < bnd[bin]  &&  bin > 0) {
+                bin--;
+              } else if (v >= bnd[bin+1]  &&  bin < Int(nbins)-1) {
+                bin++;
+              }
+              hp[bin]++;
+            }
+          }
+        }
+        h.nval = nval;
+        h.minv = minv;
+        h.maxv = maxv;
+      }
+    };
+    iterateChunks (lattice, mlattice, firstPass);
+  }
+  // Merge the histograms of the threads.
+  uInt64 nval = 0;
+  T minv = 0;
+  T maxv = 0;
+  for (uInt t=0; t<nthreads; ++t) {
+    const Histogram& h = thrHist[t][0];
+    if (h.nval > 0) {
+      if (nval == 0  ||  h.minv < minv) minv = h.minv;
+      if (nval == 0  ||  h.maxv > maxv) maxv = h.maxv;
+      nval += h.nval;
+      for (uInt i=0; i<=nbins; ++i) {
+        hist[i] += h.hist[i];
       }
     }
-    array.freeStorage (dataPtr, delData);
-    mask->freeStorage (maskPtr, delMask);
-    iter++;
   }
-  return ntodo;
+  if (nval == 0) {
+    return Vector<T>();
+  }
+  // Determine for each fractile the bin containing it.
+  // The index of a fractile is the lower one if it is between 2 elements.
+  // On return fractileInx,stv,endv form the basis of the new histogram.
+  Vector<T> result(nfrac);
+  std::vector<uInt64> fractileInx(nfrac), ntodo(nfrac);
+  std::vector<T> stv(nfrac), endv(nfrac), fminv(nfrac), fmaxv(nfrac);
+  std::vector<Bool> done(nfrac, False);
+  // If the interval ends at the maximum, the maximum is part of it.
+  std::vector<Bool> inclEnd(nfrac);
+  uInt nactive = 0;
+  for (uInt j=0; j<nfrac; ++j) {
+    fractileInx[j] = uInt64(Double(fractions[j]) * (nval-1));
+    ntodo[j] = findBin (fractileInx[j], stv[j], endv[j], minv, maxv,
+                        hist, boundaries);
+    inclEnd[j] = (endv[j] == maxv);
+    if (ntodo[j] == 0) {
+      result[j] = endv[j];
+      done[j] = True;
+    } else {
+      nactive++;
+    }
+  }
+  // Iterate until the bins containing the fractiles do not contain too
+  // many values anymore.
+  // The fractiles share the memory budget for the final in-memory pass.
+  std::vector<uInt> todo;
+  std::vector<T> step(nfrac);
+  std::vector<Block<T>> bounds(nfrac);
+  while (nactive > 0) {
+    todo.clear();
+    for (uInt j=0; j<nfrac; ++j) {
+      if (!done[j]  &&  ntodo[j] > smallSize/nactive) {
+        todo.push_back (j);
+      }
+    }
+    if (todo.empty()) {
+      break;
+    }
+    // Histogram the fractile bins with a much smaller bin size.
+    // Determine the min and max of the remaining values.
+    const uInt ntodoFrac = todo.size();
+    for (uInt k=0; k<ntodoFrac; ++k) {
+      uInt j = todo[k];
+      step[j] = (endv[j] - stv[j]) / nbins;
+      bounds[j].resize (nbins+1, False, False);
+      for (uInt i=0; i<=nbins; ++i) {
+        bounds[j][i] = stv[j] + i*step[j];
+      }
+    }
+    for (uInt t=0; t<nthreads; ++t) {
+      thrHist[t].assign (ntodoFrac, Histogram(nbins));
+    }
+    auto refinePass = [&] (const T* dataPtr, const Bool* maskPtr, size_t n)
+    {
+#ifdef _OPENMP
+#pragma omp parallel num_threads(nthreads) if(n >= minParallel)
+#endif
+      {
+        std::vector<Histogram>& hs = thrHist[OMP::threadNum()];
+        for (uInt k=0; k<ntodoFrac; ++k) {
+          const uInt j = todo[k];
+          const T st = stv[j];
+          const T end = endv[j];
+          const T stp = step[j];
+          const Bool incl = inclEnd[j];
+          const T* bnd = bounds[j].storage();
+          Histogram& h = hs[k];
+          uInt64* hp = &(h.hist[0]);
+          uInt64 nv = h.nval;
+          T mn = h.minv;
+          T mx = h.maxv;
+#ifdef _OPENMP
+#pragma omp for schedule(static) nowait
+#endif
+          for (Int64 i=0; i<Int64(n); ++i) {
+            T v = dataPtr[i];
+            if ((maskPtr == 0  ||  maskPtr[i])  &&  v >= st  &&
+                (v < end  ||  (incl  &&  v == end))) {
+              Int bin = Int(nbins) - 1;
+              if (v < end) {
+                bin = std::min (Int((v - st) / stp), bin);
+              }
+              // Due to rounding the bin number might get one too low or high.
+              if (v < bnd[bin]  &&  bin > 0) {
+                bin--;
+              } else if (v >= bnd[bin+1]  &&  bin < Int(nbins)-1) {
+                bin++;
+              }
+              hp[bin]++;
+              if (nv++ == 0) {
+                mn = v;
+                mx = v;
+              } else if (v < mn) {
+                mn = v;
+              } else if (v > mx) {
+                mx = v;
+              }
+            }
+          }
+          h.nval = nv;
+          h.minv = mn;
+          h.maxv = mx;
+        }
+      }
+    };
+    iterateChunks (lattice, mlattice, refinePass);
+    // Merge the histograms and find the new bins.
+    for (uInt k=0; k<ntodoFrac; ++k) {
+      uInt j = todo[k];
+      hist = uInt64(0);
+      T mn = endv[j];
+      T mx = stv[j];
+      uInt64 nv = 0;
+      for (uInt t=0; t<nthreads; ++t) {
+        const Histogram& h = thrHist[t][k];
+        if (h.nval > 0) {
+          if (nv == 0  ||  h.minv < mn) mn = h.minv;
+          if (nv == 0  ||  h.maxv > mx) mx = h.maxv;
+          nv += h.nval;
+          for (uInt i=0; i<=nbins; ++i) {
+            hist[i] += h.hist[i];
+          }
+        }
+      }
+      // In principle the last bin should be empty, but roundoff errors
+      // might have put a few in there. So add them to previous one.
+      hist[nbins-1] += hist[nbins];
+      hist[nbins] = 0;
+      ntodo[j] = findBin (fractileInx[j], stv[j], endv[j], mn, mx,
+                          hist, bounds[j]);
+      inclEnd[j] = (endv[j] == mx);
+      if (ntodo[j] == 0) {
+        result[j] = endv[j];
+        done[j] = True;
+        nactive--;
+      }
+    }
+  }
+  if (nactive == 0) {
+    return result;
+  }
+  // There are only a 'few' values left.
+  // So read them all in and determine the fractileInx'th-largest.
+  // Again, due to rounding we might find a few elements more or less,
+  // so the number of elements found is used in kthLargest.
+  todo.clear();
+  for (uInt j=0; j<nfrac; ++j) {
+    if (!done[j]) {
+      todo.push_back (j);
+    }
+  }
+  const uInt ntodoFrac = todo.size();
+  std::vector<std::vector<std::vector<T>>> values
+    (nthreads, std::vector<std::vector<T>>(ntodoFrac));
+  auto collectPass = [&] (const T* dataPtr, const Bool* maskPtr, size_t n)
+  {
+#ifdef _OPENMP
+#pragma omp parallel num_threads(nthreads) if(n >= minParallel)
+#endif
+    {
+      std::vector<std::vector<T>>& vals = values[OMP::threadNum()];
+      for (uInt k=0; k<ntodoFrac; ++k) {
+        const uInt j = todo[k];
+        const T st = stv[j];
+        const T end = endv[j];
+        const Bool incl = inclEnd[j];
+        std::vector<T>& vec = vals[k];
+#ifdef _OPENMP
+#pragma omp for schedule(static) nowait
+#endif
+        for (Int64 i=0; i<Int64(n); ++i) {
+          if ((maskPtr == 0  ||  maskPtr[i])  &&  dataPtr[i] >= st  &&
+              (dataPtr[i] < end  ||  (incl  &&  dataPtr[i] == end))) {
+            vec.push_back (dataPtr[i]);
+          }
+        }
+      }
+    }
+  };
+  iterateChunks (lattice, mlattice, collectPass);
+  for (uInt k=0; k<ntodoFrac; ++k) {
+    uInt j = todo[k];
+    std::vector<T> vec;
+    vec.reserve (ntodo[j]);
+    for (uInt t=0; t<nthreads; ++t) {
+      vec.insert (vec.end(), values[t][k].begin(), values[t][k].end());
+      std::vector<T>().swap (values[t][k]);
+    }
+    // By rounding it is possible that not enough elements were found.
+    // In that case return the middle of the (very small) interval.
+    if (fractileInx[j] >= vec.size()) {
+      result[j] = (stv[j] + endv[j]) / 2;
+    } else {
+      result[j] = GenSort<T>::kthLargest (vec.data(), vec.size(),
+                                          fractileInx[j]);
+    }
+  }
+  return result;
 }
 
 
@@ -225,131 +446,27 @@ template <class T>
 Vector<T> LatticeFractile<T>::unmaskedFractile (const Lattice<T>& lattice,
 						Float fraction,
 						uInt smallSize)
-						{
-	AlwaysAssert (fraction >= 0  &&  fraction <= 1, AipsError);
-	// Determine the number of elements in the lattice.
-	// If empty, return empty vector.
-	// If small enough, we read them all and do it in memory.
-	uInt ntodo = lattice.shape().product();
-	if (ntodo == 0) {
-		return Vector<T>();
-	}
-	Vector<T> result(1);
-	if (ntodo <= smallSize) {
-		if (fraction == 0.5) {
-			result(0) = median (lattice.get());
-		} else {
-			result(0) = fractile (lattice.get(), fraction);
-		}
-		return result;
-	}
-	// Bad luck. We have to do some more work.
-	// Do a first binning while determining min/max at the same time.
-	// Hopefully the start and end values make some sense.
-	// Make the block 1 element larger, because possible roundoff errors
-	// could result in a binnr just beyond the end.
-	const uInt nbins = 10000;
-	Block<uInt> hist(nbins+1, 0u);
-	Block<T> boundaries(nbins+1);
-	T stv, endv, minv, maxv;
-	unmaskedHistogram (stv, endv, minv, maxv, hist, boundaries, lattice);
-	// The index of the fractile in the lattice is the middle one.
-	// In case of an even nr of elements, it is the first one of the
-	// two middle ones.
-	uInt fractileInx = uInt(fraction * (ntodo-1));
-	// Iterate until the bin containing the fractile does not
-	// contain too many values anymore.
-	RO_LatticeIterator<T> iter(lattice);
-	while (True) {
-		// Determine which bin contains the fractile and update the various values.
-		// On return fractileInx,stv,endv form the basis of the new histogram.
-		ntodo = findBin (fractileInx, stv, endv, minv, maxv, hist, boundaries);
-		// If only a 'few' more points to do, stop making histograms.
-		// Exit if nothing left to do.
-		if (ntodo <= smallSize) {
-			if (ntodo == 0) {
-				result(0) = endv;
-				return result;
-			}
-			break;
-		}
-		// Histogram the fractile bin with a much smaller bin size.
-		// Determine the min and max of the remaining values.
-		minv = endv;
-		maxv = stv;
-		hist = 0;
-		T step = (endv - stv) / nbins;
-		for (uInt i=0; i<=nbins; i++) {
-			boundaries[i] = stv + i*step;
-		}
-		uInt ndone = 0;
-		iter.reset();
-		while (! iter.atEnd()  &&  ndone<ntodo) {
-			const Array<T>& array = iter.cursor();
-			Bool delData;
-			const T* dataPtr = array.getStorage (delData);
-			uInt n = array.nelements();
-			for (uInt i=0; i<n; i++) {
-				if (dataPtr[i] >= stv  &&  dataPtr[i] < endv) {
-					Int bin = Int((dataPtr[i] - stv) / step);
-					// Due to rounding the bin number might get one too low or high.
-					if (dataPtr[i] < boundaries[bin]) {
-						bin--;
-					} else if (dataPtr[i] >= boundaries[bin+1]) {
-						bin++;
-					}
-					hist[bin]++;
-					if (dataPtr[i] < minv) {
-						minv = dataPtr[i];
-					}
-					if (dataPtr[i] > maxv) {
-						maxv = dataPtr[i];
-					}
-					ndone++;
-				}
-			}
-			array.freeStorage (dataPtr, delData);
-			iter++;
-		}
-		// In principle the last bin should be empty, but roundoff errors
-		// might have put a few in there. So add them to previous one.
-		hist[nbins-1] += hist[nbins];
-	}
-	// There are only a 'few' points left.
-	// So read them all in and determine the fractileInx'th-largest.
-	// Again, due to rounding we might find a few elements more or less.
-	// So take care that the receiving block is not exceeded and that
-	// the number of elements found are used in kthLargest.
-	// Note it also makes sense to stop the iteration when we found all
-	// elements. It may save a few reads from the lattice.
-	Block<T> tmp(ntodo);
-	T* tmpPtr = tmp.storage();
-	uInt ndone = 0;
-	iter.reset();
-	while (! iter.atEnd()  &&  ndone<ntodo) {
-		const Array<T>& array = iter.cursor();
-		Bool delData;
-		const T* dataPtr = array.getStorage (delData);
-		uInt n = array.nelements();
-		for (uInt i=0; i<n; i++) {
-			if (dataPtr[i] >= stv  &&  dataPtr[i] < endv) {
-				tmpPtr[ndone++] = dataPtr[i];
-				if (ndone == ntodo) {
-					break;
-				}
-			}
-		}
-		array.freeStorage (dataPtr, delData);
-		iter++;
-	}
-	// By rounding it is possible that not enough elements were found.
-	// In that case return the middle of the (very small) interval.
-	if (fractileInx >= ndone) {
-		result(0) = (stv+endv)/2;
-	} else {
-		result(0) = GenSort<T>::kthLargest (tmp.storage(), ndone, fractileInx);
-	}
-	return result;
+{
+  AlwaysAssert (fraction >= 0  &&  fraction <= 1, AipsError);
+  // Determine the number of elements in the lattice.
+  // If empty, return empty vector.
+  // If small enough, we read them all and do it in memory.
+  Int64 ntodo = lattice.shape().product();
+  if (ntodo == 0) {
+    return Vector<T>();
+  }
+  if (ntodo <= Int64(smallSize)) {
+    Vector<T> result(1);
+    if (fraction == 0.5) {
+      result(0) = median (lattice.get());
+    } else {
+      result(0) = fractile (lattice.get(), fraction);
+    }
+    return result;
+  }
+  // Bad luck. We have to do some more work.
+  return multiPassFractiles (lattice, 0, Vector<Float>(1, fraction),
+                             smallSize);
 }
 
 
@@ -365,128 +482,12 @@ Vector<T> LatticeFractile<T>::maskedFractile (const MaskedLattice<T>& lattice,
   }
   // Determine the number of elements in the lattice.
   // If small enough, we read them all and do it in memory.
-  uInt ntodo = lattice.shape().product();
-  if (ntodo <= smallSize) {
+  if (lattice.shape().product() <= Int64(smallSize)) {
     return smallMaskedFractile (lattice, fraction);
   }
-  Vector<T> result(1);
   // Bad luck. We have to do some more work.
-  // Do a first binning while determining min/max at the same time.
-  // Hopefully the start and end values make some sense.
-  // Make the block 1 element larger, because possible roundoff errors
-  // could result in a binnr just beyond the end.
-  const uInt nbins = 10000;
-  Block<uInt> hist(nbins+1, 0u);
-  Block<T> boundaries(nbins+1);
-  T stv, endv, minv, maxv;
-  ntodo = maskedHistogram (stv, endv, minv, maxv, hist, boundaries, lattice);
-  if (ntodo == 0) {
-    return Vector<T>();
-  }
-  // The index of the fractile in the lattice is the middle one.
-  // In case of an even nr of elements, it is the first one of the
-  // two middle ones.
-  uInt fractileInx = uInt(fraction * (ntodo-1));
-  // Iterate until the bin containing the fractile does not
-  // contain too many values anymore.
-  COWPtr<Array<Bool>> mask;
-  RO_MaskedLatticeIterator<T> iter(lattice);
-  while (True) {
-    // Determine which bin contains the fractile and update the various values.
-    // On return fractileInx,stv,endv form the basis of the new histogram.
-    ntodo = findBin (fractileInx, stv, endv, minv, maxv, hist, boundaries);
-    // If only a 'few' more points to do, stop making histograms.
-    // Exit if nothing left to do.
-    if (ntodo <= smallSize) {
-      if (ntodo == 0) {
-	result(0) = endv;
-	return result;
-      }
-      break;
-    }
-    // Histogram the fractile bin with a much smaller bin size.
-    // Determine the min and max of the remaining values.
-    minv = endv;
-    maxv = stv;
-    hist = 0;
-    T step = (endv - stv) / nbins;
-    for (uInt i=0; i<=nbins; i++) {
-      boundaries[i] = stv + i*step;
-    }
-    uInt ndone = 0;
-    iter.reset();
-    while (! iter.atEnd()  &&  ndone<ntodo) {
-      Bool delData, delMask;
-      const Array<T>& array = iter.cursor();
-      iter.getMask (mask);
-      const Bool* maskPtr = mask->getStorage (delMask);
-      const T* dataPtr = array.getStorage (delData);
-      uInt n = array.nelements();
-      for (uInt i=0; i<n; i++) {
-	if (maskPtr[i]  &&  dataPtr[i] >= stv  &&  dataPtr[i] < endv) {
-	  Int bin = Int((dataPtr[i] - stv) / step);
-	  // Due to rounding the bin number might get one too low or high.
-	  if (dataPtr[i] < boundaries[bin]) {
-	    bin--;
-	  } else if (dataPtr[i] >= boundaries[bin+1]) {
-	    bin++;
-	  }
-	  hist[bin]++;
-	  if (dataPtr[i] < minv) {
-	    minv = dataPtr[i];
-	  }
- 	  if (dataPtr[i] > maxv) {
-	    maxv = dataPtr[i];
-	  }
-	  ndone++;
-	}
-      }
-      array.freeStorage (dataPtr, delData);
-      mask->freeStorage (maskPtr, delMask);
-      iter++;
-    }
-    // In principle the last bin should be empty, but roundoff errors
-    // might have put a few in there. So add them to previous one.
-    hist[nbins-1] += hist[nbins];
-  }
-  // There are only a 'few' points left.
-  // So read them all in and determine the fractileInx'th-largest.
-  // Again, due to rounding we might find a few elements more or less.
-  // So take care that the receiving block is not exceeded and that
-  // the number of elements found are used in kthLargest.
-  // Note it also makes sense to stop the iteration when we found all
-  // elements. It may save a few reads from the lattice.
-  Block<T> tmp(ntodo);
-  T* tmpPtr = tmp.storage();
-  uInt ndone = 0;
-  iter.reset();
-  while (! iter.atEnd()  &&  ndone<ntodo) {
-    Bool delData, delMask;
-    const Array<T>& array = iter.cursor();
-    iter.getMask (mask);
-    const Bool* maskPtr = mask->getStorage (delMask);
-    const T* dataPtr = array.getStorage (delData);
-    uInt n = array.nelements();
-    for (uInt i=0; i<n; i++) {
-      if (maskPtr[i]  &&  dataPtr[i] >= stv  &&  dataPtr[i] < endv) {
-	tmpPtr[ndone++] = dataPtr[i];
-	if (ndone == ntodo) {
-	  break;
-	}
-      }
-    }
-    array.freeStorage (dataPtr, delData);
-    mask->freeStorage (maskPtr, delMask);
-    iter++;
-  }
-  // By rounding it is possible that not enough elements were found.
-  // In that case return the middle of the (very small) interval.
-  if (fractileInx >= ndone) {
-    result(0) = (stv+endv)/2;
-  } else {
-    result(0) = GenSort<T>::kthLargest (tmp.storage(), ndone, fractileInx);
-  }
-  return result;
+  return multiPassFractiles (lattice, &lattice, Vector<Float>(1, fraction),
+                             smallSize);
 }
 
 
@@ -545,193 +546,31 @@ Vector<T> LatticeFractile<T>::unmaskedFractiles (const Lattice<T>& lattice,
   AlwaysAssert (left >= 0  &&  left <= right  &&  right <= 1, AipsError);
   // Determine the number of elements in the lattice.
   // If small enough, we read them all and do it in memory.
-  uInt ntodo1 = lattice.shape().product();
-  if (ntodo1 == 0) {
+  Int64 ntodo = lattice.shape().product();
+  if (ntodo == 0) {
     return Vector<T>();
   }
-  // Find which elements are left and right fractile.
-  uInt leftInx = uInt (left * (lattice.nelements()-1));
-  uInt rightInx = uInt (right * (lattice.nelements()-1));
-  Vector<T> result(2);
-  if (ntodo1 <= smallSize) {
+  if (ntodo <= Int64(smallSize)) {
+    // Find which elements are left and right fractile.
+    uInt leftInx = uInt (left * (ntodo-1));
+    uInt rightInx = uInt (right * (ntodo-1));
+    Vector<T> result(2);
     // We can hold all data in memory.
     Bool delData;
     Array<T> array = lattice.get();
     T* dataPtr = array.getStorage (delData);
-    result(0) = GenSort<T>::kthLargest (dataPtr, ntodo1, leftInx);
-    result(1) = GenSort<T>::kthLargest (dataPtr, ntodo1, rightInx);
+    result(0) = GenSort<T>::kthLargest (dataPtr, ntodo, leftInx);
+    result(1) = GenSort<T>::kthLargest (dataPtr, ntodo, rightInx);
     // Storage only needs to be freed, but we need a const pointer for that.
     const T* constDataPtr = dataPtr;
     array.freeStorage (constDataPtr, delData);
     return result;
   }
   // Bad luck. We have to do some more work.
-  // Do a first binning while determining min/max at the same time.
-  // Hopefully the start and end values make some sense.
-  // Make the block 1 element larger, because possible roundoff errors
-  // could result in a binnr just beyond the end.
-  const uInt nbins = 10000;
-  Block<uInt> hist1(nbins+1, 0u);
-  Block<T> boundaries1(nbins+1);
-  T stv1, endv1, minv1, maxv1;
-  unmaskedHistogram (stv1, endv1, minv1, maxv1, hist1, boundaries1, lattice);
-  // Init variables for both fractiles.
-  uInt ntodo2 = ntodo1;
-  T stv2 = stv1;
-  T endv2 = endv1;
-  T minv2 = minv1;
-  T maxv2 = maxv1;
-  Block<uInt> hist2 (hist1);
-  Block<T> boundaries2 (boundaries1);
-  Bool finished1 = False;
-  Bool finished2 = False;
-  // Iterate until the bins containing the fractiles do not
-  // contain too many values anymore.
-  RO_LatticeIterator<T> iter(lattice);
-  while (True) {
-    // Determine which bin contains the requested values, determine
-    // new boundaries, max/min and offset in bin.
-    // Do that for left and right fractile.
-    uInt ntodo = 0;
-    if (!finished1) {
-      ntodo1 = findBin (leftInx,  stv1, endv1, minv1, maxv1,
-			hist1, boundaries1);
-      // If only a 'few' more points to do, stop making histograms.
-      // Otherwise histogram the fractile bin with a much smaller bin size.
-      if (ntodo1 <= smallSize) {
-	finished1 = True;
-	if (ntodo1 == 0) {
-	  result(0) = endv1;
-	}
-      } else {
-	ntodo += ntodo1;
-      }
-    }
-    if (!finished2) {
-      ntodo2 = findBin (rightInx, stv2, endv2, minv2, maxv2,
-			hist2, boundaries2);
-      if (ntodo2 <= smallSize) {
-	finished2 = True;
-	if (ntodo2 == 0) {
-	  result(1) = endv2;
-	}
-      } else {
-	ntodo += ntodo2;
-      }
-    }
-    // Stop if both fractiles have small enough bins.
-    if (finished1 && finished2) {
-      break;
-    }
-    // Build new histograms with determined subsets
-    minv1 = endv1;
-    minv2 = endv2;
-    maxv1 = stv1;
-    maxv2 = stv2;
-    hist1 = 0;
-    hist2 = 0;
-    T step1 = (endv1 - stv1) / nbins;
-    T step2 = (endv2 - stv2) / nbins;
-    for (uInt i=0; i<=nbins; i++) {
-      boundaries1[i] = stv1 + i*step1;
-      boundaries2[i] = stv2 + i*step2;
-    }
-    uInt ndone = 0;
-    iter.reset();
-    while (! iter.atEnd()  &&  ndone<ntodo) {
-      const Array<T>& array = iter.cursor();
-      Bool delData;
-      const T* dataPtr = array.getStorage (delData);
-      uInt n = array.nelements();
-      for (uInt i=0; i<n; i++) {
-	if (!finished1  &&  dataPtr[i] >= stv1  &&  dataPtr[i] < endv1) {
-	  Int bin = Int((dataPtr[i] - stv1) / step1);
-	  // Due to rounding the bin number might get one too low or high.
-	  if (dataPtr[i] < boundaries1[bin]) {
-	    bin--;
-	  } else if (dataPtr[i] >= boundaries1[bin+1]) {
-	    bin++;
-	  }
-	  hist1[bin]++;
-	  if (dataPtr[i] < minv1) {
-	    minv1 = dataPtr[i];
-	  }
- 	  if (dataPtr[i] > maxv1) {
-	    maxv1 = dataPtr[i];
-	  }
-	  ndone++;
-	}
-	if (!finished2  &&  dataPtr[i] >= stv2  &&  dataPtr[i] < endv2) {
-	  Int bin = Int((dataPtr[i] - stv2) / step2);
-	  // Due to rounding the bin number might get one too low or high.
-	  if (dataPtr[i] < boundaries2[bin]) {
-	    bin--;
-	  } else if (dataPtr[i] >= boundaries2[bin+1]) {
-	    bin++;
-	  }
-	  hist2[bin]++;
-	  if (dataPtr[i] < minv2) {
-	    minv2 = dataPtr[i];
-	  }
- 	  if (dataPtr[i] > maxv2) {
-	    maxv2 = dataPtr[i];
-	  }
-	  ndone++;
-	}
-      }
-      array.freeStorage (dataPtr, delData);
-      iter++;
-    }
-    // In principle the last bins should be empty, but roundoff errors
-    // might have put a few in there. So add them to previous one.
-    hist1[nbins-1] += hist1[nbins];
-    hist2[nbins-1] += hist2[nbins];
-  }
-  if (ntodo1 == 0  &&  ntodo2 == 0) {
-    return result;
-  }
-  // There are only a 'few' points left in both histograms.
-  // So read them all in and determine the Inx'th-largest.
-  // Again, due to rounding we might find a few elements more or less.
-  // So take care that the receiving block is not exceeded and that
-  // the number of elements found are used in kthLargest.
-  // Note it also makes sense to stop the iteration when we found all
-  // elements. It may save a few reads from the lattice.
-  Block<T> tmp1(ntodo1);
-  Block<T> tmp2(ntodo2);
-  T* tmpPtr1 = tmp1.storage();
-  T* tmpPtr2 = tmp2.storage();
-  uInt ndone1 = 0;
-  uInt ndone2 = 0;
-  iter.reset();
-  while (! iter.atEnd() && (ndone1<ntodo1 || ndone2<ntodo2)) {
-    const Array<T>& array = iter.cursor();
-    Bool delData;
-    const T* dataPtr = array.getStorage (delData);
-    uInt n = array.nelements();
-    for (uInt i=0; i<n; i++) {
-      if (ndone1 < ntodo1  &&  dataPtr[i] >= stv1  &&  dataPtr[i] < endv1) {
-	tmpPtr1[ndone1++] = dataPtr[i];
-      }
-      if (ndone2 < ntodo2  &&  dataPtr[i] >= stv2  &&  dataPtr[i] < endv2) {
-	tmpPtr2[ndone2++] = dataPtr[i];
-      }
-    }
-    array.freeStorage (dataPtr, delData);
-    iter++;
-  }
-  // By rounding it is possible that not enough elements were found.
-  if (leftInx >= ndone1) {
-    result(0) = endv1;
-  } else {
-    result(0) = GenSort<T>::kthLargest (tmp1.storage(), ndone1, leftInx);
-  }
-  if (rightInx >= ndone2) {
-    result(1) = endv2;
-  } else {
-    result(1) = GenSort<T>::kthLargest (tmp2.storage(), ndone2, rightInx);
-  }
-  return result;
+  Vector<Float> fractions(2);
+  fractions[0] = left;
+  fractions[1] = right;
+  return multiPassFractiles (lattice, 0, fractions, smallSize);
 }
 
 
@@ -747,195 +586,52 @@ Vector<T> LatticeFractile<T>::maskedFractiles (const MaskedLattice<T>& lattice,
   }
   // Determine the number of elements in the lattice.
   // If small enough, we read them all and do it in memory.
-  uInt ntodo1 = lattice.shape().product();
-  if (ntodo1 <= smallSize) {
+  if (lattice.shape().product() <= Int64(smallSize)) {
     return smallMaskedFractiles (lattice, left, right);
   }
-  Vector<T> result(2);
   // Bad luck. We have to do some more work.
-  // Do a first binning while determining min/max at the same time.
-  // Hopefully the start and end values make some sense.
-  // Make the block 1 element larger, because possible roundoff errors
-  // could result in a binnr just beyond the end.
-  const uInt nbins = 10000;
-  Block<uInt> hist1(nbins+1, 0u);
-  Block<T> boundaries1(nbins+1);
-  T stv1, endv1, minv1, maxv1;
-  ntodo1 = maskedHistogram (stv1, endv1, minv1, maxv1, hist1, boundaries1,
-			    lattice);
-  if (ntodo1 == 0) {
-    return Vector<T>();
-  }
-  // Find which elements are left and right fractile.
-  uInt leftInx = uInt (left * (ntodo1-1));
-  uInt rightInx = uInt (right * (ntodo1-1));
-  // Init variables for both fractiles.
-  uInt ntodo2 = ntodo1;
-  T stv2 = stv1;
-  T endv2 = endv1;
-  T minv2 = minv1;
-  T maxv2 = maxv1;
-  Block<uInt> hist2 (hist1);
-  Block<T> boundaries2 (boundaries1);
-  Bool finished1 = False;
-  Bool finished2 = False;
-  // Iterate until the bins containing the fractiles do not
-  // contain too many values anymore.
-  COWPtr<Array<Bool>> mask;
-  RO_MaskedLatticeIterator<T> iter(lattice);
-  while (True) {
-    // Determine which bin contains the requested values, determine
-    // new boundaries, max/min and offset in bin.
-    // Do that for left and right fractile.
-    uInt ntodo = 0;
-    if (!finished1) {
-      ntodo1 = findBin (leftInx,  stv1, endv1, minv1, maxv1,
-			hist1, boundaries1);
-      // If only a 'few' more points to do, stop making histograms.
-      // Otherwise histogram the fractile bin with a much smaller bin size.
-      if (ntodo1 <= smallSize) {
-	finished1 = True;
-	if (ntodo1 == 0) {
-	  result(0) = endv1;
-	}
-      } else {
-	ntodo += ntodo1;
-      }
-    }
-    if (!finished2) {
-      ntodo2 = findBin (rightInx, stv2, endv2, minv2, maxv2,
-			hist2, boundaries2);
-      if (ntodo2 <= smallSize) {
-	finished2 = True;
-	if (ntodo2 == 0) {
-	  result(1) = endv2;
-	}
-      } else {
-	ntodo += ntodo2;
-      }
-    }
-    // Stop if both fractiles have small enough bins.
-    if (finished1 && finished2) {
-      break;
-    }
-    // Build new histograms with determined subsets
-    minv1 = endv1;
-    minv2 = endv2;
-    maxv1 = stv1;
-    maxv2 = stv2;
-    hist1 = 0;
-    hist2 = 0;
-    T step1 = (endv1 - stv1) / nbins;
-    T step2 = (endv2 - stv2) / nbins;
-    for (uInt i=0; i<=nbins; i++) {
-      boundaries1[i] = stv1 + i*step1;
-      boundaries2[i] = stv2 + i*step2;
-    }
-    uInt ndone = 0;
-    iter.reset();
-    while (! iter.atEnd()  &&  ndone<ntodo) {
-      Bool delData, delMask;
-      const Array<T>& array = iter.cursor();
-      iter.getMask (mask);
-      const Bool* maskPtr = mask->getStorage (delMask);
-      const T* dataPtr = array.getStorage (delData);
-      uInt n = array.nelements();
-      for (uInt i=0; i<n; i++) {
-	if (maskPtr[i]) {
-	  if (!finished1  &&  dataPtr[i] >= stv1  &&  dataPtr[i] < endv1) {
-	    Int bin = Int((dataPtr[i] - stv1) / step1);
-	    // Due to rounding the bin number might get one too low or high.
-	    if (dataPtr[i] < boundaries1[bin]) {
-	      bin--;
-	    } else if (dataPtr[i] >= boundaries1[bin+1]) {
-	      bin++;
-	    }
-	    hist1[bin]++;
-	    if (dataPtr[i] < minv1) {
-	      minv1 = dataPtr[i];
-	    }
-	    if (dataPtr[i] > maxv1) {
-	      maxv1 = dataPtr[i];
-	    }
-	    ndone++;
-	  }
-	  if (!finished2  &&  dataPtr[i] >= stv2  &&  dataPtr[i] < endv2) {
-	    Int bin = Int((dataPtr[i] - stv2) / step2);
-	    // Due to rounding the bin number might get one too low or high.
-	    if (dataPtr[i] < boundaries2[bin]) {
-	      bin--;
-	    } else if (dataPtr[i] >= boundaries2[bin+1]) {
-	      bin++;
-	    }
-	    hist2[bin]++;
-	    if (dataPtr[i] < minv2) {
-	      minv2 = dataPtr[i];
-	    }
-	    if (dataPtr[i] > maxv2) {
-	      maxv2 = dataPtr[i];
-	    }
-	    ndone++;
-	  }
-	}
-      }
-      array.freeStorage (dataPtr, delData);
-      mask->freeStorage (maskPtr, delMask);
-      iter++;
-    }
-    // In principle the last bins should be empty, but roundoff errors
-    // might have put a few in there. So add them to previous one.
-    hist1[nbins-1] += hist1[nbins];
-    hist2[nbins-1] += hist2[nbins];
+  Vector<Float> fractions(2);
+  fractions[0] = left;
+  fractions[1] = right;
+  return multiPassFractiles (lattice, &lattice, fractions, smallSize);
+}
+
+
+template <class T>
+Vector<T> LatticeFractile<T>::maskedFractiles (const MaskedLattice<T>& lattice,
+                                               const Vector<Float>& fractions,
+                                               uInt smallSize)
+{
+  for (uInt j=0; j<fractions.size(); ++j) {
+    AlwaysAssert (fractions[j] >= 0  &&  fractions[j] <= 1, AipsError);
   }
-  if (ntodo1 == 0  &&  ntodo2 == 0) {
-    return result;
+  if (fractions.empty()  ||  lattice.shape().product() == 0) {
+    return Vector<T>();
   }
-  // There are only a 'few' points left in both histograms.
-  // So read them all in and determine the Inx'th-largest.
-  // Again, due to rounding we might find a few elements more or less.
-  // So take care that the receiving block is not exceeded and that
-  // the number of elements found are used in kthLargest.
-  // Note it also makes sense to stop the iteration when we found all
-  // elements. It may save a few reads from the lattice.
-  Block<T> tmp1(ntodo1);
-  Block<T> tmp2(ntodo2);
-  T* tmpPtr1 = tmp1.storage();
-  T* tmpPtr2 = tmp2.storage();
-  uInt ndone1 = 0;
-  uInt ndone2 = 0;
-  iter.reset();
-  while (! iter.atEnd() && (ndone1<ntodo1 || ndone2<ntodo2)) {
-    Bool delData, delMask;
-    const Array<T>& array = iter.cursor();
-    iter.getMask (mask);
-    const Bool* maskPtr = mask->getStorage (delMask);
-    const T* dataPtr = array.getStorage (delData);
-    uInt n = array.nelements();
-    for (uInt i=0; i<n; i++) {
-      if (maskPtr[i]) {
-	if (ndone1 < ntodo1  &&  dataPtr[i] >= stv1  &&  dataPtr[i] < endv1) {
-	  tmpPtr1[ndone1++] = dataPtr[i];
-	}
-	if (ndone2 < ntodo2  &&  dataPtr[i] >= stv2  &&  dataPtr[i] < endv2) {
-	  tmpPtr2[ndone2++] = dataPtr[i];
-	}
+  const MaskedLattice<T>* mlattice = (lattice.isMasked() ? &lattice : 0);
+  if (lattice.shape().product() > Int64(smallSize)) {
+    return multiPassFractiles (lattice, mlattice, fractions, smallSize);
+  }
+  // Small enough, so assemble all (masked-on) elements in memory.
+  std::vector<T> buffer;
+  buffer.reserve (lattice.shape().product());
+  auto collect = [&buffer] (const T* dataPtr, const Bool* maskPtr, size_t n)
+  {
+    for (size_t i=0; i<n; i++) {
+      if (maskPtr == 0  ||  maskPtr[i]) {
+        buffer.push_back (dataPtr[i]);
       }
     }
-    array.freeStorage (dataPtr, delData);
-    mask->freeStorage (maskPtr, delMask);
-    iter++;
-  }
-  // By rounding it is possible that not enough elements were found.
-  // In that case return the middle of the (very small) interval.
-  if (leftInx >= ndone1) {
-    result(0) = endv1;
-  } else {
-    result(0) = GenSort<T>::kthLargest (tmp1.storage(), ndone1, leftInx);
+  };
+  iterateChunks (lattice, mlattice, collect);
+  if (buffer.empty()) {
+    return Vector<T>();
   }
-  if (rightInx >= ndone2) {
-    result(1) = endv2;
-  } else {
-    result(1) = GenSort<T>::kthLargest (tmp2.storage(), ndone2, rightInx);
+  Vector<T> result(fractions.size());
+  for (uInt j=0; j<fractions.size(); ++j) {
+    uInt fractileInx = uInt (fractions[j] * (buffer.size()-1));
+    result[j] = GenSort<T>::kthLargest (buffer.data(), buffer.size(),
+                                        fractileInx);
   }
   return result;
 }
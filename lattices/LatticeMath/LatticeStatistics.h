@@ -425,6 +425,15 @@ public:
    // large images (CAS-10947/10948).
    void setComputeQuantiles(Bool b);
 
+   // Use a persistent per-plane statistics cache (see class
+   // <linkto class=LatticeStatsCache>LatticeStatsCache</linkto>) if possible.
+   // It is only possible for a lattice stored in a table (e.g. a PagedImage
+   // or a SubImage of it) using its default mask, a box region containing
+   // whole planes (spanned by the first two axes) and cursor axes containing
+   // the first two axes. Furthermore, only classical statistics without
+   // quantiles and pixel ranges can use the cache. Default is False.
+   void setUseStatsCache(Bool b);
+
 protected:
 
    LogIO os_p;
@@ -542,6 +551,8 @@ private:
    // unset means let the code decide
    std::unique_ptr<LatticeStatsAlgorithm> _latticeStatsAlgortihm;
 
+   Bool _useStatsCache;
+
    void _setDefaultCoeffs() {
        // coefficients from timings run on PagedImages on
        // etacarinae.cv.nrao.edu (dmehring's development
@@ -586,6 +597,10 @@ private:
 // Create a new storage lattice
    Bool generateStorageLattice (); 
 
+// Fill the storage lattice from the persistent statistics cache.
+// False is returned if the cache cannot be used.
+   Bool _fillStorageLatticeFromCache ();
+
 // Given a location in the lattice and a statistic type, work
 // out where to put it in the storage lattice
    IPosition locInStorageLattice(const IPosition& latticePosition,
@@ -30,6 +30,7 @@
 #include <casacore/lattices/LatticeMath/LattStatsSpecialize.h>
 #include <casacore/lattices/LatticeMath/LattStatsProgress.h>
 #include <casacore/lattices/LatticeMath/StatsTiledCollapser.h>
+#include <casacore/lattices/LatticeMath/LatticeStatsCache.h>
 
 #include <casacore/casa/Arrays/ArrayLogical.h>
 #include <casacore/casa/Arrays/ArrayMath.h>
@@ -69,6 +70,7 @@
 #include <casacore/scimath/StatsFramework/ChauvenetCriterionStatistics.h>
 #include <casacore/scimath/StatsFramework/FitToHalfStatistics.h>
 #include <casacore/scimath/StatsFramework/HingesFencesStatistics.h>
+#include <casacore/scimath/StatsFramework/StatisticsUtilities.h>
 
 namespace casacore { //# NAMESPACE CASACORE - BEGIN
 
@@ -98,7 +100,8 @@ LatticeStatistics<T>::LatticeStatistics (const MaskedLattice<T>& lattice,
   showProgress_p(showProgress),
   forceDisk_p(forceDisk),
   doneFullMinMax_p(False),
-  _saf(), _chauvIters(), _latticeStatsAlgortihm() {
+  _saf(), _chauvIters(), _latticeStatsAlgortihm(),
+  _useStatsCache(False) {
    nxy_p.resize(0);
    statsToPlot_p.resize(0);   
    range_p.resize(0);
@@ -141,7 +144,8 @@ LatticeStatistics<T>::LatticeStatistics (const MaskedLattice<T>& lattice,
   showProgress_p(showProgress),
   forceDisk_p(forceDisk),
   doneFullMinMax_p(False),
-  _saf(), _chauvIters(), _latticeStatsAlgortihm()
+  _saf(), _chauvIters(), _latticeStatsAlgortihm(),
+  _useStatsCache(False)
 {
    nxy_p.resize(0);
    statsToPlot_p.resize(0);
@@ -240,6 +244,7 @@ LatticeStatistics<T> &LatticeStatistics<T>::operator=(const LatticeStatistics<T>
               ? new LatticeStatsAlgorithm(*other._latticeStatsAlgortihm)
               : nullptr
       );
+      _useStatsCache = other._useStatsCache;
    }
    return *this;
 }
@@ -309,6 +314,14 @@ void LatticeStatistics<T>::setComputeQuantiles(Bool b) {
     doRobust_p = b;
 }
 
+template <class T>
+void LatticeStatistics<T>::setUseStatsCache(Bool b) {
+    if (b != _useStatsCache) {
+        _useStatsCache = b;
+        needStorageLattice_p = True;
+    }
+}
+
 template <class T>
 Bool LatticeStatistics<T>::setInExCludeRange(const Vector<T>& include,
                                              const Vector<T>& exclude,
@@ -875,6 +888,11 @@ Bool LatticeStatistics<T>::generateStorageLattice() {
     pStoreLattice_p = std::make_shared<TempLattice<AccumType>>(
         TiledShape(storeLatticeShape, tileShape), useMemory
     );
+    if (_useStatsCache && _fillStorageLatticeFromCache()) {
+        needStorageLattice_p = False;
+        doneSomeGoodPoints_p = False;
+        return True;
+    }
     // Set up min/max location variables
     std::shared_ptr<LattStatsProgress> pProgressMeter(
         showProgress_p ? std::make_shared<LattStatsProgress>() : NULL
@@ -955,6 +973,133 @@ Bool LatticeStatistics<T>::generateStorageLattice() {
     return True;
 }
 
+template <class T>
+Bool LatticeStatistics<T>::_fillStorageLatticeFromCache() {
+    // Check if the cache can be used.
+    DataType latticeType = whatType<T>();
+    if (
+        (latticeType != TpFloat && latticeType != TpDouble)
+        || _saf.algorithm() != StatisticsData::CLASSICAL
+        || ! noInclude_p || ! noExclude_p || doRobust_p
+        || ! pInLattice_p->isPaged()
+    ) {
+        return False;
+    }
+    const String name = pInLattice_p->name();
+    const IPosition shape = pInLattice_p->shape();
+    const uInt ndim = shape.size();
+    if (
+        ndim < 2 || LatticeStatsBase::statsCacheName(name).empty()
+        || LatticeStatsBase::isStatsCacheInvalidated(name)
+    ) {
+        return False;
+    }
+    Bool hasAxis0 = False;
+    Bool hasAxis1 = False;
+    for (uInt i=0; i<cursorAxes_p.size(); ++i) {
+        hasAxis0 = hasAxis0 || cursorAxes_p[i] == 0;
+        hasAxis1 = hasAxis1 || cursorAxes_p[i] == 1;
+    }
+    const LatticeRegion& region = pInLattice_p->region();
+    const IPosition& parentShape = region.region().latticeShape();
+    const IPosition blc = region.slicer().start();
+    if (
+        ! hasAxis0 || ! hasAxis1 || region.hasMask()
+        || parentShape.size() != ndim
+        || ! region.slicer().length().isEqual(shape)
+        || ! region.slicer().stride().allOne()
+        || blc[0] != 0 || blc[1] != 0
+        || shape[0] != parentShape[0] || shape[1] != parentShape[1]
+    ) {
+        return False;
+    }
+    // The cache can only be used if the mask can be identified.
+    String maskName;
+    if (! pInLattice_p->pixelMaskName(maskName)) {
+        return False;
+    }
+    if (haveLogger_p) {
+        os_p << LogIO::NORMAL1
+             << "Using the statistics cache of " << name << LogIO::POST;
+    }
+    // Calculate the statistics of the planes not cached yet.
+    const Bool isMasked = pInLattice_p->isMasked();
+    LatticeStatsCache<AccumType> cache(name, parentShape, maskName, isMasked);
+    std::shared_ptr<StatisticsAlgorithm<AccumType, const T*, const Bool*>> sa
+        = _saf.createStatsAlgorithm();
+    IPosition cursorShape(ndim, 1);
+    cursorShape[0] = shape[0];
+    cursorShape[1] = shape[1];
+    RO_MaskedLatticeIterator<T> iter(
+        *pInLattice_p, LatticeStepper(shape, cursorShape)
+    );
+    for (iter.reset(); ! iter.atEnd(); iter++) {
+        const uInt64 plane = cache.planeIndex(blc + iter.position());
+        if (cache.isCached(plane)) {
+            continue;
+        }
+        const Array<T> data = iter.cursor().contiguousStorage()
+            ? iter.cursor() : iter.cursor().copy();
+        if (isMasked) {
+            const Array<Bool> mask = iter.getMask().copy();
+            sa->setData(data.data(), mask.data(), data.size());
+            cache.put(plane, sa->getStatistics());
+        }
+        else {
+            sa->setData(data.data(), data.size());
+            cache.put(plane, sa->getStatistics());
+        }
+    }
+    cache.flush();
+    // Combine the statistics of the planes per storage lattice position.
+    IPosition storeShape = pStoreLattice_p->shape();
+    storeShape.resize(storeShape.size() - 1);
+    const uInt64 nsets = storeShape.product();
+    std::vector<std::vector<StatsData<AccumType>>> setStats(nsets);
+    std::vector<IPosition> setPos(nsets);
+    std::vector<IPosition> planePos;
+    const Int nDispAxes = displayAxes_p.size();
+    for (iter.reset(); ! iter.atEnd(); iter++) {
+        const IPosition& pos = iter.position();
+        uInt64 set = 0;
+        for (Int j=nDispAxes-1; j>=0; --j) {
+            set = set*storeShape[j] + pos[displayAxes_p[j]];
+        }
+        setStats[set].push_back(
+            cache.get(cache.planeIndex(blc + pos), planePos.size())
+        );
+        setPos[set] = pos;
+        planePos.push_back(pos);
+    }
+    T overallMin = 0;
+    T overallMax = 0;
+    Bool atStart = True;
+    minPos_p.resize(0);
+    maxPos_p.resize(0);
+    for (uInt64 i=0; i<nsets; ++i) {
+        StatsData<AccumType> stats = StatisticsUtilities<AccumType>::combine(
+            setStats[i]
+        );
+        T currentMin = stats.min ? T(*stats.min) : T(0);
+        T currentMax = stats.max ? T(*stats.max) : T(0);
+        _fillStorageLattice(currentMin, currentMax, setPos[i], stats, False, 0, 0);
+        if (stats.npts > 0) {
+            IPosition minPos = planePos[stats.minpos.first];
+            minPos[0] = stats.minpos.second % shape[0];
+            minPos[1] = stats.minpos.second / shape[0];
+            IPosition maxPos = planePos[stats.maxpos.first];
+            maxPos[0] = stats.maxpos.second % shape[0];
+            maxPos[1] = stats.maxpos.second / shape[0];
+            _updateMinMaxPos(
+                overallMin, overallMax, currentMin, currentMax,
+                minPos, maxPos, atStart
+            );
+            atStart = False;
+        }
+    }
+    return True;
+}
+
 template <class T>
 void LatticeStatistics<T>::_doStatsLoop(
     uInt nsets, std::shared_ptr<LattStatsProgress> progressMeter
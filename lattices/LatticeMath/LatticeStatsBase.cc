@@ -32,8 +32,14 @@
 #include <casacore/casa/BasicSL/String.h>
 #include <casacore/casa/Utilities/Regex.h>
 #include <casacore/casa/IO/ArrayIO.h>
+#include <casacore/casa/OS/Directory.h>
+#include <casacore/casa/OS/DirectoryIterator.h>
+#include <casacore/casa/OS/File.h>
+#include <casacore/casa/OS/RegularFile.h>
 
 #include <casacore/casa/iostream.h>
+#include <atomic>
+#include <mutex>
 
 
 namespace casacore { //# NAMESPACE CASACORE - BEGIN
@@ -207,5 +213,76 @@ std::set<Double> LatticeStatsBase::quartileFracs() {
     return std::set<Double>(fracs, fracs+2);
 }
 
+// The names of the lattices written (but not flushed) by this process.
+static std::set<String> theStatsCacheWritten;
+static std::mutex theStatsCacheMutex;
+static std::atomic<uInt64> theStatsCacheFlushCount(0);
+
+String LatticeStatsBase::statsCacheName (const String& latticeName)
+{
+   if (latticeName.empty()  ||  !File(latticeName + "/table.dat").exists()) {
+      return String();
+   }
+   return latticeName + "/statscache";
+}
+
+static void addStatsCacheStamp (Int64& size, uInt& mtime,
+                                const Directory& dir)
+{
+   for (DirectoryIterator iter(dir); !iter.pastEnd(); iter++) {
+      File file(iter.file());
+      if (file.isDirectory (False)) {
+         addStatsCacheStamp (size, mtime, Directory(file));
+      } else if (file.isRegular (False)) {
+         const String name = iter.name();
+         if (name != "table.lock"  &&  !name.startsWith ("statscache")) {
+            size += RegularFile(file).size();
+            mtime = max (mtime, file.modifyTime());
+         }
+      }
+   }
+}
+
+void LatticeStatsBase::statsCacheStamp (Int64& size, uInt& mtime,
+                                        const String& latticeName)
+{
+   size = 0;
+   mtime = 0;
+   addStatsCacheStamp (size, mtime, Directory(latticeName));
+}
+
+void LatticeStatsBase::invalidateStatsCache (const String& latticeName)
+{
+   std::lock_guard<std::mutex> lock(theStatsCacheMutex);
+   if (theStatsCacheWritten.insert(latticeName).second) {
+      String name = statsCacheName (latticeName);
+      if (!name.empty()  &&  File(name).exists()) {
+         try {
+            RegularFile(name).remove();
+         } catch (const std::exception&) {
+            // A readonly directory; the stamp of the cache makes it invalid.
+         }
+      }
+   }
+}
+
+void LatticeStatsBase::flushedStatsCache (const String& latticeName)
+{
+   std::lock_guard<std::mutex> lock(theStatsCacheMutex);
+   theStatsCacheWritten.erase (latticeName);
+   theStatsCacheFlushCount++;
+}
+
+Bool LatticeStatsBase::isStatsCacheInvalidated (const String& latticeName)
+{
+   std::lock_guard<std::mutex> lock(theStatsCacheMutex);
+   return theStatsCacheWritten.find(latticeName) != theStatsCacheWritten.end();
+}
+
+uInt64 LatticeStatsBase::statsCacheFlushCount()
+{
+   return theStatsCacheFlushCount;
+}
+
 } //# NAMESPACE CASACORE - END
 
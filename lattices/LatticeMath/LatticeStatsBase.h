@@ -179,6 +179,33 @@ enum StatisticsTypes {
    static void stretchMinMax (Float& min, Float& max);
 
    static std::set<Double> quartileFracs();
+
+// Functions for the persistent statistics cache of a paged lattice
+// (see class <linkto class=LatticeStatsCache>LatticeStatsCache</linkto>).
+// <br><src>statsCacheName</src> returns the name of the cache file in the
+// table directory of the lattice; it returns an empty string if the lattice
+// is not stored in a table.
+// <br><src>statsCacheStamp</src> gets the total size and last modification
+// time of the files in the table directory (except the lock and cache files).
+// <br><src>invalidateStatsCache</src> has to be called when a paged lattice
+// is written. The first time after a flush it removes the cache file.
+// <br><src>flushedStatsCache</src> has to be called when a paged lattice
+// is flushed, thus when the files reflect the written data again.
+// <br><src>isStatsCacheInvalidated</src> tells if the lattice has been
+// written by this process and not flushed yet, thus if a cache might not
+// reflect the data.
+// <br><src>statsCacheFlushCount</src> gives the number of flushes done so
+// far. A writer can use it to call <src>invalidateStatsCache</src> only
+// for its first write after a flush.
+// <group>
+   static String statsCacheName (const String& latticeName);
+   static void statsCacheStamp (Int64& size, uInt& mtime,
+                                const String& latticeName);
+   static void invalidateStatsCache (const String& latticeName);
+   static void flushedStatsCache (const String& latticeName);
+   static Bool isStatsCacheInvalidated (const String& latticeName);
+   static uInt64 statsCacheFlushCount();
+// </group>
 };
 
 
@@ -0,0 +1,150 @@
+//# LatticeStatsCache.h: Persistent per-plane statistics of a paged lattice
+//# Copyright (C) 2026
+//# Associated Universities, Inc. Washington DC, USA.
+//#
+//# This library is free software; you can redistribute it and/or modify it
+//# under the terms of the GNU Library General Public License as published by
+//# the Free Software Foundation; either version 2 of the License, or (at your
+//# option) any later version.
+//#
+//# This library is distributed in the hope that it will be useful, but WITHOUT
+//# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+//# License for more details.
+//#
+//# You should have received a copy of the GNU Library General Public License
+//# along with this library; if not, write to the Free Software Foundation,
+//# Inc., 675 Massachusetts Ave, Cambridge, MA 02139, USA.
+//#
+//# Correspondence concerning AIPS++ should be addressed as follows:
+//#        Internet email: aips2-request@nrao.edu.
+//#        Postal address: AIPS++ Project Office
+//#                        National Radio Astronomy Observatory
+//#                        520 Edgemont Road
+//#                        Charlottesville, VA 22903-2475 USA
+
+
+#ifndef LATTICES_LATTICESTATSCACHE_H
+#define LATTICES_LATTICESTATSCACHE_H
+
+#include <casacore/casa/aips.h>
+#include <casacore/casa/Arrays/IPosition.h>
+#include <casacore/casa/Arrays/Vector.h>
+#include <casacore/casa/BasicSL/String.h>
+#include <casacore/scimath/StatsFramework/StatisticsTypes.h>
+
+namespace casacore {
+
+// <summary>
+// Persistent per-plane statistics of a paged lattice.
+// </summary>
+
+// <use visibility=local>
+
+// <reviewed reviewer="" date="" tests="tLatticeStatistics.cc">
+// </reviewed>
+
+// <prerequisite>
+//   <li> <linkto class=LatticeStatistics>LatticeStatistics</linkto>
+// </prerequisite>
+
+// <synopsis>
+// This class holds the classical statistics accumulators (number of points,
+// sum, sum of squares, mean, variance and minimum and maximum with their
+// positions) of each plane of a lattice stored in a table (e.g. a
+// PagedImage). A plane is spanned by the first two axes; all other axes
+// define the planes. Because the accumulators of several planes can be
+// combined, the statistics of any set of whole planes can be derived from
+// them without reading the pixels.
+// <p>
+// The cache is stored in the file <src>statscache</src> in the table
+// directory. It is only used if the size and modification time of the
+// table files are the same as when the cache was made. Furthermore,
+// writing a paged lattice removes the cache (see
+// <src>LatticeStatsBase::invalidateStatsCache</src>).
+// The statistics depend on the mask used, so the name of the pixelmask
+// (empty if none) and the masked flag are stored in the cache as well; the
+// cache is not used if they do not match.
+// <p>
+// Only planes for which statistics have been calculated are cached. The cache
+// is written by <src>flush</src>; failure to write it (e.g. because the
+// directory is not writable) is ignored.
+// </synopsis>
+
+// <motivation>
+// Viewers and quality assessment tools repeatedly ask for the per-plane
+// statistics of the same (large) image, which should not require a full
+// pass over the data each time.
+// </motivation>
+
+template <class AccumType> class LatticeStatsCache
+{
+public:
+  // Open the cache of the paged lattice with the given name and shape
+  // using the given pixelmask (see <src>MaskedLattice::pixelMaskName</src>).
+  // A missing, outdated or unreadable cache, or a cache made with another
+  // mask, results in an empty cache.
+  LatticeStatsCache (const String& latticeName, const IPosition& shape,
+                     const String& maskName, Bool isMasked);
+
+  // Forbid copy constructor and assignment.
+  // <group>
+  LatticeStatsCache (const LatticeStatsCache<AccumType>&) = delete;
+  LatticeStatsCache<AccumType>& operator=
+    (const LatticeStatsCache<AccumType>&) = delete;
+  // </group>
+
+  // Get the number of planes.
+  uInt64 nplanes() const
+    { return itsCached.size(); }
+
+  // Get the index of the plane containing the given lattice position.
+  uInt64 planeIndex (const IPosition& position) const;
+
+  // Are the statistics of the given plane cached?
+  Bool isCached (uInt64 plane) const
+    { return itsCached[plane]; }
+
+  // Get the statistics of a cached plane. The <src>second</src> value of
+  // the min and max position is the offset in the plane; the <src>first</src>
+  // value is set to <src>dataset</src>.
+  StatsData<AccumType> get (uInt64 plane, Int64 dataset) const;
+
+  // Set the statistics of a plane. The min and max position have to be
+  // given as the offset in the plane.
+  void put (uInt64 plane, const StatsData<AccumType>& stats);
+
+  // Write the cache if it has been changed and if the lattice has not
+  // been changed since the cache was opened.
+  void flush();
+
+private:
+  // Read the cache. False is returned if not possible or outdated.
+  Bool read();
+
+  String    itsLatticeName;
+  String    itsFileName;
+  IPosition itsShape;
+  String    itsMaskName;
+  Bool      itsIsMasked;
+  Int64     itsStampSize;
+  uInt      itsStampTime;
+  Bool      itsChanged;
+  Vector<Bool>      itsCached;
+  Vector<Double>    itsNpts;
+  Vector<AccumType> itsSum;
+  Vector<AccumType> itsSumsq;
+  Vector<AccumType> itsMean;
+  Vector<AccumType> itsNvariance;
+  Vector<AccumType> itsMin;
+  Vector<AccumType> itsMax;
+  Vector<Int64>     itsMinPos;
+  Vector<Int64>     itsMaxPos;
+};
+
+} //# NAMESPACE CASACORE - END
+
+#ifndef CASACORE_NO_AUTO_TEMPLATES
+#include <casacore/lattices/LatticeMath/LatticeStatsCache.tcc>
+#endif //# CASACORE_NO_AUTO_TEMPLATES
+#endif
@@ -0,0 +1,200 @@
+//# LatticeStatsCache.tcc: Persistent per-plane statistics of a paged lattice
+//# Copyright (C) 2026
+//# Associated Universities, Inc. Washington DC, USA.
+//#
+//# This library is free software; you can redistribute it and/or modify it
+//# under the terms of the GNU Library General Public License as published by
+//# the Free Software Foundation; either version 2 of the License, or (at your
+//# option) any later version.
+//#
+//# This library is distributed in the hope that it will be useful, but WITHOUT
+//# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+//# License for more details.
+//#
+//# You should have received a copy of the GNU Library General Public License
+//# along with this library; if not, write to the Free Software Foundation,
+//# Inc., 675 Massachusetts Ave, Cambridge, MA 02139, USA.
+//#
+//# Correspondence concerning AIPS++ should be addressed as follows:
+//#        Internet email: aips2-request@nrao.edu.
+//#        Postal address: AIPS++ Project Office
+//#                        National Radio Astronomy Observatory
+//#                        520 Edgemont Road
+//#                        Charlottesville, VA 22903-2475 USA
+
+
+#ifndef LATTICES_LATTICESTATSCACHE_TCC
+#define LATTICES_LATTICESTATSCACHE_TCC
+
+#include <casacore/lattices/LatticeMath/LatticeStatsCache.h>
+#include <casacore/lattices/LatticeMath/LatticeStatsBase.h>
+#include <casacore/casa/IO/AipsIO.h>
+#include <casacore/casa/IO/ArrayIO.h>
+#include <casacore/casa/OS/File.h>
+#include <casacore/casa/OS/RegularFile.h>
+#include <casacore/casa/Utilities/Assert.h>
+#include <ctime>
+#include <unistd.h>
+
+namespace casacore {
+
+template <class AccumType>
+LatticeStatsCache<AccumType>::LatticeStatsCache (const String& latticeName,
+                                                 const IPosition& shape,
+                                                 const String& maskName,
+                                                 Bool isMasked)
+: itsLatticeName (latticeName),
+  itsFileName    (LatticeStatsBase::statsCacheName (latticeName)),
+  itsShape       (shape),
+  itsMaskName    (maskName),
+  itsIsMasked    (isMasked),
+  itsStampSize   (0),
+  itsStampTime   (0),
+  itsChanged     (False)
+{
+  AlwaysAssert (shape.size() >= 2, AipsError);
+  AlwaysAssert (!itsFileName.empty(), AipsError);
+  // Get the stamp before any pixel is read, so a change while the
+  // statistics are calculated is detected by flush.
+  LatticeStatsBase::statsCacheStamp (itsStampSize, itsStampTime, latticeName);
+  if (! read()) {
+    const uInt64 n = shape.product() / (shape[0] * shape[1]);
+    itsCached.resize (n);
+    itsCached = False;
+    itsNpts.resize (n);
+    itsSum.resize (n);
+    itsSumsq.resize (n);
+    itsMean.resize (n);
+    itsNvariance.resize (n);
+    itsMin.resize (n);
+    itsMax.resize (n);
+    itsMinPos.resize (n);
+    itsMaxPos.resize (n);
+  }
+}
+
+template <class AccumType>
+uInt64 LatticeStatsCache<AccumType>::planeIndex (const IPosition& position) const
+{
+  uInt64 index = 0;
+  for (Int i=itsShape.size()-1; i>=2; --i) {
+    index = index*itsShape[i] + position[i];
+  }
+  return index;
+}
+
+template <class AccumType>
+StatsData<AccumType> LatticeStatsCache<AccumType>::get (uInt64 plane,
+                                                        Int64 dataset) const
+{
+  StatsData<AccumType> stats = initializeStatsData<AccumType>();
+  stats.npts = itsNpts[plane];
+  stats.sumweights = itsNpts[plane];
+  stats.sum = itsSum[plane];
+  stats.sumsq = itsSumsq[plane];
+  stats.mean = itsMean[plane];
+  stats.nvariance = itsNvariance[plane];
+  if (stats.npts > 0) {
+    stats.min.reset (new AccumType(itsMin[plane]));
+    stats.max.reset (new AccumType(itsMax[plane]));
+    stats.minpos = std::make_pair (dataset, itsMinPos[plane]);
+    stats.maxpos = std::make_pair (dataset, itsMaxPos[plane]);
+  }
+  return stats;
+}
+
+template <class AccumType>
+void LatticeStatsCache<AccumType>::put (uInt64 plane,
+                                        const StatsData<AccumType>& stats)
+{
+  itsCached[plane] = True;
+  itsNpts[plane] = stats.npts;
+  itsSum[plane] = stats.sum;
+  itsSumsq[plane] = stats.sumsq;
+  itsMean[plane] = stats.mean;
+  itsNvariance[plane] = stats.nvariance;
+  itsMin[plane] = stats.min ? *stats.min : AccumType(0);
+  itsMax[plane] = stats.max ? *stats.max : AccumType(0);
+  itsMinPos[plane] = stats.minpos.second;
+  itsMaxPos[plane] = stats.maxpos.second;
+  itsChanged = True;
+}
+
+template <class AccumType>
+Bool LatticeStatsCache<AccumType>::read()
+{
+  if (! File(itsFileName).exists()) {
+    return False;
+  }
+  try {
+    AipsIO ios(itsFileName);
+    // Version 1 did not contain the mask, so cannot be used.
+    if (ios.getstart ("LatticeStatsCache") < 2) {
+      return False;
+    }
+    Int64 stampSize;
+    uInt  stampTime;
+    IPosition shape;
+    String maskName;
+    Bool isMasked;
+    ios >> stampSize >> stampTime >> shape >> maskName >> isMasked;
+    if (stampSize != itsStampSize  ||  stampTime != itsStampTime
+        ||  !shape.isEqual (itsShape)
+        ||  maskName != itsMaskName  ||  isMasked != itsIsMasked) {
+      return False;
+    }
+    ios >> itsCached >> itsNpts >> itsSum >> itsSumsq >> itsMean
+        >> itsNvariance >> itsMin >> itsMax >> itsMinPos >> itsMaxPos;
+    ios.getend();
+  } catch (const std::exception&) {
+    return False;
+  }
+  return True;
+}
+
+template <class AccumType>
+void LatticeStatsCache<AccumType>::flush()
+{
+  if (! itsChanged) {
+    return;
+  }
+  itsChanged = False;
+  // Do not write if the lattice has been changed in the meantime, nor if
+  // it has been changed within the last seconds; the resolution of the
+  // modification time could make a later change undetectable.
+  Int64 stampSize;
+  uInt  stampTime;
+  LatticeStatsBase::statsCacheStamp (stampSize, stampTime, itsLatticeName);
+  if (stampSize != itsStampSize  ||  stampTime != itsStampTime
+      ||  LatticeStatsBase::isStatsCacheInvalidated (itsLatticeName)
+      ||  Int64(stampTime) + 2 > Int64(std::time(0))) {
+    return;
+  }
+  // Write a temporary file first, so other processes do not see a partly
+  // written cache.
+  const String tmpName = itsFileName + "_tmp" + String::toString(getpid());
+  try {
+    {
+      AipsIO ios(tmpName, ByteIO::New);
+      ios.putstart ("LatticeStatsCache", 2);
+      ios << itsStampSize << itsStampTime << itsShape
+          << itsMaskName << itsIsMasked;
+      ios << itsCached << itsNpts << itsSum << itsSumsq << itsMean
+          << itsNvariance << itsMin << itsMax << itsMinPos << itsMaxPos;
+      ios.putend();
+    }
+    RegularFile(tmpName).move (itsFileName);
+  } catch (const std::exception&) {
+    if (File(tmpName).exists()) {
+      try {
+        RegularFile(tmpName).remove();
+      } catch (const std::exception&) {
+      }
+    }
+  }
+}
+
+} //# NAMESPACE CASACORE - END
+
+#endif
@@ -631,20 +631,7 @@ Int MultiTermLatticeCleaner<T>::manageMemory(Bool direction)
 template <class T>
 Int MultiTermLatticeCleaner<T>::addTo(Lattice<Float>& to, const Lattice<Float>& add, Float multiplier)
 {
-	// Check the lattice is writable.
-	// Check the shape conformance.
-	AlwaysAssert (to.isWritable(), AipsError);
-	const IPosition shapeIn  = add.shape();
-	const IPosition shapeOut = to.shape();
-	AlwaysAssert (shapeIn.isEqual (shapeOut), AipsError);
-	IPosition cursorShape = to.niceCursorShape();
-	LatticeStepper stepper (shapeOut, cursorShape, LatticeStepper::RESIZE);
-	LatticeIterator<Float> toIter(to, stepper);
-	RO_LatticeIterator<Float> addIter(add, stepper);
-	for (addIter.reset(), toIter.reset(); !addIter.atEnd();addIter++, toIter++) 
-	{
-		toIter.rwCursor()+=addIter.cursor()*multiplier;
-	}
+	LatticeCleaner<Float>::addScaled(to, add, multiplier);
 	return 0;
 }
 
@@ -1189,37 +1176,48 @@ Bool MultiTermLatticeCleaner<T>::findMaxAbsLattice(const TempLattice<Float>& mas
 
   AlwaysAssert(masklat.shape()==lattice.shape(), AipsError);
 
-  Array<Float> msk;
-  
   posMaxAbs = IPosition(lattice.shape().nelements(), 0);
   maxAbs=0.0;
   //maxAbs=-1.0e+10;
-  const IPosition tileShape = lattice.niceCursorShape();
-  TiledLineStepper ls(lattice.shape(), tileShape, 0);
-  TiledLineStepper lsm(masklat.shape(), tileShape, 0);
+  LatticeStepper ls(lattice.shape(), LatticeCleaner<T>::chunkShape(lattice),
+                    LatticeStepper::RESIZE);
   {
     RO_LatticeIterator<Float> li(lattice, ls);
-    RO_LatticeIterator<Float> lim(masklat, lsm);
+    RO_LatticeIterator<Float> lim(masklat, ls);
     for(li.reset(),lim.reset();!li.atEnd();li++,lim++) 
     {
-      IPosition posMax=li.position();
-      IPosition posMin=li.position();
-      Float maxVal=0.0;
-      Float minVal=0.0;
-      
-      msk = lim.cursor();
-      if(flip) msk = (Float)1.0 - msk;
-      
-      //minMaxMasked(minVal, maxVal, posMin, posMax, li.cursor(),lim.cursor());
-      minMaxMasked(minVal, maxVal, posMin, posMax, li.cursor(),msk);
-      
-      
-      if((maxVal)>(maxAbs)) 
-      {
-        maxAbs=maxVal;
-	posMaxAbs=li.position();
-	posMaxAbs(0)=posMax(0);
+      const Array<Float>& chunk = li.cursor();
+      const Array<Float>& mchunk = lim.cursor();
+      const IPosition& shape = chunk.shape();
+      const size_t nx = shape[0];
+      Bool deleteIt, deleteMask;
+      const Float* data = chunk.getStorage (deleteIt);
+      const Float* mdata = mchunk.getStorage (deleteMask);
+      // Find the first maximum of the masked values in each line.
+      size_t line, pixel;
+      if (LatticeCleaner<T>::findPeakInLines
+          (chunk.nelements() / nx, nx,
+           [data, mdata, nx, flip] (size_t l, Float& value) -> size_t
+           {
+             const Float* d = data + l*nx;
+             const Float* m = mdata + l*nx;
+             size_t maxp = 0;
+             Float maxv = d[0] * (flip ? 1-m[0] : m[0]);
+             for (size_t i=1; i<nx; ++i) {
+               const Float tmp = d[i] * (flip ? 1-m[i] : m[i]);
+               if (tmp > maxv) {
+                 maxv = tmp;
+                 maxp = i;
+               }
+             }
+             value = maxv;
+             return maxp;
+           },
+           False, maxAbs, line, pixel)) {
+        posMaxAbs = li.position() + toIPositionInArray (line*nx + pixel, shape);
       }
+      chunk.freeStorage (data, deleteIt);
+      mchunk.freeStorage (mdata, deleteMask);
     }
   }
 
@@ -0,0 +1,136 @@
+//# tLatticeCleanerPerf.cc: Test performance of the LatticeCleaner minor cycle
+//# Copyright (C) 2026
+//# Associated Universities, Inc. Washington DC, USA.
+//#
+//# This program is free software; you can redistribute it and/or modify it
+//# under the terms of the GNU General Public License as published by the Free
+//# Software Foundation; either version 2 of the License, or (at your option)
+//# any later version.
+//#
+//# This program is distributed in the hope that it will be useful, but WITHOUT
+//# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+//# more details.
+//#
+//# You should have received a copy of the GNU General Public License along
+//# with this program; if not, write to the Free Software Foundation, Inc.,
+//# 675 Massachusetts Ave, Cambridge, MA 02139, USA.
+//#
+//# Correspondence concerning AIPS++ should be addressed as follows:
+//#        Internet email: aips2-request@nrao.edu.
+//#        Postal address: AIPS++ Project Office
+//#                        National Radio Astronomy Observatory
+//#                        520 Edgemont Road
+//#                        Charlottesville, VA 22903-2475 USA
+
+#include <casacore/lattices/LatticeMath/LatticeCleaner.h>
+#include <casacore/lattices/Lattices/ArrayLattice.h>
+#include <casacore/casa/Arrays/Matrix.h>
+#include <casacore/casa/Arrays/ArrayMath.h>
+#include <casacore/casa/OS/OMP.h>
+#include <casacore/casa/OS/Timer.h>
+#include <casacore/casa/Utilities/Assert.h>
+#include <casacore/casa/iostream.h>
+#include <stdlib.h>
+
+#include <casacore/casa/namespace.h>
+
+// <summary>
+// Test program for performance of the LatticeCleaner minor cycle.
+// It reports the number of clean iterations per second.
+// </summary>
+
+
+// Make a Gaussian PSF centered in the image.
+Matrix<Float> makePsf (Int nx)
+{
+  Matrix<Float> psf(nx, nx);
+  const Float width = 3;
+  for (Int j=0; j<nx; ++j) {
+    for (Int i=0; i<nx; ++i) {
+      Float dx = (i - nx/2) / width;
+      Float dy = (j - nx/2) / width;
+      psf(i,j) = exp(-(dx*dx + dy*dy));
+    }
+  }
+  return psf;
+}
+
+// Make a dirty image of some point sources convolved with the PSF.
+Matrix<Float> makeDirty (const Matrix<Float>& psf, Int nx)
+{
+  Matrix<Float> dirty(nx, nx, 0.);
+  const Int nsrc = 5;
+  for (Int k=0; k<nsrc; ++k) {
+    Int x0 = nx/2 + (k-nsrc/2) * nx/16;
+    Int y0 = nx/2 + (k%2) * nx/16;
+    Float flux = 1 + k;
+    for (Int j=0; j<nx; ++j) {
+      Int pj = j - y0 + nx/2;
+      if (pj < 0  ||  pj >= nx) continue;
+      for (Int i=0; i<nx; ++i) {
+        Int pi = i - x0 + nx/2;
+        if (pi >= 0  &&  pi < nx) {
+          dirty(i,j) += flux * psf(pi,pj);
+        }
+      }
+    }
+  }
+  return dirty;
+}
+
+void doClean (Int nx, Int niter, Int nscales)
+{
+  Matrix<Float> psfArr = makePsf (nx);
+  Matrix<Float> dirtyArr = makeDirty (psfArr, nx);
+  ArrayLattice<Float> psf(psfArr);
+  ArrayLattice<Float> dirty(dirtyArr);
+  ArrayLattice<Float> model(IPosition(2, nx, nx));
+  model.set (0);
+  LatticeCleaner<Float> cleaner(psf, dirty);
+  if (nscales > 1) {
+    cleaner.setscales (nscales, 2.0);
+    cleaner.setcontrol (CleanEnums::MULTISCALE, niter, 0.1,
+                        Quantity(0, "Jy"), False);
+  } else {
+    cleaner.setscales (1);
+    cleaner.setcontrol (CleanEnums::HOGBOM, niter, 0.1,
+                        Quantity(0, "Jy"), False);
+  }
+  cleaner.ignoreCenterBox (True);
+  Float peakBefore = max(abs(dirtyArr));
+  Timer timer;
+  cleaner.clean (model);
+  double sec = timer.real();
+  Float peakAfter = max(abs(cleaner.residual()->get()));
+  cout << "nx=" << nx << " nscales=" << nscales
+       << " nthreads=" << OMP::maxThreads()
+       << "  " << cleaner.numberIterations() << " iterations in "
+       << sec << " sec";
+  if (sec > 0) {
+    cout << " = " << cleaner.numberIterations() / sec << " iter/sec";
+  }
+  cout << endl;
+  // The residual must have been reduced and flux found.
+  AlwaysAssertExit (peakAfter < peakBefore);
+  AlwaysAssertExit (sum(model.get()) > 0);
+}
+
+int main (int argc, char* argv[])
+{
+  // Default is a small run, so it can be used as a regular test.
+  Int nx = 128;
+  Int niter = 200;
+  Int nscales = 1;
+  if (argc > 1) nx = atoi(argv[1]);
+  if (argc > 2) niter = atoi(argv[2]);
+  if (argc > 3) nscales = atoi(argv[3]);
+  if (argc > 4) OMP::setNumThreads (atoi(argv[4]));
+  try {
+    doClean (nx, niter, nscales);
+  } catch (std::exception& x) {
+    cout << "Caught an exception: " << x.what() << endl;
+    return 1;
+  }
+  return 0;                           // exit with success status
+}
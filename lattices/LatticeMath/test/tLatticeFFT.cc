@@ -34,6 +34,8 @@
 #include <casacore/lattices/LatticeMath/LatticeFFT.h>
 #include <casacore/lattices/Lattices/LatticeIterator.h>
 #include <casacore/lattices/Lattices/PagedArray.h>
+#include <casacore/lattices/Lattices/ArrayLattice.h>
+#include <casacore/casa/OS/OMP.h>
 #include <casacore/casa/iostream.h>
 
 #include <casacore/casa/namespace.h>
@@ -174,6 +176,28 @@ int main() {
  	}
       }
     }
+    { // test that the threaded line transforms match the serial ones
+      const IPosition shape(3, 32, 24, 7);
+      Array<Complex> data(shape);
+      uInt n = 0;
+      for (Array<Complex>::iterator it=data.begin(); it!=data.end(); ++it) {
+	*it = Complex(n%13, (n*7)%5);
+	n++;
+      }
+      ArrayLattice<Complex> serial(data.copy());
+      ArrayLattice<Complex> threaded(data.copy());
+      Vector<Bool> whichAxes(3, True);
+      const uInt nthr = OMP::maxThreads();
+      OMP::setNumThreads(1);
+      LatticeFFT::cfft(serial, whichAxes, True);
+      OMP::setNumThreads(std::max(nthr, 4u));
+      LatticeFFT::cfft(threaded, whichAxes, True);
+      AlwaysAssert(allNearAbs(serial.get(), threaded.get(), 1E-1), AipsError);
+      // A round trip must give back the original data.
+      LatticeFFT::cfft(threaded, whichAxes, False);
+      OMP::setNumThreads(nthr);
+      AlwaysAssert(allNearAbs(threaded.get(), data, 1E-4), AipsError);
+    }
     cout<< "OK"<< endl;
     return 0;
   } catch (std::exception& x) {
@@ -26,6 +26,7 @@
 
 #include <casacore/lattices/Lattices/ArrayLattice.h>
 #include <casacore/lattices/Lattices/TempLattice.h>
+#include <casacore/lattices/Lattices/SubLattice.h>
 #include <casacore/lattices/Lattices/LatticeIterator.h>
 #include <casacore/lattices/LatticeMath/LatticeFractile.h>
 #include <casacore/lattices/LEL/LatticeExpr.h>
@@ -34,6 +35,8 @@
 #include <casacore/casa/IO/ArrayIO.h>
 #include <casacore/casa/Inputs/Input.h>
 #include <casacore/casa/OS/Timer.h>
+#include <casacore/casa/Utilities/Assert.h>
+#include <casacore/casa/Utilities/GenSort.h>
 #include <casacore/casa/Exceptions/Error.h>
 #include <casacore/casa/iostream.h>
 
@@ -154,6 +157,48 @@ int main (int argc, const char* argv[])
 	   << endl;
     }
 
+    {
+      // Test multiple fractiles in one go against the fractiles of the
+      // sorted array. Use a small memory budget to force multiple passes.
+      // Note that the result can be approximate (within 1e-5) if the
+      // histogram bins get too narrow.
+      IPosition shape(2, 32*nx, 32*ny);
+      Array<Float> arr(shape);
+      indgen (arr, float(-100), float(0.5));
+      ArrayLattice<Float> aF(arr);
+      SubLattice<Float> subF(aF);
+      Vector<Float> fractions(5);
+      fractions[0] = 0;
+      fractions[1] = 0.1;
+      fractions[2] = 0.5;
+      fractions[3] = 0.77;
+      fractions[4] = 1;
+      uInt n = arr.size();
+      Vector<Float> sorted(arr.reform(IPosition(1,n)).copy());
+      GenSort<Float>::sort (sorted);
+      for (uInt smallSize : {4u, 1000u, 1u<<30}) {
+        Vector<Float> res = LatticeFractile<Float>::maskedFractiles
+          (subF, fractions, smallSize);
+        AlwaysAssertExit (res.size() == fractions.size());
+        for (uInt j=0; j<fractions.size(); ++j) {
+          AlwaysAssertExit (near (res[j], sorted[uInt(fractions[j]*(n-1))],
+                                  1e-5));
+        }
+      }
+      // Do the same for a masked lattice.
+      LatticeExprNode afExpr(aF);
+      LatticeExpr<Float> expr(afExpr[aF>4]);
+      Vector<Float> sel(arr(arr > Float(4)).getCompressedArray());
+      GenSort<Float>::sort (sel);
+      uInt nsel = sel.size();
+      Vector<Float> res = LatticeFractile<Float>::maskedFractiles
+        (expr, fractions, 100);
+      for (uInt j=0; j<fractions.size(); ++j) {
+        AlwaysAssertExit (near (res[j], sel[uInt(fractions[j]*(nsel-1))],
+                                1e-5));
+      }
+    }
+
     // Hereafter numbers can be different on different machines.
     // So 'outcomment' it for assay (and also outcomment the timings).
     cout << ">>>" << endl;
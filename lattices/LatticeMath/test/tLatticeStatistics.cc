@@ -26,6 +26,7 @@
 #include <casacore/casa/aips.h>
 #include <casacore/casa/Arrays/Array.h>
 #include <casacore/casa/Arrays/ArrayMath.h>
+#include <casacore/casa/Arrays/ArrayLogical.h>
 #include <casacore/casa/Exceptions/Error.h>
 #include <casacore/casa/Inputs/Input.h>
 #include <casacore/casa/Logging.h>
@@ -33,18 +34,24 @@
 #include <casacore/casa/BasicSL/String.h>
 #include <casacore/casa/Utilities/Regex.h>
 #include <casacore/lattices/Lattices/ArrayLattice.h>
+#include <casacore/lattices/Lattices/PagedArray.h>
 #include <casacore/lattices/LatticeMath/LatticeStatistics.h>
 #include <casacore/lattices/Lattices/SubLattice.h>
 #include <casacore/lattices/LatticeMath/LatticeStatsBase.h>
 #include <casacore/lattices/Lattices/LatticeUtilities.h>
 #include <casacore/lattices/LRegions/LCSlicer.h>
 #include <casacore/scimath/StatsFramework/ClassicalStatistics.h>
+#include <casacore/casa/OS/DirectoryIterator.h>
+#include <casacore/casa/OS/File.h>
+#include <casacore/tables/Tables/Table.h>
+#include <ctime>
 
 #include <casacore/casa/iostream.h>
 
 #include <casacore/casa/namespace.h>
 
 void doitFloat(LogIO& os);
+void testStatsCache();
 void do1DFloat (const Vector<Float>& results,
                 const Vector<Bool>& hasResult, 
                 const Array<Float>& inArr,
@@ -65,6 +72,7 @@ int main()
         LogOrigin lor("tLatticeStatistics", "main()", WHERE);
         LogIO os(lor);
         doitFloat(os);
+        testStatsCache();
 
         Vector<Float> data(1000);
         Vector<Float>::iterator iter = data.begin();
@@ -1132,3 +1140,131 @@ void test2DFloat (LatticeStatistics<Float>& stats, const Vector<Float>& results,
    }
 }
 
+
+void compareStats (LatticeStatistics<Float>& stats1,
+                   LatticeStatistics<Float>& stats2)
+{
+    LatticeStatsBase::StatisticsTypes types[] = {
+        LatticeStatsBase::NPTS, LatticeStatsBase::SUM, LatticeStatsBase::SUMSQ,
+        LatticeStatsBase::MEAN, LatticeStatsBase::VARIANCE,
+        LatticeStatsBase::SIGMA, LatticeStatsBase::RMS,
+        LatticeStatsBase::MIN, LatticeStatsBase::MAX
+    };
+    for (uInt i=0; i<9; ++i) {
+        Array<Double> stat1, stat2;
+        AlwaysAssert(stats1.getStatistic(stat1, types[i]), AipsError);
+        AlwaysAssert(stats2.getStatistic(stat2, types[i]), AipsError);
+        AlwaysAssert(allNear(stat1, stat2, 1e-10), AipsError);
+    }
+    IPosition minPos1, maxPos1, minPos2, maxPos2;
+    stats1.getMinMaxPos(minPos1, maxPos1);
+    stats2.getMinMaxPos(minPos2, maxPos2);
+    AlwaysAssert(minPos1.isEqual(minPos2), AipsError);
+    AlwaysAssert(maxPos1.isEqual(maxPos2), AipsError);
+}
+
+void testStatsCache()
+{
+    const String name("tLatticeStatistics_tmp.pa");
+    const String cacheName(name + "/statscache");
+    const IPosition shape(3, 10, 8, 5);
+    {
+        PagedArray<Float> pa(TiledShape(shape), name);
+        Array<Float> arr(shape);
+        indgen(arr);
+        arr = sin(arr) * Float(100);
+        pa.put(arr);
+    }
+    // The cache is not written if the lattice has just been changed,
+    // so make the files older.
+    for (DirectoryIterator iter(name); !iter.pastEnd(); iter++) {
+        iter.file().touch(uInt(time(0)) - 10);
+    }
+    Vector<Int> axes(2);
+    axes[0] = 0;
+    axes[1] = 1;
+    {
+        // Statistics per plane fill the cache; the second time it is used.
+        PagedArray<Float> pa(name);
+        SubLattice<Float> subLatt(pa);
+        for (uInt i=0; i<2; ++i) {
+            LatticeStatistics<Float> stats(subLatt);
+            LatticeStatistics<Float> cachedStats(subLatt);
+            cachedStats.setUseStatsCache(True);
+            AlwaysAssert(stats.setAxes(axes), AipsError);
+            AlwaysAssert(cachedStats.setAxes(axes), AipsError);
+            compareStats(stats, cachedStats);
+            AlwaysAssert(File(cacheName).exists(), AipsError);
+        }
+        // Statistics of the entire lattice and of some planes.
+        {
+            LatticeStatistics<Float> stats(subLatt);
+            LatticeStatistics<Float> cachedStats(subLatt);
+            cachedStats.setUseStatsCache(True);
+            compareStats(stats, cachedStats);
+        }
+        {
+            SubLattice<Float> planes(
+                pa, Slicer(IPosition(3, 0, 0, 1), IPosition(3, 10, 8, 3))
+            );
+            LatticeStatistics<Float> stats(planes);
+            LatticeStatistics<Float> cachedStats(planes);
+            cachedStats.setUseStatsCache(True);
+            AlwaysAssert(stats.setAxes(axes), AipsError);
+            AlwaysAssert(cachedStats.setAxes(axes), AipsError);
+            compareStats(stats, cachedStats);
+        }
+        {
+            // An own pixelmask cannot be identified, so the cache made
+            // without a mask must not be used.
+            SubLattice<Float> masked(pa);
+            Array<Bool> mask(shape, True);
+            mask(IPosition(3, 0), shape - 1, IPosition(3, 2, 1, 1)) = False;
+            masked.setPixelMask(ArrayLattice<Bool>(mask), True);
+            LatticeStatistics<Float> stats(masked);
+            LatticeStatistics<Float> cachedStats(masked);
+            cachedStats.setUseStatsCache(True);
+            AlwaysAssert(stats.setAxes(axes), AipsError);
+            AlwaysAssert(cachedStats.setAxes(axes), AipsError);
+            compareStats(stats, cachedStats);
+            Array<Double> npts;
+            cachedStats.getStatistic(npts, LatticeStatsBase::NPTS);
+            AlwaysAssert(allEQ(npts, 40.), AipsError);
+        }
+    }
+    {
+        // A write after a flush removes the cache again.
+        PagedArray<Float> pa(name);
+        pa.putAt(2000, IPosition(3, 0));
+        AlwaysAssert(!File(cacheName).exists(), AipsError);
+        pa.flush();
+        for (DirectoryIterator iter(name); !iter.pastEnd(); iter++) {
+            iter.file().touch(uInt(time(0)) - 10);
+        }
+        SubLattice<Float> subLatt(pa);
+        LatticeStatistics<Float> cachedStats(subLatt);
+        cachedStats.setUseStatsCache(True);
+        AlwaysAssert(cachedStats.setAxes(axes), AipsError);
+        Array<Double> max;
+        cachedStats.getStatistic(max, LatticeStatsBase::MAX);
+        AlwaysAssert(File(cacheName).exists(), AipsError);
+        // Restore the original value.
+        pa.putAt(0, IPosition(3, 0));
+        AlwaysAssert(!File(cacheName).exists(), AipsError);
+    }
+    {
+        // Writing the lattice removes the cache.
+        PagedArray<Float> pa(name);
+        pa.putAt(1000, IPosition(3, 1, 2, 3));
+        AlwaysAssert(!File(cacheName).exists(), AipsError);
+        SubLattice<Float> subLatt(pa);
+        LatticeStatistics<Float> stats(subLatt);
+        LatticeStatistics<Float> cachedStats(subLatt);
+        cachedStats.setUseStatsCache(True);
+        compareStats(stats, cachedStats);
+        Array<Double> max;
+        cachedStats.getStatistic(max, LatticeStatsBase::MAX);
+        AlwaysAssert(*max.begin() == 1000, AipsError);
+        pa.table().markForDelete();
+    }
+}
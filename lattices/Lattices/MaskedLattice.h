@@ -253,6 +253,13 @@ public:
   virtual Lattice<Bool>& pixelMask();
   // </group>
 
+  // Get the name identifying the pixelmask in a persistent lattice
+  // (e.g. the name of the mask used in a PagedImage). The name is empty
+  // if the lattice has no pixelmask. False is returned if the pixelmask
+  // cannot be identified by a name.
+  // The default implementation returns False if the lattice has a pixelmask.
+  virtual Bool pixelMaskName (String& name) const;
+
   // Get the region used.
   // This is in principle the region pointed to by <src>getRegionPtr</src>.
   // However, if that pointer is 0, it returns a LatticeRegion for the
@@ -90,6 +90,13 @@ Bool MaskedLattice<T>::hasPixelMask() const
   return False;
 }
 
+template<class T>
+Bool MaskedLattice<T>::pixelMaskName (String& name) const
+{
+  name = String();
+  return !hasPixelMask();
+}
+
 template<class T>
 const Lattice<Bool>& MaskedLattice<T>::pixelMask() const
 {
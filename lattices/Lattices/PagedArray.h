@@ -587,12 +587,18 @@ private:
   void doReopen() const;
   void tempReopen() const;
   // </group>
+  // Invalidate a statistics cache of the lattice before its data are changed.
+  // It is only done for the first write after a flush (of any lattice),
+  // so a put does not need to lock the global administration.
+  void invalidateStatsCache();
 
   mutable Table     itsTable;
           String    itsColumnName;
           uInt      itsRowNumber;
   mutable Bool      itsIsClosed;
   mutable Bool      itsMarkDelete;
+          Bool      itsStatsInvalidated;
+          uInt64    itsStatsFlushCount;
           String    itsTableName;
           Bool      itsWritable;
           TableLock itsLockOpt;
@@ -31,6 +31,7 @@
 #include <casacore/lattices/Lattices/PagedArrIter.h>
 #include <casacore/lattices/Lattices/LatticeNavigator.h>
 #include <casacore/lattices/Lattices/TiledShape.h>
+#include <casacore/lattices/LatticeMath/LatticeStatsBase.h>
 #include <casacore/casa/Arrays/Array.h>
 #include <casacore/casa/Arrays/ArrayLogical.h>
 #include <casacore/casa/Arrays/ArrayUtil.h>
@@ -65,7 +66,9 @@ template<class T>
 PagedArray<T>::PagedArray (const TiledShape& shape, const String& filename) 
 : itsColumnName (defaultColumn()),
   itsRowNumber  (defaultRow()),
-  itsIsClosed   (True)
+  itsIsClosed   (True),
+  itsStatsInvalidated (False),
+  itsStatsFlushCount (0)
 {
   makeTable(filename, Table::New);
   makeArray (shape);
@@ -77,7 +80,9 @@ template<class T>
 PagedArray<T>::PagedArray (const TiledShape& shape)
 : itsColumnName (defaultColumn()),
   itsRowNumber  (defaultRow()),
-  itsIsClosed   (True)
+  itsIsClosed   (True),
+  itsStatsInvalidated (False),
+  itsStatsFlushCount (0)
 {
   Path filename=File::newUniqueName(String("./"), String("pagedArray"));
   makeTable (filename.absoluteName(), Table::Scratch);
@@ -93,6 +98,8 @@ PagedArray<T>::PagedArray (const TiledShape& shape, Table& file)
   itsRowNumber  (defaultRow()),
   itsIsClosed   (False),
   itsMarkDelete (False),
+  itsStatsInvalidated (False),
+  itsStatsFlushCount (0),
   itsWritable   (file.isWritable())
 {
   makeArray (shape);
@@ -108,6 +115,8 @@ PagedArray<T>::PagedArray (const TiledShape& shape, Table& file,
   itsRowNumber  (rowNumber),
   itsIsClosed   (False),
   itsMarkDelete (False),
+  itsStatsInvalidated (False),
+  itsStatsFlushCount (0),
   itsWritable   (file.isWritable())
 {
   makeArray (shape);
@@ -122,6 +131,8 @@ PagedArray<T>::PagedArray (const String& filename)
   itsRowNumber  (defaultRow()),
   itsIsClosed   (False),
   itsMarkDelete (False),
+  itsStatsInvalidated (False),
+  itsStatsFlushCount (0),
   itsWritable   (False),
   itsArray      (itsTable, itsColumnName),
   itsAccessor   (itsTable, itsColumnName)
@@ -135,6 +146,8 @@ template<class T> PagedArray<T>::PagedArray (Table& file)
   itsRowNumber  (defaultRow()),
   itsIsClosed   (False),
   itsMarkDelete (False),
+  itsStatsInvalidated (False),
+  itsStatsFlushCount (0),
   itsWritable   (False),
   itsArray      (itsTable, itsColumnName),
   itsAccessor   (itsTable, itsColumnName)
@@ -150,6 +163,8 @@ PagedArray<T>::PagedArray (Table& file, const String& columnName,
   itsRowNumber  (rowNumber),
   itsIsClosed   (False),
   itsMarkDelete (False),
+  itsStatsInvalidated (False),
+  itsStatsFlushCount (0),
   itsWritable   (False),
   itsArray      (itsTable, itsColumnName),
   itsAccessor   (itsTable, itsColumnName)
@@ -165,6 +180,8 @@ PagedArray<T>::PagedArray (const PagedArray<T>& other)
   itsRowNumber  (other.itsRowNumber),
   itsIsClosed   (other.itsIsClosed),
   itsMarkDelete (other.itsMarkDelete),
+  itsStatsInvalidated (other.itsStatsInvalidated),
+  itsStatsFlushCount (other.itsStatsFlushCount),
   itsTableName  (other.itsTableName),
   itsWritable   (other.itsWritable),
   itsLockOpt    (other.itsLockOpt),
@@ -177,6 +194,12 @@ PagedArray<T>::PagedArray (const PagedArray<T>& other)
 template<class T>
 PagedArray<T>::~PagedArray()
 {
+  // Flush if written, so the statistics cache can be used again.
+  // It is not needed for a table to be deleted (e.g. a scratch table).
+  if (itsStatsInvalidated  &&  !itsIsClosed
+      &&  !itsTable.isMarkedForDelete()) {
+    flush();
+  }
   // Reopen if marked for delete to force that the table files get removed.
   if (itsMarkDelete) {
     tempReopen();
@@ -192,6 +215,8 @@ PagedArray<T>& PagedArray<T>::operator= (const PagedArray<T>& other)
     itsRowNumber  = other.itsRowNumber;
     itsIsClosed   = other.itsIsClosed;
     itsMarkDelete = other.itsMarkDelete;
+    itsStatsInvalidated = other.itsStatsInvalidated;
+    itsStatsFlushCount  = other.itsStatsFlushCount;
     itsTableName  = other.itsTableName;
     itsWritable   = other.itsWritable;
     itsLockOpt    = other.itsLockOpt;
@@ -264,6 +289,7 @@ void PagedArray<T>::resize (const TiledShape& newShape)
 {
   IPosition tileShape = newShape.tileShape();
   getRWArray().setShape (itsRowNumber, newShape.shape(), tileShape);
+  invalidateStatsCache();
 }
 
 template<class T>
@@ -281,6 +307,7 @@ void PagedArray<T>::doPutSlice (const Array<T>& sourceArray,
 {
   // Create a writable column object in case not existing yet.
   getRWArray();
+  invalidateStatsCache();
   const uInt arrDim = sourceArray.ndim();
   const uInt latDim = ndim();
   AlwaysAssert(arrDim <= latDim, AipsError);
@@ -383,6 +410,7 @@ void PagedArray<T>::putAt (const T& value, const IPosition& where)
   const IPosition shape(where.nelements(),1);
   Array<T> buffer (shape, &value);
   getRWArray().putSlice (itsRowNumber, Slicer(where,shape), buffer);
+  invalidateStatsCache();
 }
 
 template<class T>
@@ -545,6 +573,7 @@ void PagedArray<T>::flush()
 {
   if (!itsIsClosed) {
     itsTable.flush();
+    LatticeStatsBase::flushedStatsCache (name());
   }
 }
 template<class T>
@@ -552,6 +581,7 @@ void PagedArray<T>::tempClose()
 {
   if (!itsIsClosed) {
     itsTable.flush();
+    LatticeStatsBase::flushedStatsCache (name());
     itsTableName = itsTable.tableName();
     itsWritable  = itsTable.isWritable();
     itsLockOpt   = itsTable.lockOptions();
@@ -566,6 +596,19 @@ void PagedArray<T>::tempClose()
   }
 }
 
+template<class T>
+void PagedArray<T>::invalidateStatsCache()
+{
+  // A flush (also by another object) removes the lattice from the
+  // administration, so it has to be invalidated again after a flush.
+  uInt64 flushCount = LatticeStatsBase::statsCacheFlushCount();
+  if (!itsStatsInvalidated  ||  flushCount != itsStatsFlushCount) {
+    LatticeStatsBase::invalidateStatsCache (name());
+    itsStatsInvalidated = True;
+    itsStatsFlushCount  = flushCount;
+  }
+}
+
 template<class T>
 void PagedArray<T>::reopen()
 {
@@ -217,6 +217,10 @@ public:
   virtual Lattice<Bool>& pixelMask();
   // </group>
 
+  // Get the name of the pixelmask of the parent lattice.
+  // False is returned if an own pixelmask is used.
+  virtual Bool pixelMaskName (String& name) const;
+
   // Use the given mask as the pixelmask.
   // If another mask was already used, the new one will be used instead.
   // It checks if its shape matches the shape of the sublattice.
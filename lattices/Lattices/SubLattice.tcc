@@ -362,6 +362,19 @@ Bool SubLattice<T>::hasPixelMask() const
   return itsHasLattPMask  ||  itsOwnPixelMask != 0;
 }
 
+template<class T>
+Bool SubLattice<T>::pixelMaskName (String& name) const
+{
+  name = String();
+  if (itsOwnPixelMask != 0) {
+    return False;
+  }
+  if (itsHasLattPMask) {
+    return itsMaskLatPtr->pixelMaskName (name);
+  }
+  return True;
+}
+
 template<class T>
 const Lattice<Bool>& SubLattice<T>::pixelMask() const
 {
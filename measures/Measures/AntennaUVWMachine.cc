@@ -0,0 +1,219 @@
+//# AntennaUVWMachine.cc: Calculates UVW coordinates for many times and antennae
+//# Copyright (C) 2026
+//# Associated Universities, Inc. Washington DC, USA.
+//#
+//# This library is free software; you can redistribute it and/or modify it
+//# under the terms of the GNU Library General Public License as published by
+//# the Free Software Foundation; either version 2 of the License, or (at your
+//# option) any later version.
+//#
+//# This library is distributed in the hope that it will be useful, but WITHOUT
+//# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+//# License for more details.
+//#
+//# You should have received a copy of the GNU Library General Public License
+//# along with this library; if not, write to the Free Software Foundation,
+//# Inc., 675 Massachusetts Ave, Cambridge, MA 02139, USA.
+//#
+//# Correspondence concerning AIPS++ should be addressed as follows:
+//#        Internet email: aips2-request@nrao.edu.
+//#        Postal address: AIPS++ Project Office
+//#                        National Radio Astronomy Observatory
+//#                        520 Edgemont Road
+//#                        Charlottesville, VA 22903-2475 USA
+
+//# Includes
+#include <casacore/measures/Measures/AntennaUVWMachine.h>
+#include <casacore/measures/Measures/MCBaseline.h>
+#include <casacore/measures/Measures/MCDirection.h>
+#include <casacore/measures/Measures/MCPosition.h>
+#include <casacore/measures/Measures/MeasConvert.h>
+#include <casacore/measures/Measures/MeasFrame.h>
+#include <casacore/casa/Quanta/Euler.h>
+#include <casacore/casa/Quanta/RotMatrix.h>
+#include <casacore/casa/Quanta/MVBaseline.h>
+#include <casacore/casa/BasicSL/Constants.h>
+#include <casacore/casa/Exceptions/Error.h>
+#include <casacore/casa/Utilities/Assert.h>
+#include <exception>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace casacore { //# NAMESPACE CASACORE - BEGIN
+
+//# Constructors
+AntennaUVWMachine::AntennaUVWMachine (const Vector<MPosition>& antennaPositions,
+                                      const MPosition& arrayPosition)
+  : itsArrayPos (arrayPosition),
+    itsAntPos   (3, antennaPositions.size())
+{
+  Vector<Double> pos0;
+  for (uInt i=0; i<antennaPositions.size(); ++i) {
+    Vector<Double> pos = MPosition::Convert (antennaPositions[i],
+                                             MPosition::ITRF)()
+      .getValue().getValue();
+    if (i == 0) {
+      pos0 = pos;
+    }
+    for (uInt j=0; j<3; ++j) {
+      itsAntPos(j,i) = pos[j] - pos0[j];
+    }
+  }
+}
+
+//# Member functions
+void AntennaUVWMachine::setPhaseCenters (const Vector<MDirection>& phaseCenters)
+{
+  itsCenters.resize (phaseCenters.size());
+  itsCenters = phaseCenters;
+}
+
+void AntennaUVWMachine::getMatrix (Double* matrix, MeasFrame& frame,
+                                   MBaseline::Convert& convert,
+                                   const MEpoch& epoch, uInt center) const
+{
+  if (center >= itsCenters.size()) {
+    throw AipsError ("AntennaUVWMachine: invalid phase center index " +
+                     String::toString(center));
+  }
+  frame.resetEpoch (epoch);
+  // Get the phase center in J2000.
+  const MDirection& dir = itsCenters[center];
+  MVDirection mvdir;
+  if (dir.getRef().getType() == MDirection::J2000  &&  !dir.isModel()) {
+    mvdir = dir.getValue();
+  } else {
+    mvdir = MDirection::Convert (dir, MDirection::Ref(MDirection::J2000,
+                                                      frame))().getValue();
+  }
+  mvdir.adjust();
+  // Rotation projecting J2000 on the phase center (as done in MVuvw).
+  RotMatrix proj(Euler(mvdir.getLat() - C::pi_2, 1u,
+                       -mvdir.getLong() - C::pi_2, 3u));
+  // The ITRF to J2000 conversion is a rotation; get its matrix by
+  // converting the unit vectors.
+  Double rot[3][3];
+  for (uInt j=0; j<3; ++j) {
+    MVBaseline unit(j==0 ? 1. : 0., j==1 ? 1. : 0., j==2 ? 1. : 0.);
+    Vector<Double> col = convert(unit).getValue().getValue();
+    for (uInt i=0; i<3; ++i) {
+      rot[i][j] = col[i];
+    }
+  }
+  for (uInt i=0; i<3; ++i) {
+    for (uInt j=0; j<3; ++j) {
+      matrix[3*i+j] = (proj(i,0) * rot[0][j] + proj(i,1) * rot[1][j] +
+                       proj(i,2) * rot[2][j]);
+    }
+  }
+}
+
+void AntennaUVWMachine::antennaUVW (Matrix<Double>& uvw, const MEpoch& epoch,
+                                    uInt center) const
+{
+  MeasFrame frame(epoch, itsArrayPos);
+  MBaseline::Convert convert(MBaseline(MVBaseline(), MBaseline::ITRF),
+                             MBaseline::Ref(MBaseline::J2000, frame));
+  Double m[9];
+  getMatrix (m, frame, convert, epoch, center);
+  uvw.resize (3, nantenna());
+  for (uInt a=0; a<nantenna(); ++a) {
+    const Double* p = &(itsAntPos(0,a));
+    for (uInt i=0; i<3; ++i) {
+      uvw(i,a) = m[3*i] * p[0] + m[3*i+1] * p[1] + m[3*i+2] * p[2];
+    }
+  }
+}
+
+void AntennaUVWMachine::baselineUVW (Matrix<Double>& uvw,
+                                     const Vector<Double>& times,
+                                     MEpoch::Types timeRef,
+                                     const Vector<Int>& ant1,
+                                     const Vector<Int>& ant2,
+                                     const Vector<Int>& centers) const
+{
+  const uInt nrow = times.size();
+  AlwaysAssert (ant1.size() == nrow  &&  ant2.size() == nrow  &&
+                (centers.empty()  ||  centers.size() == nrow), AipsError);
+  // Find the unique time/center combinations (slots) of the rows.
+  std::map<std::pair<Double,Int>, uInt> slotMap;
+  std::vector<std::pair<Double,Int> > slots;
+  std::vector<uInt> rowSlot(nrow);
+  const Int nant = nantenna();
+  for (uInt row=0; row<nrow; ++row) {
+    if (ant1[row] < 0  ||  ant1[row] >= nant  ||
+        ant2[row] < 0  ||  ant2[row] >= nant) {
+      throw AipsError ("AntennaUVWMachine: invalid antenna index in row " +
+                       String::toString(row));
+    }
+    std::pair<Double,Int> key(times[row], centers.empty() ? 0 : centers[row]);
+    // Rows are usually in time order, so first try the last slot.
+    if (slots.empty()  ||  slots.back() != key) {
+      std::map<std::pair<Double,Int>, uInt>::const_iterator iter =
+        slotMap.find (key);
+      if (iter == slotMap.end()) {
+        slotMap[key] = slots.size();
+        slots.push_back (key);
+        rowSlot[row] = slots.size() - 1;
+      } else {
+        rowSlot[row] = iter->second;
+      }
+    } else {
+      rowSlot[row] = slots.size() - 1;
+    }
+  }
+  // Calculate the matrix of each slot. Each thread has its own frame and
+  // converter; an exception is rethrown after the parallel loop.
+  const Int nslot = slots.size();
+  std::vector<Double> matrices(9*nslot);
+  std::exception_ptr error;
+#ifdef _OPENMP
+#pragma omp parallel if (nslot > 1)
+#endif
+  {
+    MeasFrame frame(MEpoch(MVEpoch(), timeRef), itsArrayPos);
+    MBaseline::Convert convert(MBaseline(MVBaseline(), MBaseline::ITRF),
+                               MBaseline::Ref(MBaseline::J2000, frame));
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+    for (Int i=0; i<nslot; ++i) {
+      try {
+        MEpoch epoch(MVEpoch(Quantity(slots[i].first, "s")), timeRef);
+        getMatrix (&(matrices[9*i]), frame, convert, epoch, slots[i].second);
+      } catch (...) {
+#ifdef _OPENMP
+#pragma omp critical(AntennaUVWMachine_baselineUVW)
+#endif
+        {
+          if (!error) {
+            error = std::current_exception();
+          }
+        }
+      }
+    }
+  }
+  if (error) {
+    std::rethrow_exception (error);
+  }
+  // The baseline UVW is the matrix times the difference of the positions.
+  uvw.resize (3, nrow);
+  Bool deleteIt;
+  Double* uvwPtr = uvw.getStorage (deleteIt);
+  const Double* posPtr = itsAntPos.data();
+  for (uInt row=0; row<nrow; ++row) {
+    const Double* m = &(matrices[9*rowSlot[row]]);
+    const Double* p1 = posPtr + 3*ant1[row];
+    const Double* p2 = posPtr + 3*ant2[row];
+    Double d[3] = {p2[0]-p1[0], p2[1]-p1[1], p2[2]-p1[2]};
+    Double* out = uvwPtr + 3*row;
+    for (uInt i=0; i<3; ++i) {
+      out[i] = m[3*i] * d[0] + m[3*i+1] * d[1] + m[3*i+2] * d[2];
+    }
+  }
+  uvw.putStorage (uvwPtr, deleteIt);
+}
+
+} //# NAMESPACE CASACORE - END
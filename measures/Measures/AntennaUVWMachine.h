@@ -0,0 +1,156 @@
+//# AntennaUVWMachine.h: Calculates UVW coordinates for many times and antennae
+//# Copyright (C) 2026
+//# Associated Universities, Inc. Washington DC, USA.
+//#
+//# This library is free software; you can redistribute it and/or modify it
+//# under the terms of the GNU Library General Public License as published by
+//# the Free Software Foundation; either version 2 of the License, or (at your
+//# option) any later version.
+//#
+//# This library is distributed in the hope that it will be useful, but WITHOUT
+//# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+//# License for more details.
+//#
+//# You should have received a copy of the GNU Library General Public License
+//# along with this library; if not, write to the Free Software Foundation,
+//# Inc., 675 Massachusetts Ave, Cambridge, MA 02139, USA.
+//#
+//# Correspondence concerning AIPS++ should be addressed as follows:
+//#        Internet email: aips2-request@nrao.edu.
+//#        Postal address: AIPS++ Project Office
+//#                        National Radio Astronomy Observatory
+//#                        520 Edgemont Road
+//#                        Charlottesville, VA 22903-2475 USA
+
+#ifndef MEASURES_ANTENNAUVWMACHINE_H
+#define MEASURES_ANTENNAUVWMACHINE_H
+
+//# Includes
+#include <casacore/casa/aips.h>
+#include <casacore/measures/Measures/MBaseline.h>
+#include <casacore/measures/Measures/MDirection.h>
+#include <casacore/measures/Measures/MEpoch.h>
+#include <casacore/measures/Measures/MPosition.h>
+#include <casacore/casa/Arrays/Vector.h>
+#include <casacore/casa/Arrays/Matrix.h>
+
+namespace casacore { //# NAMESPACE CASACORE - BEGIN
+
+//# Forward Declarations
+class MeasFrame;
+
+// <summary> Calculates UVW coordinates for many times and antennae
+// </summary>
+
+// <use visibility=export>
+
+// <reviewed reviewer="" date="" tests="tAntennaUVWMachine.cc" demos="">
+// </reviewed>
+
+// <prerequisite>
+//   <li> <linkto class=MBaseline>MBaseline</linkto> class
+//   <li> <linkto class=UVWMachine>UVWMachine</linkto> class
+// </prerequisite>
+//
+// <etymology>
+// From antenna UVW coordinates and machinery
+// </etymology>
+//
+// <synopsis>
+// The construction of an AntennaUVWMachine class object creates a machine
+// that calculates the J2000 UVW coordinates (in meters) of the baselines
+// of an array for a series of times and phase centers, for instance to
+// (re)calculate the UVW column of a MeasurementSet.
+//
+// Converting the UVW of each baseline separately is expensive, because
+// each conversion does the full frame conversion from ITRF to J2000.
+// However, for a given time this conversion is a rotation, which
+// together with the projection on the phase center gives a single 3x3
+// matrix. This machine calculates that matrix only once per time and
+// phase center. The UVW of an antenna is the matrix times its position
+// (relative to the first antenna); the UVW of a baseline is the difference
+// of the UVWs of its antennae, which is the same as the matrix times the
+// difference of the antenna positions.
+//
+// The matrices of different times are calculated in parallel (if
+// OpenMP is used), where each thread uses its own conversion engines.
+// The results are the same as converting each baseline with
+// an <linkto class=MBaseline>MBaseline</linkto> conversion to J2000
+// followed by an <linkto class=MVuvw>MVuvw</linkto> projection on the
+// J2000 phase center (apart from rounding errors).
+// </synopsis>
+//
+// <example>
+// <srcblock>
+//  // Positions of the antennae and array.
+//  Vector<MPosition> antPos = ...;
+//  AntennaUVWMachine machine(antPos, arrayPos);
+//  machine.setPhaseCenters (Vector<MDirection>(1, phaseCenter));
+//  // Get the UVW of the rows given by time (in sec), ANTENNA1, ANTENNA2
+//  // and the index of the phase center.
+//  Matrix<Double> uvw;
+//  machine.baselineUVW (uvw, times, MEpoch::UTC, ant1, ant2, centers);
+// </srcblock>
+// </example>
+//
+// <motivation>
+// To speed up the calculation of UVW coordinates of entire observations.
+// </motivation>
+
+class AntennaUVWMachine {
+public:
+  //# Constructors
+  // Construct for the given antenna positions (in any reference frame).
+  // The array position is used in the frame of the conversions.
+  AntennaUVWMachine (const Vector<MPosition>& antennaPositions,
+                     const MPosition& arrayPosition);
+
+  //# Member functions
+  // Set the phase centers. The rows given to <src>baselineUVW</src>
+  // refer to a phase center by its index.
+  void setPhaseCenters (const Vector<MDirection>& phaseCenters);
+
+  // Get the number of antennae.
+  uInt nantenna() const
+    { return itsAntPos.ncolumn(); }
+
+  // Get the J2000 UVW of all antennae (relative to the first antenna)
+  // for the given epoch and phase center index.
+  // The matrix is resized to (3,nantenna).
+  void antennaUVW (Matrix<Double>& uvw, const MEpoch& epoch,
+                   uInt center) const;
+
+  // Get the J2000 UVW of the baselines (ant2 minus ant1) given by the rows.
+  // The times are in seconds with the given reference type;
+  // <src>centers</src> gives the index of the phase center of each row.
+  // If empty, phase center 0 is used for all rows.
+  // The matrix is resized to (3,nrow).
+  // <thrown>
+  //  <li> AipsError if an antenna or phase center index is invalid
+  // </thrown>
+  void baselineUVW (Matrix<Double>& uvw, const Vector<Double>& times,
+                    MEpoch::Types timeRef,
+                    const Vector<Int>& ant1, const Vector<Int>& ant2,
+                    const Vector<Int>& centers=Vector<Int>()) const;
+
+private:
+  // Calculate the matrix converting an ITRF baseline to J2000 UVW.
+  // The frame and converter are used for the conversion.
+  void getMatrix (Double* matrix, MeasFrame& frame,
+                  MBaseline::Convert& convert,
+                  const MEpoch& epoch, uInt center) const;
+
+  //# Data
+  // Array position.
+  MPosition itsArrayPos;
+  // ITRF antenna positions relative to the first antenna (3,nant).
+  Matrix<Double> itsAntPos;
+  // The phase centers.
+  Vector<MDirection> itsCenters;
+};
+
+
+} //# NAMESPACE CASACORE - END
+
+#endif
@@ -0,0 +1,133 @@
+//# tAntennaUVWMachine.cc: Test program for AntennaUVWMachine
+//# Copyright (C) 2026
+//# Associated Universities, Inc. Washington DC, USA.
+//#
+//# This program is free software; you can redistribute it and/or modify it
+//# under the terms of the GNU General Public License as published by the Free
+//# Software Foundation; either version 2 of the License, or (at your option)
+//# any later version.
+//#
+//# This program is distributed in the hope that it will be useful, but WITHOUT
+//# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+//# more details.
+//#
+//# You should have received a copy of the GNU General Public License along
+//# with this program; if not, write to the Free Software Foundation, Inc.,
+//# 675 Massachusetts Ave, Cambridge, MA 02139, USA.
+//#
+//# Correspondence concerning AIPS++ should be addressed as follows:
+//#        Internet email: aips2-request@nrao.edu.
+//#        Postal address: AIPS++ Project Office
+//#                        National Radio Astronomy Observatory
+//#                        520 Edgemont Road
+//#                        Charlottesville, VA 22903-2475 USA
+
+#include <casacore/measures/Measures/AntennaUVWMachine.h>
+#include <casacore/measures/Measures/MBaseline.h>
+#include <casacore/measures/Measures/MCBaseline.h>
+#include <casacore/measures/Measures/MCDirection.h>
+#include <casacore/measures/Measures/MCPosition.h>
+#include <casacore/measures/Measures/MeasConvert.h>
+#include <casacore/measures/Measures/MeasFrame.h>
+#include <casacore/measures/Measures/Muvw.h>
+#include <casacore/casa/Quanta/MVuvw.h>
+#include <casacore/casa/Arrays/ArrayLogical.h>
+#include <casacore/casa/Utilities/Assert.h>
+#include <casacore/casa/Exceptions/Error.h>
+#include <casacore/casa/iostream.h>
+
+#include <casacore/casa/namespace.h>
+
+// Calculate the UVW of a baseline by converting it to J2000 and projecting
+// it on the phase center (as done in MSCalEngine).
+Vector<Double> refUVW (const MPosition& p1, const MPosition& p2,
+                       const MPosition& arrayPos, Double time,
+                       const MDirection& center)
+{
+  MeasFrame frame(MEpoch(Quantity(time, "s"), MEpoch::UTC), arrayPos);
+  Vector<Double> v1 = MPosition::Convert(p1, MPosition::ITRF)()
+    .getValue().getValue();
+  Vector<Double> v2 = MPosition::Convert(p2, MPosition::ITRF)()
+    .getValue().getValue();
+  MBaseline bl(MVBaseline(v2[0]-v1[0], v2[1]-v1[1], v2[2]-v1[2]),
+               MBaseline::ITRF);
+  MVBaseline bas = MBaseline::Convert(bl, MBaseline::Ref(MBaseline::J2000,
+                                                          frame))()
+    .getValue();
+  MDirection dir = MDirection::Convert(center,
+                                       MDirection::Ref(MDirection::J2000,
+                                                       frame))();
+  return MVuvw(bas, dir.getValue()).getValue();
+}
+
+int main()
+{
+  try {
+    // Some positions around the VLA.
+    MPosition arrayPos(MVPosition(-1601162, -5042003, 3554915),
+                       MPosition::ITRF);
+    const Int nant = 5;
+    Vector<MPosition> antPos(nant);
+    for (Int i=0; i<nant; ++i) {
+      antPos[i] = MPosition(MVPosition(-1601162 + 300*i, -5042003 - 150*i*i,
+                                       3554915 + 1000*i), MPosition::ITRF);
+    }
+    Vector<MDirection> centers(2);
+    centers[0] = MDirection(Quantity(3.25745692, "rad"),
+                            Quantity(0.040643336, "rad"), MDirection::J2000);
+    centers[1] = MDirection(Quantity(1.2, "rad"), Quantity(0.8, "rad"),
+                            MDirection::B1950);
+    AntennaUVWMachine machine(antPos, arrayPos);
+    machine.setPhaseCenters (centers);
+    AlwaysAssertExit (machine.nantenna() == uInt(nant));
+    // Make rows for some times and all baselines.
+    const Int ntime = 7;
+    const Int nbl = nant * (nant-1) / 2;
+    Vector<Double> times(ntime*nbl);
+    Vector<Int> ant1(ntime*nbl), ant2(ntime*nbl), fld(ntime*nbl);
+    Int row = 0;
+    for (Int t=0; t<ntime; ++t) {
+      for (Int a1=0; a1<nant; ++a1) {
+        for (Int a2=a1+1; a2<nant; ++a2) {
+          times[row] = 4.1216294e9 + 1800*t;
+          ant1[row] = a1;
+          ant2[row] = a2;
+          fld[row] = t%2;
+          ++row;
+        }
+      }
+    }
+    Matrix<Double> uvw;
+    machine.baselineUVW (uvw, times, MEpoch::UTC, ant1, ant2, fld);
+    AlwaysAssertExit (uvw.shape() == IPosition(2, 3, ntime*nbl));
+    for (Int i=0; i<row; ++i) {
+      Vector<Double> ref = refUVW (antPos[ant1[i]], antPos[ant2[i]],
+                                   arrayPos, times[i], centers[fld[i]]);
+      AlwaysAssertExit (allNearAbs (uvw.column(i), ref, 1e-6));
+    }
+    // The baseline UVW is the difference of the antenna UVWs.
+    Matrix<Double> antUVW;
+    machine.antennaUVW (antUVW, MEpoch(Quantity(times[nbl], "s"),
+                                       MEpoch::UTC), 1);
+    AlwaysAssertExit (antUVW.shape() == IPosition(2, 3, nant));
+    for (Int i=nbl; i<2*nbl; ++i) {
+      Vector<Double> diff = antUVW.column(ant2[i]) - antUVW.column(ant1[i]);
+      AlwaysAssertExit (allNearAbs (uvw.column(i), diff, 1e-6));
+    }
+    // An invalid antenna results in an exception.
+    ant2[3] = nant;
+    Bool caught = False;
+    try {
+      machine.baselineUVW (uvw, times, MEpoch::UTC, ant1, ant2, fld);
+    } catch (const AipsError&) {
+      caught = True;
+    }
+    AlwaysAssertExit (caught);
+  } catch (const std::exception& x) {
+    cout << "Unexpected exception: " << x.what() << endl;
+    return 1;
+  }
+  cout << "OK" << endl;
+  return 0;
+}
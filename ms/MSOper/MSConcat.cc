@@ -28,6 +28,7 @@
 #include <casacore/casa/Arrays/Matrix.h>
 #include <casacore/casa/Arrays/Cube.h>
 #include <casacore/casa/Arrays/ArrayMath.h>
+#include <casacore/casa/Arrays/Slicer.h>
 #include <casacore/casa/Containers/Block.h>
 #include <casacore/casa/Containers/Record.h>
 #include <casacore/casa/Containers/RecordField.h>
@@ -63,9 +64,103 @@
 #include <casacore/casa/OS/Path.h>
 #include <casacore/casa/OS/Directory.h>
 #include <algorithm>
+#include <map>
+#include <vector>
 
 namespace casacore {
 
+namespace {
+
+// Lookup table to remap the ids in a column of the main table.
+// Ids not in the map are not changed.
+class ConcatIdMap
+{
+public:
+  ConcatIdMap(const std::map<Int, Int>& idMap, Bool use=True)
+    : itsMin(0)
+  {
+    if(use && !idMap.empty()){
+      itsMin = idMap.begin()->first;
+      const Int nid = idMap.rbegin()->first - itsMin + 1;
+      itsIds.resize(nid);
+      for(Int i=0; i<nid; i++){
+	itsIds[i] = itsMin + i;
+      }
+      for(const auto& id : idMap){
+	itsIds[id.first - itsMin] = id.second;
+      }
+    }
+  }
+
+  Int operator()(Int id) const
+  {
+    const Int inx = id - itsMin;
+    return (inx >= 0 && inx < Int(itsIds.size())  ?  itsIds[inx] : id);
+  }
+
+private:
+  Int itsMin;
+  std::vector<Int> itsIds;
+};
+
+template<class T> inline T concatConj(const T& value, Bool)
+  { return value; }
+inline Complex concatConj(const Complex& value, Bool doConj)
+  { return (doConj ? conj(value) : value); }
+
+// Get the cells of an array column for a range of rows with the same shape.
+// For the rows where swapRow is True (if given) the correlations (first
+// axis) are swapped according to polSwap and the values are conjugated
+// if doConj is True. The channels (second axis) are reversed if
+// reverseChan is True.
+template<class T>
+Array<T> concatGetCells(const ArrayColumn<T>& col, const Slicer& rows,
+			const Bool* swapRow, const vector<Int>& polSwap,
+			Bool reverseChan, Bool doConj)
+{
+  Array<T> arr = col.getColumnRange(rows);
+  if((swapRow == 0 && !reverseChan) || arr.empty()){
+    return arr;
+  }
+  const IPosition& shape = arr.shape();
+  const Int64 nrow = shape[shape.size()-1];
+  const size_t ncorr = shape[0];
+  const size_t nchan = (reverseChan ? shape[1] : 1);
+  const size_t cellSize = arr.nelements() / nrow;
+  const size_t nrest = cellSize / (ncorr * nchan);
+  Bool deleteIt;
+  T* data = arr.getStorage(deleteIt);
+#ifdef _OPENMP
+#pragma omp parallel if(arr.nelements() > 1000000)
+#endif
+  {
+    Block<T> cell(cellSize);
+#ifdef _OPENMP
+#pragma omp for
+#endif
+    for(Int64 r=0; r<nrow; r++){
+      const Bool swap = (swapRow != 0 && swapRow[r]);
+      if(swap || reverseChan){
+	T* out = data + r*cellSize;
+	std::copy(out, out+cellSize, cell.storage());
+	for(size_t k=0; k<nrest; k++){
+	  for(size_t c=0; c<nchan; c++){
+	    const T* in = cell.storage() + (k*nchan + (reverseChan ? nchan-1-c : c)) * ncorr;
+	    T* outc = out + (k*nchan + c) * ncorr;
+	    for(size_t p=0; p<ncorr; p++){
+	      outc[p] = (swap ? concatConj(in[polSwap[p]], doConj) : in[p]);
+	    }
+	  }
+	}
+      }
+    }
+  }
+  arr.putStorage(data, deleteIt);
+  return arr;
+}
+
+} //# end anonymous namespace
+
 MSConcat::MSConcat(MeasurementSet& ms):
   MSColumns(ms),
   itsMS(ms),
@@ -75,6 +170,8 @@ MSConcat::MSConcat(MeasurementSet& ms):
   itsFreqTol=Quantum<Double>(1.0, "Hz");
   itsWeightScale = 1.;
   itsRespectForFieldName = False;
+  itsBulkCopy = True;
+  itsBulkBlockRows = 10000;
   doSource_p=False;
   doObsA_p = doObsB_p = False;
   doProcA_p = doProcB_p = False;
@@ -1381,30 +1478,35 @@ IPosition MSConcat::isFixedShape(const TableDesc& td) {
   thisProcId.reference(processorId());
 
   Vector<Int> obsIds=otherObsId.getColumn();
+  Vector<Int> procIds=otherProcId.getColumn();
 
-  if(doObsA_p){ // the obs ids changed for the first table
-    Vector<Int> oldObsIds=thisObsId.getColumn();
-    for(rownr_t r = 0; r < curRow; r++) {
-      if(newObsIndexA_p.find(oldObsIds[r]) != newObsIndexA_p.end()){ // apply change
-	thisObsId.put(r, getMapValue (newObsIndexA_p, oldObsIds[r]));
+  // the id columns of the first table are read and written as a whole
+  Vector<Int> theseObsIds;
+  Vector<Int> theseScans;
+  if(curRow > 0){
+    const Slicer firstRows(IPosition(1, 0), IPosition(1, curRow));
+    theseObsIds = thisObsId.getColumnRange(firstRows);
+    theseScans = thisScan.getColumnRange(firstRows);
+
+    if(doObsA_p){ // the obs ids changed for the first table
+      const ConcatIdMap obsMap(newObsIndexA_p);
+      for(rownr_t r = 0; r < curRow; r++) {
+	theseObsIds[r] = obsMap(theseObsIds[r]);
       }
+      thisObsId.putColumnRange(firstRows, theseObsIds);
     }
-  }
-
-  Vector<Int> procIds=otherProcId.getColumn();
 
-  if(doProcA_p){ // the proc ids changed for the first table
-    Vector<Int> oldProcIds=thisProcId.getColumn();
-    for(uInt r = 0; r < curRow; r++) {
-      if(newProcIndexA_p.find(oldProcIds[r]) != newProcIndexA_p.end()){ // apply change
-	thisProcId.put(r, getMapValue (newProcIndexA_p, oldProcIds[r]));
+    if(doProcA_p){ // the proc ids changed for the first table
+      const ConcatIdMap procMap(newProcIndexA_p);
+      Vector<Int> theseProcIds=thisProcId.getColumnRange(firstRows);
+      for(rownr_t r = 0; r < curRow; r++) {
+	theseProcIds[r] = procMap(theseProcIds[r]);
       }
+      thisProcId.putColumnRange(firstRows, theseProcIds);
     }
-  }
 
-  if(doState && otherStateNull){ // the state ids for the first table will have to be set to -1
-    for(rownr_t r = 0; r < curRow; r++) {
-      thisStateId.put(r, -1);
+    if(doState && otherStateNull){ // the state ids for the first table will have to be set to -1
+      thisStateId.putColumnRange(firstRows, Vector<Int>(curRow, -1));
     }
   }
 
@@ -1418,8 +1520,8 @@ IPosition MSConcat::isFixedShape(const TableDesc& td) {
   vector<Int> maxScan;
   Int maxScanThis=0;
   for(rownr_t r = 0; r < curRow; r++) {
-    Int oid = thisObsId(r);
-    Int scanid = thisScan(r);
+    Int oid = theseObsIds[r];
+    Int scanid = theseScans[r];
     Bool found = False;
     uInt i;
     for(i=0; i<distinctObsIdSet.size(); i++){
@@ -1510,6 +1612,205 @@ IPosition MSConcat::isFixedShape(const TableDesc& td) {
   Int polId = -1;
   vector<Int> polSwap;
 
+  if(itsBulkCopy){
+    // Copy the rows in blocks. The ids are remapped using lookup tables.
+    // The array columns are copied in runs of rows with the same data
+    // description id, thus with the same shape, correlation swap and
+    // channel order.
+    const ConcatIdMap obsMap(newObsIndexB_p, doObsB_p);
+    const ConcatIdMap procMap(newProcIndexB_p, doProcB_p);
+
+    // the scan number offset for each obs id (in order of appearance)
+    std::map<Int, Int> scanAdd;
+    for (rownr_t r = 0; r < newRows; r++) {
+      if((r == 0 || obsIds[r] != obsIds[r-1]) &&
+	 scanAdd.find(obsIds[r]) == scanAdd.end()){
+	const Int oid = obsMap(obsIds[r]);
+	Int offset = 0;
+	if(oid != obsIds[r]){ // obsid actually changed
+	  if(scanOffsetForOid.find(oid) == scanOffsetForOid.end()){ // offset not set, use default
+	    scanOffsetForOid[oid] = defaultScanOffset;
+	  }
+	  if(encountered.find(oid)==encountered.end() && scanOffsetForOid.at(oid)!=0){
+	    log << LogIO::NORMAL << "Will offset scan numbers by " <<  scanOffsetForOid.at(oid)
+		<< " for observations with Obs ID " << oid
+		<< " in order to make scan numbers unique." << LogIO::POST;
+	    encountered[oid] = 0;
+	  }
+	  offset = scanOffsetForOid.at(oid);
+	}
+	scanAdd[obsIds[r]] = offset;
+      }
+    }
+    const ConcatIdMap scanMap(scanAdd);
+
+    // the correlation swap for each data description id
+    vector<vector<Int> > polSwaps(otherDDCols.nrow());
+    for (uInt d = 0; d < polSwaps.size(); d++) {
+      const Matrix<Int> products = otherPolCols.corrProduct()(otherDDCols.polarizationId()(d));
+      vector<Int>& swap = polSwaps[d];
+      swap.resize(products.shape()(1));
+      for (uInt i = 0; i < swap.size(); i++) {
+	swap[i] = i;
+	for (uInt j = 0; j < swap.size(); j++) {
+	  if (products(0, i) == products(1, j) &&
+	      products(1, i) == products(0, j)) {
+	    swap[i] = j;
+	    break;
+	  }
+	}
+      }
+    }
+
+    for (rownr_t r0 = 0; r0 < newRows; r0 += itsBulkBlockRows) {
+      const rownr_t nb = std::min(itsBulkBlockRows, newRows - r0);
+      const Slicer inRows(IPosition(1, r0), IPosition(1, nb));
+      const Slicer outRows(IPosition(1, curRow + r0), IPosition(1, nb));
+
+      // the scalar columns
+      Vector<Int> ant1 = otherAnt1.getColumnRange(inRows);
+      Vector<Int> ant2 = otherAnt2.getColumnRange(inRows);
+      Vector<Int> feed1 = otherFeed1.getColumnRange(inRows);
+      Vector<Int> feed2 = otherFeed2.getColumnRange(inRows);
+      const Vector<Int> ddIds = otherDDId.getColumnRange(inRows);
+      Vector<Int> newDDIds(nb);
+      Vector<Int> fieldIds = otherFieldId.getColumnRange(inRows);
+      Vector<Int> scans = otherScan.getColumnRange(inRows);
+      Vector<Int> newObsIds(nb);
+      Vector<Int> newProcIds(nb);
+      Vector<Int> stateIds = otherStateId.getColumnRange(inRows);
+      Block<Bool> swapRow(nb);
+      for (rownr_t i = 0; i < nb; i++) {
+	if(notYetFeedWarned && (feed1[i]>0 || feed2[i]>0)){
+	  log << LogIO::WARN << "MS to be appended contains antennas with multiple feeds. Feed ID reindexing is not implemented.\n"
+	      << LogIO::POST;
+	  notYetFeedWarned = False;
+	}
+	const Int newA1 = newAntIndices[ant1[i]];
+	const Int newA2 = newAntIndices[ant2[i]];
+	swapRow[i] = (newA1 > newA2); // swap indices and multiply UVW by -1
+	if(swapRow[i]){
+	  ant1[i] = newA2;
+	  ant2[i] = newA1;
+	  std::swap(feed1[i], feed2[i]);
+	}
+	else{
+	  ant1[i] = newA1;
+	  ant2[i] = newA2;
+	}
+	newDDIds[i] = newDDIndices[ddIds[i]];
+	fieldIds[i] = newFldIndices[fieldIds[i]];
+	scans[i] += scanMap(obsIds[r0+i]);
+	newObsIds[i] = obsMap(obsIds[r0+i]);
+	newProcIds[i] = procMap(procIds[r0+i]);
+	if(doState){
+	  stateIds[i] = ((itsStateNull || otherStateNull)  ?
+			 -1 : Int(newStateIndices[stateIds[i]]));
+	}
+      }
+      thisAnt1.putColumnRange(outRows, ant1);
+      thisAnt2.putColumnRange(outRows, ant2);
+      thisFeed1.putColumnRange(outRows, feed1);
+      thisFeed2.putColumnRange(outRows, feed2);
+      thisDDId.putColumnRange(outRows, newDDIds);
+      thisFieldId.putColumnRange(outRows, fieldIds);
+      thisScan.putColumnRange(outRows, scans);
+      thisObsId.putColumnRange(outRows, newObsIds);
+      thisProcId.putColumnRange(outRows, newProcIds);
+      thisStateId.putColumnRange(outRows, stateIds);
+      thisTime.putColumnRange(outRows, otherTime.getColumnRange(inRows));
+      thisInterval.putColumnRange(outRows, otherInterval.getColumnRange(inRows));
+      thisExposure.putColumnRange(outRows, otherExposure.getColumnRange(inRows));
+      thisTimeCen.putColumnRange(outRows, otherTimeCen.getColumnRange(inRows));
+      thisArrayId.putColumnRange(outRows, otherArrayId.getColumnRange(inRows));
+      thisFlagRow.putColumnRange(outRows, otherFlagRow.getColumnRange(inRows));
+
+      // the array columns
+      rownr_t i0 = 0;
+      while (i0 < nb) {
+	rownr_t i1 = i0 + 1;
+	while (i1 < nb && ddIds[i1] == ddIds[i0]) {
+	  i1++;
+	}
+	const Slicer inRun(IPosition(1, r0 + i0), IPosition(1, i1 - i0));
+	const Slicer outRun(IPosition(1, curRow + r0 + i0), IPosition(1, i1 - i0));
+	const Bool reverse = itsChanReversed[ddIds[i0]];
+	const vector<Int>& runSwap = polSwaps[ddIds[i0]];
+	const Bool* swap = 0;
+	for (rownr_t i = i0; i < i1; i++) {
+	  if(swapRow[i]){
+	    swap = swapRow.storage() + i0;
+	    break;
+	  }
+	}
+
+	Array<Double> uvw = otherUvw.getColumnRange(inRun);
+	if(swap){
+	  Matrix<Double> uvwm(uvw);
+	  for (rownr_t i = 0; i < i1 - i0; i++) {
+	    if(swap[i]){
+	      for (uInt k = 0; k < uvwm.nrow(); k++) {
+		uvwm(k, i) = -uvwm(k, i);
+	      }
+	    }
+	  }
+	}
+	thisUvw.putColumnRange(outRun, uvw);
+
+	if(doFloatData){
+	  thisFloatData.putColumnRange(outRun, concatGetCells(otherFloatData, inRun,
+							    0, runSwap, reverse, False));
+	}
+	else{
+	  thisData.putColumnRange(outRun, concatGetCells(otherData, inRun,
+						       swap, runSwap, reverse, True));
+	}
+	if(doModelData){
+	  thisModelData.putColumnRange(outRun, concatGetCells(otherModelData, inRun,
+							    swap, runSwap, reverse, True));
+	}
+	if(doCorrectedData){
+	  thisCorrectedData.putColumnRange(outRun, concatGetCells(otherCorrectedData, inRun,
+								swap, runSwap, reverse, True));
+	}
+
+	Array<Float> weight = concatGetCells(otherWeight, inRun, swap, runSwap, False, False);
+	Array<Float> sigma = concatGetCells(otherSigma, inRun, swap, runSwap, False, False);
+	if(doWeightScale){
+	  weight *= itsWeightScale;
+	  sigma *= sScale;
+	}
+	thisWeight.putColumnRange(outRun, weight);
+	thisSigma.putColumnRange(outRun, sigma);
+	if(copyWtSp){
+	  Array<Float> weightSp = concatGetCells(otherWeightSp, inRun, swap, runSwap, False, False);
+	  if(doWeightScale){
+	    weightSp *= itsWeightScale;
+	  }
+	  thisWeightSp.putColumnRange(outRun, weightSp);
+	}
+	if(copySgSp){
+	  Array<Float> sigmaSp = concatGetCells(otherSigmaSp, inRun, swap, runSwap, False, False);
+	  if(doWeightScale){
+	    sigmaSp *= sScale;
+	  }
+	  thisSigmaSp.putColumnRange(outRun, sigmaSp);
+	}
+
+	thisFlag.putColumnRange(outRun, concatGetCells(otherFlag, inRun, swap, runSwap, False, False));
+	if(copyFlagCat){
+	  thisFlagCat.putColumnRange(outRun, concatGetCells(otherFlagCat, inRun, swap, runSwap, False, False));
+	}
+	i0 = i1;
+      }
+    }
+
+    if(doModelData){ //update the MODEL_DATA keywords
+      updateModelDataKeywords(*destMS);
+    }
+    return;
+  }
+
   for (rownr_t r = 0; r < newRows; r++, curRow++) {
     // Determine whether we need to swap rows in the visibility matrix
     // if we change the order of the antennas.  This is done by
@@ -1877,6 +2178,11 @@ void MSConcat::setRespectForFieldName(const Bool respectFieldName){
   itsRespectForFieldName = respectFieldName;
 }
 
+void MSConcat::setBulkCopy(const Bool bulkCopy, const rownr_t blockRows){
+  itsBulkCopy = bulkCopy;
+  itsBulkBlockRows = std::max(blockRows, rownr_t(1));
+}
+
 void MSConcat::checkShape(const IPosition& otherShape) const
 {
   const uInt nAxes = std::min(itsFixedShape.nelements(), otherShape.nelements());
@@ -92,6 +92,13 @@ public:
   void setRespectForFieldName(const Bool respectFieldName); //# If True, fields of same direction are not merged
                                                             //# if their name is different
 
+  // Tell if <src>concatenate</src> copies the main table rows in blocks of
+  // at most <src>blockRows</src> rows (which is the default). The ids are
+  // then remapped using lookup tables and the array columns are copied
+  // with a single get and put per run of rows with the same data
+  // description id. If False, the rows are copied one by one.
+  void setBulkCopy(const Bool bulkCopy, const rownr_t blockRows=10000);
+
 private:
   MSConcat();
   static IPosition isFixedShape(const TableDesc& td);
@@ -143,6 +150,8 @@ private:
   Float itsWeightScale;
   Bool itsRespectForFieldName;
   Vector<Bool> itsChanReversed;
+  Bool itsBulkCopy;
+  rownr_t itsBulkBlockRows;
   std::map <Int, Int> newSourceIndex_p;
   std::map <Int, Int> newSourceIndex2_p;
   std::map <Int, Int> newSPWIndex_p;
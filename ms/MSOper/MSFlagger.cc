@@ -327,13 +327,13 @@ void MSFlagger::getStats(Array<Float>& medTF, Array<Float>& adTF,
   {
     Bool deletemedT;
     const Float* pmedT=medT.getStorage(deletemedT);
-    Int offset=0;
-    IPosition polifr(2);
-    for (Int pol=0; pol<nCorr; pol++) {
-      polifr(0)=pol;
-      offset=pol;
-      for (Int ifr=0; ifr<nIfr; ifr++, offset+=nXY) {
-	polifr(1)=ifr;
+#ifdef _OPENMP
+#pragma omp parallel for if(nIfr > 16)
+#endif
+    for (Int ifr=0; ifr<nIfr; ifr++) {
+      IPosition polifr(2, 0, ifr);
+      for (Int pol=0, offset=ifr*nXY; pol<nCorr; pol++, offset++) {
+	polifr(0)=pol;
 	Float ad=0, med=medFmedT(polifr);
 	Int count=0, offchan=offset;
 	for (Int i=0; i<nChan; i++, offchan+=nCorr) {
@@ -353,13 +353,14 @@ void MSFlagger::getStats(Array<Float>& medTF, Array<Float>& adTF,
   {
     Bool deletemedF;
     const Float* pmedF=medF.getStorage(deletemedF);
-    Int offset=0, nXZ=nCorr*nIfr;
-    IPosition polifr(2);
-    for (Int pol=0; pol<nCorr; pol++) {
-      polifr(0)=pol;
-      offset=pol;
-      for (Int ifr=0; ifr<nIfr; ifr++, offset+=nCorr) {
-	polifr(1)=ifr;
+    const Int nXZ=nCorr*nIfr;
+#ifdef _OPENMP
+#pragma omp parallel for if(nIfr > 16)
+#endif
+    for (Int ifr=0; ifr<nIfr; ifr++) {
+      IPosition polifr(2, 0, ifr);
+      for (Int pol=0, offset=ifr*nCorr; pol<nCorr; pol++, offset++) {
+	polifr(0)=pol;
 	Float ad=0, med=medTmedF(polifr);
 	Int count=0, offtime=offset, offrow=ifr;
 	for (Int i=0; i<nTime; i++, offtime+=nXZ, offrow+=nIfr) {
@@ -377,12 +378,13 @@ void MSFlagger::getStats(Array<Float>& medTF, Array<Float>& adTF,
 
   // calculate overall average deviation (per pol and ifr)
   {
-    IPosition polifr(2);
-    for (Int pol=0; pol<nCorr; pol++) {
-      polifr(0)=pol;
-      Int offset=pol;
-      for (Int ifr=0; ifr<nIfr; ifr++, offset+=nXY) {  
-	polifr(1)=ifr;
+#ifdef _OPENMP
+#pragma omp parallel for if(nIfr > 1)
+#endif
+    for (Int ifr=0; ifr<nIfr; ifr++) {
+      IPosition polifr(2, 0, ifr);
+      for (Int pol=0, offset=ifr*nXY; pol<nCorr; pol++, offset++) {
+	polifr(0)=pol;
 	Float ad=0, med=medTF(polifr);
 	Int count=0, offset2=offset, offrow=ifr;
 	for (Int i=0; i<nTime; i++, offset2+=nXYZ, offrow+=nIfr) {
@@ -429,16 +431,29 @@ void MSFlagger::diffMedian(Array<Float>& out, const Array<Float>& in,
   const Float* pin=in.getStorage(deleteIn);
   const Bool* pflag=flag.getStorage(deleteFlag);
   Float* pout=out.getStorage(deleteOut);
-  Block<Float> values(nAxis);
-  for (Int j=0, offj=0; j<nGreater; j++, offj+=nLess) {
-    for (Int k=0, offk=offj*nAxis, offout=offj; k<nLess; 
-	 k++, offk++, offout++) {
+  // The profiles are independent, so they can be done in parallel.
+  const Int64 nOut=Int64(nGreater)*nLess;
+#ifdef _OPENMP
+#pragma omp parallel if(nOut*nAxis > 65536)
+#endif
+  {
+    Block<Float> values(nAxis);
+#ifdef _OPENMP
+#pragma omp for
+#endif
+    for (Int64 offout=0; offout<nOut; offout++) {
+      const Int64 j=offout/nLess;
+      const Int64 offk=j*nLess*nAxis + offout-j*nLess;
       Int count=0;
-      for (Int l=0, offin=offk; l<nAxis; l++, offin+=nLess) {
+      for (Int64 l=0, offin=offk; l<nAxis; l++, offin+=nLess) {
 	if (!pflag[offin]) values[count++]=pin[offin];
       }
-      if (count>0) pout[offout]=median(Vector<Float>(values.begin(),values.begin()+count));
-      else pout[offout]=0;
+      if (count>0) {
+	pout[offout]=medianInPlace(Vector<Float>(IPosition(1,count),
+						 values.storage(),SHARE));
+      } else {
+	pout[offout]=0;
+      }
     }
   }
   in.freeStorage(pin,deleteIn);
@@ -516,8 +531,12 @@ Bool MSFlagger::clipDataBuffer(Float pixelLevel, Float timeLevel,
   while (iter) {
     iter=False;
 
-    for (Int ifr=0, offset=0; ifr<nIfr; ifr++, offset=ifr*nXY) {
-      for (Int pol=0; pol<nCorr; pol++, offset++) {
+    // The interferometers are independent, so they can be done in parallel.
+#ifdef _OPENMP
+#pragma omp parallel for reduction(||:iter) if(nIfr > 1)
+#endif
+    for (Int ifr=0; ifr<nIfr; ifr++) {
+      for (Int pol=0, offset=ifr*nXY; pol<nCorr; pol++, offset++) {
 	
 	// keep these values around
 	Float mfmt = medFmedT(pol,ifr);
@@ -91,7 +91,7 @@ MSMetaData::MSMetaData(const MeasurementSet *const &ms, const Float maxCacheSize
         File(ms->tableName()).exists() ? 0 : 1, ms
       ),
        _spwInfoStored(False), _forceSubScanPropsToCache(False),
-       _sourceTimes() {}
+       _sourceTimes(), _useIndex(False), _storeIndex(False), _index() {}
 
 MSMetaData::~MSMetaData() {}
 
@@ -2264,13 +2264,32 @@ std::shared_ptr<std::map<ScanKey, std::set<Double> > > MSMetaData::_getScanToTim
 template <class T> std::shared_ptr<Vector<T> > MSMetaData::_getMainScalarColumn(
     MSMainEnums::PredefinedColumns col
 ) const {
+    std::shared_ptr<Vector<T> > v(new Vector<T>());
+    std::shared_ptr<const MSMetaDataIndex> index = _getIndex();
+    if (index && index->getColumn(*v, col, 0, index->nrow())) {
+        return v;
+    }
     String name = MeasurementSet::columnName(col);
     ScalarColumn<T> mycol(*_ms, name);
-    std::shared_ptr<Vector<T> > v(new Vector<T>());
     mycol.getColumn(*v);
     return v;
 }
 
+void MSMetaData::setUseIndex(Bool useIndex, Bool storeIndex) {
+    if (useIndex != _useIndex || storeIndex != _storeIndex) {
+        _index.reset();
+    }
+    _useIndex = useIndex;
+    _storeIndex = storeIndex;
+}
+
+std::shared_ptr<const MSMetaDataIndex> MSMetaData::_getIndex() const {
+    if (_useIndex && ! _index) {
+        _index = MSMetaDataIndex::create(*_ms, _storeIndex);
+    }
+    return _index;
+}
+
 std::shared_ptr<Vector<Double> > MSMetaData::_getTimes() const {
     return _getMainScalarColumn<Double>(MSMainEnums::TIME);
 }
@@ -3589,14 +3608,30 @@ MSMetaData::SubScanProperties MSMetaData::getSubScanProperties(
 void MSMetaData::_getScalarIntColumn(
     Vector<Int>& v, TableProxy& tp, const String& colname,
     rownr_t beginRow, rownr_t nrows
-) {
+) const {
+    std::shared_ptr<const MSMetaDataIndex> index = _getIndex();
+    if (
+        index && index->getColumn(
+            v, MeasurementSet::columnType(colname), beginRow, nrows
+        )
+    ) {
+        return;
+    }
     v = tp.getColumn(colname, beginRow, nrows, 1).asArrayInt();
 }
 
 void MSMetaData::_getScalarDoubleColumn(
     Vector<Double>& v, TableProxy& tp, const String& colname,
     rownr_t beginRow, rownr_t nrows
-) {
+) const {
+    std::shared_ptr<const MSMetaDataIndex> index = _getIndex();
+    if (
+        index && index->getColumn(
+            v, MeasurementSet::columnType(colname), beginRow, nrows
+        )
+    ) {
+        return;
+    }
     v = tp.getColumn(colname, beginRow, nrows, 1).asArrayDouble();
 }
 
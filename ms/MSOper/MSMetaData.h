@@ -32,6 +32,7 @@
 #include <casacore/measures/Measures/MPosition.h>
 #include <casacore/ms/MeasurementSets/MeasurementSet.h>
 #include <casacore/ms/MeasurementSets/MSPointingColumns.h>
+#include <casacore/ms/MSOper/MSMetaDataIndex.h>
 #include <casacore/tables/Tables/TableProxy.h>
 #include <map>
 #include <memory>
@@ -54,6 +55,9 @@ struct SubScanKey;
 // needed temporarily to compute smaller data structures, and the column data
 // is not particularly expensive to recreate if necessary.
 // Parallel processing is enabled using openmp.
+// Optionally the id and time columns of the main table are taken from a
+// compact <linkto class=MSMetaDataIndex>MSMetaDataIndex</linkto>, which is
+// built once and can be stored in the MS for reuse.
 // </summary>
 
 class MSMetaData {
@@ -660,6 +664,14 @@ public:
 
     void setShowProgress(Bool b) { _showProgress = b; }
 
+    // Use an MSMetaDataIndex to get the TIME, SCAN_NUMBER, FIELD_ID,
+    // DATA_DESC_ID, STATE_ID, ARRAY_ID, OBSERVATION_ID, ANTENNA1 and ANTENNA2
+    // columns, instead of reading them from the MS for each query.
+    // The index is built on first use; if <src>storeIndex=True</src>, it is
+    // stored in (and reused from) the MS directory, if possible.
+    // The index is not part of the cache size.
+    void setUseIndex(Bool useIndex, Bool storeIndex=True);
+
     // get statistics related to the values of the INTERVAL column. Returned
     // values are in seconds. All values in this column are used in the computation,
     // including those which associated row flags may be set. 
@@ -833,6 +845,9 @@ private:
     mutable std::shared_ptr<std::set<Int> > _ephemFields;
     mutable std::shared_ptr<const Quantum<Vector<Double> > > _sourceTimes;
 
+    Bool _useIndex, _storeIndex;
+    mutable std::shared_ptr<const MSMetaDataIndex> _index;
+
     // disallow copy constructor and = operator
     MSMetaData(const MSMetaData&);
     MSMetaData operator =(const MSMetaData&);
@@ -869,15 +884,18 @@ private:
         Bool showProgress
     ) const;
 
-    static void _getScalarIntColumn(
+    // These use the index if possible.
+    // <group>
+    void _getScalarIntColumn(
         Vector<Int>& v, TableProxy& table, const String& colname,
         rownr_t beginRow, rownr_t nrows
-    );
+    ) const;
 
-    static void _getScalarDoubleColumn(
+    void _getScalarDoubleColumn(
         Vector<Double>& v, TableProxy& table, const String& colname,
         rownr_t beginRow, rownr_t nrows
-    );
+    ) const;
+    // </group>
 
     static void _getScalarQuantDoubleColumn(
         Quantum<Vector<Double> >& v, TableProxy& table, const String& colname,
@@ -1181,6 +1199,9 @@ private:
         MSMainEnums::PredefinedColumns col
     ) const;
 
+    // Get the index (building it if needed). Null if no index is used.
+    std::shared_ptr<const MSMetaDataIndex> _getIndex() const;
+
     std::shared_ptr<vector<int>> _almaReceiverBands(uint nspw) const;
 
 };
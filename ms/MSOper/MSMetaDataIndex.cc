@@ -0,0 +1,337 @@
+//# MSMetaDataIndex.cc: Compact in-memory index of MS main table id columns
+//# Copyright (C) 2026
+//# Associated Universities, Inc. Washington DC, USA.
+//#
+//# This library is free software; you can redistribute it and/or modify it
+//# under the terms of the GNU Library General Public License as published by
+//# the Free Software Foundation; either version 2 of the License, or (at your
+//# option) any later version.
+//#
+//# This library is distributed in the hope that it will be useful, but WITHOUT
+//# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+//# License for more details.
+//#
+//# You should have received a copy of the GNU Library General Public License
+//# along with this library; if not, write to the Free Software Foundation,
+//# Inc., 675 Massachusetts Ave, Cambridge, MA 02139, USA.
+//#
+//# Correspondence concerning AIPS++ should be addressed as follows:
+//#        Internet email: aips2-request@nrao.edu.
+//#        Postal address: AIPS++ Project Office
+//#                        National Radio Astronomy Observatory
+//#                        520 Edgemont Road
+//#                        Charlottesville, VA 22903-2475 USA
+
+#include <casacore/ms/MSOper/MSMetaDataIndex.h>
+#include <casacore/ms/MeasurementSets/MeasurementSet.h>
+#include <casacore/casa/Arrays/Slicer.h>
+#include <casacore/casa/IO/AipsIO.h>
+#include <casacore/casa/OS/Directory.h>
+#include <casacore/casa/OS/DirectoryIterator.h>
+#include <casacore/casa/OS/File.h>
+#include <casacore/casa/OS/RegularFile.h>
+#include <casacore/casa/Utilities/Assert.h>
+#include <casacore/tables/Tables/ScalarColumn.h>
+
+#include <algorithm>
+#include <ctime>
+#include <unistd.h>
+
+namespace casacore {
+
+// The indexed Int columns; the order defines the index in _intCols.
+static const MSMainEnums::PredefinedColumns theIntColumns[] = {
+    MSMainEnums::SCAN_NUMBER, MSMainEnums::FIELD_ID,
+    MSMainEnums::DATA_DESC_ID, MSMainEnums::STATE_ID,
+    MSMainEnums::ARRAY_ID, MSMainEnums::OBSERVATION_ID,
+    MSMainEnums::ANTENNA1, MSMainEnums::ANTENNA2
+};
+static const Int theNIntColumns = 8;
+
+template <class T> void MSMetaDataIndex::RunLengthColumn<T>::append(
+    const T* v, rownr_t startRow, rownr_t n
+) {
+    for (rownr_t i=0; i<n; ++i) {
+        if (values.empty() || v[i] != values.back()) {
+            values.push_back(v[i]);
+            starts.push_back(startRow + i);
+        }
+    }
+}
+
+template <class T> void MSMetaDataIndex::RunLengthColumn<T>::get(
+    T* v, rownr_t startRow, rownr_t n, rownr_t nrow
+) const {
+    if (n == 0) {
+        return;
+    }
+    // Find the run containing the first row.
+    size_t run = std::upper_bound(
+        starts.begin(), starts.end(), startRow
+    ) - starts.begin() - 1;
+    rownr_t row = startRow;
+    const rownr_t endRow = startRow + n;
+    while (row < endRow) {
+        rownr_t runEnd = run + 1 < starts.size() ? starts[run + 1] : nrow;
+        rownr_t end = std::min(runEnd, endRow);
+        std::fill(v, v + (end - row), values[run]);
+        v += end - row;
+        row = end;
+        ++run;
+    }
+}
+
+template <class T> size_t MSMetaDataIndex::RunLengthColumn<T>::nbytes() const {
+    return values.size() * sizeof(T) + starts.size() * sizeof(rownr_t);
+}
+
+MSMetaDataIndex::MSMetaDataIndex()
+    : _nrow(0), _stampSize(0), _stampTime(0), _intCols(theNIntColumns) {}
+
+MSMetaDataIndex::MSMetaDataIndex(const MeasurementSet& ms)
+    : _nrow(ms.nrow()), _stampSize(0), _stampTime(0),
+      _intCols(theNIntColumns) {
+    // Take the stamp first, so a change while reading invalidates it.
+    if (! indexFileName(ms).empty()) {
+        _stamp(_stampSize, _stampTime, ms.tableName());
+    }
+    std::vector<ScalarColumn<Int> > intCols;
+    for (Int i=0; i<theNIntColumns; ++i) {
+        intCols.push_back(
+            ScalarColumn<Int>(ms, MeasurementSet::columnName(theIntColumns[i]))
+        );
+    }
+    ScalarColumn<Double> timeCol(
+        ms, MeasurementSet::columnName(MSMainEnums::TIME)
+    );
+    // The columns are read in blocks of rows, after which the columns
+    // of the block are encoded in parallel.
+    static const rownr_t rowsInBlock = 1000000;
+    std::vector<Vector<Int> > intValues(theNIntColumns);
+    Vector<Double> times;
+    for (rownr_t row=0; row<_nrow; row+=rowsInBlock) {
+        rownr_t nrows = std::min(rowsInBlock, _nrow - row);
+        Slicer rows(IPosition(1, row), IPosition(1, nrows));
+        for (Int i=0; i<theNIntColumns; ++i) {
+            intCols[i].getColumnRange(rows, intValues[i], True);
+        }
+        timeCol.getColumnRange(rows, times, True);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (Int i=0; i<=theNIntColumns; ++i) {
+            if (i < theNIntColumns) {
+                _intCols[i].append(intValues[i].data(), row, nrows);
+            }
+            else {
+                _timeCol.append(times.data(), row, nrows);
+            }
+        }
+    }
+}
+
+std::shared_ptr<const MSMetaDataIndex> MSMetaDataIndex::create(
+    const MeasurementSet& ms, Bool store
+) {
+    std::shared_ptr<const MSMetaDataIndex> index = stored(ms);
+    if (index) {
+        return index;
+    }
+    std::shared_ptr<MSMetaDataIndex> newIndex(new MSMetaDataIndex(ms));
+    String fileName = ms.isWritable() ? String() : indexFileName(ms);
+    if (store && ! fileName.empty()) {
+        // Do not store it if the MS has been changed in the meantime, nor if
+        // it has been changed within the last seconds; the resolution of the
+        // modification time could make a later change undetectable.
+        Int64 size;
+        uInt mtime;
+        _stamp(size, mtime, ms.tableName());
+        if (
+            size == newIndex->_stampSize && mtime == newIndex->_stampTime
+            && Int64(mtime) + 2 <= Int64(std::time(0))
+        ) {
+            newIndex->write(fileName);
+        }
+    }
+    return newIndex;
+}
+
+std::shared_ptr<const MSMetaDataIndex> MSMetaDataIndex::stored(
+    const MeasurementSet& ms
+) {
+    // A writable MS might have changes not flushed yet, so a stored index
+    // is only used for a readonly MS.
+    String fileName = ms.isWritable() ? String() : indexFileName(ms);
+    if (! fileName.empty()) {
+        Int64 size;
+        uInt mtime;
+        _stamp(size, mtime, ms.tableName());
+        std::shared_ptr<MSMetaDataIndex> index = _read(fileName, size, mtime);
+        if (index && index->_nrow == ms.nrow()) {
+            return index;
+        }
+    }
+    return std::shared_ptr<const MSMetaDataIndex>();
+}
+
+String MSMetaDataIndex::indexFileName(const MeasurementSet& ms) {
+    if (
+        ms.isNull() || ms.tableType() != Table::Plain || ! ms.isRootTable()
+        || ! File(ms.tableName() + "/table.dat").exists()
+    ) {
+        return String();
+    }
+    return ms.tableName() + "/msmetadata.index";
+}
+
+Int MSMetaDataIndex::_intIndex(MSMainEnums::PredefinedColumns col) {
+    for (Int i=0; i<theNIntColumns; ++i) {
+        if (theIntColumns[i] == col) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+Bool MSMetaDataIndex::isIndexed(MSMainEnums::PredefinedColumns col) {
+    return col == MSMainEnums::TIME || _intIndex(col) >= 0;
+}
+
+Bool MSMetaDataIndex::getColumn(
+    Vector<Int>& v, MSMainEnums::PredefinedColumns col,
+    rownr_t startRow, rownr_t nrow
+) const {
+    Int inx = _intIndex(col);
+    if (inx < 0) {
+        return False;
+    }
+    ThrowIf(startRow + nrow > _nrow, "Row range exceeds the number of rows");
+    v.resize(nrow);
+    Bool deleteIt;
+    Int* data = v.getStorage(deleteIt);
+    _intCols[inx].get(data, startRow, nrow, _nrow);
+    v.putStorage(data, deleteIt);
+    return True;
+}
+
+Bool MSMetaDataIndex::getColumn(
+    Vector<Double>& v, MSMainEnums::PredefinedColumns col,
+    rownr_t startRow, rownr_t nrow
+) const {
+    if (col != MSMainEnums::TIME) {
+        return False;
+    }
+    ThrowIf(startRow + nrow > _nrow, "Row range exceeds the number of rows");
+    v.resize(nrow);
+    Bool deleteIt;
+    Double* data = v.getStorage(deleteIt);
+    _timeCol.get(data, startRow, nrow, _nrow);
+    v.putStorage(data, deleteIt);
+    return True;
+}
+
+size_t MSMetaDataIndex::nRuns(MSMainEnums::PredefinedColumns col) const {
+    if (col == MSMainEnums::TIME) {
+        return _timeCol.values.size();
+    }
+    Int inx = _intIndex(col);
+    ThrowIf(inx < 0, "Column is not indexed");
+    return _intCols[inx].values.size();
+}
+
+size_t MSMetaDataIndex::nbytes() const {
+    size_t n = _timeCol.nbytes();
+    for (const auto& col : _intCols) {
+        n += col.nbytes();
+    }
+    return n;
+}
+
+void MSMetaDataIndex::write(const String& fileName) const {
+    // Write a temporary file first, so other processes do not see a partly
+    // written index. Failures (e.g. a readonly directory) are ignored.
+    const String tmpName = fileName + "_tmp" + String::toString(getpid());
+    try {
+        {
+            AipsIO ios(tmpName, ByteIO::New);
+            ios.putstart("MSMetaDataIndex", 1);
+            ios << _nrow << _stampSize << _stampTime << uInt(_intCols.size());
+            for (const auto& col : _intCols) {
+                ios << uInt(col.values.size());
+                ios.put(col.values.size(), col.values.data(), False);
+                ios.put(col.starts.size(), col.starts.data(), False);
+            }
+            ios << uInt(_timeCol.values.size());
+            ios.put(_timeCol.values.size(), _timeCol.values.data(), False);
+            ios.put(_timeCol.starts.size(), _timeCol.starts.data(), False);
+            ios.putend();
+        }
+        RegularFile(tmpName).move(fileName);
+    }
+    catch (const std::exception&) {
+        if (File(tmpName).exists()) {
+            try {
+                RegularFile(tmpName).remove();
+            }
+            catch (const std::exception&) {}
+        }
+    }
+}
+
+std::shared_ptr<MSMetaDataIndex> MSMetaDataIndex::_read(
+    const String& fileName, Int64 stampSize, uInt stampTime
+) {
+    if (! File(fileName).exists()) {
+        return std::shared_ptr<MSMetaDataIndex>();
+    }
+    try {
+        std::shared_ptr<MSMetaDataIndex> index(new MSMetaDataIndex());
+        AipsIO ios(fileName);
+        ios.getstart("MSMetaDataIndex");
+        uInt ncol;
+        ios >> index->_nrow >> index->_stampSize >> index->_stampTime >> ncol;
+        if (
+            index->_stampSize != stampSize || index->_stampTime != stampTime
+            || Int(ncol) != theNIntColumns
+        ) {
+            return std::shared_ptr<MSMetaDataIndex>();
+        }
+        uInt nruns;
+        for (auto& col : index->_intCols) {
+            ios >> nruns;
+            col.values.resize(nruns);
+            col.starts.resize(nruns);
+            ios.get(nruns, col.values.data());
+            ios.get(nruns, col.starts.data());
+        }
+        ios >> nruns;
+        index->_timeCol.values.resize(nruns);
+        index->_timeCol.starts.resize(nruns);
+        ios.get(nruns, index->_timeCol.values.data());
+        ios.get(nruns, index->_timeCol.starts.data());
+        ios.getend();
+        return index;
+    }
+    catch (const std::exception&) {
+        return std::shared_ptr<MSMetaDataIndex>();
+    }
+}
+
+void MSMetaDataIndex::_stamp(Int64& size, uInt& mtime, const String& msName) {
+    size = 0;
+    mtime = 0;
+    for (DirectoryIterator iter((Directory(msName))); ! iter.pastEnd(); iter++) {
+        File file(iter.file());
+        const String name = iter.name();
+        if (
+            file.isRegular(False) && name != "table.lock"
+            && ! name.startsWith("msmetadata.index")
+        ) {
+            size += RegularFile(file).size();
+            mtime = std::max(mtime, file.modifyTime());
+        }
+    }
+}
+
+}
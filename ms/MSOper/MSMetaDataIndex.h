@@ -0,0 +1,152 @@
+//# MSMetaDataIndex.h: Compact in-memory index of MS main table id columns
+//# Copyright (C) 2026
+//# Associated Universities, Inc. Washington DC, USA.
+//#
+//# This library is free software; you can redistribute it and/or modify it
+//# under the terms of the GNU Library General Public License as published by
+//# the Free Software Foundation; either version 2 of the License, or (at your
+//# option) any later version.
+//#
+//# This library is distributed in the hope that it will be useful, but WITHOUT
+//# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+//# License for more details.
+//#
+//# You should have received a copy of the GNU Library General Public License
+//# along with this library; if not, write to the Free Software Foundation,
+//# Inc., 675 Massachusetts Ave, Cambridge, MA 02139, USA.
+//#
+//# Correspondence concerning AIPS++ should be addressed as follows:
+//#        Internet email: aips2-request@nrao.edu.
+//#        Postal address: AIPS++ Project Office
+//#                        National Radio Astronomy Observatory
+//#                        520 Edgemont Road
+//#                        Charlottesville, VA 22903-2475 USA
+
+#ifndef MS_MSMETADATAINDEX_H
+#define MS_MSMETADATAINDEX_H
+
+#include <casacore/casa/aips.h>
+#include <casacore/casa/Arrays/Vector.h>
+#include <casacore/casa/BasicSL/String.h>
+#include <casacore/ms/MeasurementSets/MSMainEnums.h>
+
+#include <memory>
+#include <vector>
+
+namespace casacore {
+
+class AipsIO;
+class MeasurementSet;
+
+// <summary>
+// Compact in-memory index of the id and time columns of an MS main table
+// </summary>
+// <synopsis>
+// MSMetaData derives most of its information from the columns TIME,
+// SCAN_NUMBER, FIELD_ID, DATA_DESC_ID, STATE_ID, ARRAY_ID, OBSERVATION_ID,
+// ANTENNA1 and ANTENNA2 of the main table. This class holds these columns
+// run-length encoded; in a typical MS all but the antenna columns have long
+// runs of equal values, so the index is much smaller than the columns.
+// <p>
+// The index is built in a single pass over the main table, reading the
+// columns in blocks of rows. The columns of a block are encoded in parallel.
+// <br>It can be stored in the MS directory (as file
+// <src>msmetadata.index</src>), so it can be reused by later processes.
+// A stored index is only used if the size and modification time of the
+// files of the main table have not changed since the index was made.
+// </synopsis>
+
+class MSMetaDataIndex {
+public:
+
+    // Build the index by reading the main table of the MS.
+    explicit MSMetaDataIndex(const MeasurementSet& ms);
+
+    // Get the index for the MS. It is read from the MS directory if stored
+    // there and still valid. Otherwise it is built and, if
+    // <src>store=True</src>, written into the MS directory (if possible).
+    static std::shared_ptr<const MSMetaDataIndex> create(
+        const MeasurementSet& ms, Bool store
+    );
+
+    // Get the index stored in the MS directory. A null pointer is returned
+    // if there is no valid stored index or if the MS is writable.
+    static std::shared_ptr<const MSMetaDataIndex> stored(
+        const MeasurementSet& ms
+    );
+
+    // The name of the file holding the index of the MS.
+    // It is empty if the MS is not a persistent table (e.g. a selection).
+    static String indexFileName(const MeasurementSet& ms);
+
+    // Is the given column indexed?
+    static Bool isIndexed(MSMainEnums::PredefinedColumns col);
+
+    // Number of rows in the index.
+    rownr_t nrow() const { return _nrow; }
+
+    // Get the values of an indexed column for <src>nrow</src> rows
+    // starting at <src>startRow</src>. The vector is resized as needed.
+    // False is returned if the column is not indexed.
+    // <group>
+    Bool getColumn(
+        Vector<Int>& v, MSMainEnums::PredefinedColumns col,
+        rownr_t startRow, rownr_t nrow
+    ) const;
+    Bool getColumn(
+        Vector<Double>& v, MSMainEnums::PredefinedColumns col,
+        rownr_t startRow, rownr_t nrow
+    ) const;
+    // </group>
+
+    // Get the number of runs of equal values in an indexed column.
+    size_t nRuns(MSMainEnums::PredefinedColumns col) const;
+
+    // Get the size of the index in bytes.
+    size_t nbytes() const;
+
+    // Write the index into the given file.
+    void write(const String& fileName) const;
+
+private:
+    // Run-length encoded column; run i has value values[i] for rows
+    // starts[i] till starts[i+1] (or nrow for the last run).
+    template <class T> struct RunLengthColumn {
+        std::vector<T> values;
+        std::vector<rownr_t> starts;
+
+        // Add the values of the rows starting at <src>startRow</src>.
+        void append(const T* v, rownr_t startRow, rownr_t n);
+
+        // Decode the values of the rows starting at <src>startRow</src>.
+        void get(T* v, rownr_t startRow, rownr_t n, rownr_t nrow) const;
+
+        size_t nbytes() const;
+    };
+
+    MSMetaDataIndex();
+
+    // Read the index from the file. A null pointer is returned if it cannot
+    // be read or if it does not match the given stamp.
+    static std::shared_ptr<MSMetaDataIndex> _read(
+        const String& fileName, Int64 stampSize, uInt stampTime
+    );
+
+    // Get the total size and latest modification time of the files of
+    // the main table (the subtables are not taken into account).
+    static void _stamp(Int64& size, uInt& mtime, const String& msName);
+
+    // Get the index in _intCols of an indexed Int column (-1 if not).
+    static Int _intIndex(MSMainEnums::PredefinedColumns col);
+
+    rownr_t _nrow;
+    Int64 _stampSize;
+    uInt _stampTime;
+    std::vector<RunLengthColumn<Int> > _intCols;
+    RunLengthColumn<Double> _timeCol;
+};
+
+}
+
+#endif
@@ -0,0 +1,150 @@
+//# MSUVWCalculator.cc: Recalculate the UVW coordinates of a MeasurementSet
+//# Copyright (C) 2026
+//# Associated Universities, Inc. Washington DC, USA.
+//#
+//# This library is free software; you can redistribute it and/or modify it
+//# under the terms of the GNU Library General Public License as published by
+//# the Free Software Foundation; either version 2 of the License, or (at your
+//# option) any later version.
+//#
+//# This library is distributed in the hope that it will be useful, but WITHOUT
+//# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+//# License for more details.
+//#
+//# You should have received a copy of the GNU Library General Public License
+//# along with this library; if not, write to the Free Software Foundation,
+//# Inc., 675 Massachusetts Ave, Cambridge, MA 02139, USA.
+//#
+//# Correspondence concerning AIPS++ should be addressed as follows:
+//#        Internet email: aips2-request@nrao.edu.
+//#        Postal address: AIPS++ Project Office
+//#                        National Radio Astronomy Observatory
+//#                        520 Edgemont Road
+//#                        Charlottesville, VA 22903-2475 USA
+
+#include <casacore/ms/MSOper/MSUVWCalculator.h>
+#include <casacore/ms/MeasurementSets/MSMainColumns.h>
+#include <casacore/ms/MeasurementSets/MSAntennaColumns.h>
+#include <casacore/ms/MeasurementSets/MSFieldColumns.h>
+#include <casacore/measures/Measures/AntennaUVWMachine.h>
+#include <casacore/measures/Measures/MeasTable.h>
+#include <casacore/tables/Tables/ScalarColumn.h>
+#include <casacore/casa/Arrays/Slicer.h>
+#include <casacore/casa/Exceptions/Error.h>
+#include <map>
+#include <vector>
+
+namespace casacore { //# NAMESPACE CASACORE - BEGIN
+
+// Get the direction of a field at the given time from the given column.
+static MDirection fieldDir (const MSFieldColumns& fieldCols, Int dirType,
+                            rownr_t field, Double time)
+{
+  switch (dirType) {
+  case MSField::DELAY_DIR:
+    return fieldCols.delayDirMeas (field, time);
+  case MSField::REFERENCE_DIR:
+    return fieldCols.referenceDirMeas (field, time);
+  default:
+    return fieldCols.phaseDirMeas (field, time);
+  }
+}
+
+void MSUVWCalculator::recalculate (MeasurementSet& ms,
+                                   const String& dirColName,
+                                   rownr_t chunkSize)
+{
+  Int dirType;
+  if (dirColName == "PHASE_DIR") {
+    dirType = MSField::PHASE_DIR;
+  } else if (dirColName == "DELAY_DIR") {
+    dirType = MSField::DELAY_DIR;
+  } else if (dirColName == "REFERENCE_DIR") {
+    dirType = MSField::REFERENCE_DIR;
+  } else {
+    throw AipsError ("MSUVWCalculator: invalid FIELD direction column " +
+                     dirColName);
+  }
+  AlwaysAssert (chunkSize > 0, AipsError);
+  // Get the antenna positions.
+  MSAntennaColumns antCols(ms.antenna());
+  Vector<MPosition> antPos(ms.antenna().nrow());
+  for (rownr_t i=0; i<antPos.size(); ++i) {
+    antPos[i] = antCols.positionMeas()(i);
+  }
+  if (antPos.empty()) {
+    throw AipsError ("MSUVWCalculator: MS " + ms.tableName() +
+                     " has no antennae");
+  }
+  // Find the observatory position; use the middle antenna if unknown.
+  MPosition arrayPos;
+  Bool fndObs = False;
+  if (ms.observation().nrow() > 0) {
+    String telescope = ScalarColumn<String>(ms.observation(),
+                                            "TELESCOPE_NAME")(0);
+    fndObs = MeasTable::Observatory (arrayPos, telescope);
+  }
+  if (!fndObs) {
+    arrayPos = antPos[antPos.size() / 2];
+  }
+  // The fixed phase centers have the field id as index. The centers of
+  // fields with a polynomial or ephemeris are determined per time and
+  // appended per chunk.
+  MSFieldColumns fieldCols(ms.field());
+  const rownr_t nfield = ms.field().nrow();
+  std::vector<MDirection> fixedCenters(nfield);
+  std::vector<Bool> timeDep(nfield);
+  Bool anyTimeDep = False;
+  for (rownr_t i=0; i<nfield; ++i) {
+    timeDep[i] = fieldCols.needInterTime (i);
+    anyTimeDep = anyTimeDep || timeDep[i];
+    if (! timeDep[i]) {
+      fixedCenters[i] = fieldDir (fieldCols, dirType, i, 0.);
+    }
+  }
+  AntennaUVWMachine machine(antPos, arrayPos);
+  if (! anyTimeDep) {
+    machine.setPhaseCenters (Vector<MDirection>(fixedCenters));
+  }
+  MSMainColumns cols(ms);
+  MEpoch::Types timeRef = MEpoch::castType
+    (cols.timeMeas().getMeasRef().getType());
+  Vector<Double> times;
+  Vector<Int> ant1, ant2, fields;
+  Matrix<Double> uvw;
+  for (rownr_t row=0; row<ms.nrow(); row+=chunkSize) {
+    rownr_t nrow = std::min(chunkSize, ms.nrow() - row);
+    Slicer rows(IPosition(1, row), IPosition(1, nrow));
+    cols.time().getColumnRange (rows, times, True);
+    cols.antenna1().getColumnRange (rows, ant1, True);
+    cols.antenna2().getColumnRange (rows, ant2, True);
+    cols.fieldId().getColumnRange (rows, fields, True);
+    if (anyTimeDep) {
+      std::vector<MDirection> centers(fixedCenters);
+      std::map<std::pair<Int,Double>, Int> slotCenter;
+      for (rownr_t i=0; i<nrow; ++i) {
+        const Int field = fields[i];
+        if (field >= 0  &&  rownr_t(field) < nfield  &&  timeDep[field]) {
+          std::pair<Int,Double> key(field, times[i]);
+          std::map<std::pair<Int,Double>, Int>::const_iterator iter =
+            slotCenter.find (key);
+          if (iter == slotCenter.end()) {
+            slotCenter[key] = centers.size();
+            fields[i] = centers.size();
+            centers.push_back (fieldDir (fieldCols, dirType, field,
+                                         times[i]));
+          } else {
+            fields[i] = iter->second;
+          }
+        }
+      }
+      machine.setPhaseCenters (Vector<MDirection>(centers));
+    }
+    machine.baselineUVW (uvw, times, timeRef, ant1, ant2, fields);
+    cols.uvw().putColumnRange (rows, uvw);
+  }
+}
+
+
+} //# NAMESPACE CASACORE - END
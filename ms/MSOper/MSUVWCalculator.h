@@ -0,0 +1,90 @@
+//# MSUVWCalculator.h: Recalculate the UVW coordinates of a MeasurementSet
+//# Copyright (C) 2026
+//# Associated Universities, Inc. Washington DC, USA.
+//#
+//# This library is free software; you can redistribute it and/or modify it
+//# under the terms of the GNU Library General Public License as published by
+//# the Free Software Foundation; either version 2 of the License, or (at your
+//# option) any later version.
+//#
+//# This library is distributed in the hope that it will be useful, but WITHOUT
+//# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+//# License for more details.
+//#
+//# You should have received a copy of the GNU Library General Public License
+//# along with this library; if not, write to the Free Software Foundation,
+//# Inc., 675 Massachusetts Ave, Cambridge, MA 02139, USA.
+//#
+//# Correspondence concerning AIPS++ should be addressed as follows:
+//#        Internet email: aips2-request@nrao.edu.
+//#        Postal address: AIPS++ Project Office
+//#                        National Radio Astronomy Observatory
+//#                        520 Edgemont Road
+//#                        Charlottesville, VA 22903-2475 USA
+
+#ifndef MS_MSUVWCALCULATOR_H
+#define MS_MSUVWCALCULATOR_H
+
+#include <casacore/casa/aips.h>
+#include <casacore/casa/BasicSL/String.h>
+#include <casacore/ms/MeasurementSets/MeasurementSet.h>
+
+namespace casacore { //# NAMESPACE CASACORE - BEGIN
+
+// <summary>
+// Recalculate the UVW coordinates of a MeasurementSet
+// </summary>
+
+// <use visibility=export>
+
+// <reviewed reviewer="" date="" tests="tMSUVWCalculator.cc" demos="">
+// </reviewed>
+
+// <prerequisite>
+//   <li> <linkto class=MeasurementSet>MeasurementSet</linkto>
+//   <li> <linkto class=AntennaUVWMachine>AntennaUVWMachine</linkto>
+// </prerequisite>
+//
+// <synopsis>
+// MSUVWCalculator rewrites the UVW column of a MeasurementSet from the
+// antenna positions and the phase centers in the FIELD table. The rows
+// are processed in chunks; the UVW of all baselines of a time slot are
+// calculated from a single conversion matrix (see
+// <linkto class=AntennaUVWMachine>AntennaUVWMachine</linkto>).
+// <p>
+// The phase center of a row is the direction of its field at the time of
+// the row (see <src>MSFieldColumns::phaseDirMeas</src>), so fields with
+// direction polynomials (NUM_POLY>0) or ephemerides are handled as well.
+// </synopsis>
+
+// <example>
+// <srcblock>
+//   MeasurementSet ms("my.ms", Table::Update);
+//   MSUVWCalculator::recalculate (ms);
+// </srcblock>
+// </example>
+
+// <motivation>
+// To speed up the (re)calculation of UVW coordinates of entire observations.
+// </motivation>
+
+class MSUVWCalculator
+{
+public:
+  // Recalculate the UVW coordinates of all rows. The phase centers are
+  // taken from the given direction column in the FIELD table, which must
+  // be PHASE_DIR, DELAY_DIR or REFERENCE_DIR.
+  // <thrown>
+  //  <li> AipsError if the direction column is invalid or if the MS
+  //       has no antennae.
+  // </thrown>
+  static void recalculate (MeasurementSet& ms,
+                           const String& dirColName = "PHASE_DIR",
+                           rownr_t chunkSize = 1000000);
+};
+
+
+} //# NAMESPACE CASACORE - END
+
+#endif
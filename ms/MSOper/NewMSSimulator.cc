@@ -68,6 +68,7 @@
 #include <casacore/measures/Measures/MeasConvert.h>
 #include <casacore/measures/Measures/MeasData.h>
 #include <casacore/measures/Measures/MFrequency.h>
+#include <casacore/measures/Measures/AntennaUVWMachine.h>
 #include <casacore/measures/Measures.h>
 #include <casacore/casa/Utilities/Assert.h>
 #include <casacore/casa/Arrays/ArrayUtil.h>
@@ -82,6 +83,15 @@
 // temporary to get access to beam_offsets
 #include <casacore/ms/MeasurementSets/MSIter.h>
 //
+#include <deque>
+#include <exception>
+#include <memory>
+
+#ifdef USE_THREADS
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
 
 namespace casacore { //# NAMESPACE CASACORE - BEGIN
 
@@ -123,6 +133,204 @@ struct MSFeedParameterExtractor : protected MSIter {
 //
 
 
+// The rows of a timestep (of one feed) filled by observe in bulk mode.
+// The scalar columns that are constant in a timestep are only put in the
+// first row, like observe does when writing row by row (they are stored
+// with the IncrementalStMan).
+struct NewMSSimulatorTimestep {
+  rownr_t firstRow;
+  Int scan, fieldId, dataDescId, arrayId, observationId, stateId, feed;
+  Double time, interval;
+  Vector<Int> ant1, ant2;
+  Matrix<Double> uvw;
+  Cube<Complex> data;
+  Cube<Bool> flag;
+  Vector<Bool> flagRow;
+  Matrix<Float> weight, sigma;
+  // The POINTING rows of the timestep (one per antenna).
+  Double pointingTime, pointingTimeOrigin;
+  MDirection direction;
+};
+
+// Writes the timesteps filled in bulk mode into the MS.
+// If threads are used, the timesteps are written by a separate thread,
+// so calculating the next timestep overlaps with writing.
+class NewMSSimulatorWriter {
+public:
+  NewMSSimulatorWriter (MeasurementSet& ms, MSColumns& msc, Bool useThread)
+    : itsMS  (ms),
+      itsMSC (msc)
+#ifdef USE_THREADS
+      , itsDone (False)
+#endif
+  {
+#ifdef USE_THREADS
+    if (useThread) {
+      itsThread = std::thread (&NewMSSimulatorWriter::run, this);
+    }
+#else
+    (void)useThread;
+#endif
+  }
+
+  ~NewMSSimulatorWriter()
+  {
+    // Errors are only reported by finish.
+    try {
+      finish();
+    } catch (...) {
+    }
+  }
+
+  // Write a timestep (or queue it for writing).
+  void write (const std::shared_ptr<NewMSSimulatorTimestep>& step)
+  {
+#ifdef USE_THREADS
+    if (itsThread.joinable()) {
+      std::unique_lock<std::mutex> lock(itsMutex);
+      itsCond.wait (lock, [this] { return itsQueue.size() < 2; });
+      if (itsExcp) {
+        std::rethrow_exception (itsExcp);
+      }
+      itsQueue.push_back (step);
+      itsCond.notify_all();
+      return;
+    }
+#endif
+    writeStep (*step);
+  }
+
+  // Wait until all queued timesteps are written, so the caller can
+  // access other tables of the MS.
+  void wait()
+  {
+#ifdef USE_THREADS
+    std::unique_lock<std::mutex> lock(itsMutex);
+    itsCond.wait (lock, [this] { return itsQueue.empty(); });
+    if (itsExcp) {
+      std::rethrow_exception (itsExcp);
+    }
+#endif
+  }
+
+  // Write all queued timesteps and stop the thread.
+  // An exception thrown while writing is rethrown.
+  void finish()
+  {
+#ifdef USE_THREADS
+    if (itsThread.joinable()) {
+      {
+        std::lock_guard<std::mutex> lock(itsMutex);
+        itsDone = True;
+      }
+      itsCond.notify_all();
+      itsThread.join();
+    }
+    if (itsExcp) {
+      std::exception_ptr excp = itsExcp;
+      itsExcp = std::exception_ptr();
+      std::rethrow_exception (excp);
+    }
+#endif
+  }
+
+private:
+#ifdef USE_THREADS
+  void run()
+  {
+    std::unique_lock<std::mutex> lock(itsMutex);
+    while (True) {
+      itsCond.wait (lock, [this] { return !itsQueue.empty() || itsDone; });
+      if (itsQueue.empty()) {
+        break;
+      }
+      std::shared_ptr<NewMSSimulatorTimestep> step = itsQueue.front();
+      // After a failure the remaining timesteps are discarded.
+      if (!itsExcp) {
+        lock.unlock();
+        std::exception_ptr excp;
+        try {
+          writeStep (*step);
+        } catch (...) {
+          excp = std::current_exception();
+        }
+        lock.lock();
+        if (excp) {
+          itsExcp = excp;
+        }
+      }
+      // Only remove it now, so an empty queue means all has been written.
+      itsQueue.pop_front();
+      itsCond.notify_all();
+    }
+  }
+#endif
+
+  void writeStep (const NewMSSimulatorTimestep& step)
+  {
+    const rownr_t nrow = step.ant1.size();
+    const rownr_t row = step.firstRow;
+    const Slicer rows(IPosition(1, row), IPosition(1, nrow));
+    itsMSC.scanNumber().put(row, step.scan);
+    itsMSC.fieldId().put(row, step.fieldId);
+    itsMSC.dataDescId().put(row, step.dataDescId);
+    itsMSC.time().put(row, step.time);
+    itsMSC.timeCentroid().put(row, step.time);
+    itsMSC.arrayId().put(row, step.arrayId);
+    itsMSC.processorId().put(row, 0);
+    itsMSC.exposure().put(row, step.interval);
+    itsMSC.interval().put(row, step.interval);
+    itsMSC.observationId().put(row, step.observationId);
+    itsMSC.stateId().put(row, step.stateId);
+    itsMSC.antenna1().putColumnRange(rows, step.ant1);
+    itsMSC.antenna2().putColumnRange(rows, step.ant2);
+    Vector<Int> feeds(nrow, step.feed);
+    itsMSC.feed1().putColumnRange(rows, feeds);
+    itsMSC.feed2().putColumnRange(rows, feeds);
+    itsMSC.uvw().putColumnRange(rows, step.uvw);
+    itsMSC.data().putColumnRange(rows, step.data);
+    itsMSC.flag().putColumnRange(rows, step.flag);
+    itsMSC.flagRow().putColumnRange(rows, step.flagRow);
+    itsMSC.correctedData().putColumnRange(rows, step.data);
+    itsMSC.modelData().putColumnRange(rows, step.data);
+    itsMSC.weight().putColumnRange(rows, step.weight);
+    itsMSC.sigma().putColumnRange(rows, step.sigma);
+    // Add the POINTING rows.
+    MSPointingColumns& pointingc = itsMSC.pointing();
+    const rownr_t nAnt = itsMSC.antenna().nrow();
+    const rownr_t firstPnt = pointingc.nrow();
+    itsMS.pointing().addRow(nAnt);
+    const Slicer pntRows(IPosition(1, firstPnt), IPosition(1, nAnt));
+    pointingc.numPoly().putColumnRange(pntRows, Vector<Int>(nAnt, 0));
+    pointingc.tracking().putColumnRange(pntRows, Vector<Bool>(nAnt, True));
+    pointingc.time().putColumnRange(pntRows,
+                                    Vector<Double>(nAnt, step.pointingTime));
+    pointingc.timeOrigin().putColumnRange
+      (pntRows, Vector<Double>(nAnt, step.pointingTimeOrigin));
+    pointingc.interval().putColumnRange(pntRows,
+                                        Vector<Double>(nAnt, step.interval));
+    Vector<Int> antIds(nAnt);
+    indgen(antIds);
+    pointingc.antennaId().putColumnRange(pntRows, antIds);
+    Vector<MDirection> direction(1, step.direction);
+    for (rownr_t i=0; i<nAnt; ++i) {
+      pointingc.directionMeasCol().put(firstPnt+i, direction);
+      pointingc.targetMeasCol().put(firstPnt+i, direction);
+    }
+  }
+
+  MeasurementSet& itsMS;
+  MSColumns&      itsMSC;
+#ifdef USE_THREADS
+  Bool                                                itsDone;
+  std::deque<std::shared_ptr<NewMSSimulatorTimestep>> itsQueue;
+  std::exception_ptr                                  itsExcp;
+  std::mutex                                          itsMutex;
+  std::condition_variable                             itsCond;
+  std::thread                                         itsThread;
+#endif
+};
+
 
 void NewMSSimulator::defaults() {
   fractionBlockageLimit_p=1e-6;
@@ -131,6 +339,8 @@ void NewMSSimulator::defaults() {
   telescope_p="Unknown";
   qIntegrationTime_p=Quantity(10.0, "s");
   useHourAngle_p=True;
+  bulkWrite_p=False;
+  writerThread_p=True;
   Quantity today;
   MVTime::read(today, "today");
   mRefTime_p=MEpoch(today, MEpoch::UTC);
@@ -1452,6 +1662,28 @@ void NewMSSimulator::observe(const Vector<String>& sourceNames,
   os << "Calculating a total of " << nIntegrations << " integrations" << endl 
      << LogIO::POST;
 
+  // In bulk mode the UVWs of all antennas in a timestep are calculated
+  // from a single conversion matrix and all rows of a timestep are
+  // written at once (possibly by a separate thread).
+  std::unique_ptr<AntennaUVWMachine> uvwMachine;
+  std::unique_ptr<NewMSSimulatorWriter> writer;
+  Cube<Complex> zeroData;
+  if (bulkWrite_p) {
+    Vector<MPosition> antPos(nAnt);
+    for (Int ant=0; ant<nAnt; ant++) {
+      antPos(ant)=antc.positionMeas()(ant);
+    }
+    // Use the observatory position as in calcAntUVW.
+    MPosition obsPos;
+    if(!MeasTable::Observatory(obsPos, telescope_p)) {
+      obsPos=antPos(0);
+    }
+    uvwMachine.reset(new AntennaUVWMachine(antPos, obsPos));
+    zeroData.resize(nCorr, nChan, nBaselines);
+    zeroData.set(Complex(0.0));
+    writer.reset(new NewMSSimulatorWriter(*ms_p, msc, writerThread_p));
+  }
+
   for(Int feed=0; feed<nFeed; feed++) {
     //if (nFeed) 
       //       os << "Processing feed "<<feed<< LogIO::DEBUG1;
@@ -1489,6 +1721,8 @@ void NewMSSimulator::observe(const Vector<String>& sourceNames,
       } else {
 	if (not(sourceNames(pointing)==sourceNames(pointing-1))) {
 	  scan++;
+	  // The FIELD table cannot be read while the writer is busy.
+	  if (writer) writer->wait();
 
 	  // Check for existing field with correct name
 	  existingFieldID=-1;
@@ -1562,17 +1796,19 @@ void NewMSSimulator::observe(const Vector<String>& sourceNames,
       MDirection feed_phc=fcs(0);
     
       // Do the first row outside the loop
-      msc.scanNumber().put(row+1,scan);
-      msc.fieldId().put(row+1,existingFieldID);
-      msc.dataDescId().put(row+1,baseSpWID);
-      msc.time().put(row+1,Time+Tint/2);
-      msc.timeCentroid().put(row+1,Time+Tint/2);
-      msc.arrayId().put(row+1,maxArrayId);
-      msc.processorId().put(row+1,0);
-      msc.exposure().put(row+1,Tint);
-      msc.interval().put(row+1,Tint);
-      msc.observationId().put(row+1,maxObsId+1);
-      msc.stateId().put(row+1,staterow);
+      if (!writer) {
+	msc.scanNumber().put(row+1,scan);
+	msc.fieldId().put(row+1,existingFieldID);
+	msc.dataDescId().put(row+1,baseSpWID);
+	msc.time().put(row+1,Time+Tint/2);
+	msc.timeCentroid().put(row+1,Time+Tint/2);
+	msc.arrayId().put(row+1,maxArrayId);
+	msc.processorId().put(row+1,0);
+	msc.exposure().put(row+1,Tint);
+	msc.interval().put(row+1,Tint);
+	msc.observationId().put(row+1,maxObsId+1);
+	msc.stateId().put(row+1,staterow);
+      }
 
       // assume also that all mounts are the same and posit. angle is the same
       if (antenna_mounts[0]=="ALT-AZ" || antenna_mounts[0]=="alt-az") {
@@ -1593,6 +1829,94 @@ void NewMSSimulator::observe(const Vector<String>& sourceNames,
       }
       // x direction is flipped to convert az-el type frame to ra-dec
       feed_phc.shift(-beamOffset(0),beamOffset(1),True);
+
+      if (writer) {
+	// Fill all rows of the timestep in memory and hand them to the writer.
+	std::shared_ptr<NewMSSimulatorTimestep> step(new NewMSSimulatorTimestep);
+	step->firstRow=row+1;
+	step->scan=scan;
+	step->fieldId=existingFieldID;
+	step->dataDescId=baseSpWID;
+	step->arrayId=maxArrayId;
+	step->observationId=maxObsId+1;
+	step->stateId=staterow;
+	step->feed=feed;
+	step->time=Time+Tint/2;
+	step->interval=Tint;
+	step->pointingTime=Time+Tint/2;
+	step->pointingTimeOrigin=Tstart;
+	step->direction=fieldCenter;
+	step->data.reference(zeroData);
+	step->ant1.resize(nBaselines);
+	step->ant2.resize(nBaselines);
+	step->uvw.resize(3,nBaselines);
+	step->weight.resize(nCorr,nBaselines);
+	step->sigma.resize(nCorr,nBaselines);
+	step->flagRow.resize(nBaselines);
+	step->flag.resize(nCorr,nChan,nBaselines);
+
+	Matrix<Double> antUVW;
+	uvwMachine->setPhaseCenters(Vector<MDirection>(1, feed_phc));
+	uvwMachine->antennaUVW(antUVW, ep, 0);
+	Int bl=0;
+	for(Int ant1=0; ant1<nAnt; ant1++) {
+	  Int startAnt2=ant1+1;
+	  if(autoCorrelationWt_p>0.0) startAnt2=ant1;
+	  for (Int ant2=startAnt2; ant2<nAnt; ant2++) {
+	    step->ant1(bl)=ant1;
+	    step->ant2(bl)=ant2;
+	    Vector<Double> uvwvec(step->uvw.column(bl));
+	    for (uInt i=0; i<3; i++) {
+	      uvwvec(i) = antUVW(i,ant2) - antUVW(i,ant1);
+	    }
+	    if (ant1 != ant2) {
+	      blockage(fractionBlocked1, fractionBlocked2,
+		       uvwvec, antDiam(ant1), antDiam(ant2) );
+	      if (fractionBlocked1 > fractionBlockageLimit_p) {
+		isShadowed(ant1) = True;
+	      }
+	      if (fractionBlocked2 > fractionBlockageLimit_p) {
+		isShadowed(ant2) = True;
+	      }
+	    }
+	    // Deal with differing diameter case
+	    Float sigma1 = diamMax2/(antDiam(ant1) * antDiam(ant2));
+	    Float wt = 1/square(sigma1);
+	    if  (ant1 == ant2 ) {
+	      wt *= autoCorrelationWt_p;
+	    }
+	    step->weight.column(bl) = wt;
+	    step->sigma.column(bl) = sigma1;
+	    bl++;
+	  }
+	}
+
+	// Find antennas pointing below the elevation limit
+	for (Int ant1=0; ant1<nAnt; ant1++) {
+	  msd.setAntenna(ant1);
+	  Vector<Double> azel=msd.azel().getAngle("rad").getValue("rad");
+	  if (azel(1) < elevationLimit_p.getValue("rad")) {
+	    isTooLow(ant1) = True;
+	  }
+	}
+
+	// Flag the shadowed rows and the rows below the elevation limit.
+	for (bl=0; bl<nBaselines; bl++) {
+	  Int ant1=step->ant1(bl);
+	  Int ant2=step->ant2(bl);
+	  Bool shadowed = isShadowed(ant1) || isShadowed(ant2);
+	  Bool tooLow = isTooLow(ant1) || isTooLow(ant2);
+	  if (shadowed) nShadowed++;
+	  if (tooLow) nSubElevation++;
+	  step->flagRow(bl) = shadowed || tooLow;
+	  step->flag.xyPlane(bl) = step->flagRow(bl);
+	}
+
+	writer->write(step);
+	row += nBaselines;
+	Time+=Tint;
+	continue;
+      }
       ///Below code is replaced with calcUVW that does a baseline conversion
       ///to J2000 too
     
@@ -1754,6 +2078,10 @@ void NewMSSimulator::observe(const Vector<String>& sourceNames,
     }  // time ranges
   } // feeds
 } // pointings
+
+  if (writer) {
+    writer->finish();
+  }
         
   
 
@@ -108,6 +108,16 @@ public:
   // Set maximum amount of data (bytes) to be written into any one
   // scratch column hypercube
   void setMaxData(const Double maxData=2e9) {maxData_p=maxData;}
+
+  // Set if <src>observe</src> should fill the main table a timestep at
+  // a time. In that mode the UVWs of all baselines of a timestep are
+  // calculated from a single conversion matrix (using AntennaUVWMachine)
+  // and the columns of all rows of a timestep are put at once.
+  // If <src>writerThread=True</src> (and built with USE_THREADS),
+  // the rows are written by a separate thread, while the next timestep
+  // is calculated. By default the rows are written one by one.
+  void setBulkWrite(const Bool bulkWrite, const Bool writerThread=True)
+    {bulkWrite_p=bulkWrite; writerThread_p=writerThread;}
   
   // set the antenna and array data. These are written immediately to the
   // existing MS. The same model is used for the other init infor.
@@ -242,6 +252,9 @@ private:
 
   Double maxData_p;
 
+  Bool bulkWrite_p;
+  Bool writerThread_p;
+
   void local2global(Vector<Double>& xReturned,
 		    Vector<Double>& yReturned,
 		    Vector<Double>& zReturned,
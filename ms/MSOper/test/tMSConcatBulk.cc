@@ -0,0 +1,263 @@
+//# tMSConcatBulk.cc: test bulk concatenation of MeasurementSets
+//# Copyright (C) 2026
+//# Associated Universities, Inc. Washington DC, USA.
+//#
+//# This program is free software; you can redistribute it and/or modify it
+//# under the terms of the GNU General Public License as published by the Free
+//# Software Foundation; either version 2 of the License, or (at your option)
+//# any later version.
+//#
+//# This program is distributed in the hope that it will be useful, but WITHOUT
+//# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+//# more details.
+//#
+//# You should have received a copy of the GNU General Public License along
+//# with this program; if not, write to the Free Software Foundation, Inc.,
+//# 675 Massachusetts Ave, Cambridge, MA 02139, USA.
+//#
+//# Correspondence concerning AIPS++ should be addressed as follows:
+//#        Internet email: aips2-request@nrao.edu.
+//#        Postal address: AIPS++ Project Office
+//#                        National Radio Astronomy Observatory
+//#                        520 Edgemont Road
+//#                        Charlottesville, VA 22903-2475 USA
+
+#include <casacore/ms/MSOper/MSConcat.h>
+#include <casacore/ms/MeasurementSets/MeasurementSet.h>
+#include <casacore/ms/MeasurementSets/MSColumns.h>
+#include <casacore/measures/Measures/Stokes.h>
+#include <casacore/tables/Tables/SetupNewTab.h>
+#include <casacore/casa/Arrays/ArrayLogical.h>
+#include <casacore/casa/Arrays/ArrayMath.h>
+#include <casacore/casa/Arrays/Cube.h>
+#include <casacore/casa/Utilities/Assert.h>
+#include <casacore/casa/Exceptions/Error.h>
+#include <casacore/casa/iostream.h>
+
+#include <casacore/casa/namespace.h>
+
+// <summary>
+// Test program for concatenating MeasurementSets in blocks of rows.
+// The result must be the same as concatenating them row by row.
+// The antennas and channels of the appended MS are in reversed order,
+// so baselines have to be swapped and channels reversed.
+// </summary>
+
+const Int nAnt = 3;
+const Int nChan = 5;
+const Int nCorr = 4;
+const Int nTime = 7;
+
+void createMS(const String& name, Bool reversed, Float offset)
+{
+  TableDesc td(MS::requiredTableDesc());
+  MS::addColumnToDesc(td, MS::DATA, 2);
+  MS::addColumnToDesc(td, MS::WEIGHT_SPECTRUM, 2);
+  SetupNewTable newtab(name, td, Table::New);
+  MeasurementSet ms(newtab);
+  ms.createDefaultSubtables(Table::New);
+  MSColumns cols(ms);
+  // ANTENNA
+  ms.antenna().addRow(nAnt);
+  for (Int i=0; i<nAnt; ++i) {
+    const Int a = (reversed ? nAnt-1-i : i);
+    cols.antenna().name().put(i, "ANT" + String::toString(a));
+    cols.antenna().station().put(i, "ST" + String::toString(a));
+    Vector<Double> pos(3);
+    pos(0) = 6378137. + 100*a;
+    pos(1) = 1000. * a;
+    pos(2) = -500. * a;
+    cols.antenna().position().put(i, pos);
+    cols.antenna().offset().put(i, Vector<Double>(3, 0.));
+    cols.antenna().dishDiameter().put(i, 25.);
+    cols.antenna().mount().put(i, "ALT-AZ");
+    cols.antenna().type().put(i, "GROUND-BASED");
+  }
+  // SPECTRAL_WINDOW
+  ms.spectralWindow().addRow();
+  Vector<Double> freqs(nChan);
+  for (Int i=0; i<nChan; ++i) {
+    freqs(i) = 1e9 + 1e6 * (reversed ? nChan-1-i : i);
+  }
+  cols.spectralWindow().numChan().put(0, nChan);
+  cols.spectralWindow().chanFreq().put(0, freqs);
+  cols.spectralWindow().chanWidth().put(0, Vector<Double>(nChan, 1e6));
+  cols.spectralWindow().effectiveBW().put(0, Vector<Double>(nChan, 1e6));
+  cols.spectralWindow().resolution().put(0, Vector<Double>(nChan, 1e6));
+  cols.spectralWindow().refFrequency().put(0, 1e9);
+  cols.spectralWindow().totalBandwidth().put(0, nChan * 1e6);
+  cols.spectralWindow().measFreqRef().put(0, MFrequency::TOPO);
+  // POLARIZATION
+  ms.polarization().addRow();
+  Vector<Int> corrType(nCorr);
+  corrType(0) = Stokes::XX;
+  corrType(1) = Stokes::XY;
+  corrType(2) = Stokes::YX;
+  corrType(3) = Stokes::YY;
+  Matrix<Int> corrProduct(2, nCorr);
+  for (Int i=0; i<nCorr; ++i) {
+    corrProduct(0, i) = i / 2;
+    corrProduct(1, i) = i % 2;
+  }
+  cols.polarization().numCorr().put(0, nCorr);
+  cols.polarization().corrType().put(0, corrType);
+  cols.polarization().corrProduct().put(0, corrProduct);
+  // DATA_DESCRIPTION
+  ms.dataDescription().addRow();
+  cols.dataDescription().spectralWindowId().put(0, 0);
+  cols.dataDescription().polarizationId().put(0, 0);
+  // FIELD
+  ms.field().addRow();
+  cols.field().name().put(0, "SRC");
+  Matrix<Double> dir(2, 1, 0.5);
+  cols.field().delayDir().put(0, dir);
+  cols.field().phaseDir().put(0, dir);
+  cols.field().referenceDir().put(0, dir);
+  cols.field().sourceId().put(0, -1);
+  // OBSERVATION and PROCESSOR
+  ms.observation().addRow();
+  cols.observation().telescopeName().put(0, "TEST");
+  cols.observation().timeRange().put(0, Vector<Double>(2, 4e9));
+  ms.processor().addRow();
+  // MAIN
+  const Int nbl = nAnt * (nAnt - 1) / 2;
+  ms.addRow(nTime * nbl);
+  rownr_t row = 0;
+  for (Int t=0; t<nTime; ++t) {
+    for (Int a1=0; a1<nAnt; ++a1) {
+      for (Int a2=a1+1; a2<nAnt; ++a2) {
+        cols.time().put(row, 4e9 + 10 * t + offset);
+        cols.timeCentroid().put(row, 4e9 + 10 * t + offset);
+        cols.interval().put(row, 10.);
+        cols.exposure().put(row, 10.);
+        cols.scanNumber().put(row, 1 + t / 3);
+        cols.antenna1().put(row, a1);
+        cols.antenna2().put(row, a2);
+        Vector<Double> uvw(3);
+        indgen(uvw, Double(row + offset));
+        cols.uvw().put(row, uvw);
+        Matrix<Complex> data(nCorr, nChan);
+        Matrix<Float> weightSp(nCorr, nChan);
+        Matrix<Bool> flag(nCorr, nChan);
+        for (Int c=0; c<nChan; ++c) {
+          for (Int p=0; p<nCorr; ++p) {
+            data(p, c) = Complex(row + offset, 10 * c + p);
+            weightSp(p, c) = 100 * c + p + 1;
+            flag(p, c) = ((row + c + p) % 3 == 0);
+          }
+        }
+        cols.data().put(row, data);
+        cols.weightSpectrum().put(row, weightSp);
+        cols.flag().put(row, flag);
+        Vector<Float> weight(nCorr);
+        indgen(weight, Float(1));
+        cols.weight().put(row, weight);
+        cols.sigma().put(row, Float(1) / weight);
+        ++row;
+      }
+    }
+  }
+}
+
+template<typename T>
+void compareScalar(const MSMainColumns& cols1, const MSMainColumns& cols2,
+                   const ScalarColumn<T>& (MSMainColumns::*col)() const)
+{
+  AlwaysAssertExit(allEQ((cols1.*col)().getColumn(),
+                         (cols2.*col)().getColumn()));
+}
+
+template<typename T>
+void compareArray(const MSMainColumns& cols1, const MSMainColumns& cols2,
+                  const ArrayColumn<T>& (MSMainColumns::*col)() const)
+{
+  AlwaysAssertExit(allEQ((cols1.*col)().getColumn(),
+                         (cols2.*col)().getColumn()));
+}
+
+void compareMS(const MeasurementSet& ms1, const MeasurementSet& ms2)
+{
+  AlwaysAssertExit(ms1.nrow() == ms2.nrow());
+  const MSMainColumns cols1(ms1);
+  const MSMainColumns cols2(ms2);
+  compareScalar(cols1, cols2, &MSMainColumns::antenna1);
+  compareScalar(cols1, cols2, &MSMainColumns::antenna2);
+  compareScalar(cols1, cols2, &MSMainColumns::feed1);
+  compareScalar(cols1, cols2, &MSMainColumns::feed2);
+  compareScalar(cols1, cols2, &MSMainColumns::dataDescId);
+  compareScalar(cols1, cols2, &MSMainColumns::fieldId);
+  compareScalar(cols1, cols2, &MSMainColumns::scanNumber);
+  compareScalar(cols1, cols2, &MSMainColumns::observationId);
+  compareScalar(cols1, cols2, &MSMainColumns::processorId);
+  compareScalar(cols1, cols2, &MSMainColumns::stateId);
+  compareScalar(cols1, cols2, &MSMainColumns::arrayId);
+  compareScalar(cols1, cols2, &MSMainColumns::time);
+  compareScalar(cols1, cols2, &MSMainColumns::timeCentroid);
+  compareScalar(cols1, cols2, &MSMainColumns::interval);
+  compareScalar(cols1, cols2, &MSMainColumns::exposure);
+  compareScalar(cols1, cols2, &MSMainColumns::flagRow);
+  compareArray(cols1, cols2, &MSMainColumns::uvw);
+  compareArray(cols1, cols2, &MSMainColumns::data);
+  compareArray(cols1, cols2, &MSMainColumns::weight);
+  compareArray(cols1, cols2, &MSMainColumns::sigma);
+  compareArray(cols1, cols2, &MSMainColumns::weightSpectrum);
+  compareArray(cols1, cols2, &MSMainColumns::flag);
+}
+
+// Check the first appended row, which has baseline 0-1 in the appended MS.
+// It is baseline 1-2 in the result, so it has to be swapped.
+void checkSwapped(const MeasurementSet& ms, rownr_t row)
+{
+  const MSMainColumns cols(ms);
+  AlwaysAssertExit(cols.antenna1()(row) == 1);
+  AlwaysAssertExit(cols.antenna2()(row) == 2);
+  AlwaysAssertExit(allEQ(cols.uvw()(row), Array<Double>(Vector<Double>({-1000., -1001., -1002.}))));
+  const Matrix<Complex> data(cols.data()(row));
+  const Int polSwap[] = {0, 2, 1, 3};
+  for (Int c=0; c<nChan; ++c) {
+    for (Int p=0; p<nCorr; ++p) {
+      AlwaysAssertExit(data(p, c) ==
+                       conj(Complex(1000, 10 * (nChan-1-c) + polSwap[p])));
+    }
+  }
+  const Vector<Float> weight(cols.weight()(row));
+  AlwaysAssertExit(weight(1) == 2 * 3 && weight(2) == 2 * 2);
+}
+
+int main()
+{
+  try {
+    createMS("tMSConcatBulk_tmp.ms1", False, 0);
+    createMS("tMSConcatBulk_tmp.ms2", True, 1000);
+    Table("tMSConcatBulk_tmp.ms1").copy("tMSConcatBulk_tmp.row", Table::New);
+    Table("tMSConcatBulk_tmp.ms1").copy("tMSConcatBulk_tmp.bulk", Table::New);
+    const MeasurementSet appendMS("tMSConcatBulk_tmp.ms2");
+    const rownr_t nrow = appendMS.nrow();
+    {
+      MeasurementSet ms("tMSConcatBulk_tmp.row", Table::Update);
+      MSConcat mscat(ms);
+      mscat.setWeightScale(2);
+      mscat.setBulkCopy(False);
+      mscat.concatenate(appendMS);
+    }
+    {
+      // Use a block size that does not divide the number of rows.
+      MeasurementSet ms("tMSConcatBulk_tmp.bulk", Table::Update);
+      MSConcat mscat(ms);
+      mscat.setWeightScale(2);
+      mscat.setBulkCopy(True, 4);
+      mscat.concatenate(appendMS);
+    }
+    const MeasurementSet ms1("tMSConcatBulk_tmp.row");
+    const MeasurementSet ms2("tMSConcatBulk_tmp.bulk");
+    AlwaysAssertExit(ms2.nrow() == 2 * nrow);
+    compareMS(ms1, ms2);
+    checkSwapped(ms2, nrow);
+  } catch (const std::exception& x) {
+    cout << "Unexpected exception: " << x.what() << endl;
+    return 1;
+  }
+  cout << "OK" << endl;
+  return 0;
+}
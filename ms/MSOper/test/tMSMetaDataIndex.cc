@@ -0,0 +1,177 @@
+//# tMSMetaDataIndex.cc: test program for MSMetaDataIndex
+//# Copyright (C) 2026
+//# Associated Universities, Inc. Washington DC, USA.
+//#
+//# This program is free software; you can redistribute it and/or modify it
+//# under the terms of the GNU General Public License as published by the Free
+//# Software Foundation; either version 2 of the License, or (at your option)
+//# any later version.
+//#
+//# This program is distributed in the hope that it will be useful, but WITHOUT
+//# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+//# more details.
+//#
+//# You should have received a copy of the GNU General Public License along
+//# with this program; if not, write to the Free Software Foundation, Inc.,
+//# 675 Massachusetts Ave, Cambridge, MA 02139, USA.
+//#
+//# Correspondence concerning AIPS++ should be addressed as follows:
+//#        Internet email: aips2-request@nrao.edu.
+//#        Postal address: AIPS++ Project Office
+//#                        National Radio Astronomy Observatory
+//#                        520 Edgemont Road
+//#                        Charlottesville, VA 22903-2475 USA
+
+#include <casacore/ms/MSOper/MSMetaDataIndex.h>
+#include <casacore/ms/MSOper/MSMetaData.h>
+#include <casacore/ms/MSOper/MSKeys.h>
+#include <casacore/ms/MeasurementSets/MeasurementSet.h>
+#include <casacore/ms/MeasurementSets/MSMainColumns.h>
+#include <casacore/tables/Tables/SetupNewTab.h>
+#include <casacore/tables/Tables/TableUtil.h>
+#include <casacore/tables/TaQL/ExprNode.h>
+#include <casacore/casa/Arrays/ArrayLogical.h>
+#include <casacore/casa/OS/DirectoryIterator.h>
+#include <casacore/casa/OS/File.h>
+#include <casacore/casa/Utilities/Assert.h>
+#include <casacore/casa/Exceptions/Error.h>
+#include <casacore/casa/iostream.h>
+#include <ctime>
+
+#include <casacore/casa/namespace.h>
+
+const String msName("tMSMetaDataIndex_tmp.ms");
+const Int nAnt = 4;
+const Int nTime = 50;
+
+void createMS()
+{
+    SetupNewTable newtab(msName, MS::requiredTableDesc(), Table::New);
+    MeasurementSet ms(newtab);
+    ms.createDefaultSubtables(Table::New);
+    const Int nbl = nAnt * (nAnt + 1) / 2;
+    ms.addRow(nTime * nbl);
+    MSMainColumns cols(ms);
+    rownr_t row = 0;
+    for (Int t=0; t<nTime; ++t) {
+        for (Int a1=0; a1<nAnt; ++a1) {
+            for (Int a2=a1; a2<nAnt; ++a2) {
+                cols.time().put(row, 4e9 + 10 * t);
+                cols.scanNumber().put(row, 1 + t / 10);
+                cols.fieldId().put(row, t / 20);
+                cols.dataDescId().put(row, 0);
+                cols.stateId().put(row, t % 2);
+                cols.arrayId().put(row, 0);
+                cols.observationId().put(row, 0);
+                cols.antenna1().put(row, a1);
+                cols.antenna2().put(row, a2);
+                ++row;
+            }
+        }
+    }
+    ms.state().addRow(2);
+}
+
+template <class T> void checkColumn(
+    const MSMetaDataIndex& index, const MeasurementSet& ms,
+    MSMainEnums::PredefinedColumns col
+) {
+    Vector<T> expected = ScalarColumn<T>(
+        ms, MeasurementSet::columnName(col)
+    ).getColumn();
+    Vector<T> values;
+    AlwaysAssertExit(index.getColumn(values, col, 0, ms.nrow()));
+    AlwaysAssertExit(allEQ(values, expected));
+    // Some row ranges not aligned with the runs.
+    const rownr_t starts[] = {0, 3, 17, 100, ms.nrow() - 5};
+    for (rownr_t start : starts) {
+        rownr_t n = std::min(rownr_t(33), ms.nrow() - start);
+        AlwaysAssertExit(index.getColumn(values, col, start, n));
+        AlwaysAssertExit(allEQ(values, expected(Slice(start, n))));
+    }
+}
+
+void checkIndex(const MSMetaDataIndex& index, const MeasurementSet& ms)
+{
+    AlwaysAssertExit(index.nrow() == ms.nrow());
+    checkColumn<Double>(index, ms, MSMainEnums::TIME);
+    checkColumn<Int>(index, ms, MSMainEnums::SCAN_NUMBER);
+    checkColumn<Int>(index, ms, MSMainEnums::FIELD_ID);
+    checkColumn<Int>(index, ms, MSMainEnums::DATA_DESC_ID);
+    checkColumn<Int>(index, ms, MSMainEnums::STATE_ID);
+    checkColumn<Int>(index, ms, MSMainEnums::ARRAY_ID);
+    checkColumn<Int>(index, ms, MSMainEnums::OBSERVATION_ID);
+    checkColumn<Int>(index, ms, MSMainEnums::ANTENNA1);
+    checkColumn<Int>(index, ms, MSMainEnums::ANTENNA2);
+    // A column that is not indexed.
+    Vector<Int> values;
+    AlwaysAssertExit(
+        ! index.getColumn(values, MSMainEnums::FEED1, 0, ms.nrow())
+    );
+    AlwaysAssertExit(! MSMetaDataIndex::isIndexed(MSMainEnums::FEED1));
+}
+
+int main()
+{
+    try {
+        createMS();
+        // Make the files older, so the index can be stored.
+        for (DirectoryIterator iter(msName); ! iter.pastEnd(); iter++) {
+            iter.file().touch(uInt(time(0)) - 10);
+        }
+        const String indexName = msName + "/msmetadata.index";
+        {
+            MeasurementSet ms(msName);
+            AlwaysAssertExit(MSMetaDataIndex::indexFileName(ms) == indexName);
+            MSMetaDataIndex index(ms);
+            checkIndex(index, ms);
+            AlwaysAssertExit(index.nRuns(MSMainEnums::TIME) == uInt(nTime));
+            AlwaysAssertExit(
+                index.nRuns(MSMainEnums::SCAN_NUMBER) == uInt(nTime/10)
+            );
+            AlwaysAssertExit(index.nRuns(MSMainEnums::DATA_DESC_ID) == 1);
+            AlwaysAssertExit(
+                index.nbytes() < ms.nrow() * (sizeof(Double) + 8 * sizeof(Int))
+            );
+            // Store the index and read it back.
+            std::shared_ptr<const MSMetaDataIndex> stored =
+                MSMetaDataIndex::create(ms, True);
+            AlwaysAssertExit(File(indexName).exists());
+            checkIndex(*stored, ms);
+            std::shared_ptr<const MSMetaDataIndex> reused =
+                MSMetaDataIndex::create(ms, True);
+            checkIndex(*reused, ms);
+            // A selection has no stored index.
+            MeasurementSet sel(ms(ms.col("ANTENNA1") == 1));
+            AlwaysAssertExit(MSMetaDataIndex::indexFileName(sel).empty());
+            checkIndex(*MSMetaDataIndex::create(sel, True), sel);
+            // MSMetaData gives the same results with and without the index.
+            MSMetaData md(&ms, 0);
+            MSMetaData mdIndex(&ms, 0);
+            mdIndex.setUseIndex(True);
+            AlwaysAssertExit(
+                md.getUniqueFieldIDs() == mdIndex.getUniqueFieldIDs()
+            );
+            std::set<ScanKey> noScans;
+            std::set<Double> times = mdIndex.getTimesForScans(noScans);
+            AlwaysAssertExit(md.getTimesForScans(noScans) == times);
+            AlwaysAssertExit(times.size() == uInt(nTime));
+        }
+        {
+            // A changed MS invalidates the stored index.
+            MeasurementSet ms(msName, Table::Update);
+            MSMainColumns(ms).scanNumber().put(0, 99);
+        }
+        {
+            MeasurementSet ms(msName);
+            checkIndex(*MSMetaDataIndex::create(ms, False), ms);
+        }
+        TableUtil::deleteTable(msName);
+    } catch (const std::exception& x) {
+        cout << "Unexpected exception: " << x.what() << endl;
+        return 1;
+    }
+    cout << "OK" << endl;
+    return 0;
+}
@@ -0,0 +1,164 @@
+//# tMSUVWCalculator.cc: test program for MSUVWCalculator
+//# Copyright (C) 2026
+//# Associated Universities, Inc. Washington DC, USA.
+//#
+//# This program is free software; you can redistribute it and/or modify it
+//# under the terms of the GNU General Public License as published by the Free
+//# Software Foundation; either version 2 of the License, or (at your option)
+//# any later version.
+//#
+//# This program is distributed in the hope that it will be useful, but WITHOUT
+//# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+//# more details.
+//#
+//# You should have received a copy of the GNU General Public License along
+//# with this program; if not, write to the Free Software Foundation, Inc.,
+//# 675 Massachusetts Ave, Cambridge, MA 02139, USA.
+//#
+//# Correspondence concerning AIPS++ should be addressed as follows:
+//#        Internet email: aips2-request@nrao.edu.
+//#        Postal address: AIPS++ Project Office
+//#                        National Radio Astronomy Observatory
+//#                        520 Edgemont Road
+//#                        Charlottesville, VA 22903-2475 USA
+
+#include <casacore/ms/MSOper/MSUVWCalculator.h>
+#include <casacore/ms/MSOper/NewMSSimulator.h>
+#include <casacore/ms/MeasurementSets/MeasurementSet.h>
+#include <casacore/ms/MeasurementSets/MSMainColumns.h>
+#include <casacore/ms/MeasurementSets/MSAntennaColumns.h>
+#include <casacore/ms/MeasurementSets/MSFieldColumns.h>
+#include <casacore/measures/Measures/MBaseline.h>
+#include <casacore/measures/Measures/MCBaseline.h>
+#include <casacore/measures/Measures/MCDirection.h>
+#include <casacore/measures/Measures/MCPosition.h>
+#include <casacore/measures/Measures/MeasConvert.h>
+#include <casacore/measures/Measures/MeasTable.h>
+#include <casacore/casa/Quanta/MVuvw.h>
+#include <casacore/tables/Tables/ArrayColumn.h>
+#include <casacore/tables/Tables/ScalarColumn.h>
+#include <casacore/tables/Tables/TableUtil.h>
+#include <casacore/casa/Arrays/ArrayLogical.h>
+#include <casacore/casa/Arrays/ArrayMath.h>
+#include <casacore/casa/Utilities/Assert.h>
+#include <casacore/casa/Exceptions/Error.h>
+#include <iostream>
+
+using namespace casacore;
+using namespace std;
+
+// Simulate 10 minutes of a 4 antenna array (100 rows).
+void simulate (const String& msName)
+{
+  NewMSSimulator sim(msName);
+  const Int nAnt = 4;
+  Vector<Double> x(nAnt), y(nAnt), z(nAnt, 0.), diam(nAnt, 25.);
+  Vector<Double> offset(nAnt, 0.);
+  Vector<String> mount(nAnt, "ALT-AZ"), name(nAnt), pad(nAnt, "PAD");
+  for (Int i=0; i<nAnt; ++i) {
+    x[i] = 100.*i;
+    y[i] = 70.*i*i;
+    name[i] = "ANT" + String::toString(i);
+  }
+  MPosition vlaPosition;
+  MeasTable::Observatory (vlaPosition, "VLA");
+  sim.initAnt ("VLA", x, y, z, diam, offset, mount, name, pad,
+               "local", vlaPosition);
+  sim.initSpWindows ("SPW", 1, Quantity(1.4, "GHz"), Quantity(1., "MHz"),
+                     Quantity(1., "MHz"), MFrequency::TOPO, "RR LL");
+  sim.initFeeds ("perfect R L");
+  sim.initFields ("SRC", MDirection(Quantity(20., "deg"),
+                                    Quantity(60., "deg"),
+                                    MDirection::J2000), "");
+  sim.settimes (Quantity(60., "s"), True,
+                MEpoch(Quantity(58000., "d"), MEpoch::UTC));
+  sim.observe ("SRC", "SPW", Quantity(0., "s"), Quantity(600., "s"));
+}
+
+// Calculate the J2000 UVW of a baseline by converting it as a whole.
+Vector<Double> baselineUVW (const MPosition& obsPos, const MPosition& pos1,
+                            const MPosition& pos2, const MEpoch& epoch,
+                            const MVDirection& dirJ2000)
+{
+  MeasFrame frame(epoch, obsPos);
+  Vector<Double> p1 = MPosition::Convert(pos1, MPosition::ITRF)()
+    .getValue().getValue();
+  Vector<Double> p2 = MPosition::Convert(pos2, MPosition::ITRF)()
+    .getValue().getValue();
+  MBaseline bl(MVBaseline(p2[0]-p1[0], p2[1]-p1[1], p2[2]-p1[2]),
+               MBaseline::ITRF);
+  MBaseline::Convert convert(bl, MBaseline::Ref(MBaseline::J2000, frame));
+  return MVuvw(convert().getValue(), dirJ2000).getValue();
+}
+
+int main()
+{
+  try {
+    const String msName("tMSUVWCalculator_tmp.ms");
+    simulate (msName);
+    MeasurementSet ms(msName, Table::Update);
+    MSMainColumns cols(ms);
+    const rownr_t nrow = ms.nrow();
+    AlwaysAssertExit (nrow == 100);
+    const Matrix<Double> simUVW = cols.uvw().getColumn();
+    {
+      // Recalculating must give the UVWs of the simulator. Use a chunk
+      // size not dividing the number of rows.
+      cols.uvw().putColumn (Matrix<Double>(3, nrow, 0.));
+      MSUVWCalculator::recalculate (ms, "PHASE_DIR", 7);
+      AlwaysAssertExit (allNearAbs (cols.uvw().getColumn(), simUVW, 1e-3));
+      AlwaysAssertExit (anyNE (simUVW, 0.));
+    }
+    {
+      // Give the field a direction polynomial; the phase center moves
+      // 1e-6 rad/sec in RA, so the UVWs have to be calculated per time.
+      MSFieldColumns fieldCols(ms.field());
+      const Vector<Double> times = cols.time().getColumn();
+      const Double t0 = times[0];
+      ArrayColumn<Double> phaseDir(ms.field(), "PHASE_DIR");
+      Matrix<Double> dir(2, 2, 0.);
+      dir.column(0) = phaseDir(0).reform(IPosition(1, 2));
+      dir(0, 1) = 1e-6;
+      phaseDir.put (0, dir);
+      fieldCols.numPoly().put (0, 1);
+      fieldCols.time().put (0, t0);
+      MSUVWCalculator::recalculate (ms, "PHASE_DIR", 7);
+      const Matrix<Double> uvw = cols.uvw().getColumn();
+      // Check all rows against a conversion of the baseline as a whole.
+      MSAntennaColumns antCols(ms.antenna());
+      MPosition obsPos;
+      MeasTable::Observatory (obsPos, "VLA");
+      const Vector<Int> ant1 = cols.antenna1().getColumn();
+      const Vector<Int> ant2 = cols.antenna2().getColumn();
+      Double maxDiff = 0;
+      for (rownr_t row=0; row<nrow; ++row) {
+        MVDirection dirJ2000(dir(0, 0) + 1e-6 * (times[row] - t0), dir(1, 0));
+        Vector<Double> expUVW = baselineUVW
+          (obsPos, antCols.positionMeas()(ant1[row]),
+           antCols.positionMeas()(ant2[row]),
+           MEpoch(MVEpoch(Quantity(times[row], "s")), MEpoch::UTC),
+           dirJ2000);
+        AlwaysAssertExit (allNearAbs (uvw.column(row), expUVW, 1e-3));
+        maxDiff = max(maxDiff, max(abs(uvw.column(row) - simUVW.column(row))));
+      }
+      // The moving phase center must make a difference.
+      AlwaysAssertExit (maxDiff > 0.01);
+    }
+    // An unknown direction column is an error.
+    Bool thrown = False;
+    try {
+      MSUVWCalculator::recalculate (ms, "NO_DIR");
+    } catch (const AipsError&) {
+      thrown = True;
+    }
+    AlwaysAssertExit (thrown);
+    ms = MeasurementSet();
+    TableUtil::deleteTable (msName);
+  } catch (const std::exception& x) {
+    cout << "Unexpected exception: " << x.what() << endl;
+    return 1;
+  }
+  cout << "OK" << endl;
+  return 0;
+}
@@ -31,13 +31,18 @@
 #include <string>
 #include <casacore/ms/MSOper/NewMSSimulator.h>
 #include <casacore/ms/MeasurementSets/MeasurementSet.h>
+#include <casacore/ms/MeasurementSets/MSMainColumns.h>
 #include <casacore/measures/Measures/MeasTable.h>
+#include <casacore/casa/Arrays/ArrayLogical.h>
+#include <casacore/casa/Utilities/Assert.h>
 #include <casacore/casa/Exceptions/Error.h>
 
 void test_NewMSSimulator_Constructors();
 
 void test_NewMSSimulator_RandomAntenna();
 
+void test_NewMSSimulator_BulkWrite();
+
 int removeFile(const char *fpath, const struct stat *sb, int typeflag, 
                struct FTW* ftwbuf);
 
@@ -46,6 +51,7 @@ int main() {
   try {
     test_NewMSSimulator_Constructors();
     test_NewMSSimulator_RandomAntenna();
+    test_NewMSSimulator_BulkWrite();
   }
   catch (const std::exception& x) {
     std::cerr << "Exception : " << x.what() << std::endl;
@@ -167,3 +173,79 @@ void test_NewMSSimulator_RandomAntenna()
     
   }
 }
+
+/*
+ * Simulate a short observation with a small array.
+ */
+void simulate(casacore::NewMSSimulator& simulator)
+{
+  using namespace casacore;
+  const Int nAnt = 5;
+  Vector<Double> x(nAnt), y(nAnt), z(nAnt, 0.), diam(nAnt, 25.), offset(nAnt, 0.);
+  Vector<String> mount(nAnt, "ALT-AZ"), name(nAnt), pad(nAnt, "PAD");
+  for (Int i=0; i<nAnt; ++i) {
+    // Two antennas close enough to shadow each other at low elevation.
+    x[i] = (i < 2 ? 30.*i : 200.*i);
+    y[i] = 50.*i*i;
+    name[i] = "ANT" + String::toString(i);
+  }
+  MPosition vlaPosition;
+  MeasTable::Observatory(vlaPosition, "VLA");
+  simulator.initAnt("VLA", x, y, z, diam, offset, mount, name, pad,
+                    "local", vlaPosition);
+  simulator.initSpWindows("SPW", 16, Quantity(1.4, "GHz"),
+                          Quantity(1., "MHz"), Quantity(1., "MHz"),
+                          MFrequency::TOPO, "RR RL LR LL");
+  simulator.initFeeds("perfect R L");
+  simulator.initFields("SRC", MDirection(Quantity(30., "deg"),
+                                         Quantity(-20., "deg"),
+                                         MDirection::J2000), "");
+  simulator.settimes(Quantity(60., "s"), True,
+                     MEpoch(Quantity(58000., "d"), MEpoch::UTC));
+  // A long observation, so the source sets.
+  simulator.observe("SRC", "SPW", Quantity(-6., "h"), Quantity(6., "h"));
+}
+
+/*
+ * Filling the rows a timestep at a time must give the same MS as
+ * filling them one by one (apart from rounding errors in the UVW).
+ */
+void test_NewMSSimulator_BulkWrite()
+{
+  using namespace casacore;
+  NewMSSimulatorTester rowTester("newsim_rowwise");
+  simulate(*rowTester.simulator_p);
+  for (int thread=0; thread<2; ++thread) {
+    NewMSSimulatorTester bulkTester("newsim_bulk" + std::to_string(thread));
+    bulkTester.simulator_p->setBulkWrite(True, thread==1);
+    simulate(*bulkTester.simulator_p);
+    MSMainColumns rowCols(*rowTester.simulator_p->getMs());
+    MSMainColumns bulkCols(*bulkTester.simulator_p->getMs());
+    AlwaysAssertExit(rowCols.nrow() == bulkCols.nrow());
+    AlwaysAssertExit(rowCols.nrow() == 720*15);
+    AlwaysAssertExit(allEQ(rowCols.time().getColumn(),
+                           bulkCols.time().getColumn()));
+    AlwaysAssertExit(allEQ(rowCols.scanNumber().getColumn(),
+                           bulkCols.scanNumber().getColumn()));
+    AlwaysAssertExit(allEQ(rowCols.antenna1().getColumn(),
+                           bulkCols.antenna1().getColumn()));
+    AlwaysAssertExit(allEQ(rowCols.antenna2().getColumn(),
+                           bulkCols.antenna2().getColumn()));
+    AlwaysAssertExit(allEQ(rowCols.weight().getColumn(),
+                           bulkCols.weight().getColumn()));
+    AlwaysAssertExit(allEQ(rowCols.sigma().getColumn(),
+                           bulkCols.sigma().getColumn()));
+    AlwaysAssertExit(allEQ(rowCols.data().getColumn(),
+                           bulkCols.data().getColumn()));
+    AlwaysAssertExit(allNearAbs(rowCols.uvw().getColumn(),
+                                bulkCols.uvw().getColumn(), 1e-4));
+    // The source sets, so some rows must be flagged.
+    Vector<Bool> flagRow = bulkCols.flagRow().getColumn();
+    AlwaysAssertExit(anyEQ(flagRow, True) && anyEQ(flagRow, False));
+    AlwaysAssertExit(allEQ(rowCols.flagRow().getColumn(), flagRow));
+    AlwaysAssertExit(allEQ(rowCols.flag().getColumn(),
+                           bulkCols.flag().getColumn()));
+    AlwaysAssertExit(rowTester.simulator_p->getMs()->pointing().nrow() ==
+                     bulkTester.simulator_p->getMs()->pointing().nrow());
+  }
+}
@@ -29,6 +29,8 @@
 #include <casacore/ms/MSSel/MSSelUtil.h>
 #include <casacore/casa/Arrays/Vector.h>
 #include <casacore/casa/Arrays/ArrayMath.h>
+#include <casacore/casa/BasicMath/Math.h>
+#include <casacore/casa/Containers/Block.h>
 #include <casacore/casa/Exceptions/Error.h>
 #include <casacore/casa/Utilities/Assert.h>
 
@@ -59,26 +61,73 @@ Array<Float> MSSelUtil<T>::diffData(const Array<T>& data,
   const Bool* pflag = flag.getStorage(deleteFlag);
   const Bool* pflagRow = flagRow.getStorage(deleteFlagRow);
   Float* pdiff = diff.getStorage(deleteDiff);
-  T zero(0.), sum;
-  Block<Float> buf(win);
-  // diffAxis == 1: channel, 2: row, 3: time
-  if (diffAxis!=1) {
-    // do row or time difference
-    Int offset=0, rowOffset=0;
-    for (Int i=0; i<nTime; i++, rowOffset+=nIfr) {
-      Int st=max(0,i-win/2), end=min(nTime-1,i-win/2+win-1);
-      for (Int ifr=0; ifr<nIfr; ifr++) {
-	if (!pflagRow[rowOffset+ifr]) {
-	  for (Int j=0; j<nXY; j++) {
+  const T zero(0.);
+  // Each row (time and interferometer) only depends on the input data,
+  // so the rows can be done in parallel.
+  const Int64 nRow=Int64(nTime)*nIfr;
+#ifdef _OPENMP
+#pragma omp parallel if(nRow*nXY > 65536)
+#endif
+  {
+    T sum;
+    Block<Float> buf(win);
+#ifdef _OPENMP
+#pragma omp for
+#endif
+    for (Int64 row=0; row<nRow; row++) {
+      if (pflagRow[row]) continue;
+      const Int i=row/nIfr;
+      Int64 offset=row*nXY;
+      // diffAxis == 1: channel, 2: row, 3: time
+      if (diffAxis!=1) {
+	// do row or time difference
+	Int st=max(0,i-win/2), end=min(nTime-1,i-win/2+win-1);
+	for (Int j=0; j<nXY; j++, offset++) {
+	  if (!pflag[offset]) {
+	    if (win==2) {
+	      if (i>0 && !pflag[offset-nOff]) {
+		pdiff[offset]=abs(pdata[offset]-pdata[offset-nOff]);
+	      }
+	    } else if (!doMedian) {
+	      Int count=0;
+	      sum=zero;
+	      for (Int64 k=st, koff=offset+(st-i)*nOff; k<end; k++, koff+=nOff) {
+		if (!pflag[koff]) {
+		  count++;
+		  sum+=pdata[koff];
+		}
+	      }
+	      if (count>1) sum/=count;
+	      if (count>0) pdiff[offset]=abs(pdata[offset]-sum);
+	    } else { // use median
+	      Int count=0;
+	      for (Int64 k=st, koff=offset+(st-i)*nOff; k<end; k++, koff+=nOff) {
+		if (!pflag[koff]) {
+		  buf[count++]=abs(pdata[offset]-pdata[koff]);
+		}
+	      }
+	      if (count>0) {
+		pdiff[offset]=medianInPlace(Vector<Float>(IPosition(1,count),
+							  buf.storage(),SHARE));
+	      }
+	    }
+	  }
+	}
+      } else {
+	// do channel difference
+	for (Int j=0; j<nChan; j++) {
+	  Int st=max(0,j-win/2), end=min(nChan-1,j-win/2+win-1);
+	  for (Int pol=0; pol<nCorr; pol++, offset++) {
 	    if (!pflag[offset]) {
 	      if (win==2) {
-		if (i>0 && !pflag[offset-nOff]) {
-		  pdiff[offset]=abs(pdata[offset]-pdata[offset-nOff]);
+		if (j>0 && !pflag[offset-nCorr]) {
+		  pdiff[offset]=abs(pdata[offset]-pdata[offset-nCorr]);
 		}
 	      } else if (!doMedian) {
 		Int count=0;
 		sum=zero;
-		for (Int k=st, koff=offset+(st-i)*nOff; k<end; k++, koff+=nOff) {
+		for (Int64 k=st, koff=offset+(st-j)*nCorr; k<end;
+		     k++, koff+=nCorr) {
 		  if (!pflag[koff]) {
 		    count++;
 		    sum+=pdata[koff];
@@ -88,67 +137,19 @@ Array<Float> MSSelUtil<T>::diffData(const Array<T>& data,
 		if (count>0) pdiff[offset]=abs(pdata[offset]-sum);
 	      } else { // use median
 		Int count=0;
-		for (Int k=st, koff=offset+(st-i)*nOff; k<end; k++, koff+=nOff) {
+		for (Int64 k=st, koff=offset+(st-j)*nCorr; k<end; 
+		     k++, koff+=nCorr) {
 		  if (!pflag[koff]) {
 		    buf[count++]=abs(pdata[offset]-pdata[koff]);
 		  }
 		}
 		if (count>0) {
-		  pdiff[offset]=median(Vector<Float>(buf.begin(),buf.begin()+count));
-	        }
-	      }
-	    }
-	    offset++;
-	  }
-	} else {
-	  offset+=nXY;
-	}
-      }
-    }
-  } else {
-    // do channel difference
-    Int offset=0, rowOffset=0;
-    for (Int i=0; i<nTime; i++, rowOffset+=nIfr) {
-      for (Int ifr=0; ifr<nIfr; ifr++) {
-	if (!pflagRow[rowOffset+ifr]) {
-	  for (Int j=0; j<nChan; j++) {
-	    Int st=max(0,j-win/2), end=min(nChan-1,j-win/2+win-1);
-	    for (Int pol=0; pol<nCorr; pol++) {
-	      if (!pflag[offset]) {
-		if (win==2) {
-		  if (j>0 && !pflag[offset-nCorr]) {
-		    pdiff[offset]=abs(pdata[offset]-pdata[offset-nCorr]);
-		  }
-		} else if (!doMedian) {
-		  Int count=0;
-		  sum=zero;
-		  for (Int k=st, koff=offset+(st-j)*nCorr; k<end;
-		       k++, koff+=nCorr) {
-		    if (!pflag[koff]) {
-		      count++;
-		      sum+=pdata[koff];
-		    }
-		  }
-		  if (count>1) sum/=count;
-		  if (count>0) pdiff[offset]=abs(pdata[offset]-sum);
-		} else { // use median
-		  Int count=0;
-		  for (Int k=st, koff=offset+(st-j)*nCorr; k<end; 
-		       k++, koff+=nCorr) {
-		    if (!pflag[koff]) {
-		      buf[count++]=abs(pdata[offset]-pdata[koff]);
-		    }
-		  }
-		  if (count>0) {
-		    pdiff[offset]=median(Vector<Float>(buf.begin(),buf.begin()+count));
-		  }
+		  pdiff[offset]=medianInPlace(Vector<Float>(IPosition(1,count),
+							    buf.storage(),SHARE));
 		}
 	      }
-	      offset++;
 	    }
 	  }
-	} else {
-	  offset+=nXY;
 	}
       }
     }
@@ -25,6 +25,7 @@
 //----------------------------------------------------------------------------
 
 #include <casacore/ms/MSSel/MSSelection.h>
+#include <casacore/ms/MSOper/MSMetaDataIndex.h>
 #include <casacore/ms/MSSel/MSAntennaGram.h>
 #include <casacore/ms/MSSel/MSCorrGram.h>
 #include <casacore/ms/MSSel/MSFieldGram.h>
@@ -40,6 +41,9 @@
 #include <casacore/ms/MeasurementSets/MSRange.h>
 #include <casacore/tables/TaQL/TableParse.h>
 #include <casacore/tables/TaQL/RecordGram.h>
+#include <casacore/tables/TaQL/ExprDerNode.h>
+#include <casacore/tables/TaQL/ExprNodeUtil.h>
+#include <casacore/tables/Tables/ScalarColumn.h>
 
 #include <casacore/ms/MeasurementSets/MSMainColumns.h>
 #include <casacore/measures/Measures/MeasureHolder.h>
@@ -724,6 +728,12 @@ namespace casacore { //# NAMESPACE CASACORE - BEGIN
 	      } // Switch
 	    
 	    condition = condition && node;
+	    addPartTEN(node, (exprOrder_p[i] == FIELD_EXPR ||
+			      exprOrder_p[i] == SPW_EXPR ||
+			      exprOrder_p[i] == SCAN_EXPR ||
+			      exprOrder_p[i] == OBSERVATION_EXPR ||
+			      exprOrder_p[i] == ARRAY_EXPR ||
+			      exprOrder_p[i] == STATE_EXPR));
 	  }//For
 	//
 	// Now parse the time expression.  Internally use the condition
@@ -752,6 +762,7 @@ namespace casacore { //# NAMESPACE CASACORE - BEGIN
 	      condition = *timeNode;
 	    else 
 	      condition = condition && *timeNode;
+	    addPartTEN(*timeNode, True);
 	  }
 	
 	fullTEN_p = condition;
@@ -893,6 +904,183 @@ namespace casacore { //# NAMESPACE CASACORE - BEGIN
     //    return baseGetSelectedMS_p(selectedMS, *ms_p, fullTEN_p, outMSName);
     return getSelectedTable(selectedMS, *ms_p, fullTEN_p, outMSName);
   }
+
+  //----------------------------------------------------------------------------
+
+  void MSSelection::addPartTEN(const TableExprNode& node, Bool singleColumn)
+  {
+    if (node.isNull()) return;
+    if (singleColumn)
+      {
+	// Check that the node uses a single Int or Double scalar column.
+	std::vector<TableExprNodeRep*> colNodes =
+	  TableExprNodeUtil::getColumnNodes(node.getRep().get());
+	String name;
+	for (uInt i=0; i<colNodes.size() && singleColumn; i++)
+	  {
+	    const TableExprNodeColumn* colNode =
+	      dynamic_cast<const TableExprNodeColumn*>(colNodes[i]);
+	    if (colNode == NULL) singleColumn = False;
+	    else
+	      {
+		const ColumnDesc& desc = colNode->getColumn().columnDesc();
+		if (i == 0) name = desc.name();
+		singleColumn = (desc.name() == name && desc.isScalar() &&
+				(desc.dataType() == TpInt ||
+				 desc.dataType() == TpDouble));
+	      }
+	  }
+	if (singleColumn && !colNodes.empty())
+	  {
+	    columnTENs_p.push_back(node);
+	    return;
+	  }
+      }
+    residualTEN_p = residualTEN_p && node;
+  }
+
+  //----------------------------------------------------------------------------
+
+  namespace {
+    // A single-column part of the selection, holding the column values
+    // of the current block of rows and the result for the last value.
+    struct MSSelColumnPart {
+      TableExprNode node;
+      TableColumn column;
+      MSMainEnums::PredefinedColumns msColumn;
+      Bool isInt;
+      Vector<Int> intValues;
+      Vector<Double> doubleValues;
+      Bool hasLast;
+      Int lastInt;
+      Double lastDouble;
+      Bool lastResult;
+
+      Bool changed(rownr_t i, rownr_t j) const
+      {
+	return isInt ? intValues[i] != intValues[j]
+	             : doubleValues[i] != doubleValues[j];
+      }
+    };
+
+    // Add a range of rows to the row ranges (triplets start,end,incr).
+    void addRowRange(std::vector<rownr_t>& ranges, rownr_t start, rownr_t end)
+    {
+      if (!ranges.empty() && ranges[ranges.size()-2] + 1 == start) {
+	ranges[ranges.size()-2] = end;
+      } else {
+	ranges.push_back(start);
+	ranges.push_back(end);
+	ranges.push_back(1);
+      }
+    }
+  }
+
+  RefRows MSSelection::getSelectedRows(const MeasurementSet* ms)
+  {
+    TableExprNode fullTEN = getTEN(ms);
+    if ((ms_p == NULL) || ms_p->isNull())
+      throw(MSSelectionError("MSSelection::getSelectedRows() called without setting the parent MS.\n"
+			     "Hint: Need to use MSSelection::resetMS() perhaps?"));
+    const rownr_t nrow = ms_p->nrow();
+    std::vector<rownr_t> ranges;
+    if (nrow == 0) return RefRows(Vector<rownr_t>(), True);
+    if (fullTEN.isNull() || fullTEN.getRep()->isConstant())
+      {
+	if (fullTEN.isNull() || fullTEN.getBool(TableExprId(0)))
+	  addRowRange(ranges, 0, nrow-1);
+	return RefRows(Vector<rownr_t>(ranges), True);
+      }
+    //
+    // The column values are taken from a stored index if there is one.
+    // Note that the index is never built here, because that requires
+    // reading all id columns.
+    //
+    std::shared_ptr<const MSMetaDataIndex> index = MSMetaDataIndex::stored(*ms_p);
+    if (index && index->nrow() != nrow) index.reset();
+    std::vector<MSSelColumnPart> parts(columnTENs_p.size());
+    for (uInt k=0; k<parts.size(); k++)
+      {
+	MSSelColumnPart& part = parts[k];
+	part.node = columnTENs_p[k];
+	std::vector<TableExprNodeRep*> colNodes =
+	  TableExprNodeUtil::getColumnNodes(part.node.getRep().get());
+	part.column = dynamic_cast<const TableExprNodeColumn*>(colNodes[0])->getColumn();
+	const ColumnDesc& desc = part.column.columnDesc();
+	part.msColumn = MeasurementSet::columnType(desc.name());
+	part.isInt = (desc.dataType() == TpInt);
+	part.hasLast = False;
+	part.lastInt = 0;
+	part.lastDouble = 0;
+	part.lastResult = False;
+      }
+    //
+    // Process the rows in blocks.  A block is split into segments in
+    // which none of the columns changes value, so the column parts
+    // only need to be evaluated for the first row of a segment.
+    //
+    static const rownr_t rowsInBlock = 1000000;
+    for (rownr_t row=0; row<nrow; row+=rowsInBlock)
+      {
+	rownr_t nrows = std::min(rowsInBlock, nrow - row);
+	Slicer rows(IPosition(1, row), IPosition(1, nrows));
+	for (uInt k=0; k<parts.size(); k++)
+	  {
+	    MSSelColumnPart& part = parts[k];
+	    if (part.isInt)
+	      {
+		if (!index || !index->getColumn(part.intValues, part.msColumn,
+						row, nrows))
+		  ScalarColumn<Int>(part.column).getColumnRange(rows, part.intValues, True);
+	      }
+	    else
+	      {
+		if (!index || !index->getColumn(part.doubleValues, part.msColumn,
+						row, nrows))
+		  ScalarColumn<Double>(part.column).getColumnRange(rows, part.doubleValues, True);
+	      }
+	  }
+	rownr_t start = 0;
+	while (start < nrows)
+	  {
+	    rownr_t end = start + 1;
+	    Bool changed = False;
+	    while (end < nrows && !changed)
+	      {
+		for (uInt k=0; k<parts.size() && !changed; k++)
+		  changed = parts[k].changed(start, end);
+		if (!changed) end++;
+	      }
+	    Bool selected = True;
+	    for (uInt k=0; k<parts.size() && selected; k++)
+	      {
+		MSSelColumnPart& part = parts[k];
+		Bool same = part.hasLast &&
+		  (part.isInt ? part.intValues[start] == part.lastInt
+		              : part.doubleValues[start] == part.lastDouble);
+		if (!same)
+		  {
+		    part.lastResult = part.node.getBool(TableExprId(row+start));
+		    part.lastInt = part.isInt ? part.intValues[start] : 0;
+		    part.lastDouble = part.isInt ? 0 : part.doubleValues[start];
+		    part.hasLast = True;
+		  }
+		selected = part.lastResult;
+	      }
+	    if (selected)
+	      {
+		if (residualTEN_p.isNull())
+		  addRowRange(ranges, row+start, row+end-1);
+		else
+		  for (rownr_t i=start; i<end; i++)
+		    if (residualTEN_p.getBool(TableExprId(row+i)))
+		      addRowRange(ranges, row+i, row+i);
+	      }
+	    start = end;
+	  }
+      }
+    return RefRows(Vector<rownr_t>(ranges), True);
+  }
   
   //----------------------------------------------------------------------------
   
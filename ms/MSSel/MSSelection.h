@@ -38,7 +38,9 @@
 #include <casacore/ms/MSSel/MSSelectionError.h>
 #include <casacore/ms/MSSel/MSSelectionErrorHandler.h>
 #include <casacore/ms/MSSel/MSSelectableTable.h>
+#include <casacore/tables/Tables/RefRows.h>
 #include <map>
+#include <vector>
 
 namespace casacore { //# NAMESPACE CASACORE - BEGIN
 
@@ -474,9 +476,20 @@ namespace casacore { //# NAMESPACE CASACORE - BEGIN
     // for on-the-fly in-row selection.
     Bool getSelectedMS(MeasurementSet& selectedMS,
 		       const String& outMSName="");
+
+    // Return the numbers of the rows selected in the MS as a compressed
+    // set of row ranges.  Unlike getSelectedMS(), the full TEN is not
+    // evaluated for each row.  The selections on a single column
+    // (field, spw, scan, observation, array, state and time) are
+    // evaluated once per run of equal values in their column; the
+    // columns are taken from the MSMetaDataIndex stored in the MS if
+    // available.  The remaining expressions (e.g. antenna or uv-distance)
+    // are only evaluated for the rows passing those selections.
+    RefRows getSelectedRows(const MeasurementSet* ms=NULL);
     
     void resetMS(const MeasurementSet& ms) {resetTEN(); ms_p=&ms;};
-    void resetTEN() {fullTEN_p=TableExprNode();};
+    void resetTEN() {fullTEN_p=TableExprNode(); columnTENs_p.clear();
+                     residualTEN_p=TableExprNode();};
     
     
     // The MSSelection object is designed to be re-usable object.  The
@@ -602,8 +615,15 @@ namespace casacore { //# NAMESPACE CASACORE - BEGIN
     
     // Convert an MS select string to TaQL
     //   const String msToTaQL(const String& msSelect) {};
+
+    // Add the TEN of an expression to columnTENs_p if it is a selection
+    // on a single column, otherwise to residualTEN_p.
+    void addPartTEN(const TableExprNode& node, Bool singleColumn);
     
     TableExprNode fullTEN_p;
+    // The parts of fullTEN_p used by getSelectedRows().
+    std::vector<TableExprNode> columnTENs_p;
+    TableExprNode residualTEN_p;
     const MeasurementSet *ms_p;
     // Selection expressions
     String antennaExpr_p;
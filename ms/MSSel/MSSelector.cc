@@ -1703,9 +1703,9 @@ void MSSelector::getAveragedData(Array<Complex>& avData, const Array<Bool>& flag
 	}
 	// do the polarization conversion or selection
 	if (convert_p) {
-		Array<Complex> out;
-		stokesConverter_p.convert(out,avData);
-		avData.reference(out);
+		Cube<Complex> cube(avData);
+		stokesConverter_p.convert(cube);
+		avData.reference(cube);
 	} else if (polIndex_p.nelements()>0) {
 		Int n=polIndex_p.nelements();
 		Array<Complex> out(IPosition(3,n,nChan,nRow));
@@ -0,0 +1,163 @@
+//# tMSSelUtil.cc: test program for MSSelUtil
+//# Copyright (C) 2026
+//# Associated Universities, Inc. Washington DC, USA.
+//#
+//# This program is free software; you can redistribute it and/or modify it
+//# under the terms of the GNU General Public License as published by the Free
+//# Software Foundation; either version 2 of the License, or (at your option)
+//# any later version.
+//#
+//# This program is distributed in the hope that it will be useful, but WITHOUT
+//# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+//# more details.
+//#
+//# You should have received a copy of the GNU General Public License along
+//# with this program; if not, write to the Free Software Foundation, Inc.,
+//# 675 Massachusetts Ave, Cambridge, MA 02139, USA.
+//#
+//# Correspondence concerning AIPS++ should be addressed as follows:
+//#        Internet email: aips2-request@nrao.edu.
+//#        Postal address: AIPS++ Project Office
+//#                        National Radio Astronomy Observatory
+//#                        520 Edgemont Road
+//#                        Charlottesville, VA 22903-2475 USA
+
+#include <casacore/ms/MSSel/MSSelUtil.h>
+#include <casacore/casa/Arrays/ArrayLogical.h>
+#include <casacore/casa/Arrays/ArrayMath.h>
+#include <casacore/casa/BasicMath/Math.h>
+#include <casacore/casa/Utilities/Assert.h>
+#include <casacore/casa/Exceptions/Error.h>
+#include <casacore/casa/iostream.h>
+
+#include <casacore/casa/namespace.h>
+
+// The buffer is large enough to be differenced in parallel.
+const Int nCorr = 2;
+const Int nChan = 64;
+const Int nIfr = 10;
+const Int nTime = 60;
+
+// The value of a cell is linear in channel and time with a slope
+// depending on the interferometer.
+Float value(Int chan, Int ifr, Int time)
+{
+  return (ifr + 1) * time + 0.5 * (ifr + 1) * chan;
+}
+
+template<class T>
+Array<T> makeData(Array<Bool>& flag, Array<Bool>& flagRow)
+{
+  const IPosition shape(4, nCorr, nChan, nIfr, nTime);
+  Array<T> data(shape);
+  flag.resize(shape);
+  flag = False;
+  flagRow.resize(IPosition(2, nIfr, nTime));
+  flagRow = False;
+  for (Int t=0; t<nTime; ++t) {
+    for (Int ifr=0; ifr<nIfr; ++ifr) {
+      for (Int c=0; c<nChan; ++c) {
+        for (Int p=0; p<nCorr; ++p) {
+          data(IPosition(4, p, c, ifr, t)) = T(value(c, ifr, t));
+        }
+      }
+    }
+  }
+  // Flag a row and a single cell.
+  flagRow(IPosition(2, 3, 20)) = True;
+  flag(IPosition(4, 1, 10, 5, 30)) = True;
+  return data;
+}
+
+// Check the result of differencing with the previous time or channel.
+void checkPrevious(const Array<Float>& diff, Int axis)
+{
+  for (Int t=0; t<nTime; ++t) {
+    for (Int ifr=0; ifr<nIfr; ++ifr) {
+      for (Int c=0; c<nChan; ++c) {
+        for (Int p=0; p<nCorr; ++p) {
+          const Int prev = (axis == 1  ?  c : t);
+          Float expected = (axis == 1  ?  0.5 * (ifr + 1) : ifr + 1);
+          if (prev == 0 || (ifr == 3 && t == 20)) {
+            expected = 0;
+          } else if (ifr == 5 && p == 1 &&
+                     ((t == 30 && (c == 10 || (axis == 1 && c == 11))) ||
+                      (axis != 1 && t == 31 && c == 10))) {
+            // the flagged cell and the next one
+            expected = 0;
+          }
+          AlwaysAssertExit(near(diff(IPosition(4, p, c, ifr, t)), expected));
+        }
+      }
+    }
+  }
+}
+
+// Check the median absolute difference over a window of 3 times.
+// The window holds the previous time and the time itself, so the
+// median is the mean of the previous difference and zero.
+// At the last time the window only holds the previous time.
+void checkMedian(const Array<Float>& diff)
+{
+  for (Int t=0; t<nTime; ++t) {
+    for (Int ifr=0; ifr<nIfr; ++ifr) {
+      if (ifr == 3 && t == 20) {
+        continue;
+      }
+      for (Int c=0; c<nChan; ++c) {
+        for (Int p=0; p<nCorr; ++p) {
+          Float expected = (t == 0  ?  0 : 0.5 * (ifr + 1));
+          if (t == nTime-1) {
+            expected = ifr + 1;
+          }
+          if (ifr == 5 && p == 1 && c == 10 && t >= 30 && t <= 31) {
+            // the flagged cell and the next one (only the zero difference)
+            expected = 0;
+          }
+          AlwaysAssertExit(near(diff(IPosition(4, p, c, ifr, t)), expected));
+        }
+      }
+    }
+  }
+}
+
+template<class T>
+void doTest()
+{
+  Array<Bool> flag, flagRow;
+  Array<T> data = makeData<T>(flag, flagRow);
+  checkPrevious(MSSelUtil<T>::diffData(data, flag, flagRow, 3, 2), 3);
+  checkPrevious(MSSelUtil<T>::diffData(data, flag, flagRow, 1, 2), 1);
+  checkMedian(MSSelUtil<T>::diffData(data, flag, flagRow, 3, 3, True));
+  // A 3-dim buffer gives the same result as one interferometer.
+  Array<T> data3 = data(IPosition(4, 0, 0, 2, 0),
+                        IPosition(4, nCorr-1, nChan-1, 2, nTime-1)).reform(
+                          IPosition(3, nCorr, nChan, nTime));
+  Array<Bool> flag3 = flag(IPosition(4, 0, 0, 2, 0),
+                           IPosition(4, nCorr-1, nChan-1, 2, nTime-1)).reform(
+                             IPosition(3, nCorr, nChan, nTime));
+  Array<Bool> flagRow3 = flagRow(IPosition(2, 2, 0),
+                                 IPosition(2, 2, nTime-1)).reform(
+                                   IPosition(1, nTime));
+  Array<Float> diff = MSSelUtil<T>::diffData(data, flag, flagRow, 3, 2);
+  Array<Float> diff3 = MSSelUtil<T>::diffData(data3, flag3, flagRow3, 3, 2);
+  AlwaysAssertExit(allNear(diff3, diff(IPosition(4, 0, 0, 2, 0),
+                                       IPosition(4, nCorr-1, nChan-1, 2,
+                                                 nTime-1)).reform(
+                                         IPosition(3, nCorr, nChan, nTime)),
+                           1e-6));
+}
+
+int main()
+{
+  try {
+    doTest<Float>();
+    doTest<Complex>();
+  } catch (const std::exception& x) {
+    cout << "Unexpected exception: " << x.what() << endl;
+    return 1;
+  }
+  cout << "OK" << endl;
+  return 0;
+}
@@ -0,0 +1,284 @@
+//# tMSSelectionRows.cc: test program for MSSelection::getSelectedRows
+//# Copyright (C) 2026
+//# Associated Universities, Inc. Washington DC, USA.
+//#
+//# This program is free software; you can redistribute it and/or modify it
+//# under the terms of the GNU General Public License as published by the Free
+//# Software Foundation; either version 2 of the License, or (at your option)
+//# any later version.
+//#
+//# This program is distributed in the hope that it will be useful, but WITHOUT
+//# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+//# more details.
+//#
+//# You should have received a copy of the GNU General Public License along
+//# with this program; if not, write to the Free Software Foundation, Inc.,
+//# 675 Massachusetts Ave, Cambridge, MA 02139, USA.
+//#
+//# Correspondence concerning AIPS++ should be addressed as follows:
+//#        Internet email: aips2-request@nrao.edu.
+//#        Postal address: AIPS++ Project Office
+//#                        National Radio Astronomy Observatory
+//#                        520 Edgemont Road
+//#                        Charlottesville, VA 22903-2475 USA
+
+
+#include <casacore/ms/MSSel/MSSelection.h>
+#include <casacore/ms/MSOper/MSMetaDataIndex.h>
+#include <casacore/ms/MeasurementSets/MeasurementSet.h>
+#include <casacore/ms/MeasurementSets/MSColumns.h>
+#include <casacore/tables/Tables/SetupNewTab.h>
+#include <casacore/tables/Tables/TableUtil.h>
+#include <casacore/tables/Tables/RefRows.h>
+#include <casacore/tables/TaQL/ExprNode.h>
+#include <casacore/casa/Arrays/ArrayLogical.h>
+#include <casacore/casa/Arrays/ArrayMath.h>
+#include <casacore/casa/OS/DirectoryIterator.h>
+#include <casacore/casa/Utilities/Assert.h>
+#include <casacore/casa/Exceptions/Error.h>
+#include <casacore/casa/iostream.h>
+#include <ctime>
+
+#include <casacore/casa/namespace.h>
+
+// <summary>
+// Test program for MSSelection::getSelectedRows. The selected rows must be
+// the same as the rows selected by the full TaQL expression.
+// </summary>
+
+const String msName("tMSSelectionRows_tmp.ms");
+const Int nAnt = 4;
+const Int nbl = nAnt * (nAnt + 1) / 2;
+const Int nTime = 50;
+// The spectral window of each data description. Spectral window 0 is
+// used by two data descriptions; the last one is only used in the first
+// 20 time slots.
+const Int nDD = 4;
+const Int ddSpw[nDD] = {2, 0, 1, 0};
+const Int nTimeLastDD = 20;
+// The start time is MJD 50000 (1995/10/10/00:00:00); the time slots
+// are 10 seconds.
+const Double startTime = 50000. * 86400.;
+
+// Create an MS shaped for row selection. Its rows are ordered in time;
+// each time slot contains all baselines (including autocorrelations) of
+// each data description in turn, so the column runs of DATA_DESC_ID are
+// shorter than those of the time, scan and field.
+// Scan n covers time slots 10*(n-1) till 10*n; field f covers time slots
+// 20*f till 20*(f+1).
+void createMS()
+{
+  SetupNewTable newtab(msName, MS::requiredTableDesc(), Table::New);
+  MeasurementSet ms(newtab);
+  ms.createDefaultSubtables(Table::New);
+  MSColumns cols(ms);
+  ms.antenna().addRow(nAnt);
+  for (Int i=0; i<nAnt; ++i) {
+    cols.antenna().name().put(i, "A" + String::toString(i));
+    cols.antenna().station().put(i, "S" + String::toString(i));
+    cols.antenna().dishDiameter().put(i, 25.);
+  }
+  ms.field().addRow(3);
+  for (Int i=0; i<3; ++i) {
+    cols.field().name().put(i, "F" + String::toString(i));
+    cols.field().numPoly().put(i, 0);
+  }
+  const Int nChan = 4;
+  ms.spectralWindow().addRow(3);
+  for (Int i=0; i<3; ++i) {
+    Vector<Double> freq(nChan);
+    indgen(freq, 1e9 * (i+1), 1e6);
+    cols.spectralWindow().name().put(i, "SPW" + String::toString(i));
+    cols.spectralWindow().numChan().put(i, nChan);
+    cols.spectralWindow().chanFreq().put(i, freq);
+    cols.spectralWindow().chanWidth().put(i, Vector<Double>(nChan, 1e6));
+    cols.spectralWindow().effectiveBW().put(i, Vector<Double>(nChan, 1e6));
+    cols.spectralWindow().resolution().put(i, Vector<Double>(nChan, 1e6));
+    cols.spectralWindow().refFrequency().put(i, freq[0]);
+    cols.spectralWindow().totalBandwidth().put(i, nChan * 1e6);
+    cols.spectralWindow().flagRow().put(i, False);
+  }
+  ms.dataDescription().addRow(nDD);
+  for (Int i=0; i<nDD; ++i) {
+    cols.dataDescription().spectralWindowId().put(i, ddSpw[i]);
+    cols.dataDescription().polarizationId().put(i, i == nDD-1 ? 1 : 0);
+    cols.dataDescription().flagRow().put(i, False);
+  }
+  ms.addRow(nbl * ((nDD-1) * nTime + nTimeLastDD));
+  rownr_t row = 0;
+  for (Int t=0; t<nTime; ++t) {
+    for (Int dd=0; dd<(t < nTimeLastDD ? nDD : nDD-1); ++dd) {
+      for (Int a1=0; a1<nAnt; ++a1) {
+        for (Int a2=a1; a2<nAnt; ++a2) {
+          cols.time().put(row, startTime + 10 * t);
+          cols.interval().put(row, 10.);
+          cols.exposure().put(row, 10.);
+          cols.scanNumber().put(row, 1 + t / 10);
+          cols.fieldId().put(row, t / 20);
+          cols.dataDescId().put(row, dd);
+          cols.antenna1().put(row, a1);
+          cols.antenna2().put(row, a2);
+          cols.flagRow().put(row, False);
+          ++row;
+        }
+      }
+    }
+  }
+  AlwaysAssertExit(row == ms.nrow());
+}
+
+// Check that getSelectedRows gives the same rows as the full TEN.
+// The number of rows is not checked if nexp is negative.
+void checkRows(MSSelection& mss, const MeasurementSet& ms, Int64 nexp)
+{
+  RefRows rows = mss.getSelectedRows(&ms);
+  AlwaysAssertExit(rows.isSliced());
+  TableExprNode node = mss.getTEN(&ms);
+  Vector<rownr_t> expected(ms.nrow());
+  if (node.isNull()) {
+    indgen(expected);
+  } else {
+    expected.reference(ms(node).rowNumbers(ms));
+  }
+  Vector<rownr_t> result = rows.convert();
+  AlwaysAssertExit(nexp < 0 || Int64(result.size()) == nexp);
+  AlwaysAssertExit(allEQ(result, expected));
+}
+
+void checkSelections(const MeasurementSet& ms)
+{
+  // The number of rows in a time slot with and without the last DD.
+  const Int64 nAll = nDD * nbl;
+  const Int64 nPart = (nDD-1) * nbl;
+  {
+    MSSelection mss;
+    checkRows(mss, ms, ms.nrow());
+  }
+  {
+    MSSelection mss;
+    mss.setScanExpr("2");
+    checkRows(mss, ms, 10 * nAll);
+    // A single scan results in a single row range.
+    AlwaysAssertExit(mss.getSelectedRows(&ms).rowVector().size() == 3);
+  }
+  {
+    // The last scan ends at the last row.
+    MSSelection mss;
+    mss.setScanExpr("5");
+    RefRows rows = mss.getSelectedRows(&ms);
+    AlwaysAssertExit(rows.rowVector().size() == 3);
+    AlwaysAssertExit(rows.rowVector()[1] == ms.nrow() - 1);
+    checkRows(mss, ms, 10 * nPart);
+  }
+  {
+    MSSelection mss;
+    mss.setScanExpr("2,4~5");
+    mss.setFieldExpr("1");
+    checkRows(mss, ms, 10 * nPart);
+  }
+  {
+    // Scan 2 is observed on field F0 only.
+    MSSelection mss;
+    mss.setScanExpr("2");
+    mss.setFieldExpr("F2");
+    checkRows(mss, ms, 0);
+  }
+  {
+    // Spectral window 0 is used by two data descriptions.
+    MSSelection mss;
+    mss.setSpwExpr("0");
+    checkRows(mss, ms, (2 * nTimeLastDD + (nTime - nTimeLastDD)) * nbl);
+  }
+  {
+    MSSelection mss;
+    mss.setSpwExpr("1,2");
+    mss.setScanExpr("1");
+    checkRows(mss, ms, 10 * 2 * nbl);
+  }
+  {
+    // A channel selection does not change the selected rows.
+    MSSelection mss;
+    mss.setSpwExpr("0:1~2");
+    mss.setScanExpr("5");
+    checkRows(mss, ms, 10 * nbl);
+  }
+  {
+    MSSelection mss;
+    mss.setScanExpr("3");
+    mss.setAntennaExpr("A0&A2");
+    checkRows(mss, ms, 10 * (nDD-1));
+  }
+  {
+    MSSelection mss;
+    mss.setAntennaExpr("A1&&&");
+    mss.setFieldExpr("F0,F2");
+    checkRows(mss, ms, 20 * nDD + 10 * (nDD-1));
+  }
+  {
+    // Two baselines, so the antenna part selects single rows.
+    MSSelection mss;
+    mss.setAntennaExpr("A0&A1;A2&A3");
+    mss.setSpwExpr("2");
+    checkRows(mss, ms, 2 * nTime);
+  }
+  {
+    // The bounds are halfway between time slots 10 and 19.
+    MSSelection mss;
+    mss.setTimeExpr("1995/10/10/00:01:35~1995/10/10/00:03:15");
+    checkRows(mss, ms, 10 * nAll);
+  }
+  {
+    // The edges of an inclusive range are widened by half the exposure.
+    MSSelection mss;
+    mss.setTimeExpr("[1995/10/10/00:01:40~1995/10/10/00:03:10]");
+    checkRows(mss, ms, 10 * nAll);
+  }
+  {
+    // The bounds are exactly on time slots 20 and 30; whether they are
+    // selected depends on the rounding of the converted times, so only
+    // check that both ways give the same rows.
+    MSSelection mss;
+    mss.setTimeExpr("1995/10/10/00:03:20~1995/10/10/00:05:00");
+    checkRows(mss, ms, -1);
+  }
+  {
+    // Time slots 19 and 20, where the last DD stops.
+    MSSelection mss;
+    mss.setTimeExpr("1995/10/10/00:03:05~1995/10/10/00:03:25");
+    mss.setSpwExpr("0");
+    checkRows(mss, ms, 3 * nbl);
+  }
+}
+
+int main()
+{
+  try {
+    createMS();
+    {
+      MeasurementSet ms(msName);
+      checkSelections(ms);
+      // A selection of the MS.
+      MeasurementSet sel(ms(ms.col("ANTENNA1") == 1));
+      MSSelection mss;
+      mss.setScanExpr("1,5");
+      checkRows(mss, sel, 10 * (nDD + nDD-1) * (nAnt - 1));
+    }
+    // Store an index of the MS, so its id columns are used.
+    for (DirectoryIterator iter(msName); ! iter.pastEnd(); iter++) {
+      iter.file().touch(uInt(time(0)) - 10);
+    }
+    {
+      MeasurementSet ms(msName);
+      MSMetaDataIndex::create(ms, True);
+      AlwaysAssertExit(MSMetaDataIndex::stored(ms) != nullptr);
+      checkSelections(ms);
+    }
+    TableUtil::deleteTable(msName);
+  } catch (const std::exception& x) {
+    cout << "Unexpected exception: " << x.what() << endl;
+    return 1;
+  }
+  cout << "OK" << endl;
+  return 0;
+}
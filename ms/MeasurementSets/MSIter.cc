@@ -29,6 +29,7 @@
 #include <casacore/casa/Arrays/Slice.h>
 #include <casacore/casa/Exceptions/Error.h>
 #include <casacore/tables/Tables/TableIter.h>
+#include <casacore/tables/Tables/ArrayColumn.h>
 #include <casacore/casa/Utilities/Assert.h>
 #include <casacore/casa/Utilities/GenSort.h>
 #include <casacore/casa/Arrays/Slicer.h>
@@ -42,6 +43,15 @@
 #include <casacore/tables/Tables/TableRecord.h>
 #include <casacore/casa/Logging/LogIO.h>
 #include <casacore/casa/iostream.h>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#ifdef USE_THREADS
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
 
 namespace casacore { //# NAMESPACE CASACORE - BEGIN
 
@@ -387,9 +397,16 @@ void MSIter::construct(const Block<Int>& sortColumns,
     }
 
     if (!useIn && !useSorted) {
-      // we have to resort the input; enclose in >>> <<< to avoid pollution of test .out file
-      if (aips_debug) cout << ">>>"<<endl<<"MSIter::construct - resorting table"<<endl<<"<<<"<<endl;
-      sorted = bms_p[i].sort(columns, Sort::Ascending, Sort::QuickSort);
+      if (isSorted(bms_p[i], columns)) {
+        // the input is already in the iteration order, so it can be used
+        // as such (and there is no need to store a sorted copy)
+        useIn=True;
+        store=False;
+      } else {
+        // we have to resort the input; enclose in >>> <<< to avoid pollution of test .out file
+        if (aips_debug) cout << ">>>"<<endl<<"MSIter::construct - resorting table"<<endl<<"<<<"<<endl;
+        sorted = bms_p[i].sort(columns, Sort::Ascending, Sort::ParSort);
+      }
     }
 
     // Only store if globally requested _and_ locally decided
@@ -421,6 +438,52 @@ void MSIter::construct(const Block<Int>& sortColumns,
 
 }
 
+// Check if the values are in ascending order for the row pairs not decided
+// yet by the previous sort columns. Pairs with ascending values get decided.
+template<typename T>
+static Bool isSortedColumn (const Vector<T>& values, std::vector<Bool>& decided)
+{
+  const T* v = values.data();
+  for (size_t i=0; i<decided.size(); i++) {
+    if (!decided[i]) {
+      if (v[i+1] < v[i]) return False;
+      decided[i] = (v[i] < v[i+1]);
+    }
+  }
+  return True;
+}
+
+Bool MSIter::isSorted(const Table& tab, const Block<String>& columns)
+{
+  rownr_t nrow = tab.nrow();
+  if (nrow < 2) return True;
+  // decided[i] tells if rows i and i+1 are known to be in the right order.
+  // A time interval binning does not change the order of the values,
+  // so the values themselves can be compared.
+  std::vector<Bool> decided(nrow-1, False);
+  for (size_t i=0; i<columns.nelements(); i++) {
+    Bool ok;
+    switch (tab.tableDesc()[columns[i]].dataType()) {
+    case TpInt:
+      ok = isSortedColumn (ScalarColumn<Int>(tab, columns[i]).getColumn(),
+                           decided);
+      break;
+    case TpDouble:
+      ok = isSortedColumn (ScalarColumn<Double>(tab, columns[i]).getColumn(),
+                           decided);
+      break;
+    case TpBool:
+      ok = isSortedColumn (ScalarColumn<Bool>(tab, columns[i]).getColumn(),
+                           decided);
+      break;
+    default:
+      ok = False;
+    }
+    if (!ok) return False;
+  }
+  return True;
+}
+
 MSIter::MSIter(const MSIter& other)
 	: nMS_p(0), storeSorted_p(False), allBeamOffsetsZero_p(True)
 {
@@ -545,6 +608,124 @@ MSIter & MSIter::operator++()
 }
 
 
+void MSIter::fillChunk(MSIterChunk& chunk, size_t chunkNr,
+                       uInt columns) const
+{
+  chunk.chunkNr = chunkNr;
+  chunk.msId = curMS_p;
+  chunk.arrayId = arrayId();
+  chunk.fieldId = fieldId();
+  chunk.dataDescId = dataDescriptionId();
+  chunk.spectralWindowId = spectralWindowId();
+  chunk.polarizationId = polarizationId();
+  chunk.rowNumbers = curTable_p.rowNumbers(bms_p[curMS_p], True);
+  ScalarColumn<Double>(curTable_p, MS::columnName(MS::TIME)).
+    getColumn(chunk.time, True);
+  ScalarColumn<Int>(curTable_p, MS::columnName(MS::ANTENNA1)).
+    getColumn(chunk.antenna1, True);
+  ScalarColumn<Int>(curTable_p, MS::columnName(MS::ANTENNA2)).
+    getColumn(chunk.antenna2, True);
+  const TableDesc& td = curTable_p.tableDesc();
+  if ((columns & ChunkData) && td.isColumn(MS::columnName(MS::DATA))) {
+    ArrayColumn<Complex>(curTable_p, MS::columnName(MS::DATA)).
+      getColumn(chunk.data, True);
+  }
+  if ((columns & ChunkFlag) && td.isColumn(MS::columnName(MS::FLAG))) {
+    ArrayColumn<Bool>(curTable_p, MS::columnName(MS::FLAG)).
+      getColumn(chunk.flag, True);
+  }
+  if ((columns & ChunkWeight) && td.isColumn(MS::columnName(MS::WEIGHT))) {
+    ArrayColumn<Float>(curTable_p, MS::columnName(MS::WEIGHT)).
+      getColumn(chunk.weight, True);
+  }
+  if ((columns & ChunkUVW) && td.isColumn(MS::columnName(MS::UVW))) {
+    ArrayColumn<Double>(curTable_p, MS::columnName(MS::UVW)).
+      getColumn(chunk.uvw, True);
+  }
+}
+
+void MSIter::forEachChunk(const std::function<void(const MSIterChunk&)>& func,
+                          uInt columns, uInt nthreads)
+{
+  if ((columns & (ChunkData | ChunkFlag | ChunkWeight))  &&  !ddInSort_p) {
+    throw AipsError("MSIter::forEachChunk - DATA, FLAG and WEIGHT can only "
+                    "be read if DATA_DESC_ID is an iteration column");
+  }
+#ifdef USE_THREADS
+  // This thread reads the chunks and puts them in a queue of limited
+  // length, from which the worker threads take them.
+  nthreads = std::max(1u, nthreads);
+  const size_t maxQueued = nthreads + 1;
+  std::mutex mutex;
+  std::condition_variable cond;
+  std::deque<std::shared_ptr<MSIterChunk>> queue;
+  Bool done = False;
+  std::exception_ptr excp;
+  auto worker = [&]() {
+    while (True) {
+      std::shared_ptr<MSIterChunk> chunk;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        cond.wait (lock, [&]() {return !queue.empty() || done;});
+        if (queue.empty() || excp) return;
+        chunk = queue.front();
+        queue.pop_front();
+      }
+      cond.notify_all();
+      try {
+        func (*chunk);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!excp) excp = std::current_exception();
+        done = True;
+        cond.notify_all();
+        return;
+      }
+    }
+  };
+  std::vector<std::thread> workers;
+  for (uInt i=0; i<nthreads; i++) {
+    workers.emplace_back (worker);
+  }
+  try {
+    size_t chunkNr = 0;
+    for (origin(); more(); (*this)++) {
+      std::shared_ptr<MSIterChunk> chunk(new MSIterChunk());
+      fillChunk (*chunk, chunkNr++, columns);
+      std::unique_lock<std::mutex> lock(mutex);
+      cond.wait (lock, [&]() {return queue.size() < maxQueued || done;});
+      if (done) break;
+      queue.push_back (chunk);
+      lock.unlock();
+      cond.notify_all();
+    }
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!excp) excp = std::current_exception();
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    done = True;
+  }
+  cond.notify_all();
+  for (auto& thr : workers) {
+    thr.join();
+  }
+  more_p = False;
+  if (excp) {
+    std::rethrow_exception (excp);
+  }
+#else
+  (void)nthreads;
+  size_t chunkNr = 0;
+  for (origin(); more(); (*this)++) {
+    MSIterChunk chunk;
+    fillChunk (chunk, chunkNr++, columns);
+    func (chunk);
+  }
+#endif
+}
+
 void MSIter::advance()
 {
   newMS_p=newArrayId_p=newSpectralWindowId_p=newPolarizationId_p=
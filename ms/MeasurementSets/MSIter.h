@@ -38,6 +38,7 @@
 #include <casacore/casa/BasicSL/String.h>
 #include <casacore/scimath/Mathematics/SquareMatrix.h>
 #include <casacore/scimath/Mathematics/RigidVector.h>
+#include <functional>
 
 namespace casacore { //# NAMESPACE CASACORE - BEGIN
 
@@ -67,6 +68,53 @@ private:
     mutable Double offset_p;
 };
 
+// <summary>
+// The data of an MSIter iteration chunk held in memory
+// </summary>
+// <synopsis>
+// MSIter::forEachChunk reads the row numbers, the main identifiers and
+// the requested data columns of each iteration chunk into an MSIterChunk.
+// Because it does not refer to the MeasurementSet, it can be processed
+// while other threads access the MeasurementSet.
+// The arrays of columns that were not requested are empty.
+// </synopsis>
+class MSIterChunk
+{
+public:
+  MSIterChunk()
+    : chunkNr(0), msId(0), arrayId(-1), fieldId(-1), dataDescId(-1),
+      spectralWindowId(-1), polarizationId(-1)
+  {}
+
+  // Sequence number of the chunk in the iteration (0-relative).
+  size_t chunkNr;
+  // MS Id (order in which the MSs were given to the MSIter).
+  size_t msId;
+  // Ids of the first row in the chunk.
+  // <group>
+  Int arrayId;
+  Int fieldId;
+  Int dataDescId;
+  Int spectralWindowId;
+  Int polarizationId;
+  // </group>
+  // The row numbers in the MS of the rows in the chunk.
+  Vector<rownr_t> rowNumbers;
+  // The TIME, ANTENNA1 and ANTENNA2 of the rows.
+  // <group>
+  Vector<Double> time;
+  Vector<Int> antenna1;
+  Vector<Int> antenna2;
+  // </group>
+  // The DATA, FLAG, WEIGHT and UVW of the rows (if requested).
+  // <group>
+  Cube<Complex> data;
+  Cube<Bool> flag;
+  Matrix<Float> weight;
+  Matrix<Double> uvw;
+  // </group>
+};
+
 // <summary>
 // An iterator class for MeasurementSets
 // </summary>
@@ -90,6 +138,16 @@ private:
 // examples below.  MSIter implements iteration by time interval for the use of
 // e.g., calibration tasks that want to calculate solutions over some interval
 // of time.  You can iterate over multiple MeasurementSets with this class.
+// <p>
+// The MS is sorted on the iteration columns when the MSIter is constructed,
+// unless it is already in that order or the sorted table stored by a
+// previous MSIter can be used. The sort uses multiple threads if possible.
+// <p>
+// Function <src>forEachChunk</src> iterates over the entire MS and calls a
+// function for each chunk, which gets the chunk data in an
+// <linkto class=MSIterChunk>MSIterChunk</linkto>. While that function
+// processes a chunk, the next chunks are read in advance. The chunks can
+// be processed by multiple threads in parallel.
 // </synopsis>
 //
 // <example>
@@ -166,6 +224,15 @@ public:
     Linear=1
   };
 
+  // The data columns read by forEachChunk (can be or-ed).
+  enum ChunkColumns {
+    ChunkData=1,
+    ChunkFlag=2,
+    ChunkWeight=4,
+    ChunkUVW=8,
+    ChunkAll=15
+  };
+
   // Default constructor - useful only to assign another iterator later.
   // Use of other member functions on this object is likely to dump core.
   MSIter();
@@ -245,6 +312,23 @@ public:
   virtual MSIter & operator++(int);
   virtual MSIter & operator++();
 
+  // Iterate over all chunks (starting at the origin) and call the function
+  // for each chunk. The given data columns (or-ed ChunkColumns) are read
+  // into the MSIterChunk, besides the row numbers, ids, TIME, ANTENNA1 and
+  // ANTENNA2. DATA, FLAG and WEIGHT can only be read if DATA_DESC_ID is one of
+  // the iteration columns.
+  // <br>The calling thread reads the chunks, while <src>nthreads</src> other
+  // threads call the function (if built with USE_THREADS). The calling
+  // thread reads ahead at most <src>nthreads+1</src> chunks.
+  // If <src>nthreads>1</src>, the chunks are processed in parallel and not
+  // necessarily in order, so the function has to be thread-safe.
+  // It must not access the MeasurementSet (nor use this MSIter), because
+  // the Table system is not thread-safe.
+  // <br>An exception thrown by the function stops the iteration and is
+  // rethrown. After the iteration more() returns False.
+  void forEachChunk (const std::function<void(const MSIterChunk&)>& func,
+                     uInt columns=ChunkAll, uInt nthreads=1);
+
   // Report Name of slowest column that changes at end of current iteration
   const String& keyChange() const;
 
@@ -425,6 +509,12 @@ protected:
 // Determine if the numbers in r1 are a sorted subset of those in r2
   Bool isSubSet(const Vector<rownr_t>& r1, const Vector<rownr_t>& r2);
 
+  // Determine if the table is in ascending order of the given columns.
+  static Bool isSorted(const Table& tab, const Block<String>& columns);
+
+  // Fill the chunk with the data of the current iteration.
+  void fillChunk(MSIterChunk& chunk, size_t chunkNr, uInt columns) const;
+
   MSIter* This;
   Block<MeasurementSet> bms_p;
   PtrBlock<TableIterator* > tabIter_p;
@@ -32,6 +32,8 @@
 #include <casacore/casa/Exceptions/Error.h>
 #include <casacore/casa/BasicMath/Math.h>
 #include <casacore/casa/Utilities/Assert.h>
+#include <algorithm>
+#include <vector>
 
 namespace casacore { //# NAMESPACE CASACORE - BEGIN
 
@@ -40,17 +42,19 @@ extern "C" {
     static float floatsqrt(float val) {return sqrt(val);}
 }
 
-StokesConverter::StokesConverter() {}
+StokesConverter::StokesConverter() : linearOnly_p(False) {}
 
 StokesConverter::~StokesConverter() {}
 
 StokesConverter::StokesConverter(const Vector<Int>& out, const Vector<Int>& in,
 				 Bool rescale)
+: linearOnly_p(False)
 {
   setConversion(out,in,rescale);
 }
 
 StokesConverter::StokesConverter(const StokesConverter& other)
+: linearOnly_p(False)
 {
   operator=(other);
 }
@@ -175,6 +179,92 @@ void StokesConverter::setConversion(const Vector<Int>& out,
       }
     }
   }
+  initKernel();
+}
+
+void StokesConverter::initKernel()
+{
+  Int nOut=out_p.nelements();
+  Int nIn=in_p.nelements();
+  linearOnly_p=True;
+  for (Int i=0; i<nOut; i++) {
+    if (out_p(i)<=0 || out_p(i)>Stokes::YL) linearOnly_p=False;
+  }
+  kernelStart_p.resize(nOut+1);
+  kernelStart_p=0;
+  kernelIn_p.resize(0);
+  kernelCoef_p.resize(0);
+  if (!linearOnly_p) return;
+  uInt n=0;
+  for (Int i=0; i<nOut; i++) {
+    for (Int j=0; j<nIn; j++) {
+      if (conv_p(i,j)!=Complex(0.)) n++;
+    }
+  }
+  kernelIn_p.resize(n);
+  kernelCoef_p.resize(n);
+  n=0;
+  for (Int i=0; i<nOut; i++) {
+    kernelStart_p(i)=n;
+    for (Int j=0; j<nIn; j++) {
+      if (conv_p(i,j)!=Complex(0.)) {
+	kernelIn_p(n)=j;
+	kernelCoef_p(n)=conv_p(i,j);
+	n++;
+      }
+    }
+  }
+  kernelStart_p(nOut)=n;
+}
+
+void StokesConverter::applyKernel(Complex* out, const Complex* in,
+				  size_t ncol) const
+{
+  const uInt nIn=in_p.nelements();
+  const uInt nOut=out_p.nelements();
+  // The vectors are converted in blocks. The input of a block is copied
+  // first, so the output can overwrite it.
+  const size_t blockSize=1024;
+  const size_t nBlock=(ncol+blockSize-1)/blockSize;
+#ifdef _OPENMP
+#pragma omp parallel for if (nBlock>16)
+#endif
+  for (size_t b=0; b<nBlock; b++) {
+    const size_t start=b*blockSize;
+    const size_t n=std::min(blockSize,ncol-start);
+    std::vector<Complex> buf(in+start*nIn, in+(start+n)*nIn);
+    const Float* src=reinterpret_cast<const Float*>(buf.data());
+    Float* dst=reinterpret_cast<Float*>(out+start*nOut);
+    for (uInt i=0; i<nOut; i++) {
+      Float* d=dst+2*i;
+      for (size_t j=0; j<n; j++) {
+	d[2*nOut*j]=0;
+	d[2*nOut*j+1]=0;
+      }
+      for (uInt k=kernelStart_p(i); k<kernelStart_p(i+1); k++) {
+	const Float* s=src+2*kernelIn_p(k);
+	const Float cr=kernelCoef_p(k).real();
+	const Float ci=kernelCoef_p(k).imag();
+	// Most factors are real or imaginary, which needs less work.
+	if (ci==0) {
+	  for (size_t j=0; j<n; j++) {
+	    d[2*nOut*j]+=cr*s[2*nIn*j];
+	    d[2*nOut*j+1]+=cr*s[2*nIn*j+1];
+	  }
+	} else if (cr==0) {
+	  for (size_t j=0; j<n; j++) {
+	    d[2*nOut*j]-=ci*s[2*nIn*j+1];
+	    d[2*nOut*j+1]+=ci*s[2*nIn*j];
+	  }
+	} else {
+	  for (size_t j=0; j<n; j++) {
+	    d[2*nOut*j]+=cr*s[2*nIn*j]-ci*s[2*nIn*j+1];
+	    d[2*nOut*j+1]+=cr*s[2*nIn*j+1]+ci*s[2*nIn*j];
+	  }
+	}
+      }
+    }
+  }
 }
 
 void StokesConverter::initConvMatrix()
@@ -288,6 +378,15 @@ void StokesConverter::convert(Array<Complex>& out, const Array<Complex>& in) con
   out.resize(outShape);
   Int nCorrIn=in.shape()(0);
   DebugAssert(nCorrIn==Int(in_p.nelements()),AipsError);
+  if (linearOnly_p) {
+    Bool deleteIn, deleteOut;
+    const Complex* inPtr=in.getStorage(deleteIn);
+    Complex* outPtr=out.getStorage(deleteOut);
+    applyKernel(outPtr,inPtr,in.nelements()/nCorrIn);
+    in.freeStorage(inPtr,deleteIn);
+    out.putStorage(outPtr,deleteOut);
+    return;
+  }
   Matrix<Complex> inMat=in.reform(IPosition(2,nCorrIn,in.nelements()/nCorrIn));
 
   Matrix<Complex> outMat=out.reform(IPosition(2,outShape(0),
@@ -363,6 +462,21 @@ void StokesConverter::convert(Array<Complex>& out, const Array<Complex>& in) con
 }
 
 
+void StokesConverter::convert(Cube<Complex>& data) const
+{
+  DebugAssert(data.shape()(0)==Int(in_p.nelements()),AipsError);
+  if (linearOnly_p && out_p.nelements()==in_p.nelements()) {
+    Bool deleteIt;
+    Complex* ptr=data.getStorage(deleteIt);
+    applyKernel(ptr,ptr,data.nelements()/in_p.nelements());
+    data.putStorage(ptr,deleteIt);
+  } else {
+    Array<Complex> out;
+    convert(out,data);
+    data.reference(out);
+  }
+}
+
 void StokesConverter::convert(Array<Bool>& out, const Array<Bool>& in) const
 {
   IPosition outShape(in.shape()); outShape(0)=out_p.nelements();
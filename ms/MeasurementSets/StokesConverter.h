@@ -29,6 +29,7 @@
 #include <casacore/casa/aips.h>
 #include <casacore/casa/Arrays/Vector.h>
 #include <casacore/casa/Arrays/Matrix.h>
+#include <casacore/casa/Arrays/Cube.h>
 #include <casacore/casa/BasicSL/Complex.h>
 #include <casacore/measures/Measures/Stokes.h>
 
@@ -86,6 +87,12 @@ namespace casacore { //# NAMESPACE CASACORE - BEGIN
 //    sc.convert(dataout,datain);
 // </srcblock>
 // </example>
+// When converting to linear combinations of the input polarizations
+// (i.e. not to Ptotal, Pangle, etc.), a sparse kernel holding only the
+// nonzero conversion factors is applied. It is applied to blocks of
+// channels and rows at a time, so the compiler can vectorize the
+// complex multiply-adds. A Cube of data (polarization, channel, row)
+// can be converted in place.
 // </synopsis>
 //
 // <motivation>
@@ -140,6 +147,13 @@ public:
   // Output is resized as needed.
   void convert(Array<Complex>& out, const Array<Complex>& in) const;
 
+  // convert a cube of data with axes polarization, channel and row in place.
+  // The first axis of the cube is changed to the number of output
+  // polarizations. The data are converted without a copy if the numbers
+  // of input and output polarizations are the same and the conversion
+  // consists of linear combinations only.
+  void convert(Cube<Complex>& data) const;
+
   // convert flags, first dimension of input must match
   // that of the input conversion vector used to set up the conversion.
   // Output is resized as needed. All output depending on a flagged input
@@ -165,6 +179,13 @@ protected:
   // initialize the polarization conversion matrix
   void initConvMatrix();
 
+  // initialize the sparse kernel from the conversion matrix
+  void initKernel();
+
+  // apply the sparse kernel to ncol polarization vectors.
+  // out and in can be the same if the number of polarizations is the same.
+  void applyKernel(Complex* out, const Complex* in, size_t ncol) const;
+
 private:
   Vector<Int> in_p,out_p;
   Bool rescale_p;
@@ -175,6 +196,12 @@ private:
   Matrix<Bool> flagConv_p;
   Matrix<Float> wtConv_p;
   Matrix<Complex> polConv_p;
+  //# The sparse kernel: output i is the sum of kernelCoef_p(k)*input
+  //# kernelIn_p(k) for k from kernelStart_p(i) till kernelStart_p(i+1).
+  Vector<uInt> kernelStart_p;
+  Vector<Int> kernelIn_p;
+  Vector<Complex> kernelCoef_p;
+  Bool linearOnly_p;
 };
 
 
@@ -38,8 +38,11 @@
 #include <casacore/casa/Arrays/Vector.h>
 #include <casacore/casa/Arrays/ArrayMath.h>
 #include <casacore/casa/IO/ArrayIO.h>
+#include <casacore/casa/Arrays/ArrayLogical.h>
+#include <casacore/casa/Utilities/Assert.h>
 #include <iostream>
 #include <sstream>
+#include <mutex>
 
 using namespace casacore;
 using namespace std;
@@ -952,6 +955,78 @@ void iterMSCachedFieldInfo ()
   }
 }
 
+// Check that forEachChunk gives the same chunks as the normal iteration.
+void iterMSChunks (double binwidth, uInt nthreads)
+{
+  MeasurementSet ms("tMSIter_tmp.ms");
+  Block<int> sort(2);
+  sort[0] = MS::ANTENNA1;
+  sort[1] = MS::ANTENNA2;
+  MSIter msIter(ms, sort, binwidth, True, False);
+  std::vector<Vector<rownr_t>> rownrs;
+  std::vector<Cube<Complex>> data;
+  for (msIter.origin(); msIter.more(); msIter++) {
+    rownrs.push_back (msIter.table().rowNumbers(ms));
+    data.push_back (ArrayColumn<Complex>(msIter.table(), "DATA").getColumn());
+  }
+  std::vector<Bool> seen(rownrs.size(), False);
+  std::mutex mutex;
+  msIter.forEachChunk ([&](const MSIterChunk& chunk) {
+      std::lock_guard<std::mutex> lock(mutex);
+      AlwaysAssertExit (chunk.chunkNr < rownrs.size());
+      AlwaysAssertExit (!seen[chunk.chunkNr]);
+      seen[chunk.chunkNr] = True;
+      AlwaysAssertExit (chunk.msId == 0  &&  chunk.fieldId == 0  &&
+                        chunk.dataDescId == 0);
+      AlwaysAssertExit (allEQ (chunk.rowNumbers, rownrs[chunk.chunkNr]));
+      AlwaysAssertExit (allEQ (chunk.data, data[chunk.chunkNr]));
+      AlwaysAssertExit (chunk.antenna1.size() == chunk.rowNumbers.size());
+      // Only DATA is read (FLAG has not been filled).
+      AlwaysAssertExit (chunk.flag.empty()  &&  chunk.uvw.empty());
+    }, MSIter::ChunkData, nthreads);
+  AlwaysAssertExit (!msIter.more());
+  for (size_t i=0; i<seen.size(); ++i) {
+    AlwaysAssertExit (seen[i]);
+  }
+  // An exception in the function is passed on.
+  Bool caught = False;
+  try {
+    msIter.forEachChunk ([](const MSIterChunk& chunk) {
+        if (chunk.chunkNr == 2) throw AipsError("chunk error");
+      }, 0, nthreads);
+  } catch (const AipsError&) {
+    caught = True;
+  }
+  AlwaysAssertExit (caught);
+  // WEIGHT can only be read if DATA_DESC_ID is an iteration column.
+  MSIter msIterNoDD(ms, sort, binwidth, False, False);
+  caught = False;
+  try {
+    msIterNoDD.forEachChunk ([](const MSIterChunk&) {},
+                             MSIter::ChunkWeight, nthreads);
+  } catch (const AipsError&) {
+    caught = True;
+  }
+  AlwaysAssertExit (caught);
+}
+
+// The MS is in time order, so it does not need to be sorted.
+void iterMSSorted (double binwidth)
+{
+  MeasurementSet ms("tMSIter_tmp.ms");
+  Block<int> sort(1);
+  sort[0] = MS::TIME;
+  MSIter msIter(ms, sort, binwidth, True, False);
+  rownr_t nextRow = 0;
+  for (msIter.origin(); msIter.more(); msIter++) {
+    Vector<rownr_t> rownrs = msIter.table().rowNumbers(ms);
+    for (size_t i=0; i<rownrs.size(); ++i) {
+      AlwaysAssertExit (rownrs[i] == nextRow++);
+    }
+  }
+  AlwaysAssertExit (nextRow == ms.nrow());
+}
+
 int main (int argc, char* argv[])
 {
   try {
@@ -991,6 +1066,9 @@ int main (int argc, char* argv[])
     iterMSCachedDDFeedInfo();
     cout << "########" << endl;
     iterMSCachedFieldInfo();
+    iterMSChunks(binwidth, 1);
+    iterMSChunks(binwidth, 3);
+    iterMSSorted(binwidth);
   } catch (std::exception& x) {
     cerr << "Unexpected exception: " << x.what() << endl;
     return 1;
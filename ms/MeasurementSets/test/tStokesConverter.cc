@@ -30,6 +30,18 @@
 #include <casacore/casa/iostream.h>
 
 #include <casacore/casa/namespace.h>
+
+// Convert rescaled linear correlations XX,XY,YX,YY to I,Q,U,V.
+Vector<Complex> linearToIQUV(const Vector<Complex>& lin)
+{
+  Vector<Complex> iquv(4);
+  iquv(0)=0.5f*(lin(0)+lin(3));
+  iquv(1)=0.5f*(lin(0)-lin(3));
+  iquv(2)=0.5f*(lin(1)+lin(2));
+  iquv(3)=Complex(0.,0.5)*(lin(2)-lin(1));
+  return iquv;
+}
+
 int main() 
 {
   Int err=0;
@@ -117,6 +129,98 @@ int main()
 	}
       }
     }
+
+    {
+      // Convert linear correlations with and without rescaling.
+      Vector<Int> out(4),in(4);
+      in(0)=Stokes::XX;
+      in(1)=Stokes::XY;
+      in(2)=Stokes::YX;
+      in(3)=Stokes::YY;
+      out(0)=Stokes::I;
+      out(1)=Stokes::Q;
+      out(2)=Stokes::U;
+      out(3)=Stokes::V;
+      Vector<Complex> datain(4),dataout;
+      datain(0)=Complex(1.5,0.5);
+      datain(1)=Complex(0.25,0.75);
+      datain(2)=Complex(0.5,-0.25);
+      datain(3)=Complex(0.5,-0.5);
+      Vector<Complex> expected(4);
+      expected(0)=Complex(1.0,0.0);
+      expected(1)=Complex(0.5,0.5);
+      expected(2)=Complex(0.375,0.25);
+      expected(3)=Complex(0.5,0.125);
+      sc.setConversion(out,in,True);
+      sc.convert(dataout,datain);
+      if (!allNearAbs(dataout,expected,1.e-6)) {
+	err++;
+	cerr << "rescaled linear dataout="<<dataout<<endl;
+      }
+      Cube<Complex> cube(4,1,1);
+      cube.xyPlane(0).column(0)=datain;
+      sc.convert(cube);
+      if (!allNearAbs(cube.xyPlane(0).column(0),expected,1.e-6)) {
+	err++;
+	cerr << "rescaled linear cube="<<cube<<endl;
+      }
+      sc.setConversion(out,in,False);
+      sc.convert(dataout,datain);
+      if (!allNearAbs(dataout,Complex(2.0f)*expected,1.e-6)) {
+	err++;
+	cerr << "linear dataout="<<dataout<<endl;
+      }
+    }
+
+    {
+      // Convert a cube in place and compare with the explicit conversion.
+      Vector<Int> in(4);
+      in(0)=Stokes::XX;
+      in(1)=Stokes::XY;
+      in(2)=Stokes::YX;
+      in(3)=Stokes::YY;
+      const Int nOutCases=3;
+      const Int nOut[nOutCases]={4,1,2};
+      const Int outPol[nOutCases][4]={
+	{Stokes::I,Stokes::Q,Stokes::U,Stokes::V},
+	{Stokes::I,0,0,0},
+	{Stokes::U,Stokes::Plinear,0,0}
+      };
+      Cube<Complex> datain(4,7,300);
+      for (uInt i=0; i<datain.nelements(); i++) {
+	datain.data()[i]=Complex(0.01*(i%37),0.02*(i%11)-0.1);
+      }
+      for (Int c=0; c<nOutCases; c++) {
+	Vector<Int> out(nOut[c]);
+	for (Int j=0; j<nOut[c]; j++) out(j)=outPol[c][j];
+	sc.setConversion(out,in,True);
+	Cube<Complex> data;
+	data=datain;
+	sc.convert(data);
+	if (data.shape()!=IPosition(3,nOut[c],7,300)) {
+	  err++;
+	  cerr << "cube shape="<<data.shape()<<endl;
+	} else {
+	  Vector<Complex> vecout(nOut[c]);
+	  for (Int row=0; row<300; row++) {
+	    for (Int chan=0; chan<7; chan++) {
+	      Vector<Complex> iquv=linearToIQUV(datain.xyPlane(row).column(chan));
+	      for (Int j=0; j<nOut[c]; j++) {
+		if (outPol[c][j]==Stokes::Plinear) {
+		  vecout(j)=sqrt(norm(iquv(1))+norm(iquv(2)));
+		} else {
+		  vecout(j)=iquv(outPol[c][j]-Stokes::I);
+		}
+	      }
+	      if (!allNearAbs(data.xyPlane(row).column(chan),vecout,1.e-5)) {
+		err++;
+		cerr << "Cube error for case "<<c<<", row="<<row<<endl;
+	      }
+	    }
+	  }
+	}
+      }
+    }
   } catch (std::exception& x) {
     cout << "Exception: "<< x.what() <<endl;
   } 
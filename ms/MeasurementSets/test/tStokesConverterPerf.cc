@@ -0,0 +1,125 @@
+//# tStokesConverterPerf.cc: Test performance of StokesConverter
+//# Copyright (C) 2026
+//# Associated Universities, Inc. Washington DC, USA.
+//#
+//# This program is free software; you can redistribute it and/or modify it
+//# under the terms of the GNU General Public License as published by the Free
+//# Software Foundation; either version 2 of the License, or (at your option)
+//# any later version.
+//#
+//# This program is distributed in the hope that it will be useful, but WITHOUT
+//# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+//# more details.
+//#
+//# You should have received a copy of the GNU General Public License along
+//# with this program; if not, write to the Free Software Foundation, Inc.,
+//# 675 Massachusetts Ave, Cambridge, MA 02139, USA.
+//#
+//# Correspondence concerning AIPS++ should be addressed as follows:
+//#        Internet email: aips2-request@nrao.edu.
+//#        Postal address: AIPS++ Project Office
+//#                        National Radio Astronomy Observatory
+//#                        520 Edgemont Road
+//#                        Charlottesville, VA 22903-2475 USA
+
+
+#include <casacore/ms/MeasurementSets/StokesConverter.h>
+#include <casacore/casa/Arrays/Cube.h>
+#include <casacore/casa/Arrays/ArrayMath.h>
+#include <casacore/casa/Arrays/ArrayLogical.h>
+#include <casacore/casa/Arrays/MatrixMath.h>
+#include <casacore/casa/OS/Timer.h>
+#include <casacore/casa/Utilities/Assert.h>
+#include <casacore/casa/iostream.h>
+#include <stdlib.h>
+
+#include <casacore/casa/namespace.h>
+
+// <summary>
+// Test program for performance of StokesConverter.
+// It converts the data of a number of rows from XX,XY,YX,YY to I,Q,U,V
+// using a per-row matrix product (as done before the sparse kernel
+// was used), per-row conversion, and the in-place conversion of a cube.
+// It reports the number of visibilities converted per second.
+// </summary>
+
+
+void report (const String& name, double sec, Int64 nvis)
+{
+  cout << name << ": " << sec << " sec";
+  if (sec > 0) {
+    cout << " = " << nvis / sec / 1e6 << " Mvis/sec";
+  }
+  cout << endl;
+}
+
+void doConvert (Int nchan, Int nrow)
+{
+  Vector<Int> in(4), out(4);
+  in(0) = Stokes::XX;
+  in(1) = Stokes::XY;
+  in(2) = Stokes::YX;
+  in(3) = Stokes::YY;
+  out(0) = Stokes::I;
+  out(1) = Stokes::Q;
+  out(2) = Stokes::U;
+  out(3) = Stokes::V;
+  StokesConverter sc(out, in, True);
+  // The conversion matrix for rescaled linear correlations:
+  // I=(XX+YY)/2, Q=(XX-YY)/2, U=(XY+YX)/2, V=i(YX-XY)/2.
+  Matrix<Complex> conv(4, 4, Complex(0.));
+  conv(0,0) = 0.5;
+  conv(0,3) = 0.5;
+  conv(1,0) = 0.5;
+  conv(1,3) = -0.5;
+  conv(2,1) = 0.5;
+  conv(2,2) = 0.5;
+  conv(3,1) = Complex(0., -0.5);
+  conv(3,2) = Complex(0., 0.5);
+  Cube<Complex> data(4, nchan, nrow);
+  for (uInt i=0; i<data.nelements(); ++i) {
+    data.data()[i] = Complex(0.001*(i%1009), 0.002*(i%97) - 0.1);
+  }
+  const Int64 nvis = Int64(nchan) * nrow * 4;
+  // Matrix product per row.
+  Cube<Complex> result1(4, nchan, nrow);
+  Timer timer;
+  for (Int row=0; row<nrow; ++row) {
+    result1.xyPlane(row) = product(conv, data.xyPlane(row));
+  }
+  report ("matrix product per row", timer.real(), nvis);
+  // Conversion per row.
+  Cube<Complex> result2(4, nchan, nrow);
+  timer.mark();
+  for (Int row=0; row<nrow; ++row) {
+    Array<Complex> outRow;
+    sc.convert (outRow, data.xyPlane(row));
+    result2.xyPlane(row) = outRow;
+  }
+  report ("conversion per row     ", timer.real(), nvis);
+  // Conversion of the cube in place.
+  Cube<Complex> result3;
+  result3 = data;
+  timer.mark();
+  sc.convert (result3);
+  report ("cube in place          ", timer.real(), nvis);
+  AlwaysAssertExit (allNearAbs (result1, result2, 1e-5));
+  AlwaysAssertExit (allNearAbs (result1, result3, 1e-5));
+}
+
+int main (int argc, char* argv[])
+{
+  // Default is a small run, so it can be used as a regular test.
+  Int nchan = 64;
+  Int nrow = 1000;
+  if (argc > 1) nchan = atoi(argv[1]);
+  if (argc > 2) nrow = atoi(argv[2]);
+  try {
+    doConvert (nchan, nrow);
+  } catch (std::exception& x) {
+    cout << "Caught an exception: " << x.what() << endl;
+    return 1;
+  }
+  return 0;                           // exit with success status
+}
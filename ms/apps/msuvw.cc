@@ -0,0 +1,80 @@
+//# msuvw.cc: Recalculate the UVW coordinates of an MS
+//# Copyright (C) 2026
+//# Associated Universities, Inc. Washington DC, USA.
+//#
+//# This library is free software; you can redistribute it and/or modify it
+//# under the terms of the GNU Library General Public License as published by
+//# the Free Software Foundation; either version 2 of the License, or (at your
+//# option) any later version.
+//#
+//# This library is distributed in the hope that it will be useful, but WITHOUT
+//# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+//# License for more details.
+//#
+//# You should have received a copy of the GNU Library General Public License
+//# along with this library; if not, write to the Free Software Foundation,
+//# Inc., 675 Massachusetts Ave, Cambridge, MA 02139, USA.
+//#
+//# Correspondence concerning AIPS++ should be addressed as follows:
+//#        Internet email: aips2-request@nrao.edu.
+//#        Postal address: AIPS++ Project Office
+//#                        National Radio Astronomy Observatory
+//#                        520 Edgemont Road
+//#                        Charlottesville, VA 22903-2475 USA
+
+#include <casacore/ms/MeasurementSets/MeasurementSet.h>
+#include <casacore/ms/MSOper/MSUVWCalculator.h>
+#include <casacore/casa/Inputs/Input.h>
+#include <iostream>
+
+using namespace casacore;
+using namespace std;
+
+// Recalculate the UVW coordinates of all rows in an MS using the phase
+// centers in the FIELD table (see MSUVWCalculator).
+void recalcUVW (const String& msName, const String& dirColName,
+                rownr_t chunkSize)
+{
+  MeasurementSet ms(msName, Table::Update);
+  MSUVWCalculator::recalculate (ms, dirColName, chunkSize);
+  cout << "Recalculated the UVW coordinates of " << ms.nrow()
+       << " rows in " << msName << endl;
+}
+
+int main (int argc, char* argv[])
+{
+  try {
+    // enable input in no-prompt mode
+    Input inputs(1);
+    // define the input structure
+    inputs.version("20261018");
+    inputs.create ("in", "",
+		   "Name of MeasurementSet to update",
+		   "string");
+    inputs.create ("dircol", "PHASE_DIR",
+		   "Column in the FIELD table containing the phase centers "
+		   "(PHASE_DIR, DELAY_DIR or REFERENCE_DIR)",
+		   "string");
+    inputs.create ("chunksize", "1000000",
+		   "Number of rows to process at a time",
+		   "int");
+    // Fill the input structure from the command line.
+    inputs.readArguments (argc, argv);
+
+    // Get and check the input specification.
+    String msin (inputs.getString("in"));
+    if (msin.empty()) {
+      throw AipsError(" an input MeasurementSet must be given");
+    }
+    Int chunkSize = inputs.getInt("chunksize");
+    if (chunkSize <= 0) {
+      throw AipsError(" chunksize must be positive");
+    }
+    recalcUVW (msin, inputs.getString("dircol"), chunkSize);
+  } catch (std::exception& x) {
+    cerr << "Error: " << x.what() << endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,145 @@
+//# simms.cc: Simulate an (empty) MeasurementSet and time it
+//# Copyright (C) 2026
+//# Associated Universities, Inc. Washington DC, USA.
+//#
+//# This library is free software; you can redistribute it and/or modify it
+//# under the terms of the GNU Library General Public License as published by
+//# the Free Software Foundation; either version 2 of the License, or (at your
+//# option) any later version.
+//#
+//# This library is distributed in the hope that it will be useful, but WITHOUT
+//# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+//# License for more details.
+//#
+//# You should have received a copy of the GNU Library General Public License
+//# along with this library; if not, write to the Free Software Foundation,
+//# Inc., 675 Massachusetts Ave, Cambridge, MA 02139, USA.
+//#
+//# Correspondence concerning AIPS++ should be addressed as follows:
+//#        Internet email: aips2-request@nrao.edu.
+//#        Postal address: AIPS++ Project Office
+//#                        National Radio Astronomy Observatory
+//#                        520 Edgemont Road
+//#                        Charlottesville, VA 22903-2475 USA
+
+#include <casacore/ms/MSOper/NewMSSimulator.h>
+#include <casacore/ms/MeasurementSets/MeasurementSet.h>
+#include <casacore/measures/Measures/MeasTable.h>
+#include <casacore/tables/Tables/TableUtil.h>
+#include <casacore/casa/Inputs/Input.h>
+#include <casacore/casa/OS/Timer.h>
+#include <casacore/casa/BasicSL/Constants.h>
+#include <iostream>
+
+using namespace casacore;
+using namespace std;
+
+// Simulate an observation with NewMSSimulator and report the speed
+// at which the rows are written.
+// The antennae are placed on a spiral around the VLA.
+void simulate (const String& msName, Int nant, Int nchan,
+               const String& stokes, Double hours, Double interval,
+               Bool bulk, Bool thread)
+{
+  Timer timer;
+  NewMSSimulator sim(msName);
+  sim.setBulkWrite (bulk, thread);
+  Vector<Double> x(nant), y(nant), z(nant, 0.);
+  Vector<Double> diam(nant, 25.), offset(nant, 0.);
+  Vector<String> mount(nant, "ALT-AZ"), name(nant), pad(nant, "PAD");
+  for (Int i=0; i<nant; ++i) {
+    Double r = 100. * (i+1);
+    Double phi = 0.7 * i;
+    x[i] = r * cos(phi);
+    y[i] = r * sin(phi);
+    name[i] = "ANT" + String::toString(i);
+  }
+  MPosition vlaPos;
+  MeasTable::Observatory (vlaPos, "VLA");
+  sim.initAnt ("VLA", x, y, z, diam, offset, mount, name, pad,
+               "local", vlaPos);
+  sim.initSpWindows ("SPW", nchan, Quantity(1.4, "GHz"),
+                     Quantity(1., "MHz"), Quantity(1., "MHz"),
+                     MFrequency::TOPO, stokes);
+  sim.initFeeds ("perfect R L");
+  sim.initFields ("SRC", MDirection(Quantity(30., "deg"),
+                                    Quantity(40., "deg"),
+                                    MDirection::J2000), "");
+  sim.settimes (Quantity(interval, "s"), True,
+                MEpoch(Quantity(58000., "d"), MEpoch::UTC));
+  timer.show ("Created MS " + msName);
+  timer.mark();
+  sim.observe ("SRC", "SPW", Quantity(-hours/2, "h"), Quantity(hours/2, "h"));
+  sim.getMs()->flush();
+  Double realTime = timer.real();
+  timer.show ("Simulated");
+  // Data volume written in the array columns of the main table
+  // (DATA, MODEL_DATA, CORRECTED_DATA, FLAG, UVW, WEIGHT and SIGMA).
+  rownr_t nrow = sim.getMs()->nrow();
+  Int npol = stokes.freq(' ') + 1;
+  Double nbytes = Double(nrow) * (npol * nchan * (3*sizeof(Complex) + 1) +
+                                  3*sizeof(Double) + 2*npol*sizeof(Float));
+  cout << "Wrote " << nrow << " rows (" << nbytes / (1024.*1024.)
+       << " MB) into " << msName << endl;
+  if (realTime > 0) {
+    cout << "  " << nrow / realTime << " rows/s   "
+         << nbytes / (1024.*1024.) / realTime << " MB/s" << endl;
+  }
+}
+
+int main (int argc, char* argv[])
+{
+  try {
+    // enable input in no-prompt mode
+    Input inputs(1);
+    // define the input structure
+    inputs.version("20261018");
+    inputs.create ("ms", "simms.ms",
+		   "Name of the MeasurementSet to create",
+		   "string");
+    inputs.create ("nant", "27",
+		   "Number of antennae",
+		   "int");
+    inputs.create ("nchan", "64",
+		   "Number of channels",
+		   "int");
+    inputs.create ("stokes", "RR RL LR LL",
+		   "Correlations",
+		   "string");
+    inputs.create ("hours", "1",
+		   "Length of the observation (hours)",
+		   "double");
+    inputs.create ("interval", "10",
+		   "Integration time (seconds)",
+		   "double");
+    inputs.create ("bulk", "true",
+		   "Write all rows of a timestep at once?",
+		   "bool");
+    inputs.create ("thread", "true",
+		   "Write the timesteps in a separate thread (bulk mode)?",
+		   "bool");
+    inputs.create ("keep", "false",
+		   "Keep the MeasurementSet?",
+		   "bool");
+    // Fill the input structure from the command line.
+    inputs.readArguments (argc, argv);
+
+    String msName (inputs.getString("ms"));
+    Int nant = inputs.getInt("nant");
+    Int nchan = inputs.getInt("nchan");
+    if (nant < 2  ||  nchan < 1) {
+      throw AipsError(" at least 2 antennae and 1 channel must be given");
+    }
+    simulate (msName, nant, nchan, inputs.getString("stokes"),
+              inputs.getDouble("hours"), inputs.getDouble("interval"),
+              inputs.getBool("bulk"), inputs.getBool("thread"));
+    if (! inputs.getBool("keep")) {
+      TableUtil::deleteTable (msName, True);
+    }
+  } catch (std::exception& x) {
+    cerr << "Error: " << x.what() << endl;
+    return 1;
+  }
+  return 0;
+}
@@ -96,7 +96,12 @@
 #include <casacore/casa/iostream.h>
 #include <casacore/casa/iomanip.h>
 #include <casacore/casa/OS/Directory.h>
+#include <exception>
 #include <map>
+#include <vector>
+#ifdef USE_THREADS
+#include <thread>
+#endif
 
 using std::make_pair;
 
@@ -138,6 +143,33 @@ static Int getIndexContains(Vector<String>& map, const String& key, uInt which =
     return -1;
 }
 
+// Read the next nGroup groups and store their (scaled) parameters and data
+// values contiguously.
+static void readGroupBlock(MSPrimaryGroupHolder& priGroup, Int nGroup,
+                           Int nParams, Int nData,
+                           std::vector<Double>& parms,
+                           std::vector<Float>& data) {
+    parms.resize(size_t(nGroup) * nParams);
+    data.resize(size_t(nGroup) * nData);
+    for (Int g = 0; g < nGroup; g++) {
+        priGroup.read();
+        priGroup.copyParms(parms.data() + size_t(g) * nParams);
+        priGroup.copyData(data.data() + size_t(g) * nData, nData);
+    }
+}
+
+// Copy the scaled data values of the current group.
+// The values are the same as given by PrimaryGroup::operator().
+template<typename T>
+static void copyGroupData(PrimaryGroup<T>& group, Float* target, Int n) {
+    const Double scale = group.bscale();
+    const Double zero = group.bzero();
+    const T* raw = &(group.data(0));
+    for (Int i = 0; i < n; i++) {
+        target[i] = scale * raw[i] + zero;
+    }
+}
+
 MSPrimaryGroupHolder::MSPrimaryGroupHolder() :
     hdu_p(0), ps(0), pl(0), pf(0) {
 }
@@ -171,6 +203,16 @@ MSPrimaryGroupHolder::~MSPrimaryGroupHolder() {
     detach();
 }
 
+void MSPrimaryGroupHolder::copyData(Float* target, Int n) {
+    if (pf) {
+        copyGroupData(*pf, target, n);
+    } else if (pl) {
+        copyGroupData(*pl, target, n);
+    } else {
+        copyGroupData(*ps, target, n);
+    }
+}
+
 void MSPrimaryGroupHolder::detach() {
     if (ps)
         delete ps;
@@ -237,10 +279,11 @@ void MSPrimaryTableHolder::detach() {
 
 //------------------------------------------------------------
 MSFitsInput::MSFitsInput(const String& msFile, const String& fitsFile,
-        const Bool useNewStyle) :
+        const Bool useNewStyle, const Bool fillInBlocks) :
     _infile(0), _msc(0), _uniqueAnts(), _nAntRow(0), _restfreq(0),
     _addSourceTable(False), _log(LogOrigin("MSFitsInput", "MSFitsInput")),
-    _newNameStyle(useNewStyle), _msCreated(False) {
+    _newNameStyle(useNewStyle), _fillInBlocks(fillInBlocks),
+    _msCreated(False) {
     // First, lets verify that fitsfile exists and that it appears to be a
     // FITS file.
     File f(fitsFile);
@@ -350,7 +393,7 @@ void MSFitsInput::readRandomGroupUVFits(Int obsType) {
     //
 
     // fill the main table
-    if ((estMem < totMem) && (estMem < 1000000)) {
+    if (!_fillInBlocks && (estMem < totMem) && (estMem < 1000000)) {
         //fill column wise and keep columns in memory
         try {
             fillMSMainTableColWise(nField, nSpW);
@@ -1448,11 +1491,6 @@ void MSFitsInput::fillMSMainTable(Int& nField, Int& nSpW) {
     Int nCorr = _nPixel(getIndex(_coordType, "STOKES"));
     Int nChan = _nPixel(getIndex(_coordType, "FREQ"));
 
-
-    Matrix<Complex> vis(nCorr, nChan);
-    Vector<Float> sigma(nCorr);
-    Matrix<Float> weightSpec(nCorr, nChan);
-    Vector<Float> weight(nCorr);
     const Int nCat = 3; // three initial categories
     // define the categories
     Vector<String> cat(nCat);
@@ -1460,8 +1498,6 @@ void MSFitsInput::fillMSMainTable(Int& nField, Int& nSpW) {
     cat(1) = "ORIGINAL";
     cat(2) = "USER";
     msc.flagCategory().rwKeywordSet().define("CATEGORY", cat);
-    Cube<Bool> flagCat(nCorr, nChan, nCat, False);
-    Matrix<Bool> flag = flagCat.xyPlane(0); // references flagCat's storage
 
     // find out the indices for U, V and W, there are several naming schemes
     Int iU, iV, iW;
@@ -1518,8 +1554,6 @@ void MSFitsInput::fillMSMainTable(Int& nField, Int& nSpW) {
     ProgressMeter meter(0.0, nGroups * 1.0, "UVFITS Filler", "Groups copied",
             "", "", True, nGroups / 100);
 
-    Vector<Double> uvw(3);
-
     // Remember last-filled values for TSM use
     Int lastFillArrayId, lastFillFieldId, lastFillScanNumber;
     lastFillArrayId = -1;
@@ -1539,209 +1573,305 @@ void MSFitsInput::fillMSMainTable(Int& nField, Int& nSpW) {
 
     Bool lastRowFlag = False;
 
-    // Loop over groups
-    for (Int group = 0; group < nGroups; group++) {
-
-        // Read next group and
-        _priGroup.read();
-
-        // Extract time in MJD seconds
-        //  (this has VERY limited precision [~0.01s])
-        const Double JDofMJD0 = 2400000.5;
-        Double time = _priGroup.parm(iTime0);
-        time -= JDofMJD0;
-        if (iTime1 >= 0)
-            time += _priGroup.parm(iTime1);
-        time *= C::day;
-
-        // Extract fqid
-        Int freqId = iFreq > 0 ? Int(_priGroup.parm(iFreq)) : 1;
-
-        // Extract field Id
-        Int fieldId = 0;
-        if (iSource >= 0) {
-            // make 0-based
-            fieldId = (Int) _priGroup.parm(iSource) - 1;
-        }
-
-        // Extract uvw
-        uvw(0) = _priGroup.parm(iU);
-        uvw(1) = _priGroup.parm(iV);
-        uvw(2) = _priGroup.parm(iW);
-        // Convert from units of seconds to meters
-        uvw *= C::c;
-
-        // Extract array/baseline/antenna info
-        Int arrayId = 0;
-        std::pair<Int, Int> ants;
-        if (iBsln >= 0) {
-            Float baseline = _priGroup.parm(iBsln);
-            ants = _extractAntennas(baseline);
-            arrayId = Int(100.0 * (baseline - Int(baseline) + 0.001));
-        } else {
-            Int antenna1 = _priGroup.parm(iAnt1);
-            Int antenna2 = _priGroup.parm(iAnt2);
-            ants = _extractAntennas(antenna1, antenna2);
-            arrayId = _priGroup.parm(iSubarr);
-        }
-        _nArray = max(_nArray, arrayId + 1);
-        Int ant1 = ants.first;
-        Int ant2 = ants.second;
-        // Ensure arrayId-specific params are of correct length:
-        if (scanNumber.shape() < _nArray) {
-            scanNumber.resize(_nArray, True);
-            lastFieldId.resize(_nArray, True);
-            lastFreqId.resize(_nArray, True);
-            scanNumber(_nArray - 1) = 0;
-            lastFieldId(_nArray - 1) = -1;
-            lastFreqId(_nArray - 1) = -1;
-        }
-
-        // Detect new scan (field or freqid change) for each arrayId
-        if (fieldId != lastFieldId(arrayId) || freqId != lastFreqId(arrayId)
-                || time - lastFillTime > 300.0) {
-            scanNumber(arrayId)++;
-            lastFieldId(arrayId) = fieldId;
-            lastFreqId(arrayId) = freqId;
+    // Work out which axis increments fastests, pol or channel
+    // The COMPLEX axis is assumed to be first, and the IF axis is assumed
+    // to be after STOKES and FREQ.
+    const Bool polFastest = (getIndex(_coordType, "STOKES") < getIndex(
+            _coordType, "FREQ"));
+    const Int nx = (polFastest ? nChan : nCorr);
+    const Int ny = (polFastest ? nCorr : nChan);
+    const Int nif = max(1, _nIF);
+    // Number of data values per IF and per group (real, imag, weight)
+    const Int nIFData = 3 * nCorr * nChan;
+    const Int nData = nif * nIFData;
+
+    // The groups are handled in blocks of about 64 MBytes of data.
+    // While a block is converted and written, the next block is read
+    // by another thread (if built with USE_THREADS).
+    const Int blockGroups = max(1, Int(64 * 1024 * 1024 /
+                                       (sizeof(Float) * max(1, nData))));
+    std::vector<Double> parms[2];
+    std::vector<Float> data[2];
+    Int cur = 0;
+    Int nDone = 0;
+    Int nInBlock = min(blockGroups, nGroups);
+    readGroupBlock(_priGroup, nInBlock, nParams, nData, parms[cur], data[cur]);
+
+    while (nInBlock > 0) {
+        const Int nNext = min(blockGroups, nGroups - nDone - nInBlock);
+        std::exception_ptr excp, readExcp;
+#ifdef USE_THREADS
+        std::thread reader;
+        if (nNext > 0) {
+            reader = std::thread([&]() {
+                try {
+                    readGroupBlock(_priGroup, nNext, nParams, nData,
+                                   parms[1-cur], data[1-cur]);
+                } catch (...) {
+                    readExcp = std::current_exception();
+                }
+            });
         }
-
-        // If integration time is a RP, use it:
-        if (iInttim > -1) {
-            discernIntExp = False;
-            exposure = _priGroup.parm(iInttim);
-            interval = exposure;
-        } else {
-            // keep track of minimum which is the only one
-            // (if time step is larger than UVFITS precision (and zero))
-            discernIntExp = True;
-            Double tempint;
-            tempint = time - lastFillTime;
-            if (tempint > 0.01) {
-                discernedInt = min(discernedInt, tempint);
+#endif
+        try {
+            const Int nRow = nInBlock * nif;
+            const Int firstRow = row + 1;
+            _ms.addRow(nRow);
+
+            // Reorder the visibilities and derive weights and flags for
+            // all rows in the block. Rows are independent, so this is
+            // done in parallel.
+            Cube<Complex> vis(nCorr, nChan, nRow);
+            Cube<Float> weightSpec(nCorr, nChan, nRow);
+            Cube<Bool> flag(nCorr, nChan, nRow);
+            Array<Bool> flagCat(IPosition(4, nCorr, nChan, nCat, nRow), False);
+            Matrix<Float> weight(nCorr, nRow);
+            Matrix<Float> sigma(nCorr, nRow);
+            Vector<Bool> rowFlags(nRow);
+            const Float* blockData = data[cur].data();
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+            for (Int r = 0; r < nRow; r++) {
+                const Float* vals = blockData + size_t(r / nif) * nData
+                                    + size_t(r % nif) * nIFData;
+                Complex* visRow = vis.data() + size_t(r) * nCorr * nChan;
+                Float* wsRow = weightSpec.data() + size_t(r) * nCorr * nChan;
+                Bool* flagRow = flag.data() + size_t(r) * nCorr * nChan;
+                Float* wtRow = weight.data() + size_t(r) * nCorr;
+                Float* sigRow = sigma.data() + size_t(r) * nCorr;
+                for (Int nc = 0; nc < nCorr; nc++) {
+                    wtRow[nc] = 0.0;
+                }
+                Int count = 0;
+                // Loop over chans and corrs:
+                for (Int ix = 0; ix < nx; ix++) {
+                    for (Int iy = 0; iy < ny; iy++) {
+                        const Float visReal = vals[count++];
+                        const Float visImag = vals[count++];
+                        const Float wt = vals[count++];
+                        const Int pol = (polFastest ? _corrIndex[iy]
+                                : _corrIndex[ix]);
+                        const Int chan = (polFastest ? ix : iy);
+                        const Int inx = pol + chan * nCorr;
+                        if (wt <= 0.0) {
+                            wsRow[inx] = abs(wt);
+                            flagRow[inx] = True;
+                            wtRow[pol] += abs(wt);
+                        } else {
+                            wsRow[inx] = wt;
+                            flagRow[inx] = False;
+                            // weight column is sum of weight_spectrum (each pol):
+                            wtRow[pol] += wt;
+                        }
+                        visRow[inx] = Complex(visReal, visImag);
+                    }
+                }
+                // calculate sigma (weight = inverse variance)
+                for (Int nc = 0; nc < nCorr; nc++) {
+                    if (wtRow[nc] > 0.0) {
+                        sigRow[nc] = sqrt(1.0 / wtRow[nc]);
+                    } else {
+                        sigRow[nc] = 0.0;
+                    }
+                }
+                // The first flag category is the flag itself.
+                Bool allFlagged = True;
+                Bool* catRow = flagCat.data() + size_t(r) * nCorr * nChan * nCat;
+                for (Int i = 0; i < nCorr * nChan; i++) {
+                    catRow[i] = flagRow[i];
+                    allFlagged = allFlagged && flagRow[i];
+                }
+                rowFlags[r] = allFlagged;
             }
-        }
-
-        // Work out which axis increments fastests, pol or channel
-        // The COMPLEX axis is assumed to be first, and the IF axis is assumed
-        // to be after STOKES and FREQ.
-        Bool polFastest = (getIndex(_coordType, "STOKES") < getIndex(
-                _coordType, "FREQ"));
-        const Int nx = (polFastest ? nChan : nCorr);
-        const Int ny = (polFastest ? nCorr : nChan);
 
-        Int count = 0;
-        for (Int ifno = 0; ifno < max(1, _nIF); ifno++) {
-            // IFs go to separate rows in the MS
-            _ms.addRow();
-            row++;
-
-            // fill in values for all the unused columns
-            if (row == 0) {
-                msc.feed1().put(row, 0);
-                msc.feed2().put(row, 0);
-                msc.flagRow().put(row, False);
-                lastRowFlag = False;
-                msc.processorId().put(row, -1);
-                msc.observationId().put(row, 0);
-                msc.stateId().put(row, -1);
-            }
+            // Handle the random parameters sequentially, because scan
+            // numbers and intervals depend on the previous groups.
+            // Columns which hardly change are only put if their value changes.
+            Matrix<Double> uvw(3, nRow);
+            Vector<Int> ant1(nRow), ant2(nRow), ddId(nRow);
+            Vector<Double> interv(nRow), expos(nRow);
+            for (Int g = 0; g < nInBlock; g++) {
+                const Double* parm = &(parms[cur][size_t(g) * nParams]);
+
+                // Extract time in MJD seconds
+                //  (this has VERY limited precision [~0.01s])
+                const Double JDofMJD0 = 2400000.5;
+                Double time = parm[iTime0];
+                time -= JDofMJD0;
+                if (iTime1 >= 0)
+                    time += parm[iTime1];
+                time *= C::day;
+
+                // Extract fqid
+                Int freqId = iFreq > 0 ? Int(parm[iFreq]) : 1;
+
+                // Extract field Id
+                Int fieldId = 0;
+                if (iSource >= 0) {
+                    // make 0-based
+                    fieldId = (Int) parm[iSource] - 1;
+                }
 
-            // Fill scanNumber if changed since last row
-            if (scanNumber(arrayId) != lastFillScanNumber) {
-                msc.scanNumber().put(row, scanNumber(arrayId));
-                lastFillScanNumber = scanNumber(arrayId);
-            }
+                // Extract array/baseline/antenna info
+                Int arrayId = 0;
+                std::pair<Int, Int> ants;
+                if (iBsln >= 0) {
+                    Float baseline = parm[iBsln];
+                    ants = _extractAntennas(baseline);
+                    arrayId = Int(100.0 * (baseline - Int(baseline) + 0.001));
+                } else {
+                    Int antenna1 = parm[iAnt1];
+                    Int antenna2 = parm[iAnt2];
+                    ants = _extractAntennas(antenna1, antenna2);
+                    arrayId = iSubarr >= 0 ? Int(parm[iSubarr]) : 0;
+                }
+                _nArray = max(_nArray, arrayId + 1);
+                // Ensure arrayId-specific params are of correct length:
+                if (scanNumber.shape() < _nArray) {
+                    scanNumber.resize(_nArray, True);
+                    lastFieldId.resize(_nArray, True);
+                    lastFreqId.resize(_nArray, True);
+                    scanNumber(_nArray - 1) = 0;
+                    lastFieldId(_nArray - 1) = -1;
+                    lastFreqId(_nArray - 1) = -1;
+                }
 
-            weight = 0.0;
-            // Loop over chans and corrs:
-            for (Int ix = 0; ix < nx; ix++) {
-                for (Int iy = 0; iy < ny; iy++) {
-                    const Float visReal = _priGroup(count++);
-                    const Float visImag = _priGroup(count++);
-                    const Float wt = _priGroup(count++);
-                    const Int pol = (polFastest ? _corrIndex[iy]
-                            : _corrIndex[ix]);
-                    const Int chan = (polFastest ? ix : iy);
-                    if (wt <= 0.0) {
-                        weightSpec(pol, chan) = abs(wt);
-                        flag(pol, chan) = True;
-                        weight(pol) += abs(wt);
-                    } else {
-                        weightSpec(pol, chan) = wt;
-                        flag(pol, chan) = False;
-                        // weight column is sum of weight_spectrum (each pol):
-                        weight(pol) += wt;
-                    }
-                    vis(pol, chan) = Complex(visReal, visImag);
+                // Detect new scan (field or freqid change) for each arrayId
+                if (fieldId != lastFieldId(arrayId) || freqId != lastFreqId(arrayId)
+                        || time - lastFillTime > 300.0) {
+                    scanNumber(arrayId)++;
+                    lastFieldId(arrayId) = fieldId;
+                    lastFreqId(arrayId) = freqId;
                 }
-            }
 
-            // calculate sigma (weight = inverse variance)
-            for (Int nc = 0; nc < nCorr; nc++) {
-                if (weight(nc) > 0.0) {
-                    sigma(nc) = sqrt(1.0 / weight(nc));
+                // If integration time is a RP, use it:
+                if (iInttim > -1) {
+                    discernIntExp = False;
+                    exposure = parm[iInttim];
+                    interval = exposure;
                 } else {
-                    sigma(nc) = 0.0;
+                    // keep track of minimum which is the only one
+                    // (if time step is larger than UVFITS precision (and zero))
+                    discernIntExp = True;
+                    Double tempint;
+                    tempint = time - lastFillTime;
+                    if (tempint > 0.01) {
+                        discernedInt = min(discernedInt, tempint);
+                    }
                 }
-            }
 
-            // If available, store interval/exposure
-            if (!discernIntExp) {
-                msc.interval().put(row, interval);
-                msc.exposure().put(row, exposure);
-            }
+                for (Int ifno = 0; ifno < nif; ifno++) {
+                    // IFs go to separate rows in the MS
+                    row++;
+                    const Int r = row - firstRow;
+
+                    // fill in values for all the unused columns
+                    if (row == 0) {
+                        msc.feed1().put(row, 0);
+                        msc.feed2().put(row, 0);
+                        msc.flagRow().put(row, False);
+                        lastRowFlag = False;
+                        msc.processorId().put(row, -1);
+                        msc.observationId().put(row, 0);
+                        msc.stateId().put(row, -1);
+                    }
 
-            msc.data().put(row, vis);
+                    // Fill scanNumber if changed since last row
+                    if (scanNumber(arrayId) != lastFillScanNumber) {
+                        msc.scanNumber().put(row, scanNumber(arrayId));
+                        lastFillScanNumber = scanNumber(arrayId);
+                    }
 
-            msc.weight().put(row, weight);
-            msc.sigma().put(row, sigma);
-            msc.weightSpectrum().put(row, weightSpec);
+                    // If available, store interval/exposure
+                    interv(r) = interval;
+                    expos(r) = exposure;
 
-            msc.flag().put(row, flag);
-            msc.flagCategory().put(row, flagCat);
-            Bool rowFlag = allEQ(flag, True);
-            if (rowFlag != lastRowFlag) {
-                msc.flagRow().put(row, rowFlag);
-                lastRowFlag = rowFlag;
-            }
+                    if (rowFlags(r) != lastRowFlag) {
+                        msc.flagRow().put(row, rowFlags(r));
+                        lastRowFlag = rowFlags(r);
+                    }
 
-            if (arrayId != lastFillArrayId) {
-                msc.arrayId().put(row, arrayId);
-                lastFillArrayId = arrayId;
-            }
-            // Always put antenna1 & antenna2 since it is bound to the
-            // aipsStMan and is assumed to change every row
-            msc.antenna1().put(row, ant1);
-            msc.antenna2().put(row, ant2);
-            if (time != lastFillTime) {
-                msc.time().put(row, time);
-                msc.timeCentroid().put(row, time);
-                lastFillTime = time;
-            }
-            msc.uvw().put(row, uvw);
+                    if (arrayId != lastFillArrayId) {
+                        msc.arrayId().put(row, arrayId);
+                        lastFillArrayId = arrayId;
+                    }
+                    // Always put antenna1 & antenna2 since it is bound to the
+                    // aipsStMan and is assumed to change every row
+                    ant1(r) = ants.first;
+                    ant2(r) = ants.second;
+                    if (time != lastFillTime) {
+                        msc.time().put(row, time);
+                        msc.timeCentroid().put(row, time);
+                        lastFillTime = time;
+                    }
+                    // Convert from units of seconds to meters
+                    uvw(0, r) = parm[iU] * C::c;
+                    uvw(1, r) = parm[iV] * C::c;
+                    uvw(2, r) = parm[iW] * C::c;
+
+                    // determine the spectralWindowId
+                    Int spW = ifno;
+                    if (iFreq >= 0) {
+                        spW = (Int) parm[iFreq] - 1; // make 0-based
+                        if (_nIF > 0) {
+                            spW *= _nIF;
+                            spW += ifno;
+                        }
+                    }
+                    nSpW = max(nSpW, spW + 1);
 
-            // determine the spectralWindowId
-            Int spW = ifno;
-            if (iFreq >= 0) {
-                spW = (Int) _priGroup.parm(iFreq) - 1; // make 0-based
-                if (_nIF > 0) {
-                    spW *= _nIF;
-                    spW += ifno;
+                    // Always put DDI (SSM) since it might change rapidly
+                    ddId(r) = spW;
+
+                    // store the fieldId
+                    if (fieldId != lastFillFieldId) {
+                        msc.fieldId().put(row, fieldId);
+                        nField = max(nField, fieldId + 1);
+                        lastFillFieldId = fieldId;
+                    }
                 }
             }
-            nSpW = max(nSpW, spW + 1);
 
-            // Always put DDI (SSM) since it might change rapidly
-            msc.dataDescId().put(row, spW);
-
-            // store the fieldId
-            if (fieldId != lastFillFieldId) {
-                msc.fieldId().put(row, fieldId);
-                nField = max(nField, fieldId + 1);
-                lastFillFieldId = fieldId;
+            // Write the columns changing every row for the entire block.
+            Slicer rows(IPosition(1, firstRow), IPosition(1, nRow));
+            if (!discernIntExp) {
+                msc.interval().putColumnRange(rows, interv);
+                msc.exposure().putColumnRange(rows, expos);
             }
+            msc.data().putColumnRange(rows, vis);
+            msc.weight().putColumnRange(rows, weight);
+            msc.sigma().putColumnRange(rows, sigma);
+            msc.weightSpectrum().putColumnRange(rows, weightSpec);
+            msc.flag().putColumnRange(rows, flag);
+            msc.flagCategory().putColumnRange(rows, flagCat);
+            msc.antenna1().putColumnRange(rows, ant1);
+            msc.antenna2().putColumnRange(rows, ant2);
+            msc.uvw().putColumnRange(rows, uvw);
+            msc.dataDescId().putColumnRange(rows, ddId);
+        } catch (...) {
+            excp = std::current_exception();
+        }
+#ifdef USE_THREADS
+        if (reader.joinable()) {
+            reader.join();
+        }
+#else
+        if (nNext > 0 && !excp) {
+            readGroupBlock(_priGroup, nNext, nParams, nData,
+                           parms[1-cur], data[1-cur]);
+        }
+#endif
+        if (excp) {
+            std::rethrow_exception(excp);
+        }
+        if (readExcp) {
+            std::rethrow_exception(readExcp);
         }
-        meter.update((group + 1) * 1.0);
+        nDone += nInBlock;
+        meter.update(nDone * 1.0);
+        nInBlock = nNext;
+        cur = 1 - cur;
     }
     // If determining interval on-the-fly, fill interval/exposure columns
     //  now:
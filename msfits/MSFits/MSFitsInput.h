@@ -230,6 +230,14 @@ public:
   Double parm(Int i)
   { return pf ? pf->parm(i) : ( pl ? pl->parm(i) : ps->parm(i));}
 
+  // Copy all (scaled) parameters of the current group
+  void copyParms(Double* target) const
+  { pf ? pf->copyparm(target) : ( pl ? pl->copyparm(target) : ps->copyparm(target));}
+
+  // Copy the first n (scaled) data values of the current group.
+  // They are the same as given by operator().
+  void copyData(Float* target, Int n);
+
   // Get group data with index i, scaled and converted to Double
   Double operator () (Int i) const
   { return pf ? (*pf)(i) : ( pl ? (*pl)(i) : (*ps)(i));}
@@ -272,7 +280,11 @@ public:
 
   // Create from output and input file names. This function opens the input
   // file, and checks the output file is writable.
-  MSFitsInput(const String& msFile, const String& fitsFile, const Bool NewNameStyle=False);
+  // The main table of a random group file is filled in memory if it fits,
+  // otherwise in blocks of groups. If <src>fillInBlocks</src> is True,
+  // it is always filled in blocks.
+  MSFitsInput(const String& msFile, const String& fitsFile,
+              const Bool NewNameStyle=False, const Bool fillInBlocks=False);
   
   MSFitsInput(const MSFitsInput& other) = delete;
 
@@ -319,6 +331,7 @@ private:
   Bool _useAltrval;
   Vector<Double> _chanFreq;
   Bool _newNameStyle;
+  Bool _fillInBlocks;
   Vector<Double> _obsTime;
 
   Matrix<Double> _restFreq; // used for UVFITS
@@ -383,7 +396,8 @@ private:
   // Fill the main table from the Primary group data
   // if we have enough memory try to do it in mem
   void fillMSMainTableColWise(Int& nField, Int& nSpW);
-  //else do it row by row
+  //else do it in blocks of groups; the next block is read while the
+  //current one is converted (in parallel) and written
   void fillMSMainTable(Int& nField, Int& nSpW);
 
   // fill spectralwindow table from FITS FQ table + header info
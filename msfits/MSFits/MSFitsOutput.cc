@@ -65,8 +65,14 @@
 
 #include <casacore/casa/Logging/LogIO.h>
 
+#include <algorithm>
+#include <exception>
 #include <set>
 #include <limits>
+#include <vector>
+#ifdef USE_THREADS
+#include <thread>
+#endif
 
 namespace casacore {
 
@@ -381,6 +387,83 @@ static void defineRandomParam(Record& ek, Int n, const String& name,
     ek.setComment(ptype, comment);
 }
 
+// The random parameters of a group written by _writeMain.
+struct MSFitsGroupParms {
+    Float u, v, w;
+    Float date1, date2;
+    Float baseline, subarray, antenna1, antenna2;
+    Float freqsel;
+    Float source, inttim;
+};
+
+// Average the selected channels of the data of an input row (for the
+// correlations in FITS order) and store the real, imaginary and weight
+// values in the group data. The weight is made negative if flagged.
+// sums and flagcounter are scratch buffers of 6*numcorr0 and numcorr0
+// elements. It returns the pointer past the stored values.
+static Float* averageChannels(Float* outptr, const Complex* iptr,
+        const Bool* fptr, const Float* wptr, Bool rowFlag,
+        const uInt* indptr, Int numcorr0, Int chanstart, Int nchan,
+        Int chanstep, Int avgchan, Float* sums, Int* flagcounter) {
+    Float* realcorr = sums;
+    Float* imagcorr = sums + numcorr0;
+    Float* wgtaver = sums + 2 * numcorr0;
+    Float* realcorrf = sums + 3 * numcorr0;
+    Float* imagcorrf = sums + 4 * numcorr0;
+    Float* wgtaverf = sums + 5 * numcorr0;
+    std::fill(sums, sums + 6 * numcorr0, Float(0));
+    std::fill(flagcounter, flagcounter + numcorr0, 0);
+    Int chancounter = 0;
+    for (Int k = chanstart; k < (nchan * chanstep + chanstart); k += chanstep) {
+        if (chancounter != avgchan) {
+            for (Int j = 0; j < numcorr0; j++) {
+                Int offset = indptr[j] + k * numcorr0;
+                if (!fptr[offset]) {
+                    realcorr[j] += iptr[offset].real();
+                    imagcorr[j] += iptr[offset].imag();
+                    wgtaver[j] += wptr[offset];
+                    flagcounter[j]++;
+                }
+                else {
+                    realcorrf[j] += iptr[offset].real();
+                    imagcorrf[j] += iptr[offset].imag();
+                    wgtaverf[j] += wptr[offset];
+                }
+            }
+            ++chancounter;
+        }
+        if (chancounter == avgchan) {
+            for (Int j = 0; j < numcorr0; j++) {
+                if (flagcounter[j] > 0) {
+                    outptr[0] = realcorr[j] / flagcounter[j];
+                    outptr[1] = imagcorr[j] / flagcounter[j];
+                    outptr[2] = wgtaver[j] / flagcounter[j];
+                }
+                else if (wgtaverf[j] > 0) {
+                    outptr[0] = realcorrf[j] / avgchan;
+                    outptr[1] = imagcorrf[j] / avgchan;
+                    outptr[2] = -wgtaverf[j] / avgchan;
+                }
+                else {
+                    outptr[0] = realcorrf[j] / avgchan;
+                    outptr[1] = imagcorrf[j] / avgchan;
+                    outptr[2] = 0;
+                }
+                if (rowFlag) {
+                    //calculate the average even if row flagged, just in case
+                    //unflag the row and it has some reasonable data there
+                    outptr[2] = -abs(outptr[2]);
+                }
+                outptr += 3;
+            }
+            std::fill(sums, sums + 6 * numcorr0, Float(0));
+            std::fill(flagcounter, flagcounter + numcorr0, 0);
+            chancounter = 0;
+        }
+    }
+    return outptr;
+}
+
 std::shared_ptr<FitsOutput> MSFitsOutput::_writeMain(Int& refPixelFreq, Double& refFreq,
     Double& chanbw, const String &outFITSFile,
     const Block<Int>& spwidMap, Int nrspw,
@@ -852,28 +935,13 @@ std::shared_ptr<FitsOutput> MSFitsOutput::_writeMain(Int& refPixelFreq, Double&
     // Similarly, record the sort order (the following didn't work....)
     //  ek.define("history aips sort order", "TB");
 
-    Bool deleteIptr;
-    Matrix<Complex> indatatmp(IPosition(2, numcorr0, numchan0));
-    const Complex *iptr = indatatmp.getStorage(deleteIptr);
-
-    Bool deleteWtPtr;
-    Matrix<Float> inwttmp(numcorr0, numchan0);
-    const Float *wptr = inwttmp.getStorage(deleteWtPtr);
-
-    Bool deleteFlagPtr;
-    Matrix<Bool> inflagtmp(IPosition(2, numcorr0, numchan0));
-    const Bool *fptr = inflagtmp.getStorage(deleteFlagPtr);
-
-    Bool deleteIndPtr;
-    const uInt *indptr = stokesIndex.getStorage(deleteIndPtr);
+    // The shape of the data in a row.
+    const IPosition cellShape(2, numcorr0, numchan0);
+    const uInt *indptr = stokesIndex.data();
 
     // Do we need to check units? I think the MS rules are that units cannot
     // be changed.
 
-    Vector<Double> uvw(3);
-    Int day;
-    Double dayFraction;
-
     const Double oneOverC = 1.0 / C::c;
 
     // Sort the table in order of TIME, ANTENNA1, ANTENNA2, FIELDID, SPWID.
@@ -910,6 +978,7 @@ std::shared_ptr<FitsOutput> MSFitsOutput::_writeMain(Int& refPixelFreq, Double&
     ScalarColumn<Int> inant2(sortTable, MS::columnName(MS::ANTENNA2));
     ScalarColumn<Int> inarray(sortTable, MS::columnName(MS::ARRAY_ID));
     ScalarColumn<Int> inspwinid(sortTable, MS::columnName(MS::DATA_DESC_ID));
+    const Vector<Int> spwids(inspwinid.getColumn());
 
     ScalarColumn<Double> inexposure;
     ScalarColumn<Int> infieldid;
@@ -987,7 +1056,7 @@ std::shared_ptr<FitsOutput> MSFitsOutput::_writeMain(Int& refPixelFreq, Double&
                 miniDDIDs.resize(nrowsThisTBF);
                 miniSort.resize(nrowsThisTBF);
                 for (uInt rowInTBF = 0; rowInTBF < nrowsThisTBF; ++rowInTBF) {
-                    miniDDIDs[rowInTBF] = spwidMap[inspwinid(rownr + rowInTBF)];
+                    miniDDIDs[rowInTBF] = spwidMap[spwids[rownr + rowInTBF]];
                     ++nperIF[miniDDIDs[rowInTBF]];
                 }
                 GenSortIndirect<Int,uInt>::sort(miniSort, miniDDIDs);
@@ -1082,367 +1151,383 @@ std::shared_ptr<FitsOutput> MSFitsOutput::_writeMain(Int& refPixelFreq, Double&
     // Check if first cell has a WEIGHT of correct shape.
     if (hasWeightArray) {
         IPosition shp = inweightarray.shape(0);
-        if (shp.nelements() > 0 && !shp.isEqual(inwttmp.shape())) {
+        if (shp.nelements() > 0 && !shp.isEqual(cellShape)) {
             hasWeightArray = False;
             os << LogIO::WARN << "WEIGHT_SPECTRUM is ignored (incorrect shape)"
                     << LogIO::POST;
         }
     }
 
+    // Loop through all rows.
     // Loop through all rows.
     ProgressMeter meter(0.0, nOutRow * 1.0, "UVFITS Writer", "Rows copied", "",
             "", True, nOutRow / 100);
 
+    // The groups are made in blocks of about 64 MBytes of input data.
+    // First the input rows of each group in a block are determined
+    // sequentially, because missing spectral windows shift the rows.
+    // Thereafter the columns are read for all rows in the block and the
+    // groups are averaged in parallel. The groups of a block are written
+    // by another thread (if built with USE_THREADS), while the next block
+    // is read and averaged.
+    const uInt nOutData = nif * uInt(nchan / avgchan) * numcorr0 * 3;
+    const size_t groupBytes = size_t(nif) * numcorr0 * numchan0 *
+        (sizeof(Complex) + sizeof(Bool) + sizeof(Float));
+    const uInt blockGroups = std::max<size_t>(1, 64 * 1024 * 1024 / groupBytes);
+    const size_t ncell = size_t(numcorr0) * numchan0;
+    // Flagged data used for the IFs missing in a group.
+    const Vector<Complex> padData(ncell, Complex());
+    const Vector<Bool> padFlags(ncell, True);
+    const Vector<Float> padWeights(ncell, Float(0));
+
+    // Write the groups of a block.
+    auto writeGroups = [&] (const std::vector<Float>& data,
+                            const std::vector<MSFitsGroupParms>& parms) {
+        for (uInt g = 0; g < parms.size(); ++g) {
+            std::copy (data.begin() + size_t(g) * nOutData,
+                       data.begin() + size_t(g+1) * nOutData, optr);
+            const MSFitsGroupParms& gp = parms[g];
+            *ouu = gp.u;
+            *ovv = gp.v;
+            *oww = gp.w;
+            *odate1 = gp.date1;
+            *odate2 = gp.date2;
+            if (maxant < 256) {
+                *obaseline = gp.baseline;
+            } else {
+                *osubarray = gp.subarray;
+                *oantenna1 = gp.antenna1;
+                *oantenna2 = gp.antenna2;
+            }
+            *ofreqsel = gp.freqsel;
+            if (asMultiSource) {
+                *osource = gp.source;
+                *ointtim = gp.inttim;
+            }
+            writer.write();
+        }
+    };
+
     uInt tbfrownr = 0; // Input row # of (time, baseline, field).
     uInt outrownr = 0; // Output row #.
-
-    //Double lasttime(0.0);
-    Vector<Float> realcorr(numcorr0);
-    Vector<Float> imagcorr(numcorr0);
-    Vector<Float> wgtaver(numcorr0);
-    Vector<Float> realcorrf(numcorr0);
-    Vector<Float> imagcorrf(numcorr0);
-    Vector<Float> wgtaverf(numcorr0);
+    uInt nwritten = 0;
     Int old_nspws_found = -1; // Just for debugging curiosity.
-    while (tbfrownr < nrow) {
-        if (outrownr >= nOutRow) { // Shouldn't happen, but just in case...
-            os << LogIO::WARN
-                    << "The loop over output rows failed to stop when expected...stopping it now."
-                    << LogIO::POST;
-            break;
-        }
-
-        // Will only write a record if some non-flagged data found
-        //    Bool dowrite(True);   // temporarily disable, because FITSGroupWriter chokes
-
-        Float* outptr = optr; // reset for each spectral-window
-
-        // Loop over the IFs, whether or not the corresponding spws are present for
-        // this (time, baseline, field).
-        // rownr should only be used inside this loop; use tbfrownr outside.
-        uInt rawrownr = tbfrownr; // Essentially tbfrownr + m - # of missing spws
-        // so far.
-        uInt rownr = rawrownr;
-        uInt tbfend = tbfrownr + nif - 1;
-        if (_combineSpw && nif > 1) {
-            tbfend = tbfends[rownr];
-            rownr = sortIndex[rawrownr];
-        }
-
-        for (uInt m = 0; m < nif; ++m) {
-            Bool rowFlag; // FLAG_ROW
-
-            if (_combineSpw && (rownr >= nrow // flag remaining IFs in tbfrownr
-                    || inspwinid(rownr) != expectedDDIDs[m])) {
-                if (padWithFlags) {
-                    // Save this row for the next one, and fill in with flagged junk.
-
-                    indatatmp.set(0.0); // DATA matrix
-                    //indata.get(rownr, indatatmp);   // DATA matrix
-                    rowFlag = true;
-                    inflagtmp.set(true);
-                    inwttmp.set(0.0);
-                    // Don't update lasttime.
-                } else {
-                    os << LogIO::SEVERE
-                            << "A DATA_DESC_ID appeared out of the expected order.\n"
-                            << "MSes with multiple tunings (i.e. spw varies with time) cannot"
-                            << "\nbe exported with combinespw.  Export each tuning separately."
-                            << LogIO::POST;
-                    return 0;
-                }
-            } else { // The spw is present, use it.
-                if (rownr >= nrow) { // Shouldn't happen, but just in case...
+    Bool done = False;
+    Bool failed = False;
+    // The input row of each IF of the groups in a block (-1 is missing).
+    std::vector<Int64> groupRows;
+    // The input row of the (time, baseline, field) of each group.
+    std::vector<uInt> groupTbf;
+    std::vector<Float> outData[2];
+    std::vector<MSFitsGroupParms> outParms[2];
+    Int cur = 0;
+    std::exception_ptr excp, writeExcp;
+#ifdef USE_THREADS
+    std::thread writerThread;
+#endif
+    try {
+        while (tbfrownr < nrow  &&  !done) {
+            groupRows.clear();
+            groupTbf.clear();
+            while (tbfrownr < nrow  &&  groupTbf.size() < blockGroups) {
+                if (outrownr >= nOutRow) { // Shouldn't happen, but just in case...
                     os << LogIO::WARN
-                            << "The loop over input rows failed to stop when expected...stopping it now."
+                            << "The loop over output rows failed to stop when expected...stopping it now."
                             << LogIO::POST;
+                    done = True;
                     break;
                 }
 
-                indata.get(rownr, indatatmp); // DATA matrix
-                rowFlag = inrowflag(rownr);
-                indataflag.get(rownr, inflagtmp); // FLAG
-
-                // WEIGHT_SPECTRUM (defaults to WEIGHT)
-                Bool getwt = True;
-                if (hasWeightArray) {
-                    IPosition shp = inweightarray.shape(rownr);
-                    if (shp.isEqual(inwttmp.shape())) {
-                        inweightarray.get(rownr, inwttmp);
-                        getwt = False;
-                    }
+                // Loop over the IFs, whether or not the corresponding spws are
+                // present for this (time, baseline, field).
+                // rownr should only be used inside this loop; use tbfrownr outside.
+                uInt rawrownr = tbfrownr; // Essentially tbfrownr + m - # of missing spws
+                // so far.
+                uInt rownr = rawrownr;
+                uInt tbfend = tbfrownr + nif - 1;
+                if (_combineSpw && nif > 1) {
+                    tbfend = tbfends[rownr];
+                    rownr = sortIndex[rawrownr];
                 }
-                if (getwt) {
-                    //weight_spectrum may not exist but flag and data always will.
-                    IPosition shp = indatatmp.shape();
-                    Int nchan = shp(1); // either num of channels of num of lags
-                    //cout << "shp1=" << shp << " shp2=" << inflagtmp.shape()
-                    //     << " nchan=" << nchan << endl;
-                    if (nchan < 1) nchan = 1;
-                    const Vector<Float> wght = inweightscalar(rownr);
-                    for (Int p = 0; p < numcorr0; p++) {
-                        inwttmp.row(p) = wght(p) / nchan;
+                const size_t firstIF = groupRows.size();
+                groupRows.resize(firstIF + nif, -1);
+
+                for (uInt m = 0; m < nif; ++m) {
+                    if (_combineSpw && (rownr >= nrow // flag remaining IFs in tbfrownr
+                            || spwids[rownr] != expectedDDIDs[m])) {
+                        // Save this row for the next one, and fill in with
+                        // flagged junk.
+                        if (!padWithFlags) {
+                            os << LogIO::SEVERE
+                                    << "A DATA_DESC_ID appeared out of the expected order.\n"
+                                    << "MSes with multiple tunings (i.e. spw varies with time) cannot"
+                                    << "\nbe exported with combinespw.  Export each tuning separately."
+                                    << LogIO::POST;
+                            failed = True;
+                            break;
+                        }
+                    } else { // The spw is present, use it.
+                        if (rownr >= nrow) { // Shouldn't happen, but just in case...
+                            os << LogIO::WARN
+                                    << "The loop over input rows failed to stop when expected...stopping it now."
+                                    << LogIO::POST;
+                            break;
+                        }
+                        groupRows[firstIF + m] = rownr;
+                        if (! padWithFlags || rawrownr <= tbfend) {
+                            ++rawrownr; // register that the spw was present.
+                            rownr = _combineSpw && nif > 1 && rawrownr < nrow
+                                ? sortIndex[rawrownr] : rawrownr;
+                        }
                     }
                 }
-                /*
-                 Double rtime(86400.0*floor(intimec(0)/86400.0));
-                 cout << "rtime = " << rtime << " " << "nrows = " << intimec.nrow()
-                 << endl;
-                 cout << "time = " << intimec(rownr)-rtime;
-                 if (intimec(rownr)!=lasttime)
-                 cout << " ***NEW*** ";
-                 cout << endl;
-                 */
-                // lasttime = intimec(rownr);
-
-                if (! padWithFlags || rawrownr <= tbfend) {
-                    ++rawrownr; // register that the spw was present.
-                    rownr = _combineSpw && nif > 1
-                        ? sortIndex[rawrownr] : rawrownr;
+                if (failed) {
+                    break;
                 }
+                groupTbf.push_back(tbfrownr);
+                ++outrownr;
+
+                // How many spws showed up for this (time_centroid, ant1, ant2, field)?
+                if (rawrownr == tbfrownr) {
+                    os << LogIO::WARN << "No spectral windows were present for row # "
+                            << tbfrownr << "\n"
+                            << " input (time_centroid, ant1, ant2, field) =\n" << "  ("
+                            << intimec(tbfrownr) << ", " << inant1(tbfrownr) << ", "
+                            << inant2(tbfrownr) << ", " << infieldid(tbfrownr) << ")"
+                            << LogIO::POST;
+                } else {
+                    Int nspws_found = rawrownr - tbfrownr; // Just for debugging curiosity.
+
+                    if (nspws_found != old_nspws_found) {
+                        old_nspws_found = nspws_found;
+                        os << LogIO::DEBUG1 << "Beginning with row # " << tbfrownr
+                                << LogIO::POST;
+                        os << LogIO::DEBUG1
+                                << " input (time_centroid, ant1, ant2, field) ="
+                                << LogIO::POST;
+
+                        // intimec is in modified julian day seconds, but Time::Time() takes
+                        // julian days.
+                        Double mjd_in_s = intimec(tbfrownr);
+                        Time juldate(2400000.5 + mjd_in_s / 86400.0);
+                        os << LogIO::DEBUG1 << "  (" << juldate.year() << "-";
+                        if (juldate.month() < 10)
+                            os << "0";
+                        os << juldate.month() << "-";
+                        if (juldate.dayOfMonth() < 10)
+                            os << "0";
+                        os << juldate.dayOfMonth() << "-";
+
+                        if (juldate.hours() < 10) // Time stores things internally as days.
+                            os << "0"; // Do we really want to use it for sub-day units
+                        os << juldate.hours() << ":"; // when we start with intimec in s?
+                        if (juldate.minutes() < 10)
+                            os << "0";
+                        os << juldate.minutes() << ":";
+                        mjd_in_s -= 60.0 * static_cast<Int> (mjd_in_s / 60.0);
+                        os << mjd_in_s;
+
+                        os << ", " << inant1(tbfrownr) << ", " << inant2(tbfrownr)
+                                << ", "
+                        // infieldid is unattached and segfaultable if !asMultiSource.
+                                << (asMultiSource ? infieldid(tbfrownr) : 0) << "):"
+                                << LogIO::POST;
+                        os << LogIO::DEBUG1 << nspws_found << " spws present out of "
+                                << nif << " IFs." << LogIO::POST;
+                    }
+
+                    tbfrownr = rawrownr; // Increment it by the # of spws found.
+                }
+            }
+            const uInt ngroup = groupTbf.size();
+            if (failed  ||  ngroup == 0) {
+                break;
             }
 
-            // We should optimize this loop more, probably do frequency as
-            // the inner loop?
-            realcorr.set(0);
-            imagcorr.set(0);
-            wgtaver.set(0);
-            realcorrf.set(0);
-            imagcorrf.set(0);
-            wgtaverf.set(0);
-            Int chancounter = 0;
-            Vector<Int> flagcounter(numcorr0);
-            flagcounter.set(0);
-            //cout << "chanstart=" << chanstart << " nchan=" << nchan
-            //     << " chanstep=" << chanstep << " avgchan=" << avgchan << endl;
-            for (Int k = chanstart; k < (nchan * chanstep + chanstart); k += chanstep) {
-                //cout << "row = " << tbfrownr << " "
-                //   << outptr << " " << optr << " " << outptr-optr << " ";
-                //   << "ddi = " << m << " (" << inspwinid(i) << ") "
-                //   << "chan = " << k << " / "
-                //   << boolalpha
-                //   << "hasWeightArray = " << hasWeightArray << " "
-                //   << "wt(chan) = " << inwttmp.column(k) << "; "
-                //   << "flag(chan) = " << inflagtmp.column(k) << " "
-                //   << "shapes: "
-                //   << indatatmp.shape() << " "
-                //   << inwttmp.shape()  << " "
-                //   << inflagtmp.shape()  << " "
-                //   << endl;
-                /*
-                if (chancounter != avgchan) {
-                    for (Int j = 0; j < numcorr0; j++) {
-                        Int offset = indptr[j] + k * numcorr0;
-                        //cout << "j=" << j << " real=" << iptr[offset].real()
-                        //     << " imag=" << iptr[offset].imag() << endl;
-                        if (!fptr[offset]) {
-                            realcorr[j] += iptr[offset].real() * wptr[offset];
-                            imagcorr[j] += iptr[offset].imag() * wptr[offset];
-                            wgtaver[j] += wptr[offset];
-                            flagcounter++;
-                        }
-                        else {
-                            realcorrf[j] += iptr[offset].real() * wptr[offset];
-                            imagcorrf[j] += iptr[offset].imag() * wptr[offset];
-                            wgtaverf[j] += wptr[offset];
-                        }
-                        //cout << "j=" << j << " k=" << k
-                        //     << " real=" << realcorr[j] << " image=" << imagcorr[j]
-                        //     << " offset=" << offset << " chancounter=" << chancounter << endl;
-                    }
-                    ++chancounter;
+            // Read the columns for all input rows of the groups in the block.
+            uInt firstRow = groupTbf[0];
+            uInt lastRow = groupTbf[ngroup - 1];
+            for (Int64 inrow : groupRows) {
+                if (inrow >= 0) {
+                    firstRow = min(firstRow, uInt(inrow));
+                    lastRow = max(lastRow, uInt(inrow));
                 }
-                if (chancounter == avgchan) {
-                    for (Int j = 0; j < numcorr0; j++) {
-                        if (wgtaver[j] > 0) {
-                            outptr[0] = realcorr[j] / wgtaver[j];
-                            outptr[1] = imagcorr[j] / wgtaver[j];
-                            outptr[2] = wgtaver[j] / flagcounter * numcorr0;
-                        }
-                        else if (wgtaverf[j] > 0) {
-                            outptr[0] = realcorrf[j] / wgtaverf[j];
-                            outptr[1] = imagcorrf[j] / wgtaverf[j];
-                            outptr[2] = -wgtaverf[j] / avgchan;
-                        }
-                        else {
-                            outptr[0] = realcorrf[j] / avgchan;
-                            outptr[1] = imagcorrf[j] / avgchan;
-                            outptr[2] = 0;
-                        }
-                        if (rowFlag) {
-                            //calculate the average even if row flagged, just in case
-                            //unflag the row and it has some reasonable data there
-                            outptr[2] = -abs(outptr[2]);
-                        }
-                        outptr += 3;
-                    }
-                    realcorr.set(0);
-                    imagcorr.set(0);
-                    wgtaver.set(0);
-                    realcorrf.set(0);
-                    imagcorrf.set(0);
-                    wgtaverf.set(0);
-                    chancounter = 0;
-                    flagcounter = 0;
+            }
+            const uInt nread = lastRow - firstRow + 1;
+            Slicer rows(IPosition(1, firstRow), IPosition(1, nread));
+            const IPosition blockShape(3, numcorr0, numchan0, nread);
+            Array<Complex> data(indata.getColumnRange(rows));
+            Array<Bool> flags(indataflag.getColumnRange(rows));
+            if (!data.shape().isEqual(blockShape)
+                    || !flags.shape().isEqual(blockShape)) {
+                throw AipsError("MSFitsOutput: shape of " + columnName
+                                + " or FLAG differs from the spectral window shape");
+            }
+            Array<Float> weights(inweightscalar.getColumnRange(rows));
+            if (!weights.shape().isEqual(IPosition(2, numcorr0, nread))) {
+                throw AipsError("MSFitsOutput: shape of WEIGHT differs from "
+                                "the number of correlations");
+            }
+            // WEIGHT_SPECTRUM (defaults to WEIGHT)
+            Vector<Bool> hasWtSpec(nread, False);
+            Array<Float> wtspec;
+            if (hasWeightArray) {
+                for (uInt r = 0; r < nread; ++r) {
+                    hasWtSpec[r] = inweightarray.shape(firstRow + r).isEqual(cellShape);
                 }
-                */
-                if (chancounter != avgchan) {
-                    for (Int j = 0; j < numcorr0; j++) {
-                        Int offset = indptr[j] + k * numcorr0;
-                        //cout << "j=" << j << " real=" << iptr[offset].real()
-                        //     << " imag=" << iptr[offset].imag() << endl;
-                        if (!fptr[offset]) {
-                            realcorr[j] += iptr[offset].real();
-                            imagcorr[j] += iptr[offset].imag();
-                            wgtaver[j] += wptr[offset];
-                            flagcounter[j]++;
-                        }
-                        else {
-                            realcorrf[j] += iptr[offset].real();
-                            imagcorrf[j] += iptr[offset].imag();
-                            wgtaverf[j] += wptr[offset];
+                if (allTrue(hasWtSpec)) {
+                    wtspec.reference(inweightarray.getColumnRange(rows));
+                } else {
+                    wtspec.resize(blockShape);
+                    for (uInt r = 0; r < nread; ++r) {
+                        if (hasWtSpec[r]) {
+                            Matrix<Float> cell(cellShape, wtspec.data() + r * ncell,
+                                               SHARE);
+                            inweightarray.get(firstRow + r, cell);
                         }
-                        //cout << "j=" << j << " k=" << k
-                        //     << " real=" << realcorr[j] << " image=" << imagcorr[j]
-                        //     << " offset=" << offset << " chancounter=" << chancounter << endl;
                     }
-                    ++chancounter;
                 }
-                if (chancounter == avgchan) {
-                    for (Int j = 0; j < numcorr0; j++) {
-                        if (flagcounter[j] > 0) {
-                            outptr[0] = realcorr[j] / flagcounter[j];
-                            outptr[1] = imagcorr[j] / flagcounter[j];
-                            outptr[2] = wgtaver[j] / flagcounter[j];
-                        }
-                        else if (wgtaverf[j] > 0) {
-                            outptr[0] = realcorrf[j] / avgchan;
-                            outptr[1] = imagcorrf[j] / avgchan;
-                            outptr[2] = -wgtaverf[j] / avgchan;
-                        }
-                        else {
-                            outptr[0] = realcorrf[j] / avgchan;
-                            outptr[1] = imagcorrf[j] / avgchan;
-                            outptr[2] = 0;
+            }
+            Vector<Bool> rowflags(inrowflag.getColumnRange(rows));
+            Array<Double> uvws(inuvw.getColumnRange(rows));
+            Vector<Double> times(intimec.getColumnRange(rows));
+            Vector<Int> ant1s(inant1.getColumnRange(rows));
+            Vector<Int> ant2s(inant2.getColumnRange(rows));
+            Vector<Int> arrays(inarray.getColumnRange(rows));
+            Vector<Int> fields;
+            Vector<Double> exposures;
+            if (asMultiSource) {
+                fields.reference(infieldid.getColumnRange(rows));
+                exposures.reference(inexposure.getColumnRange(rows));
+            }
+
+            // Average the IFs of the groups. The groups are independent,
+            // so it can be done in parallel.
+            std::vector<Float>& blockData = outData[cur];
+            std::vector<MSFitsGroupParms>& blockParms = outParms[cur];
+            blockData.resize(size_t(ngroup) * nOutData);
+            blockParms.resize(ngroup);
+            const Complex* dataPtr = data.data();
+            const Bool* flagPtr = flags.data();
+            const Float* weightPtr = weights.data();
+            const Float* wtspecPtr = wtspec.data();
+            const Double* uvwPtr = uvws.data();
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+            {
+                std::vector<Float> rowWeights(ncell);
+                std::vector<Float> sums(6 * numcorr0);
+                std::vector<Int> flagcounter(numcorr0);
+#ifdef _OPENMP
+#pragma omp for
+#endif
+                for (Int g = 0; g < Int(ngroup); ++g) {
+                    Float* outptr = blockData.data() + size_t(g) * nOutData;
+                    for (uInt m = 0; m < nif; ++m) {
+                        const Int64 inrow = groupRows[size_t(g) * nif + m];
+                        if (inrow < 0) {
+                            outptr = averageChannels (outptr, padData.data(),
+                                padFlags.data(), padWeights.data(), True,
+                                indptr, numcorr0, chanstart, nchan, chanstep,
+                                avgchan, sums.data(), flagcounter.data());
+                            continue;
                         }
-                        if (rowFlag) {
-                            //calculate the average even if row flagged, just in case
-                            //unflag the row and it has some reasonable data there
-                            outptr[2] = -abs(outptr[2]);
+                        const size_t r = inrow - firstRow;
+                        const Float* wptr;
+                        if (hasWtSpec[r]) {
+                            wptr = wtspecPtr + r * ncell;
+                        } else {
+                            const Float* wght = weightPtr + r * numcorr0;
+                            for (Int k = 0; k < numchan0; ++k) {
+                                for (Int p = 0; p < numcorr0; ++p) {
+                                    rowWeights[k * numcorr0 + p] = wght[p] / numchan0;
+                                }
+                            }
+                            wptr = rowWeights.data();
                         }
-                        outptr += 3;
+                        outptr = averageChannels (outptr, dataPtr + r * ncell,
+                            flagPtr + r * ncell, wptr, rowflags[r],
+                            indptr, numcorr0, chanstart, nchan, chanstep,
+                            avgchan, sums.data(), flagcounter.data());
+                    }
+
+                    // Random parameters
+                    const size_t t = groupTbf[g] - firstRow;
+                    MSFitsGroupParms& gp = blockParms[g];
+                    // UU VV WW
+                    gp.u = uvwPtr[3 * t] * oneOverC;
+                    gp.v = uvwPtr[3 * t + 1] * oneOverC;
+                    gp.w = uvwPtr[3 * t + 2] * oneOverC;
+                    // TIME
+                    Int day;
+                    Double dayFraction;
+                    timeToDay(day, dayFraction, times[t]);
+                    gp.date1 = day;
+                    gp.date2 = dayFraction;
+                    // BASELINE
+                    if (maxant < 256) {
+                        gp.baseline = antnumbers[ant1s[t]] * 256 +
+                                antnumbers[ant2s[t]] + arrays[t] * 0.01;
+                    } else {
+                        gp.subarray = arrays[t] + 1;
+                        gp.antenna1 = antnumbers[ant1s[t]];
+                        gp.antenna2 = antnumbers[ant2s[t]];
+                    }
+                    // FREQSEL (in the future it might be FREQ_GRP+1)
+                    gp.freqsel = _combineSpw ? 1 : 1 + spwidMap[spwids[groupTbf[g]]];
+                    // SOURCE
+                    // INTTIM
+                    if (asMultiSource) {
+                        gp.source = 1 + fieldidMap[fields[t]];
+                        gp.inttim = exposures[t];
                     }
-                    realcorr.set(0);
-                    imagcorr.set(0);
-                    wgtaver.set(0);
-                    realcorrf.set(0);
-                    imagcorrf.set(0);
-                    wgtaverf.set(0);
-                    chancounter = 0;
-                    flagcounter.set(0);
                 }
             }
 
-            // if(nOutRow - outtbfrownr < 5)
-            //   os << LogIO::DEBUG1 << "(outtbfrownr, m) = (" << outtbfrownr
-            //      << ", " << m << ")" << LogIO::POST;
-
-        } // Ends loop over IFs.
-
-        // If found data at this timestamp, write it out
-        //    if (dowrite) {
-        // Random parameters
-        // UU VV WW
-        inuvw.get(tbfrownr, uvw);
-        *ouu = uvw(0) * oneOverC;
-        *ovv = uvw(1) * oneOverC;
-        *oww = uvw(2) * oneOverC;
-
-        // TIME
-        timeToDay(day, dayFraction, intimec(tbfrownr));
-        *odate1 = day;
-        *odate2 = dayFraction;
-
-        // BASELINE
-        if (maxant < 256) {
-            *obaseline = antnumbers(inant1(tbfrownr)) * 256 +
-                    antnumbers(inant2(tbfrownr)) +
-                    inarray(tbfrownr) * 0.01;
-        } else {
-            *osubarray = inarray(tbfrownr) + 1;
-            *oantenna1 = antnumbers(inant1(tbfrownr));
-            *oantenna2 = antnumbers(inant2(tbfrownr));
-        }
-
-        // FREQSEL (in the future it might be FREQ_GRP+1)
-        //    *ofreqsel = inddid(i) + 1;
-        *ofreqsel = _combineSpw ? 1 : 1 + spwidMap[inspwinid(tbfrownr)];
-
-        // SOURCE
-        // INTTIM
-        if (asMultiSource) {
-            *osource = 1 + fieldidMap[infieldid(tbfrownr)];
-            *ointtim = inexposure(tbfrownr);
-        }
-
-        writer.write();
-        ++outrownr;
-        meter.update(outrownr);
-
-        // How many spws showed up for this (time_centroid, ant1, ant2, field)?
-        if (rawrownr == tbfrownr) {
-            os << LogIO::WARN << "No spectral windows were present for row # "
-                    << tbfrownr << "\n"
-                    << " input (time_centroid, ant1, ant2, field) =\n" << "  ("
-                    << intimec(tbfrownr) << ", " << inant1(tbfrownr) << ", "
-                    << inant2(tbfrownr) << ", " << infieldid(tbfrownr) << ")"
-                    << LogIO::POST;
-        } else {
-            Int nspws_found = rawrownr - tbfrownr; // Just for debugging curiosity.
-
-            if (nspws_found != old_nspws_found) {
-                old_nspws_found = nspws_found;
-                os << LogIO::DEBUG1 << "Beginning with row # " << tbfrownr
-                        << LogIO::POST;
-                os << LogIO::DEBUG1
-                        << " input (time_centroid, ant1, ant2, field) ="
-                        << LogIO::POST;
-
-                // intimec is in modified julian day seconds, but Time::Time() takes
-                // julian days.
-                Double mjd_in_s = intimec(tbfrownr);
-                Time juldate(2400000.5 + mjd_in_s / 86400.0);
-                os << LogIO::DEBUG1 << "  (" << juldate.year() << "-";
-                if (juldate.month() < 10)
-                    os << "0";
-                os << juldate.month() << "-";
-                if (juldate.dayOfMonth() < 10)
-                    os << "0";
-                os << juldate.dayOfMonth() << "-";
-
-                if (juldate.hours() < 10) // Time stores things internally as days.
-                    os << "0"; // Do we really want to use it for sub-day units
-                os << juldate.hours() << ":"; // when we start with intimec in s?
-                if (juldate.minutes() < 10)
-                    os << "0";
-                os << juldate.minutes() << ":";
-                mjd_in_s -= 60.0 * static_cast<Int> (mjd_in_s / 60.0);
-                os << mjd_in_s;
-
-                os << ", " << inant1(tbfrownr) << ", " << inant2(tbfrownr)
-                        << ", "
-                // infieldid is unattached and segfaultable if !asMultiSource.
-                        << (asMultiSource ? infieldid(tbfrownr) : 0) << "):"
-                        << LogIO::POST;
-                os << LogIO::DEBUG1 << nspws_found << " spws present out of "
-                        << nif << " IFs." << LogIO::POST;
+            // Wait until the previous block is written and write this one.
+#ifdef USE_THREADS
+            if (writerThread.joinable()) {
+                writerThread.join();
             }
-
-            tbfrownr = rawrownr; // Increment it by the # of spws found.
+#endif
+            if (writeExcp) {
+                break;
+            }
+            meter.update(nwritten);
+#ifdef USE_THREADS
+            const Int blk = cur;
+            writerThread = std::thread([&, blk]() {
+                try {
+                    writeGroups(outData[blk], outParms[blk]);
+                } catch (...) {
+                    writeExcp = std::current_exception();
+                }
+            });
+#else
+            writeGroups(outData[cur], outParms[cur]);
+#endif
+            nwritten += ngroup;
+            cur = 1 - cur;
         }
-
-        //    } // dowrite
+    } catch (...) {
+        excp = std::current_exception();
+    }
+#ifdef USE_THREADS
+    if (writerThread.joinable()) {
+        writerThread.join();
+    }
+#endif
+    if (excp) {
+        std::rethrow_exception(excp);
+    }
+    if (writeExcp) {
+        std::rethrow_exception(writeExcp);
+    }
+    if (failed) {
+        return 0;
     }
+    meter.update(nwritten);
     os << LogIO::DEBUG1 << "tbfrownr = " << tbfrownr << LogIO::POST;
     os << LogIO::DEBUG1 << "outrownr = " << outrownr << LogIO::POST;
     os << LogIO::DEBUG1 << "nrow     = " << nrow << LogIO::POST;
@@ -136,6 +136,8 @@ private:
 
 
     // Write the main table.
+    // The rows are read in blocks and the groups of a block are averaged
+    // in parallel; they are written while the next block is processed.
     //    @param refPixelFreq
     //    @param refFreq
     //    @param chanbw
@@ -30,6 +30,12 @@
 #include <casacore/ms/MSOper/MSMetaData.h>
 #include <casacore/casa/BasicSL/STLIO.h>
 #include <casacore/casa/Arrays/ArrayLogical.h>
+#include <casacore/casa/OS/RegularFile.h>
+#include <casacore/msfits/MSFits/MSFitsOutput.h>
+#include <casacore/tables/Tables/ArrayColumn.h>
+#include <casacore/tables/Tables/ScalarColumn.h>
+#include <casacore/tables/Tables/TableUtil.h>
+#include "tMSFitsSimulate.h"
 
 using namespace casacore;
 
@@ -40,8 +46,97 @@ void removeIfNecessary(const String& msname) {
     }
 }
 
+// Compare a column of two tables cell by cell.
+template<typename T>
+void compareColumn(
+    const Table& t1, const Table& t2, const String& name, Bool isArray
+) {
+    if (isArray) {
+        ArrayColumn<T> c1(t1, name);
+        ArrayColumn<T> c2(t2, name);
+        for (rownr_t row=0; row<t1.nrow(); ++row) {
+            AlwaysAssertExit(c1.isDefined(row) == c2.isDefined(row));
+            if (c1.isDefined(row)) {
+                AlwaysAssertExit(allEQ(c1(row), c2(row)));
+            }
+        }
+    }
+    else {
+        ScalarColumn<T> c1(t1, name);
+        ScalarColumn<T> c2(t2, name);
+        AlwaysAssertExit(allEQ(c1.getColumn(), c2.getColumn()));
+    }
+}
+
+// Compare all columns of the main tables of two MSs cell by cell.
+void compareTables(const String& name1, const String& name2) {
+    Table t1(name1);
+    Table t2(name2);
+    AlwaysAssertExit(t1.nrow() > 0 && t1.nrow() == t2.nrow());
+    const TableDesc& td = t1.tableDesc();
+    AlwaysAssertExit(
+        allEQ(td.columnNames(), t2.tableDesc().columnNames())
+    );
+    for (uInt i=0; i<td.ncolumn(); ++i) {
+        const ColumnDesc& cd = td[i];
+        const String& name = cd.name();
+        const Bool isArray = cd.isArray();
+        switch (cd.dataType()) {
+        case TpBool:
+            compareColumn<Bool>(t1, t2, name, isArray);
+            break;
+        case TpInt:
+            compareColumn<Int>(t1, t2, name, isArray);
+            break;
+        case TpFloat:
+            compareColumn<Float>(t1, t2, name, isArray);
+            break;
+        case TpDouble:
+            compareColumn<Double>(t1, t2, name, isArray);
+            break;
+        case TpComplex:
+            compareColumn<Complex>(t1, t2, name, isArray);
+            break;
+        default:
+            throw AipsError("Unexpected data type of column " + name);
+        }
+    }
+}
+
+// Filling the main table in blocks of groups must give the same MS as
+// filling it column wise in memory (which is done for small files).
+void testFillInBlocks() {
+    const String msname("tMSFITSInput_tmp.ms");
+    const String fitsfile("tMSFITSInput_tmp.uvfits");
+    const String colms("tMSFITSInput_tmp_col.ms");
+    const String blockms("tMSFITSInput_tmp_block.ms");
+    removeIfNecessary(colms);
+    removeIfNecessary(blockms);
+    simulateMS(msname);
+    AlwaysAssertExit(
+        MSFitsOutput::writeFitsFile(
+            fitsfile, MeasurementSet(msname), "DATA", 0, tMSFitsNChan, 1,
+            False, False, False, False, 1.0, False, 1, 0, True
+        )
+    );
+    {
+        MSFitsInput colWise(colms, fitsfile);
+        colWise.readFitsFile();
+    }
+    {
+        MSFitsInput blockWise(blockms, fitsfile, False, True);
+        blockWise.readFitsFile();
+    }
+    compareTables(colms, blockms);
+    TableUtil::deleteTable(msname);
+    TableUtil::deleteTable(colms);
+    TableUtil::deleteTable(blockms);
+    RegularFile(fitsfile).remove();
+}
+
 int main() {
     try {
+        testFillInBlocks();
         String *parts = new String[2];
         split(EnvironmentVariable::get("CASAPATH"), parts, 2, String(" "));
         String datadir = parts[0] + "/data/";
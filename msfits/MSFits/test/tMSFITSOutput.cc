@@ -30,11 +30,127 @@
 #include <casacore/casa/OS/RegularFile.h>
 #include <casacore/ms/MeasurementSets/MeasurementSet.h>
 #include <casacore/msfits/MSFits/MSFitsOutput.h>
+#include <casacore/msfits/MSFits/MSFitsInput.h>
+#include <casacore/ms/MeasurementSets/MSPolColumns.h>
+#include <casacore/casa/Arrays/ArrayLogical.h>
+#include <casacore/casa/Arrays/Cube.h>
+#include <casacore/tables/Tables/ArrayColumn.h>
+#include <casacore/tables/Tables/ScalarColumn.h>
+#include <casacore/tables/Tables/TableUtil.h>
+#include "tMSFitsSimulate.h"
 
 using namespace casacore;
 
+// Write a simulated MS as UVFITS, read it back and compare the main
+// table columns. The correlations can be in another order.
+void testRoundTrip() {
+    const String msname("tMSFITSOutput_tmp.ms");
+    const String fitsfile("tMSFITSOutput_tmp.uvfits");
+    const String backms("tMSFITSOutput_tmp_back.ms");
+    if (File(backms).exists()) {
+        TableUtil::deleteTable(backms);
+    }
+    simulateMS(msname);
+    AlwaysAssertExit(
+        MSFitsOutput::writeFitsFile(
+            fitsfile, MeasurementSet(msname), "DATA", 0, tMSFitsNChan, 1,
+            False, False, False, False, 1.0, False, 1, 0, True
+        )
+    );
+    {
+        MSFitsInput msfitsin(backms, fitsfile);
+        msfitsin.readFitsFile();
+    }
+    {
+        MeasurementSet ms1(msname);
+        MeasurementSet ms2(backms);
+        const Vector<Int> corr1 =
+            MSPolarizationColumns(ms1.polarization()).corrType()(0);
+        const Vector<Int> corr2 =
+            MSPolarizationColumns(ms2.polarization()).corrType()(0);
+        AlwaysAssertExit(corr1.size() == uInt(tMSFitsNCorr));
+        AlwaysAssertExit(corr2.size() == corr1.size());
+        Vector<uInt> corrMap(tMSFitsNCorr);
+        for (Int i=0; i<tMSFitsNCorr; ++i) {
+            uInt j = 0;
+            while (j < corr2.size() && corr2[j] != corr1[i]) {
+                ++j;
+            }
+            AlwaysAssertExit(j < corr2.size());
+            corrMap[i] = j;
+        }
+        // UVFITS holds the groups in time-baseline order.
+        Block<String> sortNames(3);
+        sortNames[0] = MS::columnName(MS::TIME);
+        sortNames[1] = MS::columnName(MS::ANTENNA1);
+        sortNames[2] = MS::columnName(MS::ANTENNA2);
+        const Table t1 = ms1.sort(sortNames);
+        const Table t2 = ms2.sort(sortNames);
+        const rownr_t nrow = t1.nrow();
+        AlwaysAssertExit(nrow > 0 && t2.nrow() == nrow);
+        // TIME_CENTROID is written; the day fraction is a Float (5 msec).
+        AlwaysAssertExit(
+            allNearAbs(
+                ScalarColumn<Double>(t2, "TIME").getColumn(),
+                ScalarColumn<Double>(t1, "TIME_CENTROID").getColumn(), 0.01
+            )
+        );
+        AlwaysAssertExit(
+            allEQ(
+                ScalarColumn<Int>(t2, "ANTENNA1").getColumn(),
+                ScalarColumn<Int>(t1, "ANTENNA1").getColumn()
+            )
+        );
+        AlwaysAssertExit(
+            allEQ(
+                ScalarColumn<Int>(t2, "ANTENNA2").getColumn(),
+                ScalarColumn<Int>(t1, "ANTENNA2").getColumn()
+            )
+        );
+        // UVW is written as Float in seconds.
+        AlwaysAssertExit(
+            allNearAbs(
+                ArrayColumn<Double>(t2, "UVW").getColumn(),
+                ArrayColumn<Double>(t1, "UVW").getColumn(), 1e-3
+            )
+        );
+        const Cube<Complex> data1 = ArrayColumn<Complex>(t1, "DATA").getColumn();
+        const Cube<Complex> data2 = ArrayColumn<Complex>(t2, "DATA").getColumn();
+        const Cube<Bool> flag1 = ArrayColumn<Bool>(t1, "FLAG").getColumn();
+        const Cube<Bool> flag2 = ArrayColumn<Bool>(t2, "FLAG").getColumn();
+        const Matrix<Float> weight1 = ArrayColumn<Float>(t1, "WEIGHT").getColumn();
+        const Matrix<Float> weight2 = ArrayColumn<Float>(t2, "WEIGHT").getColumn();
+        AlwaysAssertExit(data2.shape().isEqual(data1.shape()));
+        AlwaysAssertExit(flag2.shape().isEqual(flag1.shape()));
+        AlwaysAssertExit(weight2.shape().isEqual(weight1.shape()));
+        // Make sure that flagged data are part of the comparison.
+        AlwaysAssertExit(anyEQ(flag1, True) && anyEQ(flag1, False));
+        for (rownr_t row=0; row<nrow; ++row) {
+            for (Int corr=0; corr<tMSFitsNCorr; ++corr) {
+                const uInt c2 = corrMap[corr];
+                // The weight is written per channel and summed when read.
+                AlwaysAssertExit(
+                    near(weight2(c2, row), weight1(corr, row), 1e-6)
+                );
+                for (Int chan=0; chan<tMSFitsNChan; ++chan) {
+                    AlwaysAssertExit(
+                        data2(c2, chan, row) == data1(corr, chan, row)
+                    );
+                    AlwaysAssertExit(
+                        flag2(c2, chan, row) == flag1(corr, chan, row)
+                    );
+                }
+            }
+        }
+    }
+    TableUtil::deleteTable(msname);
+    TableUtil::deleteTable(backms);
+    RegularFile(fitsfile).remove();
+}
+
 int main() {
     try {
+        testRoundTrip();
         String *parts = new String[2];
         split(EnvironmentVariable::get("CASAPATH"), parts, 2, String(" "));
         String datadir = parts[0] + "/data/";
@@ -0,0 +1,109 @@
+//# tMSFitsSimulate.h: Simulate a small MeasurementSet for the MSFits tests
+//# Copyright (C) 2026
+//# Associated Universities, Inc. Washington DC, USA.
+//#
+//# This program is free software; you can redistribute it and/or modify it
+//# under the terms of the GNU General Public License as published by the Free
+//# Software Foundation; either version 2 of the License, or (at your option)
+//# any later version.
+//#
+//# This program is distributed in the hope that it will be useful, but WITHOUT
+//# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+//# more details.
+//#
+//# You should have received a copy of the GNU General Public License along
+//# with this program; if not, write to the Free Software Foundation, Inc.,
+//# 675 Massachusetts Ave, Cambridge, MA 02139, USA.
+//#
+//# Correspondence concerning AIPS++ should be addressed as follows:
+//#        Internet email: aips2-request@nrao.edu.
+//#        Postal address: AIPS++ Project Office
+//#                        National Radio Astronomy Observatory
+//#                        520 Edgemont Road
+//#                        Charlottesville, VA 22903-2475 USA
+
+
+#ifndef MSFITS_TMSFITSSIMULATE_H
+#define MSFITS_TMSFITSSIMULATE_H
+
+#include <casacore/casa/aips.h>
+#include <casacore/casa/Arrays/Cube.h>
+#include <casacore/casa/Arrays/Matrix.h>
+#include <casacore/casa/Arrays/Vector.h>
+#include <casacore/casa/BasicSL/String.h>
+#include <casacore/casa/Quanta/Quantum.h>
+#include <casacore/measures/Measures/MDirection.h>
+#include <casacore/measures/Measures/MEpoch.h>
+#include <casacore/measures/Measures/MFrequency.h>
+#include <casacore/measures/Measures/MPosition.h>
+#include <casacore/measures/Measures/MeasTable.h>
+#include <casacore/ms/MeasurementSets/MeasurementSet.h>
+#include <casacore/ms/MeasurementSets/MSMainColumns.h>
+#include <casacore/ms/MSOper/NewMSSimulator.h>
+
+namespace casacore {
+
+// The shape of the data in the simulated MeasurementSet.
+const Int tMSFitsNCorr = 4;
+const Int tMSFitsNChan = 8;
+
+// Simulate a MeasurementSet of 10 minutes with 4 antennas observing a
+// circumpolar source. DATA, FLAG and WEIGHT get a different value for each
+// row, channel and correlation, so a conversion mixing them up is detected.
+// The values are exactly representable as Float.
+inline void simulateMS (const String& msName)
+{
+  {
+    NewMSSimulator sim(msName);
+    const Int nAnt = 4;
+    Vector<Double> x(nAnt), y(nAnt), z(nAnt, 0.), diam(nAnt, 25.);
+    Vector<Double> offset(nAnt, 0.);
+    Vector<String> mount(nAnt, "ALT-AZ"), name(nAnt), pad(nAnt);
+    for (Int i=0; i<nAnt; ++i) {
+      x[i] = 100.*i;
+      y[i] = 70.*i*i;
+      name[i] = "ANT" + String::toString(i);
+      pad[i] = "PAD" + String::toString(i);
+    }
+    MPosition vlaPosition;
+    MeasTable::Observatory (vlaPosition, "VLA");
+    sim.initAnt ("VLA", x, y, z, diam, offset, mount, name, pad,
+                 "local", vlaPosition);
+    sim.initSpWindows ("SPW", tMSFitsNChan, Quantity(1.4, "GHz"),
+                       Quantity(1., "MHz"), Quantity(1., "MHz"),
+                       MFrequency::TOPO, "RR RL LR LL");
+    sim.initFeeds ("perfect R L");
+    sim.initFields ("SRC", MDirection(Quantity(20., "deg"),
+                                      Quantity(60., "deg"),
+                                      MDirection::J2000), "");
+    sim.settimes (Quantity(30., "s"), True,
+                  MEpoch(Quantity(58000., "d"), MEpoch::UTC));
+    sim.observe ("SRC", "SPW", Quantity(0., "s"), Quantity(600., "s"));
+  }
+  MeasurementSet ms(msName, Table::Update);
+  MSMainColumns cols(ms);
+  const uInt nrow = ms.nrow();
+  Cube<Complex> data(tMSFitsNCorr, tMSFitsNChan, nrow);
+  Cube<Bool> flag(tMSFitsNCorr, tMSFitsNChan, nrow);
+  Matrix<Float> weight(tMSFitsNCorr, nrow);
+  for (uInt row=0; row<nrow; ++row) {
+    for (Int chan=0; chan<tMSFitsNChan; ++chan) {
+      for (Int corr=0; corr<tMSFitsNCorr; ++corr) {
+        data(corr, chan, row) = Complex(row + 0.125*chan, corr - 0.25*chan);
+        flag(corr, chan, row) = (row + chan + corr) % 7 == 0;
+      }
+    }
+    for (Int corr=0; corr<tMSFitsNCorr; ++corr) {
+      weight(corr, row) = 1 + 0.5*((row + corr) % 5);
+    }
+  }
+  cols.data().putColumn (data);
+  cols.flag().putColumn (flag);
+  cols.weight().putColumn (weight);
+  cols.flagRow().putColumn (Vector<Bool>(nrow, False));
+}
+
+} //# NAMESPACE CASACORE - END
+
+#endif
@@ -32,6 +32,7 @@
 #include <casacore/ms/MeasurementSets/MeasurementSet.h>
 #include <casacore/msfits/MSFits/MSFitsOutput.h>
 #include <casacore/casa/Exceptions/Error.h>
+#include <casacore/casa/OS/Timer.h>
 #include <casacore/casa/iostream.h>
 
 
@@ -116,11 +117,22 @@ int main (int argc, const char* argv[])
 	// Get the sensitivity.
 	Double sensitivity(inputs.getDouble("sensitivity"));
 
-	// Now write the fits file.
-	MSFitsOutput::writeFitsFile(fitsfile, MeasurementSet(msin),
+	// Now write the fits file and report the throughput.
+	MeasurementSet ms(msin);
+	Timer timer;
+	MSFitsOutput::writeFitsFile(fitsfile, ms,
 				    column, -1, -1, -1,
 				    writeSyscal, multisource,
 				    combinespw, writestation, sensitivity);
+	Double elapsed = timer.real();
+	Double nbytes = File(fitsfile).size();
+	cout << "Wrote " << ms.nrow() << " rows (" << nbytes / (1024*1024)
+	     << " MB) in " << elapsed << " sec";
+	if (elapsed > 0) {
+	  cout << " (" << ms.nrow() / elapsed << " rows/sec, "
+	       << nbytes / (1024*1024) / elapsed << " MB/sec)";
+	}
+	cout << endl;
     } catch (std::exception& x) {
 	cout << x.what() << endl;
 	return 1;
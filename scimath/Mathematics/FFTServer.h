@@ -138,7 +138,10 @@ public:
 // <em> P.N. Swarztrauber, Vectorizing the FFTs, in Parallel Computations
 // (G. Rodrigue, ed.), Academic Press, 1982, pp. 51--83. </em><br>
 // <br>If at build time it is chosen to use FFTW in a multi-threaded way,
-// it will try to use as many cores as possible.
+// it will try to use as many cores as possible (see FFTW::setNThreads).
+// <br>The FFTW plans are taken from a process-wide plan cache (see class
+// FFTW), so resizing a server to a shape used before, or using multiple
+// servers for the same shape, does not need new planning.
 
 // In this class a forward transform is defined as one that goes from the real
 // to the complex (or the time to frequency) domain. In a forward transform the
@@ -33,7 +33,14 @@
 # include <omp.h>
 #endif
 
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <map>
+#include <sstream>
+#include <tuple>
+#include <vector>
 
 
 namespace casacore {
@@ -44,6 +51,65 @@ std::mutex FFTW::theirMutex;
 
 #ifdef HAVE_FFTW3
 
+  // The process-wide plan cache and planner state.
+  // Only the fftw_execute functions are thread-safe; creating and
+  // destroying plans touches the global planner state, so these are
+  // serialized by the mutex. The object is deliberately never destroyed,
+  // because FFTW objects can be part of other static objects.
+  struct FFTWPlanKey
+  {
+    int kind;                 // 0=r2c, 1=c2r, 2=c2c forward, 3=c2c backward
+    std::vector<int> shape;
+    int alignIn;
+    int alignOut;
+    bool inPlace;             // in and out are the same array
+    int nthreads;
+    unsigned flags;
+    bool operator< (const FFTWPlanKey& other) const
+    {
+      return std::tie(kind, shape, alignIn, alignOut, inPlace, nthreads,
+                      flags) <
+        std::tie(other.kind, other.shape, other.alignIn, other.alignOut,
+                 other.inPlace, other.nthreads, other.flags);
+    }
+  };
+
+  struct FFTWPlanCache
+  {
+    std::mutex mutex;
+    std::map<FFTWPlanKey, std::shared_ptr<FFTWPlan>>  plans;
+    std::map<FFTWPlanKey, std::shared_ptr<FFTWPlanf>> plansf;
+    size_t maxPlans = 256;
+    int nthreads    = 1;
+    unsigned flags  = FFTW_ESTIMATE;
+  };
+
+  static FFTWPlanCache& planCache()
+  {
+    static FFTWPlanCache* cache = new FFTWPlanCache();
+    return *cache;
+  }
+
+  // Set the number of threads for the plans to be made.
+  // It must be called with the planner mutex locked.
+  static void planWithThreads (int nthreads)
+  {
+#ifdef HAVE_FFTW3_THREADS
+    fftw_plan_with_nthreads (nthreads);
+#else
+    (void)nthreads;
+#endif
+  }
+
+  static void planWithThreadsf (int nthreads)
+  {
+#ifdef HAVE_FFTW3_THREADS
+    fftwf_plan_with_nthreads (nthreads);
+#else
+    (void)nthreads;
+#endif
+  }
+
   class FFTWPlan
   {
   public:
@@ -51,7 +117,8 @@ std::mutex FFTW::theirMutex;
       : itsPlan(plan)
     {}
     ~FFTWPlan()
-      { fftw_destroy_plan(itsPlan); }
+      { std::lock_guard<std::mutex> lock(planCache().mutex);
+        fftw_destroy_plan(itsPlan); }
     fftw_plan getPlan()
       { return itsPlan; }
   private:
@@ -67,7 +134,8 @@ std::mutex FFTW::theirMutex;
       : itsPlan(plan)
     {}
     ~FFTWPlanf()
-      { fftwf_destroy_plan(itsPlan); }
+      { std::lock_guard<std::mutex> lock(planCache().mutex);
+        fftwf_destroy_plan(itsPlan); }
     fftwf_plan getPlan()
       { return itsPlan; }
   private:
@@ -76,9 +144,69 @@ std::mutex FFTW::theirMutex;
     fftwf_plan itsPlan;
   };
 
-    
+  // Make the key for a plan on the given arrays.
+  // The number of threads to use is filled in as well.
+  static FFTWPlanKey makeKey (int kind, const IPosition& size,
+                              const void* in, const void* out)
+  {
+    FFTWPlanKey key;
+    key.kind  = kind;
+    key.shape = size.asStdVector();
+    // fftw_alignment_of is the same for single and double precision.
+    key.alignIn  = fftw_alignment_of (const_cast<double*>
+                                      (static_cast<const double*>(in)));
+    key.alignOut = fftw_alignment_of (const_cast<double*>
+                                      (static_cast<const double*>(out)));
+    key.inPlace  = (in == out);
+    {
+      // The settings can be changed concurrently.
+      std::lock_guard<std::mutex> lock(planCache().mutex);
+      key.nthreads = planCache().nthreads;
+      key.flags    = planCache().flags;
+    }
+#ifdef _OPENMP
+    // Avoid oversubscription if the FFTs are done in parallel.
+    if (omp_in_parallel()) {
+      key.nthreads = 1;
+    }
+#endif
+    return key;
+  }
+
+  // Find a plan in the cache or create it using the given function.
+  // Plans not in use are removed if the cache gets too large; they are
+  // destroyed after the mutex is released, because their destructor
+  // acquires it as well.
+  template<typename PlanType, typename MakeFunc>
+  static std::shared_ptr<PlanType> findPlan
+  (std::map<FFTWPlanKey, std::shared_ptr<PlanType>>& cache,
+   const FFTWPlanKey& key, MakeFunc makePlan)
+  {
+    std::vector<std::shared_ptr<PlanType>> removed;
+    std::shared_ptr<PlanType> plan;
+    {
+      std::lock_guard<std::mutex> lock(planCache().mutex);
+      auto iter = cache.find (key);
+      if (iter != cache.end()) {
+        return iter->second;
+      }
+      if (cache.size() >= planCache().maxPlans) {
+        for (iter = cache.begin(); iter != cache.end();) {
+          if (iter->second.use_count() == 1) {
+            removed.push_back (std::move(iter->second));
+            iter = cache.erase (iter);
+          } else {
+            ++iter;
+          }
+        }
+      }
+      plan.reset (new PlanType(makePlan(key)));
+      cache[key] = plan;
+    }
+    return plan;
+  }
 
-  FFTW::FFTW() : flags(FFTW_ESTIMATE)
+  FFTW::FFTW()
   { 
     initialize_fftw();
   }
@@ -88,16 +216,13 @@ std::mutex FFTW::theirMutex;
     std::lock_guard<std::mutex> lock(theirMutex);
     if (!is_initialized_fftw) {
       int numCPUs = HostInfo::numCPUs();
-      int nthreads = 1;
-      if (numCPUs > 1) {
-        nthreads = numCPUs;
-      }
-      
 #ifdef HAVE_FFTW3_THREADS
       fftwf_init_threads();
       fftw_init_threads();
-      fftwf_plan_with_nthreads(nthreads);
-      fftw_plan_with_nthreads(nthreads);
+      std::lock_guard<std::mutex> planLock(planCache().mutex);
+      planCache().nthreads = std::max(1, numCPUs);
+#else
+      (void)numCPUs;
 #endif
       is_initialized_fftw = true;
     }
@@ -115,121 +240,255 @@ std::mutex FFTW::theirMutex;
     fftwf_cleanup_threads();
 #endif
   }
-  
+
+  void FFTW::setPlanRigor (Rigor rigor)
+  {
+    std::lock_guard<std::mutex> lock(planCache().mutex);
+    switch (rigor) {
+    case MEASURE:
+      planCache().flags = FFTW_MEASURE;
+      break;
+    case PATIENT:
+      planCache().flags = FFTW_PATIENT;
+      break;
+    default:
+      planCache().flags = FFTW_ESTIMATE;
+    }
+  }
+
+  void FFTW::setNThreads (int nthreads)
+  {
+    initialize_fftw();
+    std::lock_guard<std::mutex> lock(planCache().mutex);
+#ifdef HAVE_FFTW3_THREADS
+    planCache().nthreads = std::max(1, nthreads);
+#else
+    (void)nthreads;
+#endif
+  }
+
+  void FFTW::setPlanCacheSize (size_t maxPlans)
+  {
+    std::lock_guard<std::mutex> lock(planCache().mutex);
+    planCache().maxPlans = std::max(size_t(1), maxPlans);
+  }
+
+  size_t FFTW::planCacheSize()
+  {
+    std::lock_guard<std::mutex> lock(planCache().mutex);
+    return planCache().plans.size() + planCache().plansf.size();
+  }
+
+  void FFTW::clearPlanCache()
+  {
+    std::vector<std::shared_ptr<FFTWPlan>>  removed;
+    std::vector<std::shared_ptr<FFTWPlanf>> removedf;
+    std::lock_guard<std::mutex> lock(planCache().mutex);
+    for (auto iter = planCache().plans.begin();
+         iter != planCache().plans.end();) {
+      if (iter->second.use_count() == 1) {
+        removed.push_back (std::move(iter->second));
+        iter = planCache().plans.erase (iter);
+      } else {
+        ++iter;
+      }
+    }
+    for (auto iter = planCache().plansf.begin();
+         iter != planCache().plansf.end();) {
+      if (iter->second.use_count() == 1) {
+        removedf.push_back (std::move(iter->second));
+        iter = planCache().plansf.erase (iter);
+      } else {
+        ++iter;
+      }
+    }
+  }
+
+  bool FFTW::importWisdom (const std::string& fileName)
+  {
+    initialize_fftw();
+    std::ifstream ifs(fileName.c_str());
+    if (!ifs) {
+      return false;
+    }
+    std::stringstream buf;
+    buf << ifs.rdbuf();
+    std::string wisdom = buf.str();
+    // The file contains the double precision wisdom followed by the
+    // single precision wisdom, which starts with "(fftw-x.y.z fftwf_wisdom".
+    std::string::size_type pos = wisdom.find (" fftwf_wisdom");
+    if (pos != std::string::npos) {
+      pos = wisdom.rfind ('(', pos);
+    }
+    std::string wisdomd = wisdom.substr (0, pos);
+    std::string wisdomf = (pos == std::string::npos  ?  std::string() :
+                           wisdom.substr (pos));
+    std::lock_guard<std::mutex> lock(planCache().mutex);
+    bool ok = true;
+    if (!wisdomd.empty()) {
+      ok = fftw_import_wisdom_from_string (wisdomd.c_str()) != 0;
+    }
+    if (!wisdomf.empty()) {
+      ok = (fftwf_import_wisdom_from_string (wisdomf.c_str()) != 0)  &&  ok;
+    }
+    return ok;
+  }
+
+  bool FFTW::exportWisdom (const std::string& fileName)
+  {
+    std::string wisdom;
+    {
+      std::lock_guard<std::mutex> lock(planCache().mutex);
+      char* str = fftw_export_wisdom_to_string();
+      if (str) {
+        wisdom = str;
+        free (str);
+      }
+      str = fftwf_export_wisdom_to_string();
+      if (str) {
+        wisdom += str;
+        free (str);
+      }
+    }
+    std::ofstream ofs(fileName.c_str());
+    ofs << wisdom;
+    ofs.close();
+    return bool(ofs);
+  }
 
   void FFTW::plan_r2c(const IPosition &size, float *in, std::complex<float> *out) 
   {
-    itsPlanR2Cf.reset( new FFTWPlanf
-      (fftwf_plan_dft_r2c(size.nelements(),
-                          size.asStdVector().data(),
-                          in,
-                          reinterpret_cast<fftwf_complex *>(out), 
-                          flags)) );
+    itsPlanR2Cf = findPlan (planCache().plansf, makeKey(0, size, in, out),
+      [&] (const FFTWPlanKey& key)
+      { planWithThreadsf (key.nthreads);
+        return fftwf_plan_dft_r2c(size.nelements(),
+                                  key.shape.data(),
+                                  in,
+                                  reinterpret_cast<fftwf_complex *>(out), 
+                                  key.flags); });
   }
 
   void FFTW::plan_r2c(const IPosition &size, double *in, std::complex<double> *out) 
   {
-    itsPlanR2C.reset( new FFTWPlan
-      (fftw_plan_dft_r2c(size.nelements(),
-                         size.asStdVector().data(),
-                         in,
-                         reinterpret_cast<fftw_complex *>(out), 
-                         flags)) );
+    itsPlanR2C = findPlan (planCache().plans, makeKey(0, size, in, out),
+      [&] (const FFTWPlanKey& key)
+      { planWithThreads (key.nthreads);
+        return fftw_plan_dft_r2c(size.nelements(),
+                                 key.shape.data(),
+                                 in,
+                                 reinterpret_cast<fftw_complex *>(out), 
+                                 key.flags); });
   }
 
   void FFTW::plan_c2r(const IPosition &size, std::complex<float> *in, float *out) {
-    itsPlanC2Rf.reset( new FFTWPlanf
-      (fftwf_plan_dft_c2r(size.nelements(),
-                          size.asStdVector().data(),
-                          reinterpret_cast<fftwf_complex *>(in),
-                          out, 
-                          flags)) );
-
+    itsPlanC2Rf = findPlan (planCache().plansf, makeKey(1, size, in, out),
+      [&] (const FFTWPlanKey& key)
+      { planWithThreadsf (key.nthreads);
+        return fftwf_plan_dft_c2r(size.nelements(),
+                                  key.shape.data(),
+                                  reinterpret_cast<fftwf_complex *>(in),
+                                  out, 
+                                  key.flags); });
   }
 
   void FFTW::plan_c2r(const IPosition &size, std::complex<double> *in, double *out) {
-    itsPlanC2R.reset( new FFTWPlan
-      (fftw_plan_dft_c2r(size.nelements(),
-                         size.asStdVector().data(),
-                         reinterpret_cast<fftw_complex *>(in), 
-                         out,
-                         flags)) );
+    itsPlanC2R = findPlan (planCache().plans, makeKey(1, size, in, out),
+      [&] (const FFTWPlanKey& key)
+      { planWithThreads (key.nthreads);
+        return fftw_plan_dft_c2r(size.nelements(),
+                                 key.shape.data(),
+                                 reinterpret_cast<fftw_complex *>(in), 
+                                 out,
+                                 key.flags); });
   }
 
   void FFTW::plan_c2c_forward(const IPosition &size, std::complex<double> *in) {
-    itsPlanC2CF.reset( new FFTWPlan
-      (fftw_plan_dft(size.nelements(),
-                     size.asStdVector().data(),
-                     reinterpret_cast<fftw_complex *>(in), 
-                     reinterpret_cast<fftw_complex *>(in), 
-                     FFTW_FORWARD, flags)) );
-
+    itsPlanC2CF = findPlan (planCache().plans, makeKey(2, size, in, in),
+      [&] (const FFTWPlanKey& key)
+      { planWithThreads (key.nthreads);
+        return fftw_plan_dft(size.nelements(),
+                             key.shape.data(),
+                             reinterpret_cast<fftw_complex *>(in), 
+                             reinterpret_cast<fftw_complex *>(in), 
+                             FFTW_FORWARD, key.flags); });
   }
     
   void FFTW::plan_c2c_forward(const IPosition &size, std::complex<float> *in) {
-    itsPlanC2CFf.reset( new FFTWPlanf
-      (fftwf_plan_dft(size.nelements(),
-                      size.asStdVector().data(),
-                      reinterpret_cast<fftwf_complex *>(in), 
-                      reinterpret_cast<fftwf_complex *>(in), 
-                      FFTW_FORWARD, flags)) );
+    itsPlanC2CFf = findPlan (planCache().plansf, makeKey(2, size, in, in),
+      [&] (const FFTWPlanKey& key)
+      { planWithThreadsf (key.nthreads);
+        return fftwf_plan_dft(size.nelements(),
+                              key.shape.data(),
+                              reinterpret_cast<fftwf_complex *>(in), 
+                              reinterpret_cast<fftwf_complex *>(in), 
+                              FFTW_FORWARD, key.flags); });
   }
 
   void FFTW::plan_c2c_backward(const IPosition &size, std::complex<double> *in) {
-    itsPlanC2CB.reset( new FFTWPlan
-      (fftw_plan_dft(size.nelements(),
-                     size.asStdVector().data(),
-                     reinterpret_cast<fftw_complex *>(in), 
-                     reinterpret_cast<fftw_complex *>(in), 
-                     FFTW_BACKWARD, flags)) );
-      
+    itsPlanC2CB = findPlan (planCache().plans, makeKey(3, size, in, in),
+      [&] (const FFTWPlanKey& key)
+      { planWithThreads (key.nthreads);
+        return fftw_plan_dft(size.nelements(),
+                             key.shape.data(),
+                             reinterpret_cast<fftw_complex *>(in), 
+                             reinterpret_cast<fftw_complex *>(in), 
+                             FFTW_BACKWARD, key.flags); });
   }
     
   void FFTW::plan_c2c_backward(const IPosition &size, std::complex<float> *in) {
-    itsPlanC2CBf.reset( new FFTWPlanf
-      (fftwf_plan_dft(size.nelements(),
-                      size.asStdVector().data(),
-                      reinterpret_cast<fftwf_complex *>(in), 
-                      reinterpret_cast<fftwf_complex *>(in), 
-                      FFTW_BACKWARD, flags)) );
+    itsPlanC2CBf = findPlan (planCache().plansf, makeKey(3, size, in, in),
+      [&] (const FFTWPlanKey& key)
+      { planWithThreadsf (key.nthreads);
+        return fftwf_plan_dft(size.nelements(),
+                              key.shape.data(),
+                              reinterpret_cast<fftwf_complex *>(in), 
+                              reinterpret_cast<fftwf_complex *>(in), 
+                              FFTW_BACKWARD, key.flags); });
   }
 
-  // the parameters are used only in order to overload this function
-  void FFTW::r2c(const IPosition&, float*, std::complex<float>*) 
+  // A cached plan can be shared by several objects, so it is executed
+  // with the arrays given (which have the alignment of the plan's key).
+  void FFTW::r2c(const IPosition&, float* in, std::complex<float>* out) 
   {
-    fftwf_execute(itsPlanR2Cf->getPlan());
+    fftwf_execute_dft_r2c(itsPlanR2Cf->getPlan(), in,
+                          reinterpret_cast<fftwf_complex*>(out));
   }
     
-  void FFTW::r2c(const IPosition&, double*, std::complex<double>*) 
+  void FFTW::r2c(const IPosition&, double* in, std::complex<double>* out) 
   {
-    fftw_execute(itsPlanR2C->getPlan());
+    fftw_execute_dft_r2c(itsPlanR2C->getPlan(), in,
+                         reinterpret_cast<fftw_complex*>(out));
   }
 
-  void FFTW::c2r(const IPosition&, std::complex<float>*, float*)
+  void FFTW::c2r(const IPosition&, std::complex<float>* in, float* out)
   {
-    fftwf_execute(itsPlanC2Rf->getPlan());
+    fftwf_execute_dft_c2r(itsPlanC2Rf->getPlan(),
+                          reinterpret_cast<fftwf_complex*>(in), out);
   }
     
-  void FFTW::c2r(const IPosition&, std::complex<double>*, double*)
+  void FFTW::c2r(const IPosition&, std::complex<double>* in, double* out)
   {
-    fftw_execute(itsPlanC2R->getPlan());
+    fftw_execute_dft_c2r(itsPlanC2R->getPlan(),
+                         reinterpret_cast<fftw_complex*>(in), out);
   }
     
-  void FFTW::c2c(const IPosition&, std::complex<float>*, bool forward)
+  void FFTW::c2c(const IPosition&, std::complex<float>* in, bool forward)
   {
+    fftwf_complex* data = reinterpret_cast<fftwf_complex*>(in);
     if (forward) {
-      fftwf_execute(itsPlanC2CFf->getPlan());
+      fftwf_execute_dft(itsPlanC2CFf->getPlan(), data, data);
     } else {
-      fftwf_execute(itsPlanC2CBf->getPlan());
+      fftwf_execute_dft(itsPlanC2CBf->getPlan(), data, data);
     }
   }
     
-  void FFTW::c2c(const IPosition&, std::complex<double>*, bool forward)
+  void FFTW::c2c(const IPosition&, std::complex<double>* in, bool forward)
   {
+    fftw_complex* data = reinterpret_cast<fftw_complex*>(in);
     if (forward) {
-      fftw_execute(itsPlanC2CF->getPlan());
+      fftw_execute_dft(itsPlanC2CF->getPlan(), data, data);
     } else {
-      fftw_execute(itsPlanC2CB->getPlan());
+      fftw_execute_dft(itsPlanC2CB->getPlan(), data, data);
     }
   }
 
@@ -239,9 +498,13 @@ std::mutex FFTW::theirMutex;
     
     std::vector<fftwf_r2r_kind> kinds(size.nelements(), FFTW_REDFT00);
     
-    return Plan( new FFTWPlanf(
-      fftwf_plan_r2r(size.nelements(), size.asStdVector().data(),
-                     in, out, kinds.data(), FFTW_ESTIMATE)) );
+    fftwf_plan plan;
+    {
+      std::lock_guard<std::mutex> lock(planCache().mutex);
+      plan = fftwf_plan_r2r(size.nelements(), size.asStdVector().data(),
+                     in, out, kinds.data(), FFTW_ESTIMATE);
+    }
+    return Plan( new FFTWPlanf(plan) );
   }
   
   FFTW::Plan FFTW::plan_redft00(const IPosition &size, double *in, double *out)
@@ -250,9 +513,13 @@ std::mutex FFTW::theirMutex;
     
     std::vector<fftw_r2r_kind> kinds(size.nelements(), FFTW_REDFT00);
     
-    return Plan( new FFTWPlan(
-      fftw_plan_r2r(size.nelements(), size.asStdVector().data(),
-                    in, out, kinds.data(), FFTW_ESTIMATE)) );
+    fftw_plan plan;
+    {
+      std::lock_guard<std::mutex> lock(planCache().mutex);
+      plan = fftw_plan_r2r(size.nelements(), size.asStdVector().data(),
+                    in, out, kinds.data(), FFTW_ESTIMATE);
+    }
+    return Plan( new FFTWPlan(plan) );
   }
   
   void FFTW::Plan::Execute(float *in, float *out)
@@ -303,6 +570,21 @@ std::mutex FFTW::theirMutex;
   void FFTW::c2c(const IPosition&, std::complex<double>*, Bool)
   {}
 
+  void FFTW::setPlanRigor (Rigor)
+  {}
+  void FFTW::setNThreads (int)
+  {}
+  void FFTW::setPlanCacheSize (size_t)
+  {}
+  size_t FFTW::planCacheSize()
+  { return 0; }
+  void FFTW::clearPlanCache()
+  {}
+  bool FFTW::importWisdom (const std::string&)
+  { return false; }
+  bool FFTW::exportWisdom (const std::string&)
+  { return false; }
+
   FFTW::Plan FFTW::plan_redft00(const IPosition &, float *, float *)
   { throw std::runtime_error("FFTW not available"); }
   
@@ -31,6 +31,7 @@
 #include <complex>
 #include <memory>
 #include <mutex>
+#include <string>
 
 namespace casacore {
 
@@ -49,7 +50,28 @@ class FFTWPlanf;
 // The interface is such that the presence of FFTW3 is only visible
 // in the implementation. The header file does not need to know.
 // In this way external code using this class does not need to set HAVE_FFTW.
+//
+// Plans are kept in a process-wide cache keyed on the transform type,
+// shape, alignment of the arrays, number of threads and planning rigor.
+// Re-planning for a shape seen before (e.g. when an FFTServer is resized
+// back and forth) is then only a lookup, and FFTW objects in different
+// threads share the same plans. A cached plan is executed with the
+// arrays passed to the <src>r2c</src>, <src>c2r</src> and <src>c2c</src>
+// functions, which must have the same alignment as the arrays the plan
+// was made for (as is the case for the work arrays of FFTServer).
+// Creating and destroying plans is serialized by a mutex, because the
+// FFTW planner is not thread-safe.
+// <br>FFTW wisdom can be saved to and restored from a file, so later runs
+// of a program can plan with the rigor of an earlier run at low cost.
 // </synopsis>
+// <example>
+// <srcblock>
+//   FFTW::importWisdom ("my.wisdom");     // no problem if not existing
+//   FFTW::setPlanRigor (FFTW::MEASURE);
+//   ... do the FFTs ...
+//   FFTW::exportWisdom ("my.wisdom");
+// </srcblock>
+// </example>
 
 class FFTW
 {
@@ -68,9 +90,7 @@ public:
   void plan_c2c_backward(const IPosition &size, std::complex<double> *in) ;
   void plan_c2c_backward(const IPosition &size, std::complex<float> *in) ;
   
-  // TODO These overloads do not use their parameters at all. This should
-  // be written to use an interface like plan_redft00().
-  // overloaded interface to fftw[f]_execute...
+  // overloaded interface to fftw[f]_execute... using the given arrays.
   void r2c(const IPosition &size, float *in, std::complex<float> *out) ;
   void r2c(const IPosition &size, double *in, std::complex<double> *out) ;
   void c2r(const IPosition &size, std::complex<float> *in, float *out);
@@ -103,37 +123,68 @@ public:
   
   static Plan plan_redft00(const IPosition &size, float *in, float *out);
   static Plan plan_redft00(const IPosition &size, double *in, double *out);
-  
+
+  // The planning rigor used for the plan_r2c, plan_c2r and plan_c2c
+  // functions. ESTIMATE (the default) plans quickly without touching
+  // the arrays. MEASURE and PATIENT time several algorithms, which
+  // overwrites the arrays given to the plan functions, but find
+  // faster plans (which are also added to the wisdom).
+  enum Rigor {ESTIMATE, MEASURE, PATIENT};
+
+  // Set the planning rigor for plans created hereafter.
+  static void setPlanRigor (Rigor rigor);
+
+  // Set the number of threads a plan may use for a single transform.
+  // It is only used if FFTW was built with thread support.
+  // The default is the number of cores. Plans created inside an OpenMP
+  // parallel region always use a single thread.
+  static void setNThreads (int nthreads);
+
+  // Set the maximum number of plans kept in the plan cache (default 256).
+  // If exceeded, the plans not in use by an FFTW object are removed.
+  static void setPlanCacheSize (size_t maxPlans);
+
+  // Get the number of plans in the plan cache.
+  static size_t planCacheSize();
+
+  // Remove all plans not in use from the plan cache.
+  static void clearPlanCache();
+
+  // Import the double and single precision wisdom from the given file.
+  // It returns false if the file does not exist or could not be parsed.
+  static bool importWisdom (const std::string& fileName);
+
+  // Export the double and single precision wisdom to the given file.
+  // It returns false if the file could not be written.
+  static bool exportWisdom (const std::string& fileName);
+
 private:
   static void initialize_fftw();
   
-  std::unique_ptr<FFTWPlanf> itsPlanR2Cf;
-  std::unique_ptr<FFTWPlan>  itsPlanR2C;
+  std::shared_ptr<FFTWPlanf> itsPlanR2Cf;
+  std::shared_ptr<FFTWPlan>  itsPlanR2C;
   
-  std::unique_ptr<FFTWPlanf> itsPlanC2Rf;
-  std::unique_ptr<FFTWPlan>  itsPlanC2R;
+  std::shared_ptr<FFTWPlanf> itsPlanC2Rf;
+  std::shared_ptr<FFTWPlan>  itsPlanC2R;
   
-  std::unique_ptr<FFTWPlanf> itsPlanC2CFf;   // forward
-  std::unique_ptr<FFTWPlan>  itsPlanC2CF;
+  std::shared_ptr<FFTWPlanf> itsPlanC2CFf;   // forward
+  std::shared_ptr<FFTWPlan>  itsPlanC2CF;
   
-  std::unique_ptr<FFTWPlanf> itsPlanC2CBf;   // backward
-  std::unique_ptr<FFTWPlan>  itsPlanC2CB;
+  std::shared_ptr<FFTWPlanf> itsPlanC2CBf;   // backward
+  std::shared_ptr<FFTWPlan>  itsPlanC2CB;
   
-  std::unique_ptr<FFTWPlanf> itsPlanR2Rf;
-  std::unique_ptr<FFTWPlan>  itsPlanR2R;
+  std::shared_ptr<FFTWPlanf> itsPlanR2Rf;
+  std::shared_ptr<FFTWPlan>  itsPlanR2R;
   
-  unsigned flags;
-
   static bool is_initialized_fftw;  // FFTW needs initialization
                                              // only once per process,
                                              // not once per object
                                              
-  // TODO this mutex does not make FFTW thread safe, because
-  // planning an FFT with FFTW is not thread safe either.
-  // So either the plan..() methods should take the mutex, or
-  // FFTW should leave synchronization fully to the user of
-  // this class: currently it's halfway in between.
-  static std::mutex theirMutex;          // Initialization mutex
+  // Initialization mutex. Plan creation and destruction are serialized
+  // by a separate planner mutex (in FFTW.cc), so different FFTW objects
+  // can be planned and executed from different threads. A single
+  // FFTW object must still not be used by multiple threads at once.
+  static std::mutex theirMutex;
 };    
     
 } //# NAMESPACE CASACORE - END
@@ -37,6 +37,7 @@
 #include <casacore/casa/BasicSL/Complex.h>
 #include <casacore/casa/BasicSL/Constants.h>
 #include <casacore/casa/BasicMath/Math.h>
+#include <casacore/casa/OS/RegularFile.h>
 #include <casacore/casa/Utilities/Assert.h>
 #include <casacore/casa/iostream.h>
 
@@ -1283,6 +1284,46 @@ int main() {
       AlwaysAssert(allNearAbs(input, reverseTransform, 
 			      5*FLT_EPSILON), AipsError);
     }
+    { // Plans are shared via the plan cache
+      FFTW::clearPlanCache();
+      Vector<Complex> data(16, Complex(0,0));
+      data(0) = Complex(1,0);
+      Vector<Complex> expectedResult(16, Complex(1,0));
+      FFTServer<Float, Complex> server1;
+      FFTServer<Float, Complex> server2;
+      Vector<Complex> d1(data.copy());
+      Vector<Complex> d2(data.copy());
+      server1.fft0(d1, True);
+      const size_t nplan = FFTW::planCacheSize();
+      server2.fft0(d2, True);
+      // The second server has the same work array alignment in practice,
+      // so at most one extra plan can have been made.
+      AlwaysAssert(FFTW::planCacheSize() <= nplan+1, AipsError);
+      AlwaysAssert(allNearAbs(d1, expectedResult, FLT_EPSILON), AipsError);
+      AlwaysAssert(allNearAbs(d2, expectedResult, FLT_EPSILON), AipsError);
+      // Repeating identical transforms must reuse the cached plans.
+      const size_t nplan2 = FFTW::planCacheSize();
+      d1 = data;
+      server1.fft0(d1, True);
+      d2 = data;
+      server2.fft0(d2, True);
+      AlwaysAssert(FFTW::planCacheSize() == nplan2, AipsError);
+      AlwaysAssert(allNearAbs(d1, expectedResult, FLT_EPSILON), AipsError);
+      // Switching shapes and back must give the same results.
+      Vector<Complex> d3(8, Complex(1,0));
+      server1.fft0(d3, False);
+      d1 = data;
+      server1.fft0(d1, True);
+      AlwaysAssert(allNearAbs(d1, expectedResult, FLT_EPSILON), AipsError);
+      // Wisdom can be written and read back (if FFTW is used).
+      const String wisdomName("tFFTServer2_tmp.wisdom");
+      AlwaysAssert(!FFTW::importWisdom("tFFTServer2_tmp.nonexisting"),
+                   AipsError);
+      if (FFTW::exportWisdom(wisdomName)) {
+        AlwaysAssert(FFTW::importWisdom(wisdomName), AipsError);
+        RegularFile(wisdomName).remove();
+      }
+    }
   }
   catch (std::exception& x) {
     cerr << x.what() << endl;
@@ -0,0 +1,453 @@
+//# TSMAccessProfile.cc: Recorded access pattern of a TSM hypercube
+//# Copyright (C) 2026
+//# Associated Universities, Inc. Washington DC, USA.
+//#
+//# This library is free software; you can redistribute it and/or modify it
+//# under the terms of the GNU Library General Public License as published by
+//# the Free Software Foundation; either version 2 of the License, or (at your
+//# option) any later version.
+//#
+//# This library is distributed in the hope that it will be useful, but WITHOUT
+//# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+//# License for more details.
+//#
+//# You should have received a copy of the GNU Library General Public License
+//# along with this library; if not, write to the Free Software Foundation,
+//# Inc., 675 Massachusetts Ave, Cambridge, MA 02139, USA.
+//#
+//# Correspondence concerning AIPS++ should be addressed as follows:
+//#        Internet email: aips2-request@nrao.edu.
+//#        Postal address: AIPS++ Project Office
+//#                        National Radio Astronomy Observatory
+//#                        520 Edgemont Road
+//#                        Charlottesville, VA 22903-2475 USA
+
+//# Includes
+#include <casacore/tables/DataMan/TSMAccessProfile.h>
+#include <casacore/tables/DataMan/TSMCube.h>
+#include <casacore/tables/DataMan/DataManError.h>
+#include <casacore/casa/Arrays/Vector.h>
+#include <casacore/casa/Arrays/Matrix.h>
+#include <casacore/casa/Containers/Record.h>
+#include <casacore/casa/IO/AipsIO.h>
+#include <casacore/casa/BasicSL/String.h>
+#include <casacore/casa/iostream.h>
+#include <algorithm>
+#include <cmath>
+
+
+namespace casacore { //# NAMESPACE CASACORE - BEGIN
+
+// The maximum number of different access patterns kept.
+// Accesses with other patterns are counted, but not recorded.
+static const size_t maxNrPatterns = 256;
+
+
+TSMAccessProfile::TSMAccessProfile()
+: bytesPerPixel_p (0),
+  extensible_p    (False),
+  nAccess_p       (0),
+  nRead_p         (0),
+  nWrite_p        (0),
+  cacheSize_p     (0),
+  lastPattern_p   (0),
+  nDropped_p      (0)
+{}
+
+TSMAccessProfile::TSMAccessProfile (const IPosition& cubeShape,
+                                    const IPosition& tileShape,
+                                    Double bytesPerPixel, Bool extensible)
+: cubeShape_p     (cubeShape),
+  tileShape_p     (tileShape),
+  bytesPerPixel_p (bytesPerPixel),
+  extensible_p    (extensible),
+  nAccess_p       (0),
+  nRead_p         (0),
+  nWrite_p        (0),
+  cacheSize_p     (0),
+  lastPattern_p   (0),
+  nDropped_p      (0)
+{}
+
+void TSMAccessProfile::record (Int accessType, const IPosition& start,
+                               const IPosition& end, Bool write)
+{
+    IPosition shape (end - start + 1);
+    // Usually the same pattern is used many times in a row.
+    if (lastPattern_p < patterns_p.size()) {
+        Pattern& last = patterns_p[lastPattern_p];
+        if (last.accessType == accessType  &&  last.write == write
+        &&  last.shape.isEqual (shape)) {
+            last.count++;
+            return;
+        }
+    }
+    for (size_t i=0; i<patterns_p.size(); ++i) {
+        Pattern& pattern = patterns_p[i];
+        if (pattern.accessType == accessType  &&  pattern.write == write
+        &&  pattern.shape.isEqual (shape)) {
+            pattern.count++;
+            lastPattern_p = i;
+            return;
+        }
+    }
+    if (patterns_p.size() >= maxNrPatterns) {
+        nDropped_p++;
+        return;
+    }
+    Pattern pattern;
+    pattern.accessType = accessType;
+    pattern.write      = write;
+    pattern.shape      = shape;
+    pattern.count      = 1;
+    lastPattern_p = patterns_p.size();
+    patterns_p.push_back (pattern);
+}
+
+void TSMAccessProfile::setCacheStatistics (uInt64 nAccess, uInt64 nRead,
+                                           uInt64 nWrite, uInt cacheSize)
+{
+    nAccess_p   = nAccess;
+    nRead_p     = nRead;
+    nWrite_p    = nWrite;
+    cacheSize_p = cacheSize;
+}
+
+void TSMAccessProfile::merge (const TSMAccessProfile& other)
+{
+    if (! patterns_p.empty()  &&  ! other.patterns_p.empty()
+    &&  patterns_p[0].shape.size() != other.patterns_p[0].shape.size()) {
+        throw DataManError ("TSMAccessProfile::merge: profiles have a "
+                            "different dimensionality");
+    }
+    for (const Pattern& pattern : other.patterns_p) {
+        size_t i = 0;
+        for (; i<patterns_p.size(); ++i) {
+            if (patterns_p[i].accessType == pattern.accessType
+            &&  patterns_p[i].write == pattern.write
+            &&  patterns_p[i].shape.isEqual (pattern.shape)) {
+                patterns_p[i].count += pattern.count;
+                break;
+            }
+        }
+        if (i == patterns_p.size()) {
+            if (patterns_p.size() < maxNrPatterns) {
+                patterns_p.push_back (pattern);
+            } else {
+                nDropped_p += pattern.count;
+            }
+        }
+    }
+    nDropped_p  += other.nDropped_p;
+    nAccess_p   += other.nAccess_p;
+    nRead_p     += other.nRead_p;
+    nWrite_p    += other.nWrite_p;
+    cacheSize_p  = std::max (cacheSize_p, other.cacheSize_p);
+}
+
+uInt64 TSMAccessProfile::nrecorded() const
+{
+    uInt64 n = 0;
+    for (const Pattern& pattern : patterns_p) {
+        n += pattern.count;
+    }
+    return n;
+}
+
+Double TSMAccessProfile::hitRatio() const
+{
+    if (nAccess_p == 0) {
+        return -1;
+    }
+    return Double(nAccess_p - std::min(nAccess_p, nRead_p)) / nAccess_p;
+}
+
+Double TSMAccessProfile::ntilesAccessed (const Pattern& pattern,
+                                         const IPosition& tileShape,
+                                         uInt maxCacheSizeMiB) const
+{
+    uInt nrdim = cubeShape_p.size();
+    if (nrdim == 0) {
+        return 0;
+    }
+    // Get the number of tiles needed for a section in the non-last axes.
+    // A full axis is aligned with the tiles; otherwise a random offset
+    // is assumed.
+    Double nsub = 1;
+    for (uInt i=0; i<nrdim-1; ++i) {
+        ssize_t len = std::max (ssize_t(1), cubeShape_p[i]);
+        ssize_t s = std::min (pattern.shape[i], len);
+        ssize_t t = std::min (tileShape[i], len);
+        if (s >= len) {
+            nsub *= (len + t - 1) / t;
+        } else {
+            nsub *= 1 + Double(s - 1) / t;
+        }
+    }
+    // The last axis is stepped through sequentially, so a tile is
+    // only read once if the cache can hold the tiles of a section.
+    uInt last = nrdim - 1;
+    ssize_t len = std::max (ssize_t(1), cubeShape_p[last]);
+    ssize_t s = std::min (pattern.shape[last], len);
+    ssize_t t = std::min (tileShape[last], len);
+    if (s >= len) {
+        return nsub * ((len + t - 1) / t);
+    }
+    Double tileBytes = bytesPerPixel_p * tileShape.product();
+    if (maxCacheSizeMiB == 0
+    ||  nsub * tileBytes <= maxCacheSizeMiB * 1024. * 1024.) {
+        return nsub * Double(s) / t;
+    }
+    return nsub * (1 + Double(s - 1) / t);
+}
+
+Double TSMAccessProfile::ioCost (const IPosition& tileShape,
+                                 uInt maxCacheSizeMiB,
+                                 Double tileOverhead) const
+{
+    if (tileShape.size() != cubeShape_p.size()) {
+        throw DataManError ("TSMAccessProfile::ioCost: tile shape " +
+                            String::toString(tileShape) +
+                            " has a wrong dimensionality");
+    }
+    Double tileCost = bytesPerPixel_p * tileShape.product() + tileOverhead;
+    Double cost = 0;
+    for (const Pattern& pattern : patterns_p) {
+        cost += pattern.count * tileCost *
+                ntilesAccessed (pattern, tileShape, maxCacheSizeMiB);
+    }
+    return cost;
+}
+
+void TSMAccessProfile::tryTileShapes
+                        (uInt axis, IPosition& tileShape, uInt64 tileBytes,
+                         const std::vector<std::vector<ssize_t> >& candidates,
+                         uInt64 maxTileBytes, uInt maxCacheSizeMiB,
+                         Double tileOverhead,
+                         IPosition& bestShape, Double& bestCost) const
+{
+    if (axis == tileShape.size()) {
+        Double cost = ioCost (tileShape, maxCacheSizeMiB, tileOverhead);
+        if (bestShape.empty()  ||  cost < bestCost) {
+            bestShape.resize (tileShape.size());
+            bestShape = tileShape;
+            bestCost  = cost;
+        }
+        return;
+    }
+    // The candidates are in ascending order, so stop if the tile
+    // gets too large (but always try a length 1).
+    for (ssize_t len : candidates[axis]) {
+        if (len > 1  &&  tileBytes * len > maxTileBytes) {
+            break;
+        }
+        tileShape[axis] = len;
+        tryTileShapes (axis+1, tileShape, tileBytes * len, candidates,
+                       maxTileBytes, maxCacheSizeMiB, tileOverhead,
+                       bestShape, bestCost);
+    }
+}
+
+IPosition TSMAccessProfile::adviseTileShape (uInt64 maxTileBytes,
+                                             uInt maxCacheSizeMiB,
+                                             Double tileOverhead) const
+{
+    uInt nrdim = cubeShape_p.size();
+    if (patterns_p.empty()  ||  nrdim == 0) {
+        return tileShape_p;
+    }
+    // Possible tile lengths per axis are the powers of 2, the axis length,
+    // the recorded section lengths and the current tile length.
+    std::vector<std::vector<ssize_t> > candidates(nrdim);
+    for (uInt i=0; i<nrdim; ++i) {
+        ssize_t len = std::max (ssize_t(1), cubeShape_p[i]);
+        std::vector<ssize_t>& cand = candidates[i];
+        for (ssize_t t=1; t<len; t*=2) {
+            cand.push_back (t);
+        }
+        cand.push_back (len);
+        for (const Pattern& pattern : patterns_p) {
+            cand.push_back (std::min (pattern.shape[i], len));
+        }
+        if (i < tileShape_p.size()  &&  tileShape_p[i] > 0) {
+            cand.push_back (std::min (tileShape_p[i], len));
+        }
+        std::sort (cand.begin(), cand.end());
+        cand.erase (std::unique (cand.begin(), cand.end()), cand.end());
+    }
+    // The size of a tile must be a whole number of bytes, so use the
+    // (rounded up) pixel size when pruning.
+    uInt64 pixelBytes = std::max (uInt64(1), uInt64(std::ceil(bytesPerPixel_p)));
+    IPosition tileShape(nrdim, 1);
+    IPosition bestShape;
+    Double bestCost = 0;
+    tryTileShapes (0, tileShape, pixelBytes, candidates, maxTileBytes,
+                   maxCacheSizeMiB, tileOverhead, bestShape, bestCost);
+    return bestShape;
+}
+
+uInt TSMAccessProfile::adviseCacheSize (const IPosition& tileShape,
+                                        uInt maxCacheSizeMiB) const
+{
+    // Use the pattern with the most data accessed.
+    const Pattern* dominant = 0;
+    Double maxData = 0;
+    for (const Pattern& pattern : patterns_p) {
+        Double data = Double(pattern.count) * pattern.shape.product();
+        if (dominant == 0  ||  data > maxData) {
+            dominant = &pattern;
+            maxData  = data;
+        }
+    }
+    if (dominant == 0  ||  cubeShape_p.product() == 0) {
+        return 1;
+    }
+    uInt bucketSize = std::max (uInt(1),
+                                uInt(bytesPerPixel_p * tileShape.product()
+                                     + 0.5));
+    return TSMCube::calcCacheSize (cubeShape_p, tileShape, extensible_p,
+                                   dominant->shape, IPosition(), IPosition(),
+                                   IPosition(), maxCacheSizeMiB, bucketSize);
+}
+
+Record TSMAccessProfile::toRecord() const
+{
+    Record rec;
+    rec.define ("cubeShape", cubeShape_p.asVector64());
+    rec.define ("tileShape", tileShape_p.asVector64());
+    rec.define ("bytesPerPixel", bytesPerPixel_p);
+    rec.define ("extensible", extensible_p);
+    rec.define ("nAccess", Int64(nAccess_p));
+    rec.define ("nRead", Int64(nRead_p));
+    rec.define ("nWrite", Int64(nWrite_p));
+    rec.define ("cacheSize", Int64(cacheSize_p));
+    rec.define ("nDropped", Int64(nDropped_p));
+    uInt npatt = patterns_p.size();
+    Vector<Int>   types(npatt);
+    Vector<Bool>  writes(npatt);
+    Vector<Int64> counts(npatt);
+    Matrix<Int64> shapes(cubeShape_p.size(), npatt);
+    for (uInt i=0; i<npatt; ++i) {
+        const Pattern& pattern = patterns_p[i];
+        types[i]  = pattern.accessType;
+        writes[i] = pattern.write;
+        counts[i] = pattern.count;
+        for (uInt j=0; j<pattern.shape.size()  &&  j<shapes.nrow(); ++j) {
+            shapes(j,i) = pattern.shape[j];
+        }
+    }
+    rec.define ("accessTypes", types);
+    rec.define ("writes", writes);
+    rec.define ("counts", counts);
+    rec.define ("shapes", shapes);
+    return rec;
+}
+
+TSMAccessProfile TSMAccessProfile::fromRecord (const Record& rec)
+{
+    TSMAccessProfile profile
+      (IPosition(rec.asArrayInt64("cubeShape").tovector()),
+       IPosition(rec.asArrayInt64("tileShape").tovector()),
+       rec.asDouble("bytesPerPixel"), rec.asBool("extensible"));
+    profile.nAccess_p   = rec.asInt64 ("nAccess");
+    profile.nRead_p     = rec.asInt64 ("nRead");
+    profile.nWrite_p    = rec.asInt64 ("nWrite");
+    profile.cacheSize_p = rec.asInt64 ("cacheSize");
+    profile.nDropped_p  = rec.asInt64 ("nDropped");
+    Vector<Int>   types  (rec.asArrayInt ("accessTypes"));
+    Vector<Bool>  writes (rec.asArrayBool ("writes"));
+    Vector<Int64> counts (rec.asArrayInt64 ("counts"));
+    Matrix<Int64> shapes (rec.asArrayInt64 ("shapes"));
+    for (uInt i=0; i<types.size(); ++i) {
+        Pattern pattern;
+        pattern.accessType = types[i];
+        pattern.write      = writes[i];
+        pattern.count      = counts[i];
+        pattern.shape.resize (shapes.nrow());
+        for (uInt j=0; j<shapes.nrow(); ++j) {
+            pattern.shape[j] = shapes(j,i);
+        }
+        profile.patterns_p.push_back (pattern);
+    }
+    return profile;
+}
+
+void TSMAccessProfile::writeProfiles
+                        (const String& fileName,
+                         const std::vector<TSMAccessProfile>& profiles)
+{
+    AipsIO ios(fileName, ByteIO::New);
+    ios.putstart ("TSMAccessProfile", 1);
+    ios << uInt(profiles.size());
+    for (const TSMAccessProfile& profile : profiles) {
+        ios << profile.toRecord();
+    }
+    ios.putend();
+}
+
+std::vector<TSMAccessProfile> TSMAccessProfile::readProfiles
+                                                  (const String& fileName)
+{
+    AipsIO ios(fileName);
+    ios.getstart ("TSMAccessProfile");
+    uInt nprof;
+    ios >> nprof;
+    std::vector<TSMAccessProfile> profiles;
+    profiles.reserve (nprof);
+    for (uInt i=0; i<nprof; ++i) {
+        Record rec;
+        ios >> rec;
+        profiles.push_back (fromRecord (rec));
+    }
+    ios.getend();
+    return profiles;
+}
+
+String TSMAccessProfile::accessTypeName (Int accessType)
+{
+    switch (accessType) {
+    case TSMCube::CellAccess:
+        return "cell";
+    case TSMCube::SliceAccess:
+        return "cellslice";
+    case TSMCube::ColumnAccess:
+        return "column";
+    case TSMCube::ColumnSliceAccess:
+        return "columnslice";
+    default:
+        break;
+    }
+    return "other";
+}
+
+void TSMAccessProfile::show (ostream& os) const
+{
+    os << "cubeShape: " << cubeShape_p << "  tileShape: " << tileShape_p
+       << "  bytes/pixel: " << bytesPerPixel_p << endl;
+    if (nAccess_p > 0) {
+        os << "cache: " << cacheSize_p << " tiles, " << nAccess_p
+           << " accesses, " << nRead_p << " reads, " << nWrite_p
+           << " writes, hit ratio " << 100 * hitRatio() << "%" << endl;
+    }
+    // Show the most frequent patterns first.
+    std::vector<size_t> index(patterns_p.size());
+    for (size_t i=0; i<index.size(); ++i) {
+        index[i] = i;
+    }
+    std::stable_sort (index.begin(), index.end(),
+                      [this] (size_t i, size_t j)
+                      { return patterns_p[i].count > patterns_p[j].count; });
+    for (size_t i : index) {
+        const Pattern& pattern = patterns_p[i];
+        os << "  " << pattern.count << " x " << (pattern.write ? "put " : "get ")
+           << accessTypeName(pattern.accessType) << ' ' << pattern.shape
+           << endl;
+    }
+    if (nDropped_p > 0) {
+        os << "  " << nDropped_p << " accesses with other shapes" << endl;
+    }
+}
+
+
+} //# NAMESPACE CASACORE - END
@@ -0,0 +1,219 @@
+//# TSMAccessProfile.h: Recorded access pattern of a TSM hypercube
+//# Copyright (C) 2026
+//# Associated Universities, Inc. Washington DC, USA.
+//#
+//# This library is free software; you can redistribute it and/or modify it
+//# under the terms of the GNU Library General Public License as published by
+//# the Free Software Foundation; either version 2 of the License, or (at your
+//# option) any later version.
+//#
+//# This library is distributed in the hope that it will be useful, but WITHOUT
+//# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+//# License for more details.
+//#
+//# You should have received a copy of the GNU Library General Public License
+//# along with this library; if not, write to the Free Software Foundation,
+//# Inc., 675 Massachusetts Ave, Cambridge, MA 02139, USA.
+//#
+//# Correspondence concerning AIPS++ should be addressed as follows:
+//#        Internet email: aips2-request@nrao.edu.
+//#        Postal address: AIPS++ Project Office
+//#                        National Radio Astronomy Observatory
+//#                        520 Edgemont Road
+//#                        Charlottesville, VA 22903-2475 USA
+
+#ifndef TABLES_TSMACCESSPROFILE_H
+#define TABLES_TSMACCESSPROFILE_H
+
+//# Includes
+#include <casacore/casa/aips.h>
+#include <casacore/casa/Arrays/IPosition.h>
+#include <casacore/casa/iosfwd.h>
+#include <vector>
+
+namespace casacore { //# NAMESPACE CASACORE - BEGIN
+
+//# Forward Declarations
+class Record;
+class String;
+
+// <summary>
+// Recorded access pattern of a hypercube in a Tiled Storage Manager
+// </summary>
+
+// <use visibility=export>
+
+// <reviewed reviewer="" date="" tests="tTSMAccessProfile.cc">
+// </reviewed>
+
+// <prerequisite>
+//   <li> <linkto class=TiledStMan>TiledStMan</linkto>
+//   <li> <linkto class=ROTiledStManAccessor>ROTiledStManAccessor</linkto>
+// </prerequisite>
+
+// <synopsis>
+// The best tile shape of a hypercube depends on the way the data are
+// accessed. A tile shape that is good for accessing the data row by row,
+// can be very bad when accessing all rows of a few channels.
+// The tile shape is usually chosen using a few heuristics (for example
+// in <linkto class=MSTileLayout>MSTileLayout</linkto>).
+// This class makes it possible to base the choice on the actual
+// access pattern of an application.
+// <p>
+// If recording is switched on (using function
+// <src>ROTiledStManAccessor::setAccessProfiling</src>), the hypercubes
+// of a tiled storage manager record the shape of each accessed section
+// and the type of the access (as set by the TSMDataColumn access
+// functions using <src>TSMCube::setLastColAccess</src>).
+// Equal sections are counted together.
+// The profile also holds the cube and tile shape and the statistics of
+// the cache (number of tiles accessed, read and written).
+// <br>The profiles can be written into a file and read back, so they can
+// be used by other processes, for instance the program <src>retile</src>
+// that can retile a column using the advised tile shape.
+// <p>
+// The advisor estimates the number of bytes read for the recorded accesses
+// for possible tile shapes and chooses the tile shape giving the least I/O.
+// It assumes that the last axis of the hypercube (the row axis) is
+// accessed sequentially and that the cache can hold the tiles needed for
+// one section, so a tile is read only once when stepping along the
+// last axis. Each tile read also costs a fixed overhead (default 64 KiB)
+// for the seek, which favours larger tiles.
+// The advised cache size is the cache size the tiled storage manager
+// would use for the dominant access pattern.
+// </synopsis>
+
+// <example>
+// <srcblock>
+//  Table tab("my.ms");
+//  ROTiledStManAccessor acc(tab, "DATA", True);
+//  acc.setAccessProfiling (True);
+//  // ... access the DATA column in the usual way ...
+//  acc.saveAccessProfiles ("my.ms.profile");
+//  TSMAccessProfile prof = acc.getAccessProfile (0);
+//  IPosition tileShape = prof.adviseTileShape();
+//  cout << "advised tile shape " << tileShape
+//       << "  cache size " << prof.adviseCacheSize (tileShape) << endl;
+// </srcblock>
+// </example>
+
+class TSMAccessProfile
+{
+public:
+    // An access pattern: the shape of the accessed section in the
+    // hypercube, the access type and how often it was accessed.
+    struct Pattern {
+        Int       accessType;    //# a TSMCube::AccessType
+        Bool      write;
+        IPosition shape;
+        uInt64    count;
+    };
+
+    // Create an empty profile.
+    TSMAccessProfile();
+
+    // Create an empty profile for a hypercube with the given shape and
+    // tile shape, containing the given number of bytes per pixel
+    // (summed over its data columns).
+    TSMAccessProfile (const IPosition& cubeShape, const IPosition& tileShape,
+                      Double bytesPerPixel, Bool extensible);
+
+    // Record an access of the section [start,end] of the hypercube.
+    void record (Int accessType, const IPosition& start,
+                 const IPosition& end, Bool write);
+
+    // Set the cache statistics (number of tiles accessed, read and written)
+    // and the cache size (in tiles).
+    void setCacheStatistics (uInt64 nAccess, uInt64 nRead, uInt64 nWrite,
+                             uInt cacheSize);
+
+    // Add the patterns and cache statistics of another profile of a
+    // hypercube with the same dimensionality.
+    void merge (const TSMAccessProfile& other);
+
+    // Get the shape of the hypercube and the tile shape.
+    // <group>
+    const IPosition& cubeShape() const
+      { return cubeShape_p; }
+    const IPosition& tileShape() const
+      { return tileShape_p; }
+    // </group>
+
+    // Get the recorded access patterns.
+    const std::vector<Pattern>& patterns() const
+      { return patterns_p; }
+
+    // Get the total number of recorded accesses.
+    uInt64 nrecorded() const;
+
+    // Get the fraction of tile accesses not needing a read or write.
+    // It is -1 if the cache was not used (e.g. when using mmap).
+    Double hitRatio() const;
+
+    // Estimate the I/O (in bytes) of the recorded accesses for the given
+    // tile shape. A maximum cache size of 0 means unlimited.
+    Double ioCost (const IPosition& tileShape, uInt maxCacheSizeMiB=0,
+                   Double tileOverhead=65536) const;
+
+    // Advise the tile shape giving the least I/O for the recorded accesses.
+    // The size of a tile is limited to <src>maxTileBytes</src>.
+    // The current tile shape is returned if nothing has been recorded.
+    IPosition adviseTileShape (uInt64 maxTileBytes=1024*1024,
+                               uInt maxCacheSizeMiB=0,
+                               Double tileOverhead=65536) const;
+
+    // Advise the cache size (in tiles) for the given tile shape.
+    uInt adviseCacheSize (const IPosition& tileShape,
+                          uInt maxCacheSizeMiB=0) const;
+
+    // Convert the profile to or from a Record.
+    // <group>
+    Record toRecord() const;
+    static TSMAccessProfile fromRecord (const Record& rec);
+    // </group>
+
+    // Write the profiles (of several hypercubes) into a file or read them.
+    // <group>
+    static void writeProfiles (const String& fileName,
+                               const std::vector<TSMAccessProfile>& profiles);
+    static std::vector<TSMAccessProfile> readProfiles (const String& fileName);
+    // </group>
+
+    // Show the profile.
+    void show (ostream& os) const;
+
+    // Get the name of an access type.
+    static String accessTypeName (Int accessType);
+
+private:
+    // Get the number of tiles (amortized) needed for a pattern.
+    Double ntilesAccessed (const Pattern& pattern, const IPosition& tileShape,
+                           uInt maxCacheSizeMiB) const;
+
+    // Try all candidate tile lengths of the given axis and higher ones.
+    void tryTileShapes (uInt axis, IPosition& tileShape, uInt64 tileBytes,
+                        const std::vector<std::vector<ssize_t> >& candidates,
+                        uInt64 maxTileBytes, uInt maxCacheSizeMiB,
+                        Double tileOverhead,
+                        IPosition& bestShape, Double& bestCost) const;
+
+    IPosition            cubeShape_p;
+    IPosition            tileShape_p;
+    Double               bytesPerPixel_p;
+    Bool                 extensible_p;
+    uInt64               nAccess_p;
+    uInt64               nRead_p;
+    uInt64               nWrite_p;
+    uInt                 cacheSize_p;
+    std::vector<Pattern> patterns_p;
+    // Index of the pattern recorded last (to speed up record).
+    size_t               lastPattern_p;
+    // Number of accesses not recorded because of too many patterns.
+    uInt64               nDropped_p;
+};
+
+
+} //# NAMESPACE CASACORE - END
+
+#endif
@@ -30,6 +30,7 @@
 #include <casacore/tables/DataMan/TiledStMan.h>
 #include <casacore/tables/DataMan/TSMFile.h>
 #include <casacore/tables/DataMan/TSMColumn.h>
+#include <casacore/tables/DataMan/TSMAccessProfile.h>
 #include <casacore/tables/DataMan/DataManError.h>
 #include <casacore/casa/Arrays/ArrayUtil.h>
 #include <casacore/casa/Containers/Record.h>
@@ -92,7 +93,9 @@ TSMCube::TSMCube (TiledStMan* stman, TSMFile* file,
   fileOffset_p   (0),
   cache_p        (0),
   userSetCache_p (False),
-  lastColAccess_p(NoAccess)
+  lastColAccess_p(NoAccess),
+  profile_p      (0),
+  noRecord_p     (False)
 {
     if (fileOffset < 0) {
         // TiledCellStMan uses an empty shape; setShape is called later. 
@@ -119,7 +122,9 @@ TSMCube::TSMCube (TiledStMan* stman, AipsIO& ios,
   filePtr_p      (0),
   cache_p        (0),
   userSetCache_p (False),
-  lastColAccess_p(NoAccess)
+  lastColAccess_p(NoAccess),
+  profile_p      (0),
+  noRecord_p     (False)
 {
     Int fileSeqnr = getObject (ios);
     if (fileSeqnr >= 0) {
@@ -133,6 +138,7 @@ TSMCube::~TSMCube()
 {
     delete cache_p;
     delete [] cachedTile_p;
+    delete profile_p;
 }
 
 
@@ -166,6 +172,50 @@ void TSMCube::showCacheStatistics (ostream& os) const
     }
 }
 
+Double TSMCube::bytesPerPixel() const
+{
+    Int64 npixel = tileShape_p.product();
+    return (tileShape_p.empty()  ||  npixel == 0  ?  0 :
+            Double(bucketSize_p) / npixel);
+}
+
+void TSMCube::recordAccess (const IPosition& start, const IPosition& end,
+                            Bool writeFlag)
+{
+    if (noRecord_p) {
+        return;
+    }
+    if (profile_p == 0) {
+        profile_p = new TSMAccessProfile (cubeShape_p, tileShape_p,
+                                          bytesPerPixel(), extensible_p);
+    }
+    profile_p->record (lastColAccess_p, start, end, writeFlag);
+}
+
+TSMAccessProfile TSMCube::accessProfile() const
+{
+    TSMAccessProfile profile (cubeShape_p, tileShape_p,
+                              bytesPerPixel(), extensible_p);
+    if (profile_p != 0) {
+        profile.merge (*profile_p);
+    }
+    if (cache_p != 0) {
+        profile.setCacheStatistics (cache_p->nAccess(),
+                                    cache_p->nRead() + cache_p->nInit(),
+                                    cache_p->nWrite(), cache_p->cacheSize());
+    }
+    return profile;
+}
+
+void TSMCube::clearAccessProfile()
+{
+    delete profile_p;
+    profile_p = 0;
+    if (cache_p != 0) {
+        cache_p->initStatistics();
+    }
+}
+
 uInt TSMCube::coordinateSize (const String& coordinateName) const
 {
     if (! values_p.isDefined (coordinateName)) {
@@ -910,6 +960,9 @@ void TSMCube::accessSection (const IPosition& start, const IPosition& end,
     if (writeFlag) {
 	stmanPtr_p->setDataChanged();
     }
+    if (stmanPtr_p->accessProfiling()) {
+        recordAccess (start, end, writeFlag);
+    }
     // Prepare for the iteration through the necessary tiles.
     uInt i, j;
 
@@ -1311,6 +1364,9 @@ void TSMCube::accessStrided (const IPosition& start, const IPosition& end,
     if (writeFlag) {
 	stmanPtr_p->setDataChanged();
     }
+    if (stmanPtr_p->accessProfiling()) {
+        recordAccess (start, end, writeFlag);
+    }
     uInt i, j;
     // Get the cache (if needed).
     BucketCache* cachePtr = getCache();
@@ -42,6 +42,7 @@ class TiledStMan;
 class TSMFile;
 class TSMColumn;
 class BucketCache;
+class TSMAccessProfile;
 template<class T> class Block;
 
 // <summary>
@@ -291,7 +292,23 @@ public:
     void setLastColSlice (const IPosition& slice);
     // </group>
 
+    // Get the access profile recorded for this hypercube (if access
+    // profiling is switched on in the storage manager). The cube shape,
+    // tile shape and cache statistics are filled in.
+    TSMAccessProfile accessProfile() const;
+
+    // Remove the recorded access profile and reset the cache statistics.
+    void clearAccessProfile();
+
 protected:
+    // Get the number of bytes per pixel in a tile (in external format).
+    Double bytesPerPixel() const;
+
+    // Record the access of a section if access profiling is switched on.
+    // Nothing is recorded if <src>noRecord_p</src> is set.
+    void recordAccess (const IPosition& start, const IPosition& end,
+                       Bool writeFlag);
+
     // Initialize the various variables.
     // <group>
     void setup();
@@ -398,6 +415,11 @@ protected:
     AccessType      lastColAccess_p;
     // The slice shape of the last column access to a slice.
     IPosition       lastColSlice_p;
+    // The recorded access profile (0 if not recorded).
+    TSMAccessProfile* profile_p;
+    // Do not record accesses (set while accessSection is used to do
+    // a strided access, which is recorded itself).
+    Bool            noRecord_p;
 
     // IPosition variables used in accessSection(); declared here
     // as member variables to avoid significant construction and
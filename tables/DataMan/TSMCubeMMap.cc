@@ -159,6 +159,9 @@ void TSMCubeMMap::accessSection (const IPosition& start, const IPosition& end,
                                  uInt localPixelSize, uInt externalPixelSize,
                                  Bool writeFlag)
 {
+  if (stmanPtr_p->accessProfiling()) {
+    recordAccess (start, end, writeFlag);
+  }
   // A tile can contain more than one data column.
   // Get the offset of the column's data array in the tile.
   uInt tileOffset = externalOffset_p[colnr];
@@ -433,17 +436,29 @@ void TSMCubeMMap::accessStrided (const IPosition& start, const IPosition& end,
   Array<char> fullArr(fullShape);
   Array<char> partArr = fullArr(fst, fend, incr);
   Array<char> sectArr(sectShape, section, SHARE);
-  // Read the data of the full array.
-  // Thereafter copy the part needed.
-  accessSection (start, end, fullArr.data(), colnr,
-                 localPixelSize, externalPixelSize, False);
-  if (writeFlag) {
-    partArr = sectArr;
+  // Record the strided access once; the section accesses done for it
+  // are not recorded.
+  if (stmanPtr_p->accessProfiling()) {
+    recordAccess (start, end, writeFlag);
+  }
+  noRecord_p = True;
+  try {
+    // Read the data of the full array.
+    // Thereafter copy the part needed.
     accessSection (start, end, fullArr.data(), colnr,
-                   localPixelSize, externalPixelSize, True);
-  } else {
-    sectArr = partArr;
+                   localPixelSize, externalPixelSize, False);
+    if (writeFlag) {
+      partArr = sectArr;
+      accessSection (start, end, fullArr.data(), colnr,
+                     localPixelSize, externalPixelSize, True);
+    } else {
+      sectArr = partArr;
+    }
+  } catch (...) {
+    noRecord_p = False;
+    throw;
   }
+  noRecord_p = False;
 }
 
 
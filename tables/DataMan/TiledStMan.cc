@@ -58,7 +58,8 @@ TiledStMan::TiledStMan ()
   maxCacheSize_p    (0),
   nrdim_p           (0),
   nrCoordVector_p   (0),
-  dataChanged_p     (False)
+  dataChanged_p     (False),
+  accessProfiling_p (False)
 {}
 
 TiledStMan::TiledStMan (const String& hypercolumnName, uInt maximumCacheSize)
@@ -70,7 +71,8 @@ TiledStMan::TiledStMan (const String& hypercolumnName, uInt maximumCacheSize)
   maxCacheSize_p    (maximumCacheSize),
   nrdim_p           (0),
   nrCoordVector_p   (0),
-  dataChanged_p     (False)
+  dataChanged_p     (False),
+  accessProfiling_p (False)
 {}
 
 TiledStMan::~TiledStMan()
@@ -494,6 +496,18 @@ void TiledStMan::showCacheStatistics (ostream& os) const
     }
 }
 
+void TiledStMan::setAccessProfiling (Bool profile)
+{
+    if (profile) {
+	for (uInt i=0; i<cubeSet_p.nelements(); i++) {
+	    if (cubeSet_p[i] != 0) {
+		cubeSet_p[i]->clearAccessProfile();
+	    }
+	}
+    }
+    accessProfiling_p = profile;
+}
+
 TSMCube* TiledStMan::singleHypercube()
 {
     if (cubeSet_p.nelements() != 1  ||  cubeSet_p[0] == 0) {
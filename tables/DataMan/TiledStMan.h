@@ -262,6 +262,15 @@ public:
     // Show the statistics of all caches used.
     void showCacheStatistics (ostream& os) const;
 
+    // Switch recording of the access patterns of the hypercubes on or off.
+    // Switching it on clears the profiles recorded before (also the cache
+    // statistics, so they only reflect the recorded accesses).
+    // <br>See class <linkto class=TSMAccessProfile>TSMAccessProfile</linkto>.
+    void setAccessProfiling (Bool profile);
+
+    // Is recording of the access patterns switched on?
+    Bool accessProfiling() const;
+
     // Get the length of the data for the given number of pixels.
     // This can be used to calculate the length of a tile.
     uInt64 getLengthOffset (uInt64 nrPixels, Block<uInt>& dataOffset,
@@ -523,6 +532,8 @@ protected:
     IPosition fixedCellShape_p;
     // Has any data changed since the last flush?
     Bool      dataChanged_p;
+    // Are the access patterns recorded?
+    Bool      accessProfiling_p;
 };
 
 
@@ -541,6 +552,9 @@ inline uInt TiledStMan::nhypercubes() const
 inline void TiledStMan::setDataChanged()
     { dataChanged_p = True; }
 
+inline Bool TiledStMan::accessProfiling() const
+    { return accessProfiling_p; }
+
 inline const TSMCube* TiledStMan::getTSMCube (uInt hypercube) const
     { return const_cast<TiledStMan*>(this)->getTSMCube (hypercube); }
 
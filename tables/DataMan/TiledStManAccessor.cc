@@ -200,5 +200,25 @@ void ROTiledStManAccessor::clearCaches()
     dataManPtr_p->emptyCaches();
 }
 
+void ROTiledStManAccessor::setAccessProfiling (Bool profile)
+{
+    dataManPtr_p->setAccessProfiling (profile);
+}
+
+TSMAccessProfile ROTiledStManAccessor::getAccessProfile (uInt hypercube) const
+{
+    return dataManPtr_p->getTSMCube(hypercube)->accessProfile();
+}
+
+void ROTiledStManAccessor::saveAccessProfiles (const String& fileName) const
+{
+    std::vector<TSMAccessProfile> profiles;
+    profiles.reserve (nhypercubes());
+    for (uInt i=0; i<nhypercubes(); ++i) {
+        profiles.push_back (getAccessProfile(i));
+    }
+    TSMAccessProfile::writeProfiles (fileName, profiles);
+}
+
 } //# NAMESPACE CASACORE - END
 
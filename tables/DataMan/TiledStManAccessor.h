@@ -29,6 +29,7 @@
 //# Includes
 #include <casacore/casa/aips.h>
 #include <casacore/tables/DataMan/DataManAccessor.h>
+#include <casacore/tables/DataMan/TSMAccessProfile.h>
 #include <casacore/casa/iosfwd.h>
 
 namespace casacore { //# NAMESPACE CASACORE - BEGIN
@@ -279,6 +280,19 @@ public:
     // resulting in a possibly large drop in memory used.
     void clearCaches();
 
+    // Switch recording of the access patterns of the hypercubes on or off.
+    // Switching it on clears the profiles recorded before.
+    // See class <linkto class=TSMAccessProfile>TSMAccessProfile</linkto>
+    // for more information.
+    void setAccessProfiling (Bool profile);
+
+    // Get the access profile recorded for the given hypercube.
+    TSMAccessProfile getAccessProfile (uInt hypercube) const;
+
+    // Write the access profiles of all hypercubes into the given file.
+    // They can be read back using <src>TSMAccessProfile::readProfiles</src>.
+    void saveAccessProfiles (const String& fileName) const;
+
 
 protected:
     // Get the data manager.
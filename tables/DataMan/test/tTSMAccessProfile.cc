@@ -0,0 +1,263 @@
+//# tTSMAccessProfile.cc: Test program for the TSM access profiles
+//# Copyright (C) 2026
+//# Associated Universities, Inc. Washington DC, USA.
+//#
+//# This program is free software; you can redistribute it and/or modify it
+//# under the terms of the GNU General Public License as published by the Free
+//# Software Foundation; either version 2 of the License, or (at your option)
+//# any later version.
+//#
+//# This program is distributed in the hope that it will be useful, but WITHOUT
+//# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+//# more details.
+//#
+//# You should have received a copy of the GNU General Public License along
+//# with this program; if not, write to the Free Software Foundation, Inc.,
+//# 675 Massachusetts Ave, Cambridge, MA 02139, USA.
+//#
+//# Correspondence concerning AIPS++ should be addressed as follows:
+//#        Internet email: aips2-request@nrao.edu.
+//#        Postal address: AIPS++ Project Office
+//#                        National Radio Astronomy Observatory
+//#                        520 Edgemont Road
+//#                        Charlottesville, VA 22903-2475 USA
+
+#include <casacore/tables/DataMan/TSMAccessProfile.h>
+#include <casacore/tables/DataMan/TiledStManAccessor.h>
+#include <casacore/tables/DataMan/TiledColumnStMan.h>
+#include <casacore/tables/DataMan/TSMCube.h>
+#include <casacore/tables/DataMan/TSMOption.h>
+#include <casacore/tables/Tables/TableDesc.h>
+#include <casacore/tables/Tables/SetupNewTab.h>
+#include <casacore/tables/Tables/Table.h>
+#include <casacore/tables/Tables/ArrColDesc.h>
+#include <casacore/tables/Tables/ArrayColumn.h>
+#include <casacore/tables/Tables/TableCopy.h>
+#include <casacore/casa/Arrays/ArrayLogical.h>
+#include <casacore/casa/Arrays/Cube.h>
+#include <casacore/casa/Arrays/Matrix.h>
+#include <casacore/casa/Arrays/Slicer.h>
+#include <casacore/casa/Utilities/Assert.h>
+#include <casacore/casa/Exceptions/Error.h>
+#include <casacore/casa/iostream.h>
+
+#include <casacore/casa/namespace.h>
+
+// <summary>
+// Test program for recording the access pattern of a tiled column,
+// the tile shape advisor and retiling a column.
+// </summary>
+
+const String tabName("tTSMAccessProfile_tmp.data");
+const Int npol  = 4;
+const Int nchan = 64;
+const Int nrow  = 256;
+
+Float value (Int pol, Int chan, Int row)
+{
+  return pol + 10*chan + 1000*row;
+}
+
+void createTable()
+{
+  TableDesc td;
+  td.addColumn (ArrayColumnDesc<Float> ("DATA", IPosition(2, npol, nchan),
+                                        ColumnDesc::FixedShape));
+  SetupNewTable newtab(tabName, td, Table::New);
+  TiledColumnStMan stman ("TSMData", IPosition(3, npol, 8, 16));
+  newtab.bindAll (stman);
+  Table tab(newtab, nrow);
+  ArrayColumn<Float> data(tab, "DATA");
+  Matrix<Float> arr(npol, nchan);
+  for (Int row=0; row<nrow; ++row) {
+    for (Int chan=0; chan<nchan; ++chan) {
+      for (Int pol=0; pol<npol; ++pol) {
+        arr(pol, chan) = value(pol, chan, row);
+      }
+    }
+    data.put (row, arr);
+  }
+}
+
+// Read the data row by row.
+TSMAccessProfile readRows()
+{
+  Table tab(tabName);
+  ROTiledStManAccessor acc(tab, "DATA", True);
+  acc.setAccessProfiling (True);
+  ArrayColumn<Float> data(tab, "DATA");
+  for (Int row=0; row<nrow; ++row) {
+    AlwaysAssertExit (data(row)(IPosition(2,1,3)) == value(1,3,row));
+  }
+  TSMAccessProfile prof = acc.getAccessProfile (0);
+  AlwaysAssertExit (prof.patterns().size() == 1);
+  AlwaysAssertExit (prof.nrecorded() == uInt64(nrow));
+  AlwaysAssertExit (prof.patterns()[0].shape.isEqual
+                    (IPosition(3, npol, nchan, 1)));
+  AlwaysAssertExit (! prof.patterns()[0].write);
+  AlwaysAssertExit (prof.tileShape().isEqual (IPosition(3, npol, 8, 16)));
+  return prof;
+}
+
+// Read the data channel by channel for all rows.
+TSMAccessProfile readChannels()
+{
+  Table tab(tabName);
+  ROTiledStManAccessor acc(tab, "DATA", True);
+  acc.setAccessProfiling (True);
+  ArrayColumn<Float> data(tab, "DATA");
+  for (Int chan=0; chan<nchan; ++chan) {
+    Cube<Float> arr = data.getColumn (Slicer(IPosition(2, 0, chan),
+                                             IPosition(2, npol, 1)));
+    AlwaysAssertExit (arr(2, 0, 7) == value(2, chan, 7));
+  }
+  acc.setAccessProfiling (False);
+  // Not recorded anymore.
+  data.get (0);
+  TSMAccessProfile prof = acc.getAccessProfile (0);
+  AlwaysAssertExit (prof.nrecorded() > 0);
+  for (const TSMAccessProfile::Pattern& pattern : prof.patterns()) {
+    AlwaysAssertExit (pattern.shape[1] == 1);
+  }
+  return prof;
+}
+
+void checkAdvice (const TSMAccessProfile& rowProf,
+                  const TSMAccessProfile& chanProf)
+{
+  IPosition rowTile  = rowProf.adviseTileShape();
+  IPosition chanTile = chanProf.adviseTileShape();
+  cout << "Row access:" << endl;
+  rowProf.show (cout);
+  cout << "advised tile shape " << rowTile << endl;
+  cout << "Channel access:" << endl;
+  chanProf.show (cout);
+  cout << "advised tile shape " << chanTile << endl;
+  // Row access wants all channels in a tile, channel access few channels.
+  AlwaysAssertExit (rowTile[1] == nchan);
+  AlwaysAssertExit (chanTile[1] < rowTile[1]);
+  // The advised tile shape is never worse than the current one.
+  AlwaysAssertExit (rowProf.ioCost(rowTile) <=
+                    rowProf.ioCost(rowProf.tileShape()));
+  AlwaysAssertExit (chanProf.ioCost(chanTile) <=
+                    chanProf.ioCost(chanProf.tileShape()));
+  // A tile size limit is obeyed.
+  IPosition smallTile = rowProf.adviseTileShape (4096);
+  AlwaysAssertExit (smallTile.product() * sizeof(Float) <= 4096);
+  AlwaysAssertExit (rowProf.adviseCacheSize (rowTile) >= 1);
+  // Merging adds the patterns.
+  TSMAccessProfile merged (rowProf);
+  merged.merge (chanProf);
+  AlwaysAssertExit (merged.nrecorded() ==
+                    rowProf.nrecorded() + chanProf.nrecorded());
+  // An empty profile keeps the tile shape.
+  TSMAccessProfile empty (IPosition(3, npol, nchan, nrow),
+                          IPosition(3, 2, 2, 2), 4, False);
+  AlwaysAssertExit (empty.adviseTileShape().isEqual (IPosition(3, 2, 2, 2)));
+  AlwaysAssertExit (empty.ioCost (IPosition(3, 2, 2, 2)) == 0);
+  AlwaysAssertExit (empty.hitRatio() == -1);
+}
+
+void checkSave (const TSMAccessProfile& rowProf)
+{
+  const String profName = tabName + ".profile";
+  {
+    Table tab(tabName);
+    ROTiledStManAccessor acc(tab, "DATA", True);
+    acc.setAccessProfiling (True);
+    ArrayColumn<Float> data(tab, "DATA");
+    for (Int row=0; row<nrow; ++row) {
+      data.get (row);
+    }
+    acc.saveAccessProfiles (profName);
+  }
+  std::vector<TSMAccessProfile> profs =
+    TSMAccessProfile::readProfiles (profName);
+  AlwaysAssertExit (profs.size() == 1);
+  const TSMAccessProfile& prof = profs[0];
+  AlwaysAssertExit (prof.cubeShape().isEqual (rowProf.cubeShape()));
+  AlwaysAssertExit (prof.tileShape().isEqual (rowProf.tileShape()));
+  AlwaysAssertExit (prof.patterns().size() == rowProf.patterns().size());
+  AlwaysAssertExit (prof.nrecorded() == rowProf.nrecorded());
+  AlwaysAssertExit (prof.adviseTileShape().isEqual
+                    (rowProf.adviseTileShape()));
+  AlwaysAssertExit (prof.ioCost(prof.tileShape()) ==
+                    rowProf.ioCost(rowProf.tileShape()));
+}
+
+// A strided access is recorded once, also if it is done by reading
+// (and writing) the full section.
+void checkStrided (TSMOption::Option option)
+{
+  Table tab(tabName, Table::Update, TSMOption(option));
+  ROTiledStManAccessor acc(tab, "DATA", True);
+  acc.setAccessProfiling (True);
+  ArrayColumn<Float> data(tab, "DATA");
+  Slicer slicer(IPosition(2, 0, 0), IPosition(2, npol-1, nchan-1),
+                IPosition(2, 2, 3), Slicer::endIsLast);
+  Matrix<Float> arr = data.getSlice (5, slicer);
+  AlwaysAssertExit (arr(1, 2) == value(2, 6, 5));
+  data.putSlice (5, slicer, arr);
+  TSMAccessProfile prof = acc.getAccessProfile (0);
+  AlwaysAssertExit (prof.nrecorded() == 2);
+  AlwaysAssertExit (prof.patterns().size() == 2);
+  // The box spanned by the strided section is recorded.
+  for (const TSMAccessProfile::Pattern& pattern : prof.patterns()) {
+    AlwaysAssertExit (pattern.count == 1);
+    AlwaysAssertExit (pattern.shape[1] > nchan/2  &&  pattern.shape[2] == 1);
+  }
+  AlwaysAssertExit (prof.patterns()[0].shape.isEqual
+                    (prof.patterns()[1].shape));
+  AlwaysAssertExit (prof.patterns()[0].write != prof.patterns()[1].write);
+}
+
+void checkRetile (const IPosition& tileShape)
+{
+  {
+    Table tab(tabName, Table::Update);
+    TableCopy::retileColumn (tab, "DATA", tileShape);
+  }
+  Table tab(tabName);
+  ROTiledStManAccessor acc(tab, "DATA", True);
+  AlwaysAssertExit (acc.dataManagerName() == "TSMData_retiled");
+  AlwaysAssertExit (acc.getTileShape(0).isEqual (tileShape));
+  ArrayColumn<Float> data(tab, "DATA");
+  for (Int row=0; row<nrow; row+=17) {
+    Matrix<Float> arr = data(row);
+    for (Int chan=0; chan<nchan; ++chan) {
+      for (Int pol=0; pol<npol; ++pol) {
+        AlwaysAssertExit (arr(pol, chan) == value(pol, chan, row));
+      }
+    }
+  }
+}
+
+int main()
+{
+  try {
+    createTable();
+    TSMAccessProfile rowProf  = readRows();
+    TSMAccessProfile chanProf = readChannels();
+    checkAdvice (rowProf, chanProf);
+    checkSave (rowProf);
+    checkStrided (TSMOption::Cache);
+    checkStrided (TSMOption::Buffer);
+    checkStrided (TSMOption::MMap);
+    checkRetile (chanProf.adviseTileShape());
+    // Retiling a column that is not tiled fails.
+    Table tab(tabName, Table::Update);
+    Bool failed = False;
+    try {
+      TableCopy::retileColumn (tab, "NOCOL", IPosition(3, 1, 1, 1));
+    } catch (const AipsError&) {
+      failed = True;
+    }
+    AlwaysAssertExit (failed);
+  } catch (const std::exception& x) {
+    cout << "Unexpected exception: " << x.what() << endl;
+    return 1;
+  }
+  cout << "OK" << endl;
+  return 0;
+}
@@ -39,6 +39,7 @@
 #include <casacore/casa/Arrays/Vector.h>
 #include <casacore/casa/OS/Path.h>
 #include <casacore/casa/BasicSL/String.h>
+#include <algorithm>
 
 
 namespace casacore { //# NAMESPACE CASACORE - BEGIN
@@ -248,6 +249,77 @@ void TableCopy::copyColumnData (const Table& tabFrom, const String& colFrom,
   }
 }
 
+void TableCopy::retileColumn (Table& table, const String& column,
+                              const IPosition& tileShape,
+                              const String& dataManagerName)
+{
+  // Find the data manager of the column.
+  Record dminfo = table.dataManagerInfo();
+  Record dmrec;
+  for (uInt i=0; i<dminfo.nfields(); ++i) {
+    const Record& rec = dminfo.subRecord(i);
+    Vector<String> cols (rec.asArrayString ("COLUMNS"));
+    if (std::find (cols.begin(), cols.end(), column) != cols.end()) {
+      if (cols.size() != 1) {
+        throw TableError ("TableCopy::retileColumn: data manager " +
+                          rec.asString("NAME") + " of column " + column +
+                          " contains other columns as well");
+      }
+      dmrec = rec;
+      break;
+    }
+  }
+  if (dmrec.nfields() == 0) {
+    throw TableError ("TableCopy::retileColumn: column " + column +
+                      " does not exist");
+  }
+  String type = dmrec.asString ("TYPE");
+  if (type != "TiledShapeStMan"  &&  type != "TiledColumnStMan"
+  &&  type != "TiledCellStMan") {
+    throw TableError ("TableCopy::retileColumn: column " + column +
+                      " is stored with " + type +
+                      ", not with a tiled storage manager");
+  }
+  // Make the new data manager using the old specification, but
+  // without the existing hypercubes.
+  String dmName (dataManagerName);
+  if (dmName.empty()) {
+    dmName = dmrec.asString ("NAME");
+    if (dmName.size() > 8  &&
+        dmName.compare (dmName.size()-8, 8, "_retiled") == 0) {
+      dmName = dmName.substr (0, dmName.size()-8);
+    } else {
+      dmName += "_retiled";
+    }
+  }
+  Record spec;
+  if (dmrec.isDefined ("SPEC")) {
+    spec = dmrec.asRecord ("SPEC");
+  }
+  if (spec.isDefined ("HYPERCUBES")) {
+    spec.removeField ("HYPERCUBES");
+  }
+  spec.define ("DEFAULTTILESHAPE", tileShape.asVector());
+  String tmpColumn = column + "_retile_tmp";
+  Record newrec;
+  newrec.define ("TYPE", type);
+  newrec.define ("NAME", dmName);
+  newrec.define ("COLUMNS", Vector<String>(1, tmpColumn));
+  newrec.defineRecord ("SPEC", spec);
+  Record newdminfo;
+  newdminfo.defineRecord ("*1", newrec);
+  // Copy the data into the new column using the new default tile shape.
+  cloneColumn (table, column, table, tmpColumn, dmName, newdminfo);
+  try {
+    copyColumnData (table, column, table, tmpColumn, False);
+  } catch (...) {
+    table.removeColumn (tmpColumn);
+    throw;
+  }
+  table.removeColumn (column);
+  table.renameColumn (column, tmpColumn);
+}
+
 
 } //# NAMESPACE CASACORE - END
 
@@ -188,6 +188,19 @@ public:
                               const String& toColumn,
                               Bool preserveTileShape=True);
 
+  // Retile a column stored with a TiledShapeStMan, TiledColumnStMan or
+  // TiledCellStMan using the given tile shape (of the hypercube).
+  // The data are copied into a new column with a new data manager of
+  // the same type, after which the old column is replaced by it.
+  // The data manager must not contain other columns.
+  // If not given, the new data manager gets the name of the old one with
+  // suffix <src>_retiled</src> (or without if the old name had it).
+  // <br>The advised tile shape can be obtained from an access profile
+  // (see class <linkto class=TSMAccessProfile>TSMAccessProfile</linkto>).
+  static void retileColumn (Table& table, const String& column,
+                            const IPosition& tileShape,
+                            const String& dataManagerName = String());
+
   // Fill the table column with the given array.
   // The template type must match the column data type.
   template<typename T>
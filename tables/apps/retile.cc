@@ -0,0 +1,162 @@
+//# retile.cc: Advise a tile shape and retile a column of a table
+//# Copyright (C) 2026
+//# Associated Universities, Inc. Washington DC, USA.
+//#
+//# This program is free software; you can redistribute it and/or modify it
+//# under the terms of the GNU General Public License as published by the Free
+//# Software Foundation; either version 2 of the License, or (at your option)
+//# any later version.
+//#
+//# This program is distributed in the hope that it will be useful, but WITHOUT
+//# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+//# more details.
+//#
+//# You should have received a copy of the GNU General Public License along
+//# with this program; if not, write to the Free Software Foundation, Inc.,
+//# 675 Massachusetts Ave, Cambridge, MA 02139, USA.
+//#
+//# Correspondence concerning AIPS++ should be addressed as follows:
+//#        Internet email: aips2-request@nrao.edu.
+//#        Postal address: AIPS++ Project Office
+//#                        National Radio Astronomy Observatory
+//#                        520 Edgemont Road
+//#                        Charlottesville, VA 22903-2475 USA
+
+#include <casacore/tables/Tables/Table.h>
+#include <casacore/tables/Tables/TableCopy.h>
+#include <casacore/tables/DataMan/TiledStManAccessor.h>
+#include <casacore/tables/DataMan/TSMAccessProfile.h>
+#include <casacore/casa/Inputs/Input.h>
+#include <casacore/casa/Arrays/IPosition.h>
+#include <casacore/casa/Containers/Block.h>
+#include <stdexcept>
+#include <iostream>
+#include <vector>
+
+using namespace casacore;
+using namespace std;
+
+// This program advises the tile shape of a column stored with a tiled
+// storage manager using the access profile recorded by an application
+// (see ROTiledStManAccessor::saveAccessProfiles).
+// It can retile the column in place using the advised or a given tile shape.
+
+// Merge the profiles of all hypercubes with the dimensionality of the
+// largest one into a profile for that hypercube.
+TSMAccessProfile mergeProfiles (const std::vector<TSMAccessProfile>& profiles)
+{
+  size_t largest = 0;
+  for (size_t i=0; i<profiles.size(); ++i) {
+    if (profiles[i].cubeShape().product() >
+        profiles[largest].cubeShape().product()) {
+      largest = i;
+    }
+  }
+  TSMAccessProfile merged (profiles[largest]);
+  for (size_t i=0; i<profiles.size(); ++i) {
+    if (i != largest  &&  ! profiles[i].patterns().empty()  &&
+        profiles[i].cubeShape().size() == merged.cubeShape().size()) {
+      merged.merge (profiles[i]);
+    }
+  }
+  return merged;
+}
+
+int main (int argc, char* argv[])
+{
+  try {
+    // Read the input parameters.
+    Input inputs(1);
+    inputs.version("20261018");
+    inputs.create("in", "", "Input table", "string");
+    inputs.create("column", "", "Name of the column to retile", "string");
+    inputs.create("profile", "",
+                  "File containing the access profile of the column",
+                  "string");
+    inputs.create("tileshape", "",
+                  "Tile shape to use (default is the advised tile shape)",
+                  "Block<Int>");
+    inputs.create("maxtilesize", "1024", "Maximum tile size (KiB)", "int");
+    inputs.create("maxcachesize", "0",
+                  "Maximum cache size (MiB) assumed (0 is unlimited)", "int");
+    inputs.create("dryrun", "F", "Only show the advice?", "bool");
+    inputs.readArguments(argc, argv);
+
+    // Get and check the input specification.
+    String in (inputs.getString("in"));
+    if (in.empty()) {
+      throw AipsError(" an input table name must be given");
+    }
+    String column (inputs.getString("column"));
+    if (column.empty()) {
+      throw AipsError(" a column name must be given");
+    }
+    String profileName (inputs.getString("profile"));
+    Block<Int> tileShapeB (inputs.getIntArray("tileshape"));
+    uInt64 maxTileSize = inputs.getInt("maxtilesize");
+    uInt maxCacheSize  = inputs.getInt("maxcachesize");
+    Bool dryrun        = inputs.getBool("dryrun");
+    if (profileName.empty()  &&  tileShapeB.empty()) {
+      throw AipsError(" a profile or a tile shape must be given");
+    }
+
+    Table table(in, dryrun ? Table::Old : Table::Update);
+    {
+      ROTiledStManAccessor acc(table, column, True);
+      cout << "Column " << column << " is stored with "
+           << acc.dataManagerType() << ' ' << acc.dataManagerName() << endl;
+      for (uInt i=0; i<acc.nhypercubes(); ++i) {
+        if (acc.getHypercubeShape(i).product() > 0) {
+          cout << "  hypercube " << i << ": shape "
+               << acc.getHypercubeShape(i) << "  tile shape "
+               << acc.getTileShape(i) << endl;
+        }
+      }
+    }
+    IPosition tileShape(tileShapeB.nelements());
+    for (uInt i=0; i<tileShapeB.nelements(); ++i) {
+      tileShape[i] = tileShapeB[i];
+    }
+    if (! profileName.empty()) {
+      std::vector<TSMAccessProfile> profiles =
+        TSMAccessProfile::readProfiles (profileName);
+      if (profiles.empty()) {
+        throw AipsError(" profile " + profileName + " is empty");
+      }
+      TSMAccessProfile profile = mergeProfiles (profiles);
+      cout << "Recorded access profile:" << endl;
+      profile.show (cout);
+      IPosition advised = profile.adviseTileShape (maxTileSize*1024,
+                                                   maxCacheSize);
+      Double curCost = profile.ioCost (profile.tileShape(), maxCacheSize);
+      Double advCost = profile.ioCost (advised, maxCacheSize);
+      cout << "current tile shape " << profile.tileShape()
+           << "  estimated I/O " << curCost / (1024*1024) << " MiB" << endl;
+      cout << "advised tile shape " << advised
+           << "  estimated I/O " << advCost / (1024*1024) << " MiB"
+           << "  cache size " << profile.adviseCacheSize (advised, maxCacheSize)
+           << " tiles" << endl;
+      if (tileShape.empty()) {
+        if (advised.isEqual (profile.tileShape())) {
+          cout << "The current tile shape is the best; no retiling needed"
+               << endl;
+          return 0;
+        }
+        tileShape = advised;
+      }
+    }
+    if (! dryrun) {
+      cout << "Retiling column " << column << " with tile shape "
+           << tileShape << " ..." << endl;
+      TableCopy::retileColumn (table, column, tileShape);
+      ROTiledStManAccessor acc(table, column, True);
+      cout << "Column " << column << " is now stored with "
+           << acc.dataManagerName() << endl;
+    }
+  } catch (std::exception& x) {
+    cerr << x.what() << endl;
+    return 1;
+  }
+  return 0;
+}